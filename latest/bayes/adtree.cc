@@ -79,9 +79,11 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 #include "adtree.h"
 #include "data.h"
 #include "query.h"
+#include "thread.h"
 #include "utility.h"
 #include "vector.h"
 #include "tm_transition.h"
@@ -216,15 +218,13 @@ adtree_free (adtree_t* adtreePtr)
 
 
 static adtree_vary_t*
-makeVary (long parentIndex,
-          long index,
+makeVary (long index,
           long start,
           long numRecord,
           data_t* dataPtr);
 
 static adtree_node_t*
-makeNode (long parentIndex,
-          long index,
+makeNode (long index,
           long start,
           long numRecord,
           data_t* dataPtr);
@@ -232,11 +232,12 @@ makeNode (long parentIndex,
 
 /* =============================================================================
  * makeVary
+ * -- Counts only depend on which records fall in a range, not on their order,
+ *    so a two-way partition on the index column is enough (no sorting)
  * =============================================================================
  */
 static adtree_vary_t*
-makeVary (long parentIndex,
-          long index,
+makeVary (long index,
           long start,
           long numRecord,
           data_t* dataPtr)
@@ -244,11 +245,7 @@ makeVary (long parentIndex,
     adtree_vary_t* varyPtr = allocVary(index);
     assert(varyPtr);
 
-    if ((parentIndex + 1 != index) && (numRecord > 1)) {
-        data_sort(dataPtr, start, numRecord, index);
-    }
-
-    long num0 = data_findSplit(dataPtr, start, numRecord, index);
+    long num0 = data_partition(dataPtr, start, numRecord, index);
     long num1 = numRecord - num0;
 
     long mostCommonValue = ((num0 >= num1) ? 0 : 1);
@@ -258,7 +255,7 @@ makeVary (long parentIndex,
         varyPtr->zeroNodePtr = NULL;
     } else {
         varyPtr->zeroNodePtr =
-            makeNode(index, index, start, num0, dataPtr);
+            makeNode(index, start, num0, dataPtr);
         varyPtr->zeroNodePtr->value = 0;
     }
 
@@ -266,7 +263,7 @@ makeVary (long parentIndex,
         varyPtr->oneNodePtr = NULL;
     } else {
         varyPtr->oneNodePtr =
-            makeNode(index, index, (start + num0), num1, dataPtr);
+            makeNode(index, (start + num0), num1, dataPtr);
         varyPtr->oneNodePtr->value = 1;
     }
 
@@ -279,8 +276,7 @@ makeVary (long parentIndex,
  * =============================================================================
  */
 static adtree_node_t*
-makeNode (long parentIndex,
-          long index,
+makeNode (long index,
           long start,
           long numRecord,
           data_t* dataPtr)
@@ -296,7 +292,7 @@ makeNode (long parentIndex,
     long numVar = dataPtr->numVar;
     for (v = (index + 1); v < numVar; v++) {
         adtree_vary_t* varyPtr =
-            makeVary(parentIndex, v, start, numRecord, dataPtr);
+            makeVary(v, start, numRecord, dataPtr);
         assert(varyPtr);
         bool status = vector_pushBack(varyVectorPtr, (void*)varyPtr);
         assert(status);
@@ -306,19 +302,189 @@ makeNode (long parentIndex,
 }
 
 
+/*
+ * Parallel construction: the root and its varies (one partition of all
+ * records per variable) are built sequentially. Each root vary has at most
+ * one child node; the varies of those children are independent subtrees and
+ * become the tasks. Every thread works on a private copy of the records, so
+ * partitions never interfere, and tasks are handed out in (v, w) order so a
+ * thread usually finds its copy already partitioned on v.
+ */
+typedef struct makeTask {
+    long v;       /* root vary */
+    long w;       /* vary of the root vary's child node */
+} makeTask_t;
+
+typedef struct makeArg {
+    data_t* dataPtr;
+    adtree_node_t** childNodePtrs; /* [v]: least common child of root vary v */
+    adtree_vary_t** varyPtrs;      /* [v * numVar + w] */
+    makeTask_t* tasks;
+    long numTask;
+    long nextTask;
+} makeArg_t;
+
+
+/* =============================================================================
+ * grabTask
+ * -- Returns index of next task, or numTask if there are none left
+ * -- Kept out of line so makeSubtrees' locals are not live across the
+ *    transaction begin
+ * =============================================================================
+ */
+__attribute__((noinline))
+static long
+grabTask (makeArg_t* makeArgPtr)
+{
+    long t;
+
+    __transaction_atomic {
+        t = makeArgPtr->nextTask;
+        if (t < makeArgPtr->numTask) {
+            makeArgPtr->nextTask = t + 1;
+        }
+    }
+
+    return t;
+}
+
+
+/* =============================================================================
+ * makeSubtrees
+ * -- Executed by every thread
+ * =============================================================================
+ */
+static void
+makeSubtrees (void* argPtr)
+{
+    makeArg_t* makeArgPtr = (makeArg_t*)argPtr;
+    data_t* dataPtr = makeArgPtr->dataPtr;
+    long numVar = dataPtr->numVar;
+    long numRecord = dataPtr->numRecord;
+
+    data_t myData = *dataPtr;
+    myData.records = (char*)malloc(numVar * numRecord * sizeof(char));
+    assert(myData.records);
+    memcpy(myData.records, dataPtr->records, (numVar * numRecord));
+
+    long lastV = -1;
+    long start = 0;
+    long num = 0;
+
+    while (1) {
+        long t = grabTask(makeArgPtr);
+        if (t >= makeArgPtr->numTask) {
+            break;
+        }
+
+        long v = makeArgPtr->tasks[t].v;
+        long w = makeArgPtr->tasks[t].w;
+        adtree_node_t* childNodePtr = makeArgPtr->childNodePtrs[v];
+
+        if (v != lastV) {
+            long num0 = data_partition(&myData, 0, numRecord, v);
+            start = ((childNodePtr->value == 0) ? 0 : num0);
+            num = childNodePtr->count;
+            assert(num == ((childNodePtr->value == 0) ? num0 : (numRecord - num0)));
+            lastV = v;
+        }
+
+        makeArgPtr->varyPtrs[v * numVar + w] = makeVary(w, start, num, &myData);
+    }
+
+    free(myData.records);
+}
+
+
 /* =============================================================================
  * adtree_make
  * -- Records in dataPtr will get rearranged
+ * -- Uses the thread pool if it has been started with more than one thread
  * =============================================================================
  */
 void
 adtree_make (adtree_t* adtreePtr, data_t* dataPtr)
 {
     long numRecord = dataPtr->numRecord;
-    adtreePtr->numVar = dataPtr->numVar;
-    adtreePtr->numRecord = dataPtr->numRecord;
-    data_sort(dataPtr, 0, numRecord, 0);
-    adtreePtr->rootNodePtr = makeNode(-1, -1, 0, numRecord, dataPtr);
+    long numVar = dataPtr->numVar;
+    adtreePtr->numVar = numVar;
+    adtreePtr->numRecord = numRecord;
+
+    if (thread_getNumThread() <= 1) {
+        adtreePtr->rootNodePtr = makeNode(-1, 0, numRecord, dataPtr);
+        return;
+    }
+
+    adtree_node_t* rootNodePtr = allocNode(-1);
+    assert(rootNodePtr);
+    rootNodePtr->count = numRecord;
+
+    makeArg_t arg;
+    arg.dataPtr = dataPtr;
+    arg.childNodePtrs =
+        (adtree_node_t**)malloc(numVar * sizeof(adtree_node_t*));
+    assert(arg.childNodePtrs);
+    arg.varyPtrs =
+        (adtree_vary_t**)calloc(numVar * numVar, sizeof(adtree_vary_t*));
+    assert(arg.varyPtrs);
+    arg.tasks = (makeTask_t*)malloc(numVar * numVar * sizeof(makeTask_t));
+    assert(arg.tasks);
+    arg.numTask = 0;
+    arg.nextTask = 0;
+
+    long v;
+    for (v = 0; v < numVar; v++) {
+        adtree_vary_t* varyPtr = allocVary(v);
+        assert(varyPtr);
+        long num0 = data_partition(dataPtr, 0, numRecord, v);
+        long num1 = numRecord - num0;
+        long mostCommonValue = ((num0 >= num1) ? 0 : 1);
+        varyPtr->mostCommonValue = mostCommonValue;
+        adtree_node_t* childNodePtr = NULL;
+        if (mostCommonValue == 1 && num0 != 0) {
+            childNodePtr = allocNode(v);
+            assert(childNodePtr);
+            childNodePtr->value = 0;
+            childNodePtr->count = num0;
+            varyPtr->zeroNodePtr = childNodePtr;
+        } else if (mostCommonValue == 0 && num1 != 0) {
+            childNodePtr = allocNode(v);
+            assert(childNodePtr);
+            childNodePtr->value = 1;
+            childNodePtr->count = num1;
+            varyPtr->oneNodePtr = childNodePtr;
+        }
+        arg.childNodePtrs[v] = childNodePtr;
+        if (childNodePtr) {
+            long w;
+            for (w = (v + 1); w < numVar; w++) {
+                arg.tasks[arg.numTask].v = v;
+                arg.tasks[arg.numTask].w = w;
+                arg.numTask++;
+            }
+        }
+        bool status = vector_pushBack(rootNodePtr->varyVectorPtr, (void*)varyPtr);
+        assert(status);
+    }
+
+    thread_start(makeSubtrees, (void*)&arg);
+
+    long t;
+    for (t = 0; t < arg.numTask; t++) {
+        long v = arg.tasks[t].v;
+        long w = arg.tasks[t].w;
+        adtree_vary_t* varyPtr = arg.varyPtrs[v * numVar + w];
+        assert(varyPtr);
+        bool status = vector_pushBack(arg.childNodePtrs[v]->varyVectorPtr,
+                                      (void*)varyPtr);
+        assert(status);
+    }
+
+    free(arg.tasks);
+    free(arg.varyPtrs);
+    free(arg.childNodePtrs);
+
+    adtreePtr->rootNodePtr = rootNodePtr;
 }
 
 
@@ -331,7 +497,7 @@ long
 getCount (adtree_node_t* nodePtr,
           long i,
           long q,
-          vector_t* queryVectorPtr,
+          query_vector_t* queryVectorPtr,
           long lastQueryIndex,
           adtree_t* adtreePtr)
 {
@@ -346,10 +512,11 @@ getCount (adtree_node_t* nodePtr,
 
     long count = 0L;
 
-    query_t* queryPtr = (query_t*)vector_at(queryVectorPtr, q);
-    if (!queryPtr) {
+    long numQuery = svector_getSize(queryVectorPtr);
+    if (q >= numQuery) {
         return nodePtr->count;
     }
+    query_t* queryPtr = svector_at(queryVectorPtr, q);
     long queryIndex = queryPtr->index;
     assert(queryIndex <= lastQueryIndex);
     vector_t* varyVectorPtr = nodePtr->varyVectorPtr;
@@ -367,26 +534,23 @@ getCount (adtree_node_t* nodePtr,
          * the current (superCount) and subtracting the count for the
          * query with the current toggled (invertCount).
          */
-        long numQuery = vector_getSize(queryVectorPtr);
-        //[wer] PVECTOR_ALLOC is transformed into TM_SAFE
-        vector_t* superQueryVectorPtr = PVECTOR_ALLOC(numQuery - 1);
-
-        assert(superQueryVectorPtr);
+        query_vector_t superQueryVector;
+        svector_init(&superQueryVector);
+        bool status = svector_reserve(&superQueryVector, (numQuery - 1));
+        assert(status);
 
+        query_t** queryPtrs = svector_getElements(queryVectorPtr);
         long qq;
         for (qq = 0; qq < numQuery; qq++) {
             if (qq != q) {
-              //[wer] TM_SAFE call
-                bool status = vector_pushBack(superQueryVectorPtr,
-                                                vector_at(queryVectorPtr, qq));
+                status = svector_pushBack(&superQueryVector, queryPtrs[qq]);
                 assert(status);
             }
         }
 
-        long superCount = adtree_getCount(adtreePtr, superQueryVectorPtr);
+        long superCount = adtree_getCount(adtreePtr, &superQueryVector);
 
-        //[wer]TM_SAFE
-        PVECTOR_FREE(superQueryVectorPtr);
+        svector_free(&superQueryVector);
 
         long invertCount;
         if (queryValue == 0) {
@@ -457,7 +621,7 @@ getCount (adtree_node_t* nodePtr,
 //[wer] called in learner.c inside a TM_SAFE function
 __attribute__((transaction_safe))
 long
-adtree_getCount (adtree_t* adtreePtr, vector_t* queryVectorPtr)
+adtree_getCount (adtree_t* adtreePtr, query_vector_t* queryVectorPtr)
 {
     adtree_node_t* rootNodePtr = adtreePtr->rootNodePtr;
     if (rootNodePtr == NULL) {
@@ -465,9 +629,9 @@ adtree_getCount (adtree_t* adtreePtr, vector_t* queryVectorPtr)
     }
 
     long lastQueryIndex = -1L;
-    long numQuery = vector_getSize(queryVectorPtr);
+    long numQuery = svector_getSize(queryVectorPtr);
     if (numQuery > 0) {
-        query_t* lastQueryPtr = (query_t*)vector_at(queryVectorPtr, (numQuery - 1));
+        query_t* lastQueryPtr = svector_at(queryVectorPtr, (numQuery - 1));
         lastQueryIndex = lastQueryPtr->index;
     }
     //[wer] this function should be safe
@@ -553,13 +717,13 @@ printAdtree (adtree_t* adtreePtr)
 
 
 static void
-printQuery (vector_t* queryVectorPtr)
+printQuery (query_vector_t* queryVectorPtr)
 {
     printf("[");
     long q;
-    long numQuery = vector_getSize(queryVectorPtr);
+    long numQuery = svector_getSize(queryVectorPtr);
     for (q = 0; q < numQuery; q++) {
-        query_t* queryPtr = (query_t*)vector_at(queryVectorPtr, q);
+        query_t* queryPtr = svector_at(queryVectorPtr, q);
         printf("%li:%li ", queryPtr->index, queryPtr->value);
     }
     printf("]");
@@ -567,10 +731,10 @@ printQuery (vector_t* queryVectorPtr)
 
 
 static long
-countData (data_t* dataPtr, vector_t* queryVectorPtr)
+countData (data_t* dataPtr, query_vector_t* queryVectorPtr)
 {
     long count = 0;
-    long numQuery = vector_getSize(queryVectorPtr);
+    long numQuery = svector_getSize(queryVectorPtr);
 
     long r;
     long numRecord = dataPtr->numRecord;
@@ -579,7 +743,7 @@ countData (data_t* dataPtr, vector_t* queryVectorPtr)
         bool isMatch = true;
         long q;
         for (q = 0; q < numQuery; q++) {
-            query_t* queryPtr = (query_t*)vector_at(queryVectorPtr, q);
+            query_t* queryPtr = svector_at(queryVectorPtr, q);
             long queryValue = queryPtr->value;
             if ((queryValue != QUERY_VALUE_WILDCARD) &&
                 ((char)queryValue) != record[queryPtr->index])
@@ -600,7 +764,7 @@ countData (data_t* dataPtr, vector_t* queryVectorPtr)
 static void
 testCount (adtree_t* adtreePtr,
            data_t* dataPtr,
-           vector_t* queryVectorPtr,
+           query_vector_t* queryVectorPtr,
            long index,
            long numVar)
 {
@@ -622,7 +786,7 @@ testCount (adtree_t* adtreePtr,
     long i;
     for (i = 1; i < numVar; i++) {
         query.index = index + i;
-        bool status = vector_pushBack(queryVectorPtr, (void*)&query);
+        bool status = svector_pushBack(queryVectorPtr, &query);
         assert(status);
 
         query.value = 0;
@@ -631,7 +795,7 @@ testCount (adtree_t* adtreePtr,
         query.value = 1;
         testCount(adtreePtr, dataPtr, queryVectorPtr, query.index, numVar);
 
-        vector_popBack(queryVectorPtr);
+        svector_popBack(queryVectorPtr);
     }
 }
 
@@ -640,12 +804,15 @@ static void
 testCounts (adtree_t* adtreePtr, data_t* dataPtr)
 {
     long numVar = dataPtr->numVar;
-    vector_t* queryVectorPtr = vector_alloc(numVar);
+    query_vector_t queryVector;
+    svector_init(&queryVector);
+    bool status = svector_reserve(&queryVector, numVar);
+    assert(status);
     long v;
     for (v = -1; v < numVar; v++) {
-        testCount(adtreePtr, dataPtr, queryVectorPtr, v, dataPtr->numVar);
+        testCount(adtreePtr, dataPtr, &queryVector, v, dataPtr->numVar);
     }
-    Pvector_free(queryVectorPtr);
+    svector_free(&queryVector);
 }
 
 
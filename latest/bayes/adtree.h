@@ -139,7 +139,7 @@ adtree_make (adtree_t* adtreePtr, data_t* dataPtr);
  */
 __attribute__((transaction_safe))
 long
-adtree_getCount (adtree_t* adtreePtr, vector_t* queryVectorPtr);
+adtree_getCount (adtree_t* adtreePtr, query_vector_t* queryVectorPtr);
 
 
 #endif /* ADTREE_H */
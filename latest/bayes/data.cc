@@ -404,6 +404,52 @@ data_findSplit (data_t* dataPtr, long start, long num, long offset)
 }
 
 
+/* =============================================================================
+ * data_partition
+ * -- In place; records with 0 in offset column are moved to the front
+ * -- Unlike data_sort, leaves the order within each half unspecified
+ * -- Returns number of zeros in offset column
+ * =============================================================================
+ */
+long
+data_partition (data_t* dataPtr, long start, long num, long offset)
+{
+    assert(start >= 0 && start <= dataPtr->numRecord);
+    assert(num >= 0 && num <= dataPtr->numRecord);
+    assert(start + num >= 0 && start + num <= dataPtr->numRecord);
+
+    long numVar = dataPtr->numVar;
+    char* records = dataPtr->records;
+
+    long low = start;
+    long high = start + num - 1;
+
+    while (1) {
+        while (low <= high && records[numVar * low + offset] == 0) {
+            low++;
+        }
+        while (low < high && records[numVar * high + offset] != 0) {
+            high--;
+        }
+        if (low >= high) {
+            break;
+        }
+        char* lowRecord = &records[numVar * low];
+        char* highRecord = &records[numVar * high];
+        long v;
+        for (v = 0; v < numVar; v++) {
+            char tmp = lowRecord[v];
+            lowRecord[v] = highRecord[v];
+            highRecord[v] = tmp;
+        }
+        low++;
+        high--;
+    }
+
+    return (low - start);
+}
+
+
 /* #############################################################################
  * TEST_DATA
  * #############################################################################
@@ -475,6 +521,12 @@ testAll (long numVar, long numRecord, long numMaxParent, long percentParent)
         if (s > 0) {
             assert(dataPtr->records[numVar * (s - 1)  + v] == 0);
         }
+        long p = data_partition(dataPtr, 0, numRecord, v);
+        assert(p == s);
+        long r;
+        for (r = 0; r < numRecord; r++) {
+            assert(dataPtr->records[numVar * r + v] == ((r < p) ? 0 : 1));
+        }
     }
 
     memset(dataPtr->records, 0, dataPtr->numVar * dataPtr->numRecord);
@@ -488,6 +540,7 @@ testAll (long numVar, long numRecord, long numMaxParent, long percentParent)
             assert(dataPtr->records[numVar * (s - 1)  + v] == 0);
         }
         assert(s == numRecord);
+        assert(data_partition(dataPtr, 0, numRecord, v) == numRecord);
     }
 
     memset(dataPtr->records, 1, dataPtr->numVar * dataPtr->numRecord);
@@ -501,6 +554,7 @@ testAll (long numVar, long numRecord, long numMaxParent, long percentParent)
             assert(dataPtr->records[numVar * (s - 1)  + v] == 0);
         }
         assert(s == 0);
+        assert(data_partition(dataPtr, 0, numRecord, v) == 0);
     }
 
     data_free(dataPtr);
@@ -530,6 +584,12 @@ testBasic (long numVar, long numRecord, long numMaxParent, long percentParent)
         if (s > 0) {
             assert(dataPtr->records[numVar * (s - 1)  + v] == 0);
         }
+        long p = data_partition(dataPtr, 0, numRecord, v);
+        assert(p == s);
+        long r;
+        for (r = 0; r < numRecord; r++) {
+            assert(dataPtr->records[numVar * r + v] == ((r < p) ? 0 : 1));
+        }
     }
 
     memset(dataPtr->records, 0, dataPtr->numVar * dataPtr->numRecord);
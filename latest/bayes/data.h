@@ -151,6 +151,17 @@ long
 data_findSplit (data_t* dataPtr, long start, long num, long offset);
 
 
+/* =============================================================================
+ * data_partition
+ * -- In place; records with 0 in offset column are moved to the front
+ * -- Unlike data_sort, leaves the order within each half unspecified
+ * -- Returns number of zeros in offset column
+ * =============================================================================
+ */
+long
+data_partition (data_t* dataPtr, long start, long num, long offset);
+
+
 #endif /* DATA_H */
 
 
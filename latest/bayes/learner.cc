@@ -124,13 +124,13 @@
 #include "data.h"
 #include "learner.h"
 #include "list.h"
+#include "multiheap.h"
 #include "net.h"
 #include "operation.h"
 #include "query.h"
 #include "thread.h"
 #include "timer.h"
 #include "utility.h"
-#include "vector.h"
 #include "tm_transition.h"
 
 __attribute__ ((transaction_pure))
@@ -165,15 +165,15 @@ typedef struct findBestTaskArg {
     long toId;
     learner_t* learnerPtr;
     query_t* queries;
-    vector_t* queryVectorPtr;
-    vector_t* parentQueryVectorPtr;
+    query_vector_t* queryVectorPtr;
+    query_vector_t* parentQueryVectorPtr;
     long numTotalParent;
     float basePenalty;
     float baseLogLikelihood;
     bitmap_t* bitmapPtr;
     queue_t* workQueuePtr;
-    vector_t* aQueryVectorPtr;
-    vector_t* bQueryVectorPtr;
+    query_vector_t* aQueryVectorPtr;
+    query_vector_t* bQueryVectorPtr;
 } findBestTaskArg_t;
 
 #ifdef TEST_LEARNER
@@ -209,19 +209,19 @@ void
 TMpopulateParentQueryVector (net_t* netPtr,
                              long id,
                              query_t* queries,
-                             vector_t* parentQueryVectorPtr);
+                             query_vector_t* parentQueryVectorPtr);
 
 __attribute__((transaction_safe))
 void
 TMpopulateQueryVectors (net_t* netPtr,
                         long id,
                         query_t* queries,
-                        vector_t* queryVectorPtr,
-                        vector_t* parentQueryVectorPtr);
+                        query_vector_t* queryVectorPtr,
+                        query_vector_t* parentQueryVectorPtr);
 
 __attribute__((transaction_safe))
 learner_task_t*
-TMpopTask (list_t* taskListPtr);
+TMpopTask (multiheap_t* taskQueuePtr, unsigned long* seedPtr);
 
 /* =============================================================================
  * compareTask
@@ -248,22 +248,129 @@ compareTask (const void* aPtr, const void* bPtr)
 }
 
 
+/* =============================================================================
+ * compareTaskPriority
+ * -- Greatest score has highest priority
+ * -- For multiheap (max-heaps), so simply the reverse of compareTask
+ * =============================================================================
+ */
+__attribute__((transaction_safe)) long
+compareTaskPriority (const void* aPtr, const void* bPtr)
+{
+    return compareTask(bPtr, aPtr);
+}
+
+
 /* =============================================================================
  * compareQuery
  * -- Want smallest ID first
- * -- For vector_sort
+ * -- For svector_sort
  * =============================================================================
  */
-__attribute__((transaction_safe)) int
-compareQuery (const void* aPtr, const void* bPtr)
+__attribute__((transaction_safe)) long
+compareQuery (query_t* const* aPtr, query_t* const* bPtr)
 {
-    query_t* aQueryPtr = (query_t*)(*(void**)aPtr);
-    query_t* bQueryPtr = (query_t*)(*(void**)bPtr);
+    query_t* aQueryPtr = *aPtr;
+    query_t* bQueryPtr = *bPtr;
 
     return (aQueryPtr->index - bQueryPtr->index);
 }
 
 
+/* =============================================================================
+ * Logarithm(s)
+ * =============================================================================
+ */
+
+/*
+ * libm's log() is not transaction_safe, so TM_log() decomposes x = 2^e * m
+ * with m in [sqrt(1/2), sqrt(2)) by poking at the IEEE-754 bits and evaluates
+ * ln(m) = 2 * atanh(s), s = (m - 1) / (m + 1), |s| < 0.1716. Truncating the
+ * odd series after s^21 keeps the result within about 2-3 ulp of libm (under
+ * 5e-16 relative) across the whole positive range.
+ */
+#define TM_LOG_LN2      (0.69314718055994530942)
+#define TM_LOG_SQRT2    (1.41421356237309504880)
+
+__attribute__((transaction_safe))
+double TM_log (double x)
+{
+    assert(x > 0);
+
+    union {
+        double d;
+        unsigned long long u;
+    } bits;
+    bits.d = x;
+
+    long e = (long)((bits.u >> 52) & 0x7ffULL);
+    if (e == 0) {
+        /* Subnormal: scale into the normal range first */
+        bits.d = x * 18014398509481984.0; /* 2^54 */
+        e = (long)((bits.u >> 52) & 0x7ffULL) - 54;
+    }
+    e -= 1023;
+    bits.u = (bits.u & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+
+    double m = bits.d;
+    if (m > TM_LOG_SQRT2) {
+        m *= 0.5;
+        e++;
+    }
+
+    double s = (m - 1.0) / (m + 1.0);
+    double s2 = s * s;
+    double p = 2.0/21.0;
+    p = p * s2 + 2.0/19.0;
+    p = p * s2 + 2.0/17.0;
+    p = p * s2 + 2.0/15.0;
+    p = p * s2 + 2.0/13.0;
+    p = p * s2 + 2.0/11.0;
+    p = p * s2 + 2.0/9.0;
+    p = p * s2 + 2.0/7.0;
+    p = p * s2 + 2.0/5.0;
+    p = p * s2 + 2.0/3.0;
+    p = p * s2 + 2.0;
+
+    return ((double)e * TM_LOG_LN2 + s * p);
+}
+
+__attribute__((transaction_pure)) //TM_PURE logarithm
+double PURE_log (double dat)
+{
+  return (double)log(dat);
+}
+
+
+#ifdef LEARNER_USE_LOG_TABLE
+/*
+ * All arguments to the logarithm in the scoring function are ratios of ADtree
+ * counts in [0, numRecord], so ln(count) is precomputed once (outside of any
+ * transaction, with libm) and ln(a/b) becomes ln(a) - ln(b): two loads.
+ */
+static double* global_logCountTable = NULL;
+
+static void
+logCountTable_alloc (long numRecord)
+{
+    global_logCountTable = (double*)malloc((numRecord + 1) * sizeof(double));
+    assert(global_logCountTable);
+    global_logCountTable[0] = 0.0; /* never looked up */
+    long i;
+    for (i = 1; i <= numRecord; i++) {
+        global_logCountTable[i] = log((double)i);
+    }
+}
+
+static void
+logCountTable_free ()
+{
+    free(global_logCountTable);
+    global_logCountTable = NULL;
+}
+#endif /* LEARNER_USE_LOG_TABLE */
+
+
 /* =============================================================================
  * learner_alloc
  * =============================================================================
@@ -285,9 +392,20 @@ learner_alloc (data_t* dataPtr, adtree_t* adtreePtr)
         learnerPtr->tasks =
             (learner_task_t*)malloc(dataPtr->numVar * sizeof(learner_task_t));
         assert(learnerPtr->tasks);
-        learnerPtr->taskListPtr = list_alloc(&compareTask);
-        assert(learnerPtr->taskListPtr);
+        /*
+         * Two heaps per thread keeps the chance of a collision low; a single
+         * thread gets one heap and hence the exact greedy order.
+         */
+        long numThread = thread_getNumThread();
+        long numHeap = ((numThread > 1) ? (2 * numThread) : (1));
+        learnerPtr->taskQueuePtr = multiheap_alloc(numHeap,
+                                                   dataPtr->numVar,
+                                                   &compareTaskPriority);
+        assert(learnerPtr->taskQueuePtr);
         learnerPtr->numTotalParent = 0;
+#ifdef LEARNER_USE_LOG_TABLE
+        logCountTable_alloc(adtreePtr->numRecord);
+#endif
     }
 
     return learnerPtr;
@@ -301,63 +419,15 @@ learner_alloc (data_t* dataPtr, adtree_t* adtreePtr)
 void
 learner_free (learner_t* learnerPtr)
 {
-    list_free(learnerPtr->taskListPtr);
+#ifdef LEARNER_USE_LOG_TABLE
+    logCountTable_free();
+#endif
+    multiheap_free(learnerPtr->taskQueuePtr);
     free(learnerPtr->tasks);
     free(learnerPtr->localBaseLogLikelihoods);
     net_free(learnerPtr->netPtr);
     free(learnerPtr);
 }
-/* =============================================================================
- * Logarithm(s)
- * =============================================================================
- */
-__attribute__((transaction_safe))
-double my_exp(double x, int y)
-{
-    double ret = 1;
-    int i;
-    for (i = 0; i < y; i++)
-        ret *= x;
-    return ret;
-}
-
-// Taylor series to calculate __attribute__((transaction_safe)) logarithm
-__attribute__((transaction_safe))
-double TM_log (double x)
-{
-  assert (x > 0);
-  double ret = 0.0;
-  int i;
-
-  if (ABS(x - 1) <= 0.000001)
-    return ret;
-  else if (ABS(x) > 1) {
-    double y = x / (x - 1);
-    // more iteration, more precise
-    for (i = 1; i < 20; i++) {
-      ret += 1 / (i * my_exp (y, i));
-    }
-    return ret;
-  }
-  else{
-    double y = x - 1;
-    // more iteration, more precise
-    for (i = 1; i < 20; i++) {
-      if (i % 2 == 1)
-        ret += my_exp (y, i) / i;
-      else
-        ret -= my_exp (y, i) / i;
-    }
-    return ret;
-  }
-}
-
-__attribute__((transaction_pure)) //TM_PURE logarithm
-double PURE_log (double dat)
-{
-  return (double)log(dat);
-}
-
 /* =============================================================================
  * computeSpecificLocalLogLikelihood
  * -- Query vectors should not contain wildcards
@@ -366,8 +436,8 @@ double PURE_log (double dat)
 __attribute__((transaction_safe))
 float
 computeSpecificLocalLogLikelihood (adtree_t* adtreePtr,
-                                   vector_t* queryVectorPtr,
-                                   vector_t* parentQueryVectorPtr)
+                                   query_vector_t* queryVectorPtr,
+                                   query_vector_t* parentQueryVectorPtr)
 {
   //[wer] __attribute__((transaction_safe)) call
   long count = adtree_getCount(adtreePtr, queryVectorPtr);
@@ -382,9 +452,13 @@ computeSpecificLocalLogLikelihood (adtree_t* adtreePtr,
   assert(parentCount > 0);
 
   //[wer210] replaced with __attribute__((transaction_safe)) log()
+#ifdef LEARNER_USE_LOG_TABLE
+  double t = global_logCountTable[count] - global_logCountTable[parentCount];
+#else
   double temp = (double)count/ (double)parentCount;
   //double t = (double)PURE_log(temp);
   double t = (double)TM_log(temp);
+#endif
   return (float)(probability * t);
 }
 
@@ -414,7 +488,7 @@ createPartition (long min, long max, long id, long n,
 
 /* =============================================================================
  * createTaskList
- * -- baseLogLikelihoods and taskListPtr are updated
+ * -- baseLogLikelihoods and taskQueuePtr are updated
  * =============================================================================
  */
 void
@@ -424,7 +498,8 @@ createTaskList (void* argPtr)
     long numThread = thread_getNumThread();
 
     learner_t* learnerPtr = (learner_t*)argPtr;
-    list_t* taskListPtr = learnerPtr->taskListPtr;
+    multiheap_t* taskQueuePtr = learnerPtr->taskQueuePtr;
+    unsigned long seed = (unsigned long)myId + 1;
 
     bool status;
 
@@ -433,14 +508,16 @@ createTaskList (void* argPtr)
     learner_task_t* tasks = learnerPtr->tasks;
 
     query_t queries[2];
-    vector_t* queryVectorPtr = PVECTOR_ALLOC(2);
-    assert(queryVectorPtr);
-    status = vector_pushBack(queryVectorPtr, (void*)&queries[0]);
+    query_vector_t queryVector;
+    svector_init(&queryVector);
+    query_vector_t* queryVectorPtr = &queryVector;
+    status = svector_pushBack(queryVectorPtr, &queries[0]);
     assert(status);
 
     query_t parentQuery;
-    vector_t* parentQueryVectorPtr = PVECTOR_ALLOC(1);
-    assert(parentQueryVectorPtr);
+    query_vector_t parentQueryVector;
+    svector_init(&parentQueryVector);
+    query_vector_t* parentQueryVectorPtr = &parentQueryVector;
 
     long numVar = adtreePtr->numVar;
     long numRecord = adtreePtr->numRecord;
@@ -489,7 +566,7 @@ createTaskList (void* argPtr)
      * For each variable, find if the addition of any edge _to_ it is better
      */
 
-    status = PVECTOR_PUSHBACK(parentQueryVectorPtr, (void*)&parentQuery);
+    status = svector_pushBack(parentQueryVectorPtr, &parentQuery);
     assert(status);
 
     for (v = v_start; v < v_stop; v++) {
@@ -502,7 +579,7 @@ createTaskList (void* argPtr)
         long bestLocalIndex = v;
         float bestLocalLogLikelihood = localBaseLogLikelihoods[v];
 
-        status = PVECTOR_PUSHBACK(queryVectorPtr, (void*)&queries[1]);
+        status = svector_pushBack(queryVectorPtr, &queries[1]);
         assert(status);
 
         long vv;
@@ -561,7 +638,7 @@ createTaskList (void* argPtr)
 
         } /* foreach other variable */
 
-        PVECTOR_POPBACK(queryVectorPtr);
+        svector_popBack(queryVectorPtr);
 
         if (bestLocalIndex != v) {
             float logLikelihood = numRecord * (baseLogLikelihood +
@@ -574,54 +651,33 @@ createTaskList (void* argPtr)
             taskPtr->toId = v;
             taskPtr->score = score;
             __transaction_atomic {
-              status = TMLIST_INSERT(taskListPtr, (void*)taskPtr);
+              status = TMMULTIHEAP_INSERT(taskQueuePtr, (void*)taskPtr, &seed);
             }
             assert(status);
+#ifdef TEST_LEARNER
+            printf("[task] op=%i from=%li to=%li score=%lf\n",
+                   taskPtr->op, taskPtr->fromId, taskPtr->toId, taskPtr->score);
+#endif /* TEST_LEARNER */
         }
 
     } /* for each variable */
 
-    PVECTOR_FREE(queryVectorPtr);
-    PVECTOR_FREE(parentQueryVectorPtr);
-
-#ifdef TEST_LEARNER
-    list_iter_t it;
-    list_iter_reset(&it, taskListPtr);
-    while (list_iter_hasNext(&it)) {
-        learner_task_t* taskPtr = (learner_task_t*)list_iter_next(&it, taskListPtr);
-        printf("[task] op=%i from=%li to=%li score=%lf\n",
-               taskPtr->op, taskPtr->fromId, taskPtr->toId, taskPtr->score);
-    }
-#endif /* TEST_LEARNER */
-
+    svector_free(queryVectorPtr);
+    svector_free(parentQueryVectorPtr);
 }
 
 
 /* =============================================================================
  * TMpopTask
- * -- Returns NULL is list is empty
+ * -- Returns NULL if there are no tasks left
+ * -- Relaxed: returns one of the best tasks, not necessarily the best one
  * =============================================================================
  */
 __attribute__((transaction_safe))
 learner_task_t*
-TMpopTask (list_t* taskListPtr)
+TMpopTask (multiheap_t* taskQueuePtr, unsigned long* seedPtr)
 {
-    learner_task_t* taskPtr = NULL;
-
-    list_iter_t it;
-    //TMLIST_ITER_RESET(&it, taskListPtr);
-    it = &(taskListPtr->head);
-
-    //if (TMLIST_ITER_HASNEXT(&it)) {
-    if (it->nextPtr != NULL) {
-      //taskPtr = (learner_task_t*)TMLIST_ITER_NEXT(&it, taskListPtr);
-      taskPtr = (learner_task_t*)it->nextPtr->dataPtr;
-
-      bool status = TMLIST_REMOVE(taskListPtr, (void*)taskPtr);
-      assert(status);
-    }
-
-    return taskPtr;
+    return (learner_task_t*)TMMULTIHEAP_REMOVE(taskQueuePtr, seedPtr);
 }
 
 
@@ -634,17 +690,16 @@ void
 populateParentQueryVector (net_t* netPtr,
                            long id,
                            query_t* queries,
-                           vector_t* parentQueryVectorPtr)
+                           query_vector_t* parentQueryVectorPtr)
 {
-    vector_clear(parentQueryVectorPtr);
+    svector_clear(parentQueryVectorPtr);
 
     list_t* parentIdListPtr = net_getParentIdListPtr(netPtr, id);
     list_iter_t it;
     list_iter_reset(&it, parentIdListPtr);
     while (list_iter_hasNext(&it)) {
         long parentId = (long)list_iter_next(&it);
-        bool status = vector_pushBack(parentQueryVectorPtr,
-                                        (void*)&queries[parentId]);
+        bool status = svector_pushBack(parentQueryVectorPtr, &queries[parentId]);
         assert(status);
     }
 }
@@ -660,9 +715,9 @@ void
 TMpopulateParentQueryVector (net_t* netPtr,
                              long id,
                              query_t* queries,
-                             vector_t* parentQueryVectorPtr)
+                             query_vector_t* parentQueryVectorPtr)
 {
-  vector_clear(parentQueryVectorPtr);
+  svector_clear(parentQueryVectorPtr);
 
   list_t* parentIdListPtr = net_getParentIdListPtr(netPtr, id); //__attribute__((transaction_safe))
   list_iter_t it;
@@ -675,8 +730,7 @@ TMpopulateParentQueryVector (net_t* netPtr,
     long parentId = (long)it->nextPtr->dataPtr;
     it = it->nextPtr;
 
-    bool status = PVECTOR_PUSHBACK(parentQueryVectorPtr,
-                                     (void*)&queries[parentId]);
+    bool status = svector_pushBack(parentQueryVectorPtr, &queries[parentId]);
     assert(status);
   }
 }
@@ -692,17 +746,17 @@ void
 TMpopulateQueryVectors (net_t* netPtr,
                       long id,
                       query_t* queries,
-                      vector_t* queryVectorPtr,
-                      vector_t* parentQueryVectorPtr)
+                      query_vector_t* queryVectorPtr,
+                      query_vector_t* parentQueryVectorPtr)
 {
     TMpopulateParentQueryVector(netPtr, id, queries, parentQueryVectorPtr);
 
     bool status;
-    status = PVECTOR_COPY(queryVectorPtr, parentQueryVectorPtr);
+    status = svector_copy(queryVectorPtr, parentQueryVectorPtr);
     assert(status);
-    status = PVECTOR_PUSHBACK(queryVectorPtr, (void*)&queries[id]);
+    status = svector_pushBack(queryVectorPtr, &queries[id]);
     assert(status);
-    vector_sort(queryVectorPtr, &compareQuery);
+    svector_sort(queryVectorPtr, &compareQuery);
 }
 
 
@@ -717,8 +771,8 @@ computeLocalLogLikelihoodHelper (long i,
                                  long numParent,
                                  adtree_t* adtreePtr,
                                  query_t* queries,
-                                 vector_t* queryVectorPtr,
-                                 vector_t* parentQueryVectorPtr)
+                                 query_vector_t* queryVectorPtr,
+                                 query_vector_t* parentQueryVectorPtr)
 {
     if (i >= numParent) {
       //[wer] this function contains a log(), which was not __attribute__((transaction_safe))
@@ -729,7 +783,7 @@ computeLocalLogLikelihoodHelper (long i,
 
     float localLogLikelihood = 0.0;
 
-    query_t* parentQueryPtr = (query_t*)vector_at(parentQueryVectorPtr, i);
+    query_t* parentQueryPtr = svector_at(parentQueryVectorPtr, i);
     long parentIndex = parentQueryPtr->index;
 
     queries[parentIndex].value = 0;
@@ -765,10 +819,10 @@ float
 computeLocalLogLikelihood (long id,
                            adtree_t* adtreePtr,
                            query_t* queries,
-                           vector_t* queryVectorPtr,
-                           vector_t* parentQueryVectorPtr)
+                           query_vector_t* queryVectorPtr,
+                           query_vector_t* parentQueryVectorPtr)
 {
-    long numParent = vector_getSize(parentQueryVectorPtr);
+    long numParent = svector_getSize(parentQueryVectorPtr);
     float localLogLikelihood = 0.0;
 
     queries[id].value = 0;
@@ -802,18 +856,18 @@ __attribute__((transaction_safe))
 void
 TMfindBestInsertTask (learner_task_t * dest,  findBestTaskArg_t* argPtr)
 {
-    long       toId                     = argPtr->toId;
-    learner_t* learnerPtr               = argPtr->learnerPtr;
-    query_t*   queries                  = argPtr->queries;
-    vector_t*  queryVectorPtr           = argPtr->queryVectorPtr;
-    vector_t*  parentQueryVectorPtr     = argPtr->parentQueryVectorPtr;
-    long       numTotalParent           = argPtr->numTotalParent;
-    float      basePenalty              = argPtr->basePenalty;
-    float      baseLogLikelihood        = argPtr->baseLogLikelihood;
-    bitmap_t*  invalidBitmapPtr         = argPtr->bitmapPtr;
-    queue_t*   workQueuePtr             = argPtr->workQueuePtr;
-    vector_t*  baseParentQueryVectorPtr = argPtr->aQueryVectorPtr;
-    vector_t*  baseQueryVectorPtr       = argPtr->bQueryVectorPtr;
+    long            toId                     = argPtr->toId;
+    learner_t*      learnerPtr               = argPtr->learnerPtr;
+    query_t*        queries                  = argPtr->queries;
+    query_vector_t* queryVectorPtr           = argPtr->queryVectorPtr;
+    query_vector_t* parentQueryVectorPtr     = argPtr->parentQueryVectorPtr;
+    long            numTotalParent           = argPtr->numTotalParent;
+    float           basePenalty              = argPtr->basePenalty;
+    float           baseLogLikelihood        = argPtr->baseLogLikelihood;
+    bitmap_t*       invalidBitmapPtr         = argPtr->bitmapPtr;
+    queue_t*        workQueuePtr             = argPtr->workQueuePtr;
+    query_vector_t* baseParentQueryVectorPtr = argPtr->aQueryVectorPtr;
+    query_vector_t* baseQueryVectorPtr       = argPtr->bQueryVectorPtr;
 
     bool status;
     adtree_t* adtreePtr               = learnerPtr->adtreePtr;
@@ -827,15 +881,15 @@ TMfindBestInsertTask (learner_task_t * dest,  findBestTaskArg_t* argPtr)
      * Create base query and parentQuery
      */
     //[wer] all __attribute__((transaction_safe))
-    status = PVECTOR_COPY(baseParentQueryVectorPtr, parentQueryVectorPtr);
+    status = svector_copy(baseParentQueryVectorPtr, parentQueryVectorPtr);
     assert(status);
-    status = PVECTOR_COPY(baseQueryVectorPtr, baseParentQueryVectorPtr);
+    status = svector_copy(baseQueryVectorPtr, baseParentQueryVectorPtr);
     assert(status);
-    status = PVECTOR_PUSHBACK(baseQueryVectorPtr, (void*)&queries[toId]);
+    status = svector_pushBack(baseQueryVectorPtr, &queries[toId]);
     assert(status);
 
     //[wer] was TM_PURE due to qsort(), now __attribute__((transaction_safe))
-    vector_sort(queryVectorPtr, &compareQuery);
+    svector_sort(queryVectorPtr, &compareQuery);
 
     /*
      * Search all possible valid operations for better local log likelihood
@@ -876,18 +930,18 @@ TMfindBestInsertTask (learner_task_t * dest,  findBestTaskArg_t* argPtr)
             }
 
             //[wer] __attribute__((transaction_safe))
-            status = PVECTOR_COPY(queryVectorPtr, baseQueryVectorPtr);
+            status = svector_copy(queryVectorPtr, baseQueryVectorPtr);
             assert(status);
-            status = PVECTOR_PUSHBACK(queryVectorPtr, (void*)&queries[fromId]);
+            status = svector_pushBack(queryVectorPtr, &queries[fromId]);
             assert(status);
             //[wer] was TM_PURE due to qsort(), fixed
-            vector_sort(queryVectorPtr, &compareQuery);
+            svector_sort(queryVectorPtr, &compareQuery);
 
-            status = PVECTOR_COPY(parentQueryVectorPtr, baseParentQueryVectorPtr);
+            status = svector_copy(parentQueryVectorPtr, baseParentQueryVectorPtr);
             assert(status);
-            status = PVECTOR_PUSHBACK(parentQueryVectorPtr, (void*)&queries[fromId]);
+            status = svector_pushBack(parentQueryVectorPtr, &queries[fromId]);
             assert(status);
-            vector_sort(parentQueryVectorPtr, &compareQuery);
+            svector_sort(parentQueryVectorPtr, &compareQuery);
 
             //[wer] in computeLocal...(), there's a function log(), which not __attribute__((transaction_safe))
             float newLocalLogLikelihood = computeLocalLogLikelihood(toId,
@@ -940,15 +994,15 @@ __attribute__((transaction_safe))
 void
 TMfindBestRemoveTask (learner_task_t * dest,  findBestTaskArg_t* argPtr)
 {
-    long       toId                     = argPtr->toId;
-    learner_t* learnerPtr               = argPtr->learnerPtr;
-    query_t*   queries                  = argPtr->queries;
-    vector_t*  queryVectorPtr           = argPtr->queryVectorPtr;
-    vector_t*  parentQueryVectorPtr     = argPtr->parentQueryVectorPtr;
-    long       numTotalParent           = argPtr->numTotalParent;
-    float      basePenalty              = argPtr->basePenalty;
-    float      baseLogLikelihood        = argPtr->baseLogLikelihood;
-    vector_t*  origParentQueryVectorPtr = argPtr->aQueryVectorPtr;
+    long            toId                     = argPtr->toId;
+    learner_t*      learnerPtr               = argPtr->learnerPtr;
+    query_t*        queries                  = argPtr->queries;
+    query_vector_t* queryVectorPtr           = argPtr->queryVectorPtr;
+    query_vector_t* parentQueryVectorPtr     = argPtr->parentQueryVectorPtr;
+    long            numTotalParent           = argPtr->numTotalParent;
+    float           basePenalty              = argPtr->basePenalty;
+    float           baseLogLikelihood        = argPtr->baseLogLikelihood;
+    query_vector_t* origParentQueryVectorPtr = argPtr->aQueryVectorPtr;
 
     bool status;
     adtree_t* adtreePtr = learnerPtr->adtreePtr;
@@ -956,7 +1010,7 @@ TMfindBestRemoveTask (learner_task_t * dest,  findBestTaskArg_t* argPtr)
     float* localBaseLogLikelihoods = learnerPtr->localBaseLogLikelihoods;
 
     TMpopulateParentQueryVector(netPtr, toId, queries, origParentQueryVectorPtr);
-    long numParent = PVECTOR_GETSIZE(origParentQueryVectorPtr);
+    long numParent = svector_getSize(origParentQueryVectorPtr);
 
     /*
      * Search all possible valid operations for better local log likelihood
@@ -969,21 +1023,20 @@ TMfindBestRemoveTask (learner_task_t * dest,  findBestTaskArg_t* argPtr)
     long i;
     for (i = 0; i < numParent; i++) {
 
-        query_t* queryPtr = (query_t*)PVECTOR_AT(origParentQueryVectorPtr, i);
+        query_t* queryPtr = svector_at(origParentQueryVectorPtr, i);
         long fromId = queryPtr->index;
 
         /*
          * Create parent query (subset of parents since remove an edge)
          */
 
-        PVECTOR_CLEAR(parentQueryVectorPtr);
+        svector_clear(parentQueryVectorPtr);
 
         long p;
         for (p = 0; p < numParent; p++) {
             if (p != fromId) {
-                query_t* queryPtr = (query_t*)PVECTOR_AT(origParentQueryVectorPtr, p);
-                status = PVECTOR_PUSHBACK(parentQueryVectorPtr,
-                                          (void*)&queries[queryPtr->index]);
+                query_t* queryPtr = svector_at(origParentQueryVectorPtr, p);
+                status = svector_pushBack(parentQueryVectorPtr, &queries[queryPtr->index]);
                 assert(status);
             }
         } /* create new parent query */
@@ -992,11 +1045,11 @@ TMfindBestRemoveTask (learner_task_t * dest,  findBestTaskArg_t* argPtr)
          * Create query
          */
 
-        status = PVECTOR_COPY(queryVectorPtr, parentQueryVectorPtr);
+        status = svector_copy(queryVectorPtr, parentQueryVectorPtr);
         assert(status);
-        status = PVECTOR_PUSHBACK(queryVectorPtr, (void*)&queries[toId]);
+        status = svector_pushBack(queryVectorPtr, &queries[toId]);
         assert(status);
-        vector_sort(queryVectorPtr, &compareQuery);
+        svector_sort(queryVectorPtr, &compareQuery);
 
         /*
          * See if removing parent is better
@@ -1054,18 +1107,18 @@ __attribute__((transaction_safe))
 void
 TMfindBestReverseTask (learner_task_t * dest,  findBestTaskArg_t* argPtr)
 {
-    long       toId                         = argPtr->toId;
-    learner_t* learnerPtr                   = argPtr->learnerPtr;
-    query_t*   queries                      = argPtr->queries;
-    vector_t*  queryVectorPtr               = argPtr->queryVectorPtr;
-    vector_t*  parentQueryVectorPtr         = argPtr->parentQueryVectorPtr;
-    long       numTotalParent               = argPtr->numTotalParent;
-    float      basePenalty                  = argPtr->basePenalty;
-    float      baseLogLikelihood            = argPtr->baseLogLikelihood;
-    bitmap_t*  visitedBitmapPtr             = argPtr->bitmapPtr;
-    queue_t*   workQueuePtr                 = argPtr->workQueuePtr;
-    vector_t*  toOrigParentQueryVectorPtr   = argPtr->aQueryVectorPtr;
-    vector_t*  fromOrigParentQueryVectorPtr = argPtr->bQueryVectorPtr;
+    long            toId                         = argPtr->toId;
+    learner_t*      learnerPtr                   = argPtr->learnerPtr;
+    query_t*        queries                      = argPtr->queries;
+    query_vector_t* queryVectorPtr               = argPtr->queryVectorPtr;
+    query_vector_t* parentQueryVectorPtr         = argPtr->parentQueryVectorPtr;
+    long            numTotalParent               = argPtr->numTotalParent;
+    float           basePenalty                  = argPtr->basePenalty;
+    float           baseLogLikelihood            = argPtr->baseLogLikelihood;
+    bitmap_t*       visitedBitmapPtr             = argPtr->bitmapPtr;
+    queue_t*        workQueuePtr                 = argPtr->workQueuePtr;
+    query_vector_t* toOrigParentQueryVectorPtr   = argPtr->aQueryVectorPtr;
+    query_vector_t* fromOrigParentQueryVectorPtr = argPtr->bQueryVectorPtr;
 
     bool    status;
     adtree_t* adtreePtr               = learnerPtr->adtreePtr;
@@ -1073,7 +1126,7 @@ TMfindBestReverseTask (learner_task_t * dest,  findBestTaskArg_t* argPtr)
     float*    localBaseLogLikelihoods = learnerPtr->localBaseLogLikelihoods;
 
     TMpopulateParentQueryVector(netPtr, toId, queries, toOrigParentQueryVectorPtr);
-    long numParent = PVECTOR_GETSIZE(toOrigParentQueryVectorPtr);//__attribute__((transaction_safe))
+    long numParent = svector_getSize(toOrigParentQueryVectorPtr);//__attribute__((transaction_safe))
 
     /*
      * Search all possible valid operations for better local log likelihood
@@ -1086,7 +1139,7 @@ TMfindBestReverseTask (learner_task_t * dest,  findBestTaskArg_t* argPtr)
 
     long i;
     for (i = 0; i < numParent; i++) {
-      query_t* queryPtr = (query_t*)PVECTOR_AT(toOrigParentQueryVectorPtr, i);
+      query_t* queryPtr = svector_at(toOrigParentQueryVectorPtr, i);
       fromId = queryPtr->index;
 
       bestLocalLogLikelihood = oldLocalLogLikelihood +
@@ -1102,14 +1155,13 @@ TMfindBestReverseTask (learner_task_t * dest,  findBestTaskArg_t* argPtr)
        * Create parent query (subset of parents since remove an edge)
        */
 
-      PVECTOR_CLEAR(parentQueryVectorPtr);
+      svector_clear(parentQueryVectorPtr);
 
       long p;
       for (p = 0; p < numParent; p++) {
         if (p != fromId) {
-          query_t* queryPtr = (query_t*)PVECTOR_AT(toOrigParentQueryVectorPtr, p);
-          status = PVECTOR_PUSHBACK(parentQueryVectorPtr,
-                                    (void*)&queries[queryPtr->index]);
+          query_t* queryPtr = svector_at(toOrigParentQueryVectorPtr, p);
+          status = svector_pushBack(parentQueryVectorPtr, &queries[queryPtr->index]);
           assert(status);
         }
       } /* create new parent query */
@@ -1118,13 +1170,13 @@ TMfindBestReverseTask (learner_task_t * dest,  findBestTaskArg_t* argPtr)
          * Create query
          */
 
-      status = PVECTOR_COPY(queryVectorPtr, parentQueryVectorPtr);
+      status = svector_copy(queryVectorPtr, parentQueryVectorPtr);
       assert(status);
-      status = PVECTOR_PUSHBACK(queryVectorPtr, (void*)&queries[toId]);
+      status = svector_pushBack(queryVectorPtr, &queries[toId]);
       assert(status);
 
       //[wer]__attribute__((transaction_safe))
-      vector_sort(queryVectorPtr, &compareQuery);
+      svector_sort(queryVectorPtr, &compareQuery);
 
       /*
        * Get log likelihood for removing parent from toId
@@ -1141,17 +1193,17 @@ TMfindBestReverseTask (learner_task_t * dest,  findBestTaskArg_t* argPtr)
        * Get log likelihood for adding parent to fromId
        */
 
-      status = PVECTOR_COPY(parentQueryVectorPtr, fromOrigParentQueryVectorPtr);
+      status = svector_copy(parentQueryVectorPtr, fromOrigParentQueryVectorPtr);
       assert(status);
-      status = PVECTOR_PUSHBACK(parentQueryVectorPtr, (void*)&queries[toId]);
+      status = svector_pushBack(parentQueryVectorPtr, &queries[toId]);
       assert(status);
-      vector_sort(parentQueryVectorPtr, &compareQuery);
+      svector_sort(parentQueryVectorPtr, &compareQuery);
 
-      status = PVECTOR_COPY(queryVectorPtr, parentQueryVectorPtr);
+      status = svector_copy(queryVectorPtr, parentQueryVectorPtr);
       assert(status);
-      status = PVECTOR_PUSHBACK(queryVectorPtr, (void*)&queries[fromId]);
+      status = svector_pushBack(queryVectorPtr, &queries[fromId]);
       assert(status);
-      vector_sort(queryVectorPtr, &compareQuery);
+      svector_sort(queryVectorPtr, &compareQuery);
 
       newLocalLogLikelihood += computeLocalLogLikelihood(fromId,
                                                          adtreePtr,
@@ -1228,7 +1280,8 @@ learnStructure (void* argPtr)
     adtree_t* adtreePtr = learnerPtr->adtreePtr;
     long numRecord = adtreePtr->numRecord;
     float* localBaseLogLikelihoods = learnerPtr->localBaseLogLikelihoods;
-    list_t* taskListPtr = learnerPtr->taskListPtr;
+    multiheap_t* taskQueuePtr = learnerPtr->taskQueuePtr;
+    unsigned long seed = (unsigned long)thread_getId() + 1;
 
     float operationQualityFactor = global_operationQualityFactor;
 
@@ -1248,14 +1301,18 @@ learnStructure (void* argPtr)
 
     float basePenalty = (float)(-0.5 * log((double)numRecord));
 
-    vector_t* queryVectorPtr = PVECTOR_ALLOC(1);
-    assert(queryVectorPtr);
-    vector_t* parentQueryVectorPtr = PVECTOR_ALLOC(1);
-    assert(parentQueryVectorPtr);
-    vector_t* aQueryVectorPtr = PVECTOR_ALLOC(1);
-    assert(aQueryVectorPtr);
-    vector_t* bQueryVectorPtr = PVECTOR_ALLOC(1);
-    assert(bQueryVectorPtr);
+    query_vector_t queryVector;
+    svector_init(&queryVector);
+    query_vector_t* queryVectorPtr = &queryVector;
+    query_vector_t parentQueryVector;
+    svector_init(&parentQueryVector);
+    query_vector_t* parentQueryVectorPtr = &parentQueryVector;
+    query_vector_t aQueryVector;
+    svector_init(&aQueryVector);
+    query_vector_t* aQueryVectorPtr = &aQueryVector;
+    query_vector_t bQueryVector;
+    svector_init(&bQueryVector);
+    query_vector_t* bQueryVectorPtr = &bQueryVector;
 
     findBestTaskArg_t arg;
     arg.learnerPtr           = learnerPtr;
@@ -1272,7 +1329,7 @@ learnStructure (void* argPtr)
 
         learner_task_t* taskPtr;
         __transaction_atomic {
-          taskPtr = TMpopTask(  taskListPtr);
+          taskPtr = TMpopTask(taskQueuePtr, &seed);
         }
 
         if (taskPtr == NULL) {
@@ -1523,7 +1580,7 @@ learnStructure (void* argPtr)
             learner_task_t* tasks = learnerPtr->tasks;
             tasks[toId] = bestTask;
             __transaction_atomic {
-              TMLIST_INSERT(taskListPtr, (void*)&tasks[toId]);
+              TMMULTIHEAP_INSERT(taskQueuePtr, (void*)&tasks[toId], &seed);
             }
 
 #ifdef TEST_LEARNER
@@ -1537,10 +1594,10 @@ learnStructure (void* argPtr)
 
     TMBITMAP_FREE(visitedBitmapPtr);
     TMQUEUE_FREE(workQueuePtr);
-    PVECTOR_FREE(bQueryVectorPtr);
-    PVECTOR_FREE(aQueryVectorPtr);
-    PVECTOR_FREE(queryVectorPtr);
-    PVECTOR_FREE(parentQueryVectorPtr);
+    svector_free(bQueryVectorPtr);
+    svector_free(aQueryVectorPtr);
+    svector_free(queryVectorPtr);
+    svector_free(parentQueryVectorPtr);
     free(queries);
 }
 
@@ -1580,10 +1637,12 @@ learner_score (learner_t* learnerPtr)
     adtree_t* adtreePtr = learnerPtr->adtreePtr;
     net_t* netPtr = learnerPtr->netPtr;
 
-    vector_t* queryVectorPtr = vector_alloc(1);
-    assert(queryVectorPtr);
-    vector_t* parentQueryVectorPtr = vector_alloc(1);
-    assert(parentQueryVectorPtr);
+    query_vector_t queryVector;
+    svector_init(&queryVector);
+    query_vector_t* queryVectorPtr = &queryVector;
+    query_vector_t parentQueryVector;
+    svector_init(&parentQueryVector);
+    query_vector_t* parentQueryVectorPtr = &parentQueryVector;
 
     long numVar = adtreePtr->numVar;
     query_t* queries = (query_t*)malloc(numVar * sizeof(query_t));
@@ -1616,8 +1675,8 @@ learner_score (learner_t* learnerPtr)
         logLikelihood += localLogLikelihood;
     }
 
-    vector_free(queryVectorPtr);
-    vector_free(parentQueryVectorPtr);
+    svector_free(queryVectorPtr);
+    svector_free(parentQueryVectorPtr);
     free(queries);
 
     long numRecord = adtreePtr->numRecord;
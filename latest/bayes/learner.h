@@ -75,6 +75,7 @@
 
 #include "adtree.h"
 #include "data.h"
+#include "multiheap.h"
 #include "net.h"
 #include "query.h"
 
@@ -92,8 +93,8 @@ typedef struct learner {
     char pad2[CACHE_LINE_SIZE - sizeof(float)];
     learner_task_t* tasks;
     char pad3[CACHE_LINE_SIZE - sizeof(learner_task_t*)];
-    list_t* taskListPtr;
-    char pad4[CACHE_LINE_SIZE - sizeof(list_t*)];
+    multiheap_t* taskQueuePtr;
+    char pad4[CACHE_LINE_SIZE - sizeof(multiheap_t*)];
     long numTotalParent;
     char pad5[CACHE_LINE_SIZE - sizeof(long)];
 } learner_t;
@@ -91,8 +91,25 @@ struct net_node_t {
     net_node_mark_t mark;
 };
 
+/*
+ * Networks of up to NET_DENSE_MAX_NODE nodes also keep dense adjacency and
+ * reachability bitsets (one word per node), maintained incrementally on edge
+ * insertion and removal. Cycle checks then read a single word instead of
+ * running a BFS over the parent/child lists inside the transaction.
+ */
+#define NET_DENSE_MAX_NODE  ((long)(sizeof(unsigned long) * 8))
+#define NET_BIT(i)          (1UL << (i))
+
+struct net_bits_t {
+    unsigned long child;      /* bit j set if edge i -> j */
+    unsigned long descendant; /* transitive closure of child */
+    unsigned long ancestor;   /* transpose of descendant */
+};
+
 struct net_t {
     vector_t* nodeVectorPtr;
+    long numNode;
+    net_bits_t* bits; /* NULL if numNode > NET_DENSE_MAX_NODE */
 };
 
 /* =============================================================================
@@ -201,6 +218,12 @@ net_alloc (long numNode)
             assert(status);
         }
         netPtr->nodeVectorPtr = nodeVectorPtr;
+        netPtr->numNode = numNode;
+        netPtr->bits = NULL;
+        if (numNode <= NET_DENSE_MAX_NODE) {
+            netPtr->bits = (net_bits_t*)calloc(numNode, sizeof(net_bits_t));
+            assert(netPtr->bits);
+        }
     }
 
     return netPtr;
@@ -222,9 +245,99 @@ net_free (net_t* netPtr)
         freeNode(nodePtr);
     }
     vector_free(netPtr->nodeVectorPtr);
+    free(netPtr->bits);
     free(netPtr);
 }
 
+
+/* =============================================================================
+ * TMinsertEdgeBits
+ * -- Everything reaching fromId (and fromId) now reaches toId and below
+ * =============================================================================
+ */
+__attribute__((transaction_safe))
+static void
+TMinsertEdgeBits (net_bits_t* bits, long fromId, long toId)
+{
+    unsigned long newDescendants = NET_BIT(toId) | bits[toId].descendant;
+    unsigned long newAncestors = NET_BIT(fromId) | bits[fromId].ancestor;
+
+    bits[fromId].child |= NET_BIT(toId);
+
+    unsigned long w = newAncestors;
+    while (w) {
+        long a = __builtin_ctzl(w);
+        w &= (w - 1);
+        bits[a].descendant |= newDescendants;
+    }
+    w = newDescendants;
+    while (w) {
+        long d = __builtin_ctzl(w);
+        w &= (w - 1);
+        bits[d].ancestor |= newAncestors;
+    }
+}
+
+
+/* =============================================================================
+ * TMremoveEdgeBits
+ * -- Only fromId and its ancestors can lose descendants, and only toId and its
+ *    old descendants can lose ancestors; recompute just those rows
+ * =============================================================================
+ */
+__attribute__((transaction_safe))
+static void
+TMremoveEdgeBits (net_bits_t* bits, long fromId, long toId)
+{
+    unsigned long affected = NET_BIT(fromId) | bits[fromId].ancestor;
+    unsigned long candidates = NET_BIT(toId) | bits[toId].descendant;
+
+    bits[fromId].child &= ~NET_BIT(toId);
+
+    /* Least fixpoint from below, so also correct if the net has a cycle */
+    unsigned long w = affected;
+    while (w) {
+        long a = __builtin_ctzl(w);
+        w &= (w - 1);
+        bits[a].descendant = bits[a].child;
+    }
+    bool isChanged = true;
+    while (isChanged) {
+        isChanged = false;
+        w = affected;
+        while (w) {
+            long a = __builtin_ctzl(w);
+            w &= (w - 1);
+            unsigned long descendants = bits[a].child;
+            unsigned long c = descendants;
+            while (c) {
+                descendants |= bits[__builtin_ctzl(c)].descendant;
+                c &= (c - 1);
+            }
+            if (descendants != bits[a].descendant) {
+                bits[a].descendant = descendants;
+                isChanged = true;
+            }
+        }
+    }
+
+    w = candidates;
+    while (w) {
+        long d = __builtin_ctzl(w);
+        w &= (w - 1);
+        unsigned long ancestors = bits[d].ancestor & ~affected;
+        unsigned long a = affected;
+        while (a) {
+            long i = __builtin_ctzl(a);
+            a &= (a - 1);
+            if (bits[i].descendant & NET_BIT(d)) {
+                ancestors |= NET_BIT(i);
+            }
+        }
+        bits[d].ancestor = ancestors;
+    }
+}
+
 /* =============================================================================
  * TMinsertEdge
  * =============================================================================
@@ -245,6 +358,11 @@ TMinsertEdge (  net_t* netPtr, long fromId, long toId)
     list_t* childIdListPtr = parentNodePtr->childIdListPtr;
     status = TMLIST_INSERT(childIdListPtr, (void*)toId);
     assert(status);
+
+    net_bits_t* bits = netPtr->bits;
+    if (bits != NULL) {
+        TMinsertEdgeBits(bits, fromId, toId);
+    }
 }
 
 
@@ -268,6 +386,11 @@ TMremoveEdge (  net_t* netPtr, long fromId, long toId)
     list_t* childIdListPtr = parentNodePtr->childIdListPtr;
     status = TMLIST_REMOVE(childIdListPtr, (void*)toId);
     assert(status);
+
+    net_bits_t* bits = netPtr->bits;
+    if (bits != NULL) {
+        TMremoveEdgeBits(bits, fromId, toId);
+    }
 }
 
 /* =============================================================================
@@ -308,6 +431,11 @@ __attribute__((transaction_safe))
 bool
 TMnet_hasEdge (  net_t* netPtr, long fromId, long toId)
 {
+    net_bits_t* bits = netPtr->bits;
+    if (bits != NULL) {
+        return ((bits[fromId].child & NET_BIT(toId)) ? true : false);
+    }
+
     vector_t* nodeVectorPtr = netPtr->nodeVectorPtr;
     net_node_t* childNodePtr = (net_node_t*)vector_at(nodeVectorPtr, toId);
     list_t* parentIdListPtr = childNodePtr->parentIdListPtr;
@@ -343,6 +471,12 @@ TMnet_isPath (net_t* netPtr,
 {
     bool status;
 
+    net_bits_t* bits = netPtr->bits;
+    if (bits != NULL) {
+        return ((fromId == toId) ||
+                ((bits[fromId].descendant & NET_BIT(toId)) ? true : false));
+    }
+
     vector_t* nodeVectorPtr = netPtr->nodeVectorPtr;
     assert(visitedBitmapPtr->numBit == vector_getSize(nodeVectorPtr));
     //TM_SAFE
@@ -512,6 +646,13 @@ TMnet_findAncestors (
     vector_t* nodeVectorPtr = netPtr->nodeVectorPtr;
     assert(ancestorBitmapPtr->numBit == vector_getSize(nodeVectorPtr));
 
+    net_bits_t* bits = netPtr->bits;
+    if (bits != NULL) {
+        unsigned long ancestors = bits[id].ancestor;
+        ancestorBitmapPtr->bits[0] = ancestors;
+        return ((ancestors & NET_BIT(id)) ? false : true);
+    }
+
     TMBITMAP_CLEARALL(ancestorBitmapPtr);
     TMQUEUE_CLEAR(workQueuePtr);
 
@@ -584,6 +725,13 @@ TMnet_findDescendants (net_t* netPtr,
     vector_t* nodeVectorPtr = netPtr->nodeVectorPtr;
     assert(descendantBitmapPtr->numBit == vector_getSize(nodeVectorPtr));
 
+    net_bits_t* bits = netPtr->bits;
+    if (bits != NULL) {
+        unsigned long descendants = bits[id].descendant;
+        descendantBitmapPtr->bits[0] = descendants;
+        return ((descendants & NET_BIT(id)) ? false : true);
+    }
+
     TMBITMAP_CLEARALL(descendantBitmapPtr);
     TMQUEUE_CLEAR(workQueuePtr);
 
@@ -685,13 +833,9 @@ net_generateRandomEdges (net_t* netPtr,
 #include <stdio.h>
 
 
-int
-main ()
+static void
+testNet (long numNode)
 {
-    long numNode = 100;
-
-    puts("Starting tests...");
-
     bool status;
 
     net_t* netPtr = net_alloc(numNode);
@@ -706,7 +850,7 @@ main ()
     long aId = 31;
     long bId = 14;
     long cId = 5;
-    long dId = 92;
+    long dId = numNode - 8;
 
     TMnet_applyOperation(netPtr, OPERATION_INSERT, aId, bId);
     assert(TMnet_isPath(netPtr, aId, bId, visitedBitmapPtr, workQueuePtr));
@@ -751,6 +895,20 @@ main ()
     bitmap_free(ancestorBitmapPtr);
     bitmap_free(descendantBitmapPtr);
     net_free(netPtr);
+}
+
+
+int
+main ()
+{
+    long numNode = 100;
+
+    puts("Starting tests...");
+
+    testNet(numNode);                   /* list-based BFS */
+    testNet(NET_DENSE_MAX_NODE);        /* dense bitsets */
+
+    net_t* netPtr;
 
     random_t* randomPtr = random_alloc();
     assert(randomPtr);
@@ -72,6 +72,7 @@
 #ifndef QUERY_H
 #define QUERY_H 1
 
+#include "svector.h"
 
 #define QUERY_VALUE_WILDCARD (-1L)
 
@@ -80,6 +81,14 @@ typedef struct query {
     long value;
 } query_t;
 
+/*
+ * Query vectors hold a variable and its parents, so they stay short; the
+ * inline buffer covers them without going to the allocator.
+ */
+#define QUERY_VECTOR_INLINE (16)
+
+typedef svector_t<query_t*, QUERY_VECTOR_INLINE> query_vector_t;
+
 
 #endif /* QUERY_H */
 
@@ -101,6 +101,12 @@ gene_alloc (long length)
     genePtr->contents[length] = '\0';
     genePtr->length = length;
 
+    genePtr->packed =
+        (unsigned long*)malloc(nucleotide_numWord(length) * sizeof(unsigned long));
+    if (genePtr->packed == NULL) {
+        return NULL;
+    }
+
     genePtr->startBitmapPtr = bitmap_alloc(length);
     if (genePtr->startBitmapPtr == NULL) {
         return NULL;
@@ -138,6 +144,8 @@ gene_create (gene_t* genePtr, std::mt19937* randomPtr)
         contents[i] =
             nucleotides[(randomPtr->operator()()% NUCLEOTIDE_NUM_TYPE)];
     }
+
+    nucleotide_pack(genePtr->packed, contents, length);
 }
 
 
@@ -149,6 +157,7 @@ void
 gene_free (gene_t* genePtr)
 {
   bitmap_free(genePtr->startBitmapPtr);
+  free(genePtr->packed);
   free(genePtr->contents);
   free(genePtr);
 }
@@ -78,6 +78,7 @@
 struct gene_t {
     long length;
     char* contents;
+    unsigned long* packed;    /* contents, 2 bits per base (nucleotide.h) */
     bitmap_t* startBitmapPtr; /* used for creating segments */
 };
 
@@ -0,0 +1,170 @@
+/* =============================================================================
+ *
+ * nucleotide.c
+ * -- Tables for packed sequences
+ *
+ * =============================================================================
+ *
+ * Copyright (C) Stanford University, 2006.  All Rights Reserved.
+ * Author: Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+
+#include "nucleotide.h"
+
+const unsigned long global_nucleotideSdbm4[256] = {
+    0x0061480fd13a1080UL, 0x0063498a2e47b1feUL, 0x00674c7ee862f4faUL,
+    0x0074561a453b8eadUL, 0x00614811d2362f82UL, 0x0063498c2f43d100UL,
+    0x00674c80e95f13fcUL, 0x0074561c4637adafUL, 0x00614815d42e6d86UL,
+    0x00634990313c0f04UL, 0x00674c84eb575200UL, 0x00745620482febb3UL,
+    0x00614822da953713UL, 0x0063499d37a2d891UL, 0x00674c91f1be1b8dUL,
+    0x0074562d4e96b540UL, 0x0061480fd13c10feUL, 0x0063498a2e49b27cUL,
+    0x00674c7ee864f578UL, 0x0074561a453d8f2bUL, 0x00614811d2383000UL,
+    0x0063498c2f45d17eUL, 0x00674c80e961147aUL, 0x0074561c4639ae2dUL,
+    0x00614815d4306e04UL, 0x00634990313e0f82UL, 0x00674c84eb59527eUL,
+    0x007456204831ec31UL, 0x00614822da973791UL, 0x0063499d37a4d90fUL,
+    0x00674c91f1c01c0bUL, 0x0074562d4e98b5beUL, 0x0061480fd14011faUL,
+    0x0063498a2e4db378UL, 0x00674c7ee868f674UL, 0x0074561a45419027UL,
+    0x00614811d23c30fcUL, 0x0063498c2f49d27aUL, 0x00674c80e9651576UL,
+    0x0074561c463daf29UL, 0x00614815d4346f00UL, 0x006349903142107eUL,
+    0x00674c84eb5d537aUL, 0x007456204835ed2dUL, 0x00614822da9b388dUL,
+    0x0063499d37a8da0bUL, 0x00674c91f1c41d07UL, 0x0074562d4e9cb6baUL,
+    0x0061480fd14d152dUL, 0x0063498a2e5ab6abUL, 0x00674c7ee875f9a7UL,
+    0x0074561a454e935aUL, 0x00614811d249342fUL, 0x0063498c2f56d5adUL,
+    0x00674c80e97218a9UL, 0x0074561c464ab25cUL, 0x00614815d4417233UL,
+    0x00634990314f13b1UL, 0x00674c84eb6a56adUL, 0x007456204842f060UL,
+    0x00614822daa83bc0UL, 0x0063499d37b5dd3eUL, 0x00674c91f1d1203aUL,
+    0x0074562d4ea9b9edUL, 0x0061480fd13a1082UL, 0x0063498a2e47b200UL,
+    0x00674c7ee862f4fcUL, 0x0074561a453b8eafUL, 0x00614811d2362f84UL,
+    0x0063498c2f43d102UL, 0x00674c80e95f13feUL, 0x0074561c4637adb1UL,
+    0x00614815d42e6d88UL, 0x00634990313c0f06UL, 0x00674c84eb575202UL,
+    0x00745620482febb5UL, 0x00614822da953715UL, 0x0063499d37a2d893UL,
+    0x00674c91f1be1b8fUL, 0x0074562d4e96b542UL, 0x0061480fd13c1100UL,
+    0x0063498a2e49b27eUL, 0x00674c7ee864f57aUL, 0x0074561a453d8f2dUL,
+    0x00614811d2383002UL, 0x0063498c2f45d180UL, 0x00674c80e961147cUL,
+    0x0074561c4639ae2fUL, 0x00614815d4306e06UL, 0x00634990313e0f84UL,
+    0x00674c84eb595280UL, 0x007456204831ec33UL, 0x00614822da973793UL,
+    0x0063499d37a4d911UL, 0x00674c91f1c01c0dUL, 0x0074562d4e98b5c0UL,
+    0x0061480fd14011fcUL, 0x0063498a2e4db37aUL, 0x00674c7ee868f676UL,
+    0x0074561a45419029UL, 0x00614811d23c30feUL, 0x0063498c2f49d27cUL,
+    0x00674c80e9651578UL, 0x0074561c463daf2bUL, 0x00614815d4346f02UL,
+    0x0063499031421080UL, 0x00674c84eb5d537cUL, 0x007456204835ed2fUL,
+    0x00614822da9b388fUL, 0x0063499d37a8da0dUL, 0x00674c91f1c41d09UL,
+    0x0074562d4e9cb6bcUL, 0x0061480fd14d152fUL, 0x0063498a2e5ab6adUL,
+    0x00674c7ee875f9a9UL, 0x0074561a454e935cUL, 0x00614811d2493431UL,
+    0x0063498c2f56d5afUL, 0x00674c80e97218abUL, 0x0074561c464ab25eUL,
+    0x00614815d4417235UL, 0x00634990314f13b3UL, 0x00674c84eb6a56afUL,
+    0x007456204842f062UL, 0x00614822daa83bc2UL, 0x0063499d37b5dd40UL,
+    0x00674c91f1d1203cUL, 0x0074562d4ea9b9efUL, 0x0061480fd13a1086UL,
+    0x0063498a2e47b204UL, 0x00674c7ee862f500UL, 0x0074561a453b8eb3UL,
+    0x00614811d2362f88UL, 0x0063498c2f43d106UL, 0x00674c80e95f1402UL,
+    0x0074561c4637adb5UL, 0x00614815d42e6d8cUL, 0x00634990313c0f0aUL,
+    0x00674c84eb575206UL, 0x00745620482febb9UL, 0x00614822da953719UL,
+    0x0063499d37a2d897UL, 0x00674c91f1be1b93UL, 0x0074562d4e96b546UL,
+    0x0061480fd13c1104UL, 0x0063498a2e49b282UL, 0x00674c7ee864f57eUL,
+    0x0074561a453d8f31UL, 0x00614811d2383006UL, 0x0063498c2f45d184UL,
+    0x00674c80e9611480UL, 0x0074561c4639ae33UL, 0x00614815d4306e0aUL,
+    0x00634990313e0f88UL, 0x00674c84eb595284UL, 0x007456204831ec37UL,
+    0x00614822da973797UL, 0x0063499d37a4d915UL, 0x00674c91f1c01c11UL,
+    0x0074562d4e98b5c4UL, 0x0061480fd1401200UL, 0x0063498a2e4db37eUL,
+    0x00674c7ee868f67aUL, 0x0074561a4541902dUL, 0x00614811d23c3102UL,
+    0x0063498c2f49d280UL, 0x00674c80e965157cUL, 0x0074561c463daf2fUL,
+    0x00614815d4346f06UL, 0x0063499031421084UL, 0x00674c84eb5d5380UL,
+    0x007456204835ed33UL, 0x00614822da9b3893UL, 0x0063499d37a8da11UL,
+    0x00674c91f1c41d0dUL, 0x0074562d4e9cb6c0UL, 0x0061480fd14d1533UL,
+    0x0063498a2e5ab6b1UL, 0x00674c7ee875f9adUL, 0x0074561a454e9360UL,
+    0x00614811d2493435UL, 0x0063498c2f56d5b3UL, 0x00674c80e97218afUL,
+    0x0074561c464ab262UL, 0x00614815d4417239UL, 0x00634990314f13b7UL,
+    0x00674c84eb6a56b3UL, 0x007456204842f066UL, 0x00614822daa83bc6UL,
+    0x0063499d37b5dd44UL, 0x00674c91f1d12040UL, 0x0074562d4ea9b9f3UL,
+    0x0061480fd13a1093UL, 0x0063498a2e47b211UL, 0x00674c7ee862f50dUL,
+    0x0074561a453b8ec0UL, 0x00614811d2362f95UL, 0x0063498c2f43d113UL,
+    0x00674c80e95f140fUL, 0x0074561c4637adc2UL, 0x00614815d42e6d99UL,
+    0x00634990313c0f17UL, 0x00674c84eb575213UL, 0x00745620482febc6UL,
+    0x00614822da953726UL, 0x0063499d37a2d8a4UL, 0x00674c91f1be1ba0UL,
+    0x0074562d4e96b553UL, 0x0061480fd13c1111UL, 0x0063498a2e49b28fUL,
+    0x00674c7ee864f58bUL, 0x0074561a453d8f3eUL, 0x00614811d2383013UL,
+    0x0063498c2f45d191UL, 0x00674c80e961148dUL, 0x0074561c4639ae40UL,
+    0x00614815d4306e17UL, 0x00634990313e0f95UL, 0x00674c84eb595291UL,
+    0x007456204831ec44UL, 0x00614822da9737a4UL, 0x0063499d37a4d922UL,
+    0x00674c91f1c01c1eUL, 0x0074562d4e98b5d1UL, 0x0061480fd140120dUL,
+    0x0063498a2e4db38bUL, 0x00674c7ee868f687UL, 0x0074561a4541903aUL,
+    0x00614811d23c310fUL, 0x0063498c2f49d28dUL, 0x00674c80e9651589UL,
+    0x0074561c463daf3cUL, 0x00614815d4346f13UL, 0x0063499031421091UL,
+    0x00674c84eb5d538dUL, 0x007456204835ed40UL, 0x00614822da9b38a0UL,
+    0x0063499d37a8da1eUL, 0x00674c91f1c41d1aUL, 0x0074562d4e9cb6cdUL,
+    0x0061480fd14d1540UL, 0x0063498a2e5ab6beUL, 0x00674c7ee875f9baUL,
+    0x0074561a454e936dUL, 0x00614811d2493442UL, 0x0063498c2f56d5c0UL,
+    0x00674c80e97218bcUL, 0x0074561c464ab26fUL, 0x00614815d4417246UL,
+    0x00634990314f13c4UL, 0x00674c84eb6a56c0UL, 0x007456204842f073UL,
+    0x00614822daa83bd3UL, 0x0063499d37b5dd51UL, 0x00674c91f1d1204dUL,
+    0x0074562d4ea9ba00UL
+};
+
+
+/* =============================================================================
+ *
+ * End of nucleotide.c
+ *
+ * =============================================================================
+ */
@@ -76,4 +76,213 @@ enum nucleotide_type_t {
     NUCLEOTIDE_GUANINE  = 'g',
     NUCLEOTIDE_THYMINE  = 't',
     NUCLEOTIDE_NUM_TYPE = 4
-} nucleotide_type_t;
+};
+
+
+/* =============================================================================
+ * Packed sequences
+ * -- 2 bits per base, NUCLEOTIDE_PER_WORD bases per unsigned long, base i in
+ *    bits [2*(i%32), 2*(i%32)+2) of word i/32; unused high bits are zero
+ * -- Codes follow alphabetical order (a=0, c=1, g=2, t=3) so comparisons
+ *    order packed strings exactly like strcmp orders the letters
+ * -- Substrings at any offset are read a word at a time by shifting two
+ *    adjacent words together
+ * =============================================================================
+ */
+#define NUCLEOTIDE_PER_WORD (32L)
+
+static const char global_nucleotideDecode[NUCLEOTIDE_NUM_TYPE + 1] = "acgt";
+
+/*
+ * sdbm (hash = c + hash * 65599) of the 4 letters packed in each byte, first
+ * base in the low bits, so nucleotide_hash folds in 4 bases per step and
+ * still matches the byte-at-a-time sdbm of the letters
+ */
+#define NUCLEOTIDE_SDBM_MULTIPLIER  (65599UL)
+#define NUCLEOTIDE_SDBM_MULTIPLIER4 (0x00fc5d1543ec5f01UL) /* 65599^4 */
+
+extern const unsigned long global_nucleotideSdbm4[256]; /* nucleotide.cc */
+
+
+/* =============================================================================
+ * nucleotide_numWord
+ * =============================================================================
+ */
+static inline long
+nucleotide_numWord (long length)
+{
+    return ((length + NUCLEOTIDE_PER_WORD - 1) / NUCLEOTIDE_PER_WORD);
+}
+
+
+/* =============================================================================
+ * nucleotide_mask
+ * -- Mask for the last word of a 'length'-base string
+ * =============================================================================
+ */
+__attribute__((transaction_safe))
+static inline unsigned long
+nucleotide_mask (long length)
+{
+    long r = length % NUCLEOTIDE_PER_WORD;
+    return ((r == 0) ? ~0UL : ((1UL << (2 * r)) - 1));
+}
+
+
+/* =============================================================================
+ * nucleotide_encode
+ * =============================================================================
+ */
+static inline unsigned long
+nucleotide_encode (char c)
+{
+    unsigned long v = (unsigned long)((c >> 1) & 3); /* a=0, c=1, g=3, t=2 */
+    return (v ^ (v >> 1));
+}
+
+
+/* =============================================================================
+ * nucleotide_letter
+ * =============================================================================
+ */
+__attribute__((transaction_safe))
+static inline char
+nucleotide_letter (const unsigned long* src, long i)
+{
+    return global_nucleotideDecode[(src[i / NUCLEOTIDE_PER_WORD] >>
+                                    (2 * (i % NUCLEOTIDE_PER_WORD))) & 3];
+}
+
+
+/* =============================================================================
+ * nucleotide_pack
+ * -- dst holds nucleotide_numWord(length) words
+ * =============================================================================
+ */
+static inline void
+nucleotide_pack (unsigned long* dst, const char* src, long length)
+{
+    long numWord = nucleotide_numWord(length);
+    long w;
+
+    for (w = 0; w < numWord; w++) {
+        long b = w * NUCLEOTIDE_PER_WORD;
+        long b_stop = b + NUCLEOTIDE_PER_WORD;
+        unsigned long word = 0;
+        long shift = 0;
+        if (b_stop > length) {
+            b_stop = length;
+        }
+        for (; b < b_stop; b++, shift += 2) {
+            word |= nucleotide_encode(src[b]) << shift;
+        }
+        dst[w] = word;
+    }
+}
+
+
+/* =============================================================================
+ * nucleotide_word
+ * -- Word k of the substring of src starting at base 'offset' and running to
+ *    base 'stop' (exclusive); bits past 'stop' are not cleared
+ * =============================================================================
+ */
+__attribute__((transaction_safe))
+static inline unsigned long
+nucleotide_word (const unsigned long* src, long offset, long stop, long k)
+{
+    long bit = 2 * (offset + k * NUCLEOTIDE_PER_WORD);
+    long i = bit >> 6;
+    long shift = bit & 63;
+    unsigned long word = src[i] >> shift;
+
+    /* Only touch src[i+1] if the substring reaches into it */
+    if (shift != 0 && 2 * stop > ((i + 1) << 6)) {
+        word |= src[i + 1] << (64 - shift);
+    }
+
+    return word;
+}
+
+
+/* =============================================================================
+ * nucleotide_hash
+ * -- sdbm hash of the letters of the 'length' bases of src at 'offset'
+ * =============================================================================
+ */
+__attribute__((transaction_safe))
+static inline unsigned long
+nucleotide_hash (const unsigned long* src, long offset, long length)
+{
+    long stop = offset + length;
+    unsigned long hash = 0;
+    long k;
+
+    for (k = 0; k * NUCLEOTIDE_PER_WORD < length; k++) {
+        unsigned long word = nucleotide_word(src, offset, stop, k);
+        long n = length - k * NUCLEOTIDE_PER_WORD;
+        long b;
+        if (n > NUCLEOTIDE_PER_WORD) {
+            n = NUCLEOTIDE_PER_WORD;
+        }
+        for (b = 0; (b + 4) <= n; b += 4, word >>= 8) {
+            hash = hash * NUCLEOTIDE_SDBM_MULTIPLIER4 +
+                   global_nucleotideSdbm4[word & 0xff];
+        }
+        for (; b < n; b++, word >>= 2) {
+            hash = hash * NUCLEOTIDE_SDBM_MULTIPLIER +
+                   (unsigned long)global_nucleotideDecode[word & 3];
+        }
+    }
+
+    return hash;
+}
+
+
+/* =============================================================================
+ * nucleotide_compare
+ * -- Compares 'length' bases of a at aOffset with b at bOffset
+ * -- Returns <0, 0, >0 in the same order as strncmp on the letters
+ * =============================================================================
+ */
+__attribute__((transaction_safe))
+static inline long
+nucleotide_compare (const unsigned long* a, long aOffset,
+                    const unsigned long* b, long bOffset,
+                    long length)
+{
+    long numWord = nucleotide_numWord(length);
+    long k;
+
+    for (k = 0; k < numWord; k++) {
+        unsigned long aWord = nucleotide_word(a, aOffset, aOffset + length, k);
+        unsigned long bWord = nucleotide_word(b, bOffset, bOffset + length, k);
+        unsigned long diff = aWord ^ bWord;
+        if (k == numWord - 1) {
+            diff &= nucleotide_mask(length);
+        }
+        if (diff != 0) {
+            /* First differing base is the lowest differing bit pair */
+            long shift = __builtin_ctzl(diff) & ~1L;
+            return (long)((aWord >> shift) & 3) - (long)((bWord >> shift) & 3);
+        }
+    }
+
+    return 0;
+}
+
+
+/* =============================================================================
+ * nucleotide_unpack
+ * -- Writes 'length' letters of src starting at base 'offset'; no NUL
+ * =============================================================================
+ */
+static inline void
+nucleotide_unpack (char* dst, const unsigned long* src, long offset, long length)
+{
+    long i;
+
+    for (i = 0; i < length; i++) {
+        dst[i] = nucleotide_letter(src, (offset + i));
+    }
+}
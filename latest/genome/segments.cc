@@ -75,6 +75,7 @@
 #include <string.h>
 #include <random>
 #include "gene.h"
+#include "nucleotide.h"
 #include "segments.h"
 #include "utility.h"
 #include "vector.h"
@@ -93,7 +94,8 @@ segments_alloc (long length, long minNum)
 {
     segments_t* segmentsPtr;
     long i;
-    char* string;
+    long numWord = nucleotide_numWord(length);
+    unsigned long* words;
 
     segmentsPtr = (segments_t*)malloc(sizeof(segments_t));
     if (segmentsPtr == NULL) {
@@ -101,18 +103,18 @@ segments_alloc (long length, long minNum)
     }
 
     /* Preallocate for the min number of segments we will need */
-    segmentsPtr->strings = (char**)malloc(minNum * sizeof(char*));
-    if (segmentsPtr->strings == NULL) {
+    segmentsPtr->packed =
+        (unsigned long**)malloc(minNum * sizeof(unsigned long*));
+    if (segmentsPtr->packed == NULL) {
         return NULL;
     }
 
-    string = (char*)malloc(minNum * (length+1) * sizeof(char));
-    if (string == NULL) {
+    words = (unsigned long*)malloc(minNum * numWord * sizeof(unsigned long));
+    if (words == NULL) {
         return NULL;
     }
     for (i = 0; i < minNum; i++) {
-        segmentsPtr->strings[i] = &string[i * (length+1)];
-        segmentsPtr->strings[i][length] = '\0';
+        segmentsPtr->packed[i] = &words[i * numWord];
     }
     segmentsPtr->minNum = minNum;
     segmentsPtr->length = length;
@@ -126,6 +128,25 @@ segments_alloc (long length, long minNum)
 }
 
 
+/* =============================================================================
+ * copySegment
+ * -- Shifts the segment starting at base 'start' out of the packed gene
+ * =============================================================================
+ */
+static void
+copySegment (unsigned long* dst, gene_t* genePtr, long start, long segmentLength)
+{
+    long numWord = nucleotide_numWord(segmentLength);
+    long stop = start + segmentLength;
+    long k;
+
+    for (k = 0; k < numWord; k++) {
+        dst[k] = nucleotide_word(genePtr->packed, start, stop, k);
+    }
+    dst[numWord - 1] &= nucleotide_mask(segmentLength);
+}
+
+
 /* =============================================================================
  * segments_create
  * -- Populates 'contentsPtr'
@@ -135,10 +156,10 @@ void
 segments_create (segments_t* segmentsPtr, gene_t* genePtr, std::mt19937* randomPtr)
 {
     vector_t* segmentsContentsPtr;
-    char** strings;
+    unsigned long** packed;
     long segmentLength;
+    long numWord;
     long minNumSegment;
-    char* geneString;
     long geneLength;
     bitmap_t* startBitmapPtr;
     long numStart;
@@ -150,11 +171,11 @@ segments_create (segments_t* segmentsPtr, gene_t* genePtr, std::mt19937* randomP
     assert(randomPtr != NULL);
 
     segmentsContentsPtr = segmentsPtr->contentsPtr;
-    strings = segmentsPtr->strings;
+    packed = segmentsPtr->packed;
     segmentLength = segmentsPtr->length;
+    numWord = nucleotide_numWord(segmentLength);
     minNumSegment = segmentsPtr->minNum;
 
-    geneString = genePtr->contents;
     geneLength = genePtr->length;
     startBitmapPtr = genePtr->startBitmapPtr;
     numStart = geneLength - segmentLength + 1;
@@ -164,18 +185,19 @@ segments_create (segments_t* segmentsPtr, gene_t* genePtr, std::mt19937* randomP
         long j = (long)(randomPtr->operator()() % numStart);
         bool status = bitmap_set(startBitmapPtr, j);
         assert(status);
-        memcpy(strings[i], &(geneString[j]), segmentLength * sizeof(char));
-        status = vector_pushBack(segmentsContentsPtr, (void*)strings[i]);
+        copySegment(packed[i], genePtr, j, segmentLength);
+        status = vector_pushBack(segmentsContentsPtr, (void*)packed[i]);
         assert(status);
     }
 
     /* Make sure segment covers start */
     i = 0;
     if (!bitmap_isSet(startBitmapPtr, i)) {
-        char* string = (char*)malloc((segmentLength+1) * sizeof(char));
-        string[segmentLength] = '\0';
-        memcpy(string, &(geneString[i]), segmentLength * sizeof(char));
-        bool status = vector_pushBack(segmentsContentsPtr, (void*)string);
+        unsigned long* words =
+            (unsigned long*)malloc(numWord * sizeof(unsigned long));
+        assert(words);
+        copySegment(words, genePtr, i, segmentLength);
+        bool status = vector_pushBack(segmentsContentsPtr, (void*)words);
         assert(status);
         status = bitmap_set(startBitmapPtr, i);
         assert(status);
@@ -192,11 +214,12 @@ segments_create (segments_t* segmentsPtr, gene_t* genePtr, std::mt19937* randomP
         }
         if (i == i_stop) {
             /* Found big enough hole */
-            char* string = (char*)malloc((segmentLength+1) * sizeof(char));
-            string[segmentLength] = '\0';
+            unsigned long* words =
+                (unsigned long*)malloc(numWord * sizeof(unsigned long));
+            assert(words);
             i = i - 1;
-            memcpy(string, &(geneString[i]), segmentLength * sizeof(char));
-            bool status = vector_pushBack(segmentsContentsPtr, (void*)string);
+            copySegment(words, genePtr, i, segmentLength);
+            bool status = vector_pushBack(segmentsContentsPtr, (void*)words);
             assert(status);
             status = bitmap_set(startBitmapPtr, i);
             assert(status);
@@ -214,7 +237,7 @@ segments_free (segments_t* segmentsPtr)
 {
     free(vector_at(segmentsPtr->contentsPtr, 0));
     vector_free(segmentsPtr->contentsPtr);
-    free(segmentsPtr->strings);
+    free(segmentsPtr->packed);
     free(segmentsPtr);
 }
 
@@ -260,17 +283,22 @@ tester (long geneLength, long segmentLength, long minNumSegment, bool doPrint)
     }
 
     /* Check that each segment occurs in gene */
+    char* string = (char*)malloc((segmentLength + 1) * sizeof(char));
+    string[segmentLength] = '\0';
     for (i = 0; i < vector_getSize(segmentsPtr->contentsPtr); i++) {
-        char *charPtr = strstr(genePtr->contents,
-                               (char*)vector_at(segmentsPtr->contentsPtr, i));
+        nucleotide_unpack(string,
+                          (unsigned long*)vector_at(segmentsPtr->contentsPtr, i),
+                          0,
+                          segmentLength);
+        char *charPtr = strstr(genePtr->contents, string);
         assert(charPtr != NULL);
         j = charPtr - genePtr->contents;
         bitmap_set(startBitmapPtr, j);
         if (doPrint) {
-            printf("Segment %li (@%li) = %s\n",
-                   i, j, (char*)vector_at(segmentsPtr->contentsPtr, i));
+            printf("Segment %li (@%li) = %s\n", i, j, string);
         }
     }
+    free(string);
 
     /* Check that there is complete overlap */
     assert(bitmap_isSet(startBitmapPtr, 0));
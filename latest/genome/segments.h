@@ -78,9 +78,9 @@
 struct segments_t {
     long length;
     long minNum;
-    vector_t* contentsPtr;
+    vector_t* contentsPtr;    /* packed segments (nucleotide.h) */
 /* private: */
-    char** strings;
+    unsigned long** packed;
 };
 
 
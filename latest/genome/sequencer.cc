@@ -82,6 +82,7 @@
 #include <string.h>
 #include "hash.h"
 #include "hashtable.h"
+#include "nucleotide.h"
 #include "segments.h"
 #include "sequencer.h"
 #include "table.h"
@@ -90,11 +91,10 @@
 #include "vector.h"
 #include "tm_transition.h"
 
-// [mfs] This is a hack
-extern
-__attribute__((transaction_pure))
-int strncmp (__const char *__s1, __const char *__s2, size_t __n);
-
+struct segmentKey_t {
+    unsigned long* segment; /* packed (nucleotide.h) */
+    long length;
+};
 
 struct endInfoEntry_t {
     bool isEnd;
@@ -103,111 +103,47 @@ struct endInfoEntry_t {
 
 struct constructEntry_t {
     bool isStart;
-    char* segment;
+    unsigned long* segment; /* packed (nucleotide.h) */
     unsigned long endHash;
     constructEntry_t* startPtr;
     constructEntry_t* nextPtr;
     constructEntry_t* endPtr;
     long overlap;
     long length;
+    long offset; /* into sequence, set in step 3 */
 };
 
 
-/* =============================================================================
- * hashString
- * -- uses sdbm hash function
- * =============================================================================
- */
-__attribute__((transaction_safe))
-unsigned long
-hashString (char* str)
-{
-    unsigned long hash = 0;
-    long c;
-
-    /* Note: Do not change this hashing scheme */
-    while ((c = *str++) != '\0') {
-        hash = c + (hash << 6) + (hash << 16) - hash;
-    }
-
-    return (unsigned long)hash;
-}
-
-
 /* =============================================================================
  * hashSegment
- * -- For hashtable
+ * -- For hashtable; keys are segmentKey_t
  * =============================================================================
  */
-//[wer] need to be TM_SAFE
 __attribute__((transaction_safe))
-//__attibute__ ((transaction_pure))
 unsigned long
 hashSegment (const void* keyPtr)
 {
-  //return (unsigned long)hash_sdbm((char*)keyPtr); /* can be any "good" hash function */
-
-  //[wer] I replaced hash_sdbm with the above sdbm function, which is TM_SAFE
-  unsigned long hash = 0;
-    long c;
-    const char* str = (const char*)keyPtr;
-
-    /* Note: Do not change this hashing scheme */
-   while ((c = *str++) != '\0') {
-        hash = c + (hash << 6) + (hash << 16) - hash;
-    }
-
-   return (unsigned long)hash;
+    const segmentKey_t* segmentKeyPtr = (const segmentKey_t*)keyPtr;
 
-}
-
-
-//[wer] we need a safe version of strcmp
-/*
- *  Compare S1 and S2, returning less than, equal to or
- *  greater than zero if S1 is lexicographically less than,
- *  equal to or greater than S2.
- */
-__attribute__((transaction_safe))
-inline long tm_safe_strcmp(const void* p1, const void* p2)
-{
-
-  register const unsigned char *s1 = (const unsigned char *) p1;
-  register const unsigned char *s2 = (const unsigned char *) p2;
-
-  unsigned char c1, c2;
-  do
-  {
-      c1 = (unsigned char) *s1++;
-      c2 = (unsigned char) *s2++;
-
-      if (c1 == '\0')
-        return c1 - c2;
-  }while (c1 == c2);
-
-  return c1 - c2;
-}
-
-__attribute__((transaction_pure))
-inline static long tm_strcmp(void* a, void* b)
-{
-  return  strcmp((char*)a, (char*)b);
+    return nucleotide_hash(segmentKeyPtr->segment, 0, segmentKeyPtr->length);
 }
 
 
 /* =============================================================================
  * compareSegment
- * -- For hashtable
+ * -- For hashtable; keys are segmentKey_t of equal length
  * =============================================================================
  */
 __attribute__((transaction_safe))
 long
 compareSegment (const pair_t* a, const pair_t* b)
 {
-  void* aa = (void*)(a -> firstPtr);
-  void* bb = (void*)(b -> firstPtr);
-  //return tm_strcmp(aa, bb);
-  return tm_safe_strcmp(aa, bb); //[wer210] use safe version is TOO slow for write-through alg.
+    const segmentKey_t* aKeyPtr = (const segmentKey_t*)a->firstPtr;
+    const segmentKey_t* bKeyPtr = (const segmentKey_t*)b->firstPtr;
+
+    return nucleotide_compare(aKeyPtr->segment, 0,
+                              bKeyPtr->segment, 0,
+                              aKeyPtr->length);
 }
 
 
@@ -234,6 +170,21 @@ sequencer_alloc (long geneLength, long segmentLength, segments_t* segmentsPtr)
         return NULL;
     }
 
+    /* Keys carry the length, so the callbacks need no shared state */
+    vector_t* segmentsContentsPtr = segmentsPtr->contentsPtr;
+    long numSegment = vector_getSize(segmentsContentsPtr);
+    sequencerPtr->segmentKeys =
+        (segmentKey_t*)malloc(numSegment * sizeof(segmentKey_t));
+    if (sequencerPtr->segmentKeys == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < numSegment; i++) {
+        segmentKey_t* segmentKeyPtr = &sequencerPtr->segmentKeys[i];
+        segmentKeyPtr->segment =
+            (unsigned long*)vector_at(segmentsContentsPtr, i);
+        segmentKeyPtr->length = segmentLength;
+    }
+
     /* For finding a matching entry */
     sequencerPtr->endInfoEntries =
         (endInfoEntry_t*)malloc(maxNumUniqueSegment * sizeof(endInfoEntry_t));
@@ -272,18 +223,179 @@ sequencer_alloc (long geneLength, long segmentLength, segments_t* segmentsPtr)
         constructEntryPtr->endPtr = constructEntryPtr;
         constructEntryPtr->overlap = 0;
         constructEntryPtr->length = segmentLength;
+        constructEntryPtr->offset = -1;
     }
     sequencerPtr->hashToConstructEntryTable = table_alloc(geneLength, NULL);
     if (sequencerPtr->hashToConstructEntryTable == NULL) {
         return NULL;
     }
 
+    /* For linking ends across thread partitions in step 2c */
+    sequencerPtr->firstEnds =
+        (long*)malloc(thread_getNumThread() * sizeof(long));
+    if (sequencerPtr->firstEnds == NULL) {
+        return NULL;
+    }
+
     sequencerPtr->segmentsPtr = segmentsPtr;
 
     return sequencerPtr;
 }
 
 
+/*
+ * The transactions of sequencer_run live in the out-of-line helpers below,
+ * so that none of its locals are live across a transaction begin.
+ */
+
+/* =============================================================================
+ * insertSegments
+ * -- Step 1: adds segments [start, stop) to uniqueSegmentsPtr
+ * =============================================================================
+ */
+__attribute__((noinline))
+static void
+insertSegments (hashtable_t* uniqueSegmentsPtr, segmentKey_t* segmentKeys,
+                long start, long stop)
+{
+    __transaction_atomic {
+        long ii;
+        for (ii = 0; ii < (stop - start); ii++) {
+            segmentKey_t* segmentKeyPtr = &segmentKeys[start + ii];
+            TMHASHTABLE_INSERT(uniqueSegmentsPtr,
+                               segmentKeyPtr,
+                               segmentKeyPtr->segment);
+        } /* ii */
+    }
+}
+
+
+/* =============================================================================
+ * claimEntry
+ * -- Step 2a: stores segment in the first empty entry at or after
+ *    entryIndex (wrapping) and returns its index
+ * =============================================================================
+ */
+__attribute__((noinline))
+static long
+claimEntry (constructEntry_t* constructEntries, long numUniqueSegment,
+            long entryIndex, unsigned long* segment)
+{
+    long n;
+
+    __transaction_atomic {
+        for (n = 0; n < numUniqueSegment; n++) {
+            long e = (entryIndex + n) % numUniqueSegment; /* look for empty */
+            if (((void*)constructEntries[e].segment) == NULL) {
+                constructEntries[e].segment = segment;
+                break;
+            }
+        }
+    }
+    assert(n < numUniqueSegment);
+
+    return (entryIndex + n) % numUniqueSegment;
+}
+
+
+/* =============================================================================
+ * insertEntry
+ * -- Step 2a: returns TMTABLE_INSERT's status
+ * =============================================================================
+ */
+__attribute__((noinline))
+static bool
+insertEntry (table_t* tablePtr, unsigned long hash,
+             constructEntry_t* constructEntryPtr)
+{
+    bool status;
+
+    __transaction_atomic {
+        status = TMTABLE_INSERT(tablePtr, hash, (void*)constructEntryPtr);
+    }
+
+    return status;
+}
+
+
+/* =============================================================================
+ * getPartition
+ * -- Disjoint [*startPtr, *stopPtr) of [0, num) for thread threadId
+ * =============================================================================
+ */
+static void
+getPartition (long num, long threadId, long numThread,
+              long* startPtr, long* stopPtr)
+{
+    long partitionSize = (num + numThread/2) / numThread; /* with rounding */
+    long start = MIN((threadId * partitionSize), num);
+
+    *startPtr = start;
+    if (threadId == (numThread - 1)) {
+        *stopPtr = num;
+    } else {
+        *stopPtr = MIN((start + partitionSize), num);
+    }
+}
+
+
+/* =============================================================================
+ * matchEnd
+ * -- Step 2b for one (end, start) pair: links them if start's prefix of
+ *    substringLength matches end's suffix
+ * =============================================================================
+ */
+__attribute__((noinline))
+static void
+matchEnd (endInfoEntry_t* endInfoEntries,
+          long entryIndex,
+          constructEntry_t* endConstructEntryPtr,
+          constructEntry_t* startConstructEntryPtr,
+          long segmentLength,
+          long substringLength)
+{
+    unsigned long* endSegment = endConstructEntryPtr->segment;
+    unsigned long* startSegment = startConstructEntryPtr->segment;
+
+    __transaction_atomic {
+      /* Check if matches */
+      if (startConstructEntryPtr->isStart &&
+          (endConstructEntryPtr->startPtr != startConstructEntryPtr) &&
+          (nucleotide_compare(startSegment,
+                              0,
+                              endSegment,
+                              (segmentLength - substringLength),
+                              substringLength) == 0))
+      {
+          startConstructEntryPtr->isStart = false;
+
+        constructEntry_t* startConstructEntry_endPtr;
+        constructEntry_t* endConstructEntry_startPtr;
+
+        /* Update endInfo (appended something so no longer end) */
+        endInfoEntries[entryIndex].isEnd = false;
+
+        /* Update segment chain construct info */
+        startConstructEntry_endPtr = startConstructEntryPtr->endPtr;
+        endConstructEntry_startPtr = endConstructEntryPtr->startPtr;
+
+        assert(startConstructEntry_endPtr);
+        assert(endConstructEntry_startPtr);
+        startConstructEntry_endPtr->startPtr = endConstructEntry_startPtr;
+        endConstructEntryPtr->nextPtr = startConstructEntryPtr;
+        endConstructEntry_startPtr->endPtr = startConstructEntry_endPtr;
+        endConstructEntryPtr->overlap = substringLength;
+
+        endConstructEntry_startPtr->length =
+            endConstructEntry_startPtr->length
+            + startConstructEntryPtr->length
+            - substringLength;
+      } /* if (matched) */
+
+    } // TM_END
+}
+
+
 /* =============================================================================
  * sequencer_run
  * =============================================================================
@@ -314,12 +426,14 @@ sequencer_run (void* argPtr)
     long        segmentLength       = segmentsPtr->length;
 
     long i;
-    long j;
     long i_start;
     long i_stop;
     long numUniqueSegment;
     long substringLength;
     long entryIndex;
+    long index_start;
+    long index_stop;
+    long* firstEnds = sequencerPtr->firstEnds;
 
     /*
      * Step 1: Remove duplicate segments
@@ -337,16 +451,8 @@ sequencer_run (void* argPtr)
     }
 
     for (i = i_start; i < i_stop; i+=CHUNK_STEP1) {
-      __transaction_atomic {
-        {
-          long ii;
-          long ii_stop = MIN(i_stop, (i+CHUNK_STEP1));
-          for (ii = i; ii < ii_stop; ii++) {
-            void* segment = vector_at(segmentsContentsPtr, ii);
-            TMHASHTABLE_INSERT(uniqueSegmentsPtr, segment, segment);
-          } /* ii */
-        }
-      }
+        insertSegments(uniqueSegmentsPtr, sequencerPtr->segmentKeys,
+                       i, MIN(i_stop, (i+CHUNK_STEP1)));
     }
 
     thread_barrier_wait();
@@ -400,21 +506,17 @@ sequencer_run (void* argPtr)
 
         while (list_iter_hasNext(&it)) {
 
-            char* segment =
-                (char*)((pair_t*)list_iter_next(&it))->firstPtr;
+            unsigned long* segment =
+                (unsigned long*)((pair_t*)list_iter_next(&it))->secondPtr;
             constructEntry_t* constructEntryPtr;
             long j;
             unsigned long startHash;
             bool status;
 
             /* Find an empty constructEntries entry */
-            __transaction_atomic {
-              while (((void*)constructEntries[entryIndex].segment) != NULL) {
-                entryIndex = (entryIndex + 1) % numUniqueSegment; /* look for empty */
-              }
-              constructEntryPtr = &constructEntries[entryIndex];
-              constructEntryPtr->segment = segment;
-            }
+            entryIndex = claimEntry(constructEntries, numUniqueSegment,
+                                    entryIndex, segment);
+            constructEntryPtr = &constructEntries[entryIndex];
             entryIndex = (entryIndex + 1) % numUniqueSegment;
 
             /*
@@ -428,36 +530,36 @@ sequencer_run (void* argPtr)
              * and compute all of them here.
              */
             /* constructEntryPtr is local now */
-            constructEntryPtr->endHash = (unsigned long)hashString(&segment[1]);
+            constructEntryPtr->endHash =
+                nucleotide_hash(segment, 1, (segmentLength - 1));
 
             startHash = 0;
             for (j = 1; j < segmentLength; j++) {
-                startHash = (unsigned long)segment[j-1] +
+                startHash = (unsigned long)nucleotide_letter(segment, (j-1)) +
                             (startHash << 6) + (startHash << 16) - startHash;
-                __transaction_atomic {
-                  status = TMTABLE_INSERT(startHashToConstructEntryTables[j],
-                                          (unsigned long)startHash,
-                                          (void*)constructEntryPtr );
-                }
+                status = insertEntry(startHashToConstructEntryTables[j],
+                                     startHash,
+                                     constructEntryPtr);
                 assert(status);
             }
 
             /*
              * For looking up construct entries quickly
              */
-            startHash = (unsigned long)segment[j-1] +
+            startHash = (unsigned long)nucleotide_letter(segment, (j-1)) +
                         (startHash << 6) + (startHash << 16) - startHash;
-            __transaction_atomic {
-              status = TMTABLE_INSERT(hashToConstructEntryTable,
-                                      (unsigned long)startHash,
-                                      (void*)constructEntryPtr);
-            }
+            status = insertEntry(hashToConstructEntryTable,
+                                 startHash,
+                                 constructEntryPtr);
             assert(status);
         }
     }
 
     thread_barrier_wait();
 
+    /* Choose disjoint segments [index_start,index_stop) for each thread */
+    getPartition(numUniqueSegment, threadId, numThread, &index_start, &index_stop);
+
     /*
      * Step 2b: Match ends to starts by using hash-based string comparison.
      */
@@ -468,20 +570,6 @@ sequencer_run (void* argPtr)
         list_t** buckets = startHashToConstructEntryTablePtr->buckets;
         long numBucket = startHashToConstructEntryTablePtr->numBucket;
 
-        long index_start;
-        long index_stop;
-
-        {
-            /* Choose disjoint segments [index_start,index_stop) for each thread */
-            long partitionSize = (numUniqueSegment + numThread/2) / numThread; /* with rounding */
-            index_start = threadId * partitionSize;
-            if (threadId == (numThread - 1)) {
-                index_stop = numUniqueSegment;
-            } else {
-                index_stop = index_start + partitionSize;
-            }
-        }
-
         /* Iterating over disjoint itervals in the range [0, numUniqueSegment) */
         for (entryIndex = index_start;
              entryIndex < index_stop;
@@ -494,7 +582,6 @@ sequencer_run (void* argPtr)
             /*  ConstructEntries[entryIndex] is local data */
             constructEntry_t* endConstructEntryPtr =
                 &constructEntries[entryIndex];
-            char* endSegment = endConstructEntryPtr->segment;
             unsigned long endHash = endConstructEntryPtr->endHash;
 
             list_t* chainPtr = buckets[endHash % numBucket]; /* buckets: constant data */
@@ -506,44 +593,11 @@ sequencer_run (void* argPtr)
 
                 constructEntry_t* startConstructEntryPtr =
                     (constructEntry_t*)list_iter_next(&it);
-                char* startSegment = startConstructEntryPtr->segment;
-                long newLength = 0;
 
                 /* endConstructEntryPtr is local except for properties startPtr/endPtr/length */
-                __transaction_atomic {
-                  /* Check if matches */
-                  if (startConstructEntryPtr->isStart &&
-                      (endConstructEntryPtr->startPtr != startConstructEntryPtr) &&
-                      (strncmp(startSegment,
-                               &endSegment[segmentLength - substringLength],
-                               substringLength) == 0))
-                  {
-                      startConstructEntryPtr->isStart = false;
-
-                    constructEntry_t* startConstructEntry_endPtr;
-                    constructEntry_t* endConstructEntry_startPtr;
-
-                    /* Update endInfo (appended something so no longer end) */
-                    endInfoEntries[entryIndex].isEnd = false;
-
-                    /* Update segment chain construct info */
-                    startConstructEntry_endPtr = startConstructEntryPtr->endPtr;
-                    endConstructEntry_startPtr = endConstructEntryPtr->startPtr;
-
-                    assert(startConstructEntry_endPtr);
-                    assert(endConstructEntry_startPtr);
-                    startConstructEntry_endPtr->startPtr = endConstructEntry_startPtr;
-                    endConstructEntryPtr->nextPtr = startConstructEntryPtr;
-                    endConstructEntry_startPtr->endPtr = startConstructEntry_endPtr;
-                    endConstructEntryPtr->overlap = substringLength;
-
-                    newLength = endConstructEntry_startPtr->length
-                        + startConstructEntryPtr->length
-                        - substringLength;
-                    endConstructEntry_startPtr->length = newLength;
-                  } /* if (matched) */
-
-                } // TM_END
+                matchEnd(endInfoEntries, entryIndex,
+                         endConstructEntryPtr, startConstructEntryPtr,
+                         segmentLength, substringLength);
 
                 /* if there was a match */
                 if (!endInfoEntries[entryIndex].isEnd)
@@ -560,35 +614,52 @@ sequencer_run (void* argPtr)
          *
          * endHash entries of all remaining ends are updated to the next
          * substringLength. Additionally jumpToNext entries are updated such
-         * that they allow to skip non-end entries. Currently this is sequential
-         * because parallelization did not perform better.
-.        */
-
-        if (threadId == 0) {
-            if (substringLength > 1) {
-                long index = segmentLength - substringLength + 1;
-                /* initialization if j and i: with i being the next end after j=0 */
-                for (i = 1; !endInfoEntries[i].isEnd; i+=endInfoEntries[i].jumpToNext) {
-                    /* find first non-null */
+         * that they allow to skip non-end entries. Each thread relinks the
+         * ends within its own [index_start,index_stop); after a barrier the
+         * last end of each partition is linked to the first end of the next
+         * non-empty one.
+         */
+        if (substringLength > 1) {
+            long index = segmentLength - substringLength + 1;
+            long firstEnd = -1;
+            long lastEnd = -1;
+            long nextEnd = numUniqueSegment;
+            long t;
+
+            /* jumpToNext never skips an end, so walking from index_start is safe */
+            for (i = index_start; i < index_stop; i += endInfoEntries[i].jumpToNext) {
+                if (endInfoEntries[i].isEnd) {
+                    constructEntry_t* constructEntryPtr = &constructEntries[i];
+                    unsigned long* segment = constructEntryPtr->segment;
+                    constructEntryPtr->endHash =
+                        nucleotide_hash(segment, index, (segmentLength - index));
+                    if (lastEnd < 0) {
+                        firstEnd = i;
+                    } else {
+                        endInfoEntries[lastEnd].jumpToNext = i - lastEnd;
+                    }
+                    lastEnd = i;
                 }
-                /* entry 0 is handled seperately from the loop below */
-                endInfoEntries[0].jumpToNext = i;
-                if (endInfoEntries[0].isEnd) {
-                    constructEntry_t* constructEntryPtr = &constructEntries[0];
-                    char* segment = constructEntryPtr->segment;
-                    constructEntryPtr->endHash = (unsigned long)hashString(&segment[index]);
+            }
+            firstEnds[threadId] = firstEnd;
+
+            thread_barrier_wait();
+
+            for (t = threadId + 1; t < numThread; t++) {
+                if (firstEnds[t] >= 0) {
+                    nextEnd = firstEnds[t];
+                    break;
                 }
-                /* Continue scanning (do not reset i) */
-                for (j = 0; i < numUniqueSegment; i+=endInfoEntries[i].jumpToNext) {
-                    if (endInfoEntries[i].isEnd) {
-                        constructEntry_t* constructEntryPtr = &constructEntries[i];
-                        char* segment = constructEntryPtr->segment;
-                        constructEntryPtr->endHash = (unsigned long)hashString(&segment[index]);
-                        endInfoEntries[j].jumpToNext = MAX(1, (i - j));
-                        j = i;
+            }
+            if (index_start < index_stop) {
+                if (lastEnd < 0) {
+                    endInfoEntries[index_start].jumpToNext = nextEnd - index_start;
+                } else {
+                    endInfoEntries[lastEnd].jumpToNext = nextEnd - lastEnd;
+                    if (firstEnd != index_start) {
+                        endInfoEntries[index_start].jumpToNext = firstEnd - index_start;
                     }
                 }
-                endInfoEntries[j].jumpToNext = i - j;
             }
         }
 
@@ -601,6 +672,9 @@ sequencer_run (void* argPtr)
 
     /*
      * Step 3: Build sequence string
+     *
+     * Thread 0 walks the chains to give every segment its offset in the
+     * sequence, then all threads unpack their own entries in parallel.
      */
     if (threadId == 0) {
 
@@ -617,7 +691,6 @@ sequencer_run (void* argPtr)
         char* sequence = sequencerPtr->sequence;
         assert(sequence);
 
-        char* copyPtr = sequence;
         long sequenceLength = 0;
 
         for (i = 0; i < numUniqueSegment; i++) {
@@ -626,27 +699,39 @@ sequencer_run (void* argPtr)
             if (constructEntryPtr->isStart) {
                 long newSequenceLength = sequenceLength + constructEntryPtr->length;
                 assert( newSequenceLength <= totalLength );
-                copyPtr = sequence + sequenceLength;
+                long offset = sequenceLength;
                 sequenceLength = newSequenceLength;
                 do {
                     long numChar = segmentLength - constructEntryPtr->overlap;
-                    if ((copyPtr + numChar) > (sequence + newSequenceLength)) {
+                    if ((offset + numChar) > newSequenceLength) {
                         printf("ERROR: sequence length != actual length\n");
                         break;
                     }
-                    memcpy(copyPtr,
-                           constructEntryPtr->segment,
-                           (numChar * sizeof(char)));
-                    copyPtr += numChar;
+                    constructEntryPtr->offset = offset;
+                    offset += numChar;
                 } while ((constructEntryPtr = constructEntryPtr->nextPtr) != NULL);
-                assert(copyPtr <= (sequence + sequenceLength));
+                assert(offset <= sequenceLength);
             }
         }
 
-        assert(sequence != NULL);
         sequence[sequenceLength] = '\0';
     }
 
+    thread_barrier_wait();
+
+    {
+        char* sequence = sequencerPtr->sequence;
+        for (i = index_start; i < index_stop; i++) {
+            constructEntry_t* constructEntryPtr = &constructEntries[i];
+            if (constructEntryPtr->offset >= 0) {
+                nucleotide_unpack(&sequence[constructEntryPtr->offset],
+                                  constructEntryPtr->segment,
+                                  0,
+                                  (segmentLength - constructEntryPtr->overlap));
+            }
+        }
+    }
+
 }
 
 
@@ -666,8 +751,10 @@ sequencer_free (sequencer_t* sequencerPtr)
     }
     free(sequencerPtr->startHashToConstructEntryTables);
     free(sequencerPtr->endInfoEntries);
+    free(sequencerPtr->firstEnds);
     /* TODO: fix mixed sequential/parallel allocation */
     TMhashtable_free(sequencerPtr->uniqueSegmentsPtr);
+    free(sequencerPtr->segmentKeys);
     if (sequencerPtr->sequence != NULL) {
         free(sequencerPtr->sequence);
     }
@@ -899,8 +986,10 @@ createSegments (char* segments[])
     segmentsPtr->contentsPtr = vector_alloc(1);
 
     while (segments[i] != NULL) {
-        bool status = vector_pushBack(segmentsPtr->contentsPtr,
-                                        (void*)segments[i]);
+        unsigned long* words = (unsigned long*)malloc(
+            nucleotide_numWord(segmentsPtr->length) * sizeof(unsigned long));
+        nucleotide_pack(words, segments[i], segmentsPtr->length);
+        bool status = vector_pushBack(segmentsPtr->contentsPtr, (void*)words);
         assert(status);
         i++;
     }
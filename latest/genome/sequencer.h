@@ -74,6 +74,7 @@
 #include "segments.h"
 #include "table.h"
 
+struct segmentKey_t;
 struct endInfoEntry_t;
 struct constructEntry_t;
 
@@ -90,6 +91,7 @@ struct sequencer_t {
 
     /* For removing duplicate segments */
     hashtable_t* uniqueSegmentsPtr;
+    segmentKey_t* segmentKeys; /* keys of uniqueSegmentsPtr, one per segment */
 
     /* For matching segments */
     endInfoEntry_t* endInfoEntries;
@@ -98,6 +100,7 @@ struct sequencer_t {
     /* For constructing sequence */
     constructEntry_t* constructEntries;
     table_t* hashToConstructEntryTable;
+    long* firstEnds; /* [numThread]: first open end of each partition */
 
     /* For deallocation */
     long segmentLength;
@@ -95,6 +95,12 @@ enum param_types {
     PARAM_THREAD = (unsigned char)'t'
 };
 
+/*
+ * Packets are popped from the stream in small batches to amortize the
+ * shared pop index.
+ */
+#define INTRUDER_PACKET_BATCH (8)
+
 enum param_defaults {
     PARAM_DEFAULT_ATTACK = 10,
     PARAM_DEFAULT_LENGTH = 128,
@@ -200,51 +206,57 @@ processPackets (void* argPtr)
 
     vector_t* errorVectorPtr = errorVectors[threadId];
 
+    char* packets[INTRUDER_PACKET_BATCH];
+
     while (1) {
 
-        char* bytes;
-        __transaction_atomic {
-          //[wer210] TMQUEUE_POP(streamPtr->packetQueuePtr);
-          bytes = TMSTREAM_GETPACKET(streamPtr);
-        }
-        if (!bytes) {
+        long numPacket = stream_getPackets(streamPtr,
+                                           packets,
+                                           INTRUDER_PACKET_BATCH);
+        if (numPacket == 0) {
             break;
         }
 
-        packet_t* packetPtr = (packet_t*)bytes;
-        long flowId = packetPtr->flowId;
+        long p;
+        for (p = 0; p < numPacket; p++) {
 
-        int_error_t error;
-        __transaction_atomic {
-          error = TMDECODER_PROCESS(decoderPtr,
-                                    bytes,
-                                    (PACKET_HEADER_LENGTH + packetPtr->length));
-        }
-        //TMprint("2.\n");
-        if (error) {
-            /*
-             * Currently, stream_generate() does not create these errors.
-             */
-            assert(0);
-            bool status = PVECTOR_PUSHBACK(errorVectorPtr, (void*)flowId);
-            assert(status);
-        }
+            char* bytes = packets[p];
+            packet_t* packetPtr = (packet_t*)bytes;
+            long flowId = packetPtr->flowId;
 
-        char* data;
-        long decodedFlowId;
-        __transaction_atomic {
-          data = TMDECODER_GETCOMPLETE(decoderPtr, &decodedFlowId);
-        }
-        //TMprint("3.\n");
-        if (data) {
-            int_error_t error = PDETECTOR_PROCESS(detectorPtr, data);
-            free(data);
+            int_error_t error;
+            __transaction_atomic {
+              error = TMDECODER_PROCESS(decoderPtr,
+                                        bytes,
+                                        (PACKET_HEADER_LENGTH + packetPtr->length));
+            }
+            //TMprint("2.\n");
             if (error) {
-                bool status = PVECTOR_PUSHBACK(errorVectorPtr,
-                                                 (void*)decodedFlowId);
+                /*
+                 * Currently, stream_generate() does not create these errors.
+                 */
+                assert(0);
+                bool status = PVECTOR_PUSHBACK(errorVectorPtr, (void*)flowId);
                 assert(status);
             }
-        }
+
+            char* data;
+            long decodedFlowId;
+            __transaction_atomic {
+              data = TMDECODER_GETCOMPLETE(decoderPtr, &decodedFlowId);
+            }
+            //TMprint("3.\n");
+            if (data) {
+                int_error_t error = PDETECTOR_PROCESS(detectorPtr, data);
+                free(data);
+                if (error) {
+                    bool status = PVECTOR_PUSHBACK(errorVectorPtr,
+                                                     (void*)decodedFlowId);
+                    assert(status);
+                }
+            }
+
+        } /* foreach popped packet */
 
     }
 
@@ -88,6 +88,7 @@ struct stream_t {
     std::mt19937* randomPtr;
     vector_t* allocVectorPtr;
     queue_t* packetQueuePtr;
+    mpmcqueue_t* packetRingPtr; /* packetQueue, shuffled, for the workers */
     MAP_T* attackMapPtr;
 };
 
@@ -111,6 +112,7 @@ stream_alloc (long percentAttack)
         assert(streamPtr->allocVectorPtr);
         streamPtr->packetQueuePtr = queue_alloc(-1);
         assert(streamPtr->packetQueuePtr);
+        streamPtr->packetRingPtr = NULL;
         streamPtr->attackMapPtr = MAP_ALLOC(NULL, NULL);
         assert(streamPtr->attackMapPtr);
     }
@@ -137,6 +139,9 @@ stream_free (stream_t* streamPtr)
 
     MAP_FREE(streamPtr->attackMapPtr);
     queue_free(streamPtr->packetQueuePtr);
+    if (streamPtr->packetRingPtr != NULL) {
+        mpmcqueue_free(streamPtr->packetRingPtr);
+    }
     vector_free(streamPtr->allocVectorPtr);
     delete streamPtr->randomPtr;
     free(streamPtr);
@@ -267,6 +272,22 @@ stream_generate (stream_t* streamPtr,
 
     queue_shuffle(packetQueuePtr, randomPtr);
 
+    /*
+     * Workers drain a lock-free ring instead of popping the queue inside
+     * transactions that all conflict on the pop index
+     */
+    if (streamPtr->packetRingPtr != NULL) {
+        mpmcqueue_free(streamPtr->packetRingPtr);
+    }
+    mpmcqueue_t* packetRingPtr = mpmcqueue_alloc(queue_getSize(packetQueuePtr));
+    assert(packetRingPtr);
+    void* packetPtr;
+    while ((packetPtr = queue_pop(packetQueuePtr)) != NULL) {
+        bool status = mpmcqueue_push(packetRingPtr, packetPtr);
+        assert(status);
+    }
+    streamPtr->packetRingPtr = packetRingPtr;
+
     detector_free(detectorPtr);
 
     return numAttack;
@@ -279,11 +300,24 @@ stream_generate (stream_t* streamPtr,
  * -- If none, returns NULL
  * =============================================================================
  */
-__attribute__((transaction_safe))
 char*
 stream_getPacket (stream_t* streamPtr)
 {
-    return (char*)TMQUEUE_POP(streamPtr->packetQueuePtr);
+    return (char*)mpmcqueue_pop(streamPtr->packetRingPtr);
+}
+
+
+/* =============================================================================
+ * stream_getPackets
+ * -- Returns number of packets stored in packets; 0 if none
+ * =============================================================================
+ */
+long
+stream_getPackets (stream_t* streamPtr, char** packets, long maxNumPacket)
+{
+    return mpmcqueue_popBatch(streamPtr->packetRingPtr,
+                              (void**)packets,
+                              maxNumPacket);
 }
 
 
@@ -108,13 +108,23 @@ stream_generate (stream_t* streamPtr,
 /* =============================================================================
  * stream_getPacket
  * -- If none, returns NULL
+ * -- Not for use inside transactions
  * =============================================================================
  */
-__attribute__((transaction_safe))
 char*
 stream_getPacket (stream_t* streamPtr);
 
 
+/* =============================================================================
+ * stream_getPackets
+ * -- Returns number of packets stored in packets; 0 if none
+ * -- Not for use inside transactions
+ * =============================================================================
+ */
+long
+stream_getPackets (stream_t* streamPtr, char** packets, long maxNumPacket);
+
+
 /* =============================================================================
  * stream_isAttack
  * =============================================================================
@@ -123,4 +133,3 @@ bool
 stream_isAttack (stream_t* streamPtr, long flowId);
 
 
-#define TMSTREAM_GETPACKET(s)           stream_getPacket( s)
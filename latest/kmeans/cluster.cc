@@ -100,6 +100,8 @@
 #include "normal.h"
 #include "util.h"
 
+int global_warmStart = 0;
+
 
 /* =============================================================================
  * extractMoments
@@ -204,6 +206,16 @@ cluster_exec (
 
         randomPtr->seed(7);
 
+        /* Warm start: grow the previous k's solution by one center */
+        float** seed_clusters = NULL;
+        int nseed_clusters = 0;
+        if (global_warmStart && *cluster_centres && nclusters > min_nclusters) {
+            seed_clusters = *cluster_centres;
+            nseed_clusters = nclusters - 1;
+        }
+
+        double startTime = global_time;
+
         tmp_cluster_centres = normal_exec(nthreads,
                                           attributes,
                                           numAttributes,
@@ -211,7 +223,14 @@ cluster_exec (
                                           nclusters,
                                           threshold,
                                           membership,
-                                          randomPtr);
+                                          randomPtr,
+                                          seed_clusters,
+                                          nseed_clusters);
+
+        if (max_nclusters > min_nclusters) {
+            printf("k = %d: iterations = %d, time = %lg\n",
+                   nclusters, global_numIteration, (global_time - startTime));
+        }
 
         {
             if (*cluster_centres) {
@@ -65,6 +65,8 @@
 
 #pragma once
 
+extern int global_warmStart; /* seed each k from the (k-1) solution */
+
 /* =============================================================================
  * cluster_exec
  * =============================================================================
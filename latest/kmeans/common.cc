@@ -64,8 +64,22 @@
  */
 
 
+#include <assert.h>
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#  include <immintrin.h>
+#endif
 #include "common.h"
 
+typedef void (*common_blockDist_t)(const float* block,
+                                   const float* pt,
+                                   int nfeatures,
+                                   float* dist);
+
+static common_blockDist_t global_blockDist = NULL;
+
 
 /* =============================================================================
  * common_euclidDist2
@@ -118,6 +132,288 @@ common_findNearestPoint (float*  pt,        /* [nfeatures] */
 }
 
 
+/* =============================================================================
+ * blockDistScalar
+ * -- dist[l] = squared distance from pt to lane l of block
+ * =============================================================================
+ */
+static void
+blockDistScalar (const float* __restrict__ block,
+                 const float* __restrict__ pt,
+                 int nfeatures,
+                 float* __restrict__ dist)
+{
+    float acc[COMMON_CENTER_BLOCK];
+    int l;
+    int f;
+
+    for (l = 0; l < COMMON_CENTER_BLOCK; l++) {
+        acc[l] = 0.0F;
+    }
+    for (f = 0; f < nfeatures; f++) {
+        const float* row = &block[f * COMMON_CENTER_BLOCK];
+        float p = pt[f];
+        for (l = 0; l < COMMON_CENTER_BLOCK; l++) {
+            float diff = p - row[l];
+            acc[l] += diff * diff;
+        }
+    }
+    for (l = 0; l < COMMON_CENTER_BLOCK; l++) {
+        dist[l] = acc[l];
+    }
+}
+
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/*
+ * No "fma" in the targets: a fused multiply-add would round differently from
+ * the scalar path and could change memberships.
+ */
+
+/* =============================================================================
+ * blockDistAvx2
+ * =============================================================================
+ */
+__attribute__((target("avx2"), optimize("fp-contract=off")))
+static void
+blockDistAvx2 (const float* block, const float* pt, int nfeatures, float* dist)
+{
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    int f;
+
+    for (f = 0; f < nfeatures; f++) {
+        const float* row = &block[f * COMMON_CENTER_BLOCK];
+        __m256 p = _mm256_broadcast_ss(&pt[f]);
+        __m256 diff0 = _mm256_sub_ps(p, _mm256_load_ps(&row[0]));
+        __m256 diff1 = _mm256_sub_ps(p, _mm256_load_ps(&row[8]));
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(diff0, diff0));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(diff1, diff1));
+    }
+    _mm256_storeu_ps(&dist[0], acc0);
+    _mm256_storeu_ps(&dist[8], acc1);
+}
+
+
+/* =============================================================================
+ * blockDistAvx512
+ * =============================================================================
+ */
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+static void
+blockDistAvx512 (const float* block, const float* pt, int nfeatures, float* dist)
+{
+    __m512 acc = _mm512_setzero_ps();
+    int f;
+
+    for (f = 0; f < nfeatures; f++) {
+        __m512 p = _mm512_set1_ps(pt[f]);
+        __m512 diff = _mm512_sub_ps(p, _mm512_load_ps(&block[f * COMMON_CENTER_BLOCK]));
+        acc = _mm512_add_ps(acc, _mm512_mul_ps(diff, diff));
+    }
+    _mm512_storeu_ps(dist, acc);
+}
+
+#endif /* __x86_64__ || __i386__ */
+
+
+/* =============================================================================
+ * selectKernel
+ * =============================================================================
+ */
+static void
+selectKernel ()
+{
+    if (global_blockDist) {
+        return;
+    }
+    global_blockDist = &blockDistScalar;
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (!getenv("KMEANS_NO_SIMD")) {
+        if (__builtin_cpu_supports("avx512f")) {
+            global_blockDist = &blockDistAvx512;
+        } else if (__builtin_cpu_supports("avx2")) {
+            global_blockDist = &blockDistAvx2;
+        }
+    }
+#endif
+}
+
+
+/* =============================================================================
+ * common_allocCenters
+ * =============================================================================
+ */
+common_centers_t*
+common_allocCenters (int nclusters, int nfeatures)
+{
+    selectKernel();
+
+    common_centers_t* centersPtr =
+        (common_centers_t*)malloc(sizeof(common_centers_t));
+    assert(centersPtr);
+    centersPtr->nclusters = nclusters;
+    centersPtr->nfeatures = nfeatures;
+    centersPtr->numBlock =
+        (nclusters + COMMON_CENTER_BLOCK - 1) / COMMON_CENTER_BLOCK;
+
+    size_t size = (size_t)centersPtr->numBlock * nfeatures *
+                  COMMON_CENTER_BLOCK * sizeof(float);
+    void* blocks = NULL;
+    int status = posix_memalign(&blocks, 64, ((size > 0) ? size : 64));
+    assert(status == 0);
+    /* Padding lanes are computed but never selected */
+    memset(blocks, 0, size);
+    centersPtr->blocks = (float*)blocks;
+
+    return centersPtr;
+}
+
+
+/* =============================================================================
+ * common_packCenters
+ * =============================================================================
+ */
+void
+common_packCenters (common_centers_t* centersPtr, float** clusters)
+{
+    int nfeatures = centersPtr->nfeatures;
+    int i;
+    int f;
+
+    for (i = 0; i < centersPtr->nclusters; i++) {
+        float* block = &centersPtr->blocks[(i / COMMON_CENTER_BLOCK) *
+                                           nfeatures * COMMON_CENTER_BLOCK];
+        int lane = i % COMMON_CENTER_BLOCK;
+        for (f = 0; f < nfeatures; f++) {
+            block[f * COMMON_CENTER_BLOCK + lane] = clusters[i][f];
+        }
+    }
+}
+
+
+/* =============================================================================
+ * common_freeCenters
+ * =============================================================================
+ */
+void
+common_freeCenters (common_centers_t* centersPtr)
+{
+    free(centersPtr->blocks);
+    free(centersPtr);
+}
+
+
+/* =============================================================================
+ * common_findNearestCenter
+ * =============================================================================
+ */
+int
+common_findNearestCenter (const common_centers_t* centersPtr, const float* pt)
+{
+    int nclusters = centersPtr->nclusters;
+    int nfeatures = centersPtr->nfeatures;
+    common_blockDist_t blockDist = global_blockDist;
+    float dist[COMMON_CENTER_BLOCK];
+    int index = -1;
+    float max_dist = FLT_MAX;
+    const float limit = 0.99999;
+    int b;
+
+    for (b = 0; b < centersPtr->numBlock; b++) {
+        blockDist(&centersPtr->blocks[b * nfeatures * COMMON_CENTER_BLOCK],
+                  pt,
+                  nfeatures,
+                  dist);
+        int base = b * COMMON_CENTER_BLOCK;
+        int numLane = nclusters - base;
+        if (numLane > COMMON_CENTER_BLOCK) {
+            numLane = COMMON_CENTER_BLOCK;
+        }
+        int l;
+        for (l = 0; l < numLane; l++) {
+            /*
+             * Same test as common_findNearestPoint; dist >= max_dist already
+             * implies dist / max_dist >= 1, so the divide is skipped then
+             */
+            if ((dist[l] < max_dist) && ((dist[l] / max_dist) < limit)) {
+                max_dist = dist[l];
+                index = base + l;
+                if (max_dist == 0) {
+                    return index;
+                }
+            }
+        }
+    }
+
+    return index;
+}
+
+
+/* =============================================================================
+ * common_findNearestCenterBounds
+ * =============================================================================
+ */
+int
+common_findNearestCenterBounds (const common_centers_t* centersPtr,
+                                const float* pt,
+                                float* nearestDistPtr,
+                                float* otherDistPtr)
+{
+    int nclusters = centersPtr->nclusters;
+    int nfeatures = centersPtr->nfeatures;
+    common_blockDist_t blockDist = global_blockDist;
+    float dist[COMMON_CENTER_BLOCK];
+    int index = -1;
+    float max_dist = FLT_MAX;
+    const float limit = 0.99999;
+    float min1 = FLT_MAX; /* two smallest distances, any centre */
+    float min2 = FLT_MAX;
+    int min1Index = -1;
+    int b;
+
+    for (b = 0; b < centersPtr->numBlock; b++) {
+        blockDist(&centersPtr->blocks[b * nfeatures * COMMON_CENTER_BLOCK],
+                  pt,
+                  nfeatures,
+                  dist);
+        int base = b * COMMON_CENTER_BLOCK;
+        int numLane = nclusters - base;
+        if (numLane > COMMON_CENTER_BLOCK) {
+            numLane = COMMON_CENTER_BLOCK;
+        }
+        int l;
+        for (l = 0; l < numLane; l++) {
+            float d = dist[l];
+            if (d < min1) {
+                min2 = min1;
+                min1 = d;
+                min1Index = base + l;
+            } else if (d < min2) {
+                min2 = d;
+            }
+            if ((d < max_dist) && ((d / max_dist) < limit)) {
+                max_dist = d;
+                index = base + l;
+                if (max_dist == 0) {
+                    /* Remaining centres unseen: no usable lower bound */
+                    *nearestDistPtr = 0.0F;
+                    *otherDistPtr = 0.0F;
+                    return index;
+                }
+            }
+        }
+    }
+
+    *nearestDistPtr = max_dist;
+    *otherDistPtr = ((min1Index == index) ? min2 : min1);
+
+    return index;
+}
+
+
 /* =============================================================================
  *
  * End of common.c
@@ -88,3 +88,71 @@ common_findNearestPoint (float*  pt,        /* [nfeatures] */
                          int     nfeatures,
                          float** pts,       /* [npts][nfeatures] */
                          int     npts);
+
+
+/*
+ * Cluster centres packed for the assignment kernel: COMMON_CENTER_BLOCK
+ * centres are interleaved feature by feature ([block][feature][lane]) in
+ * 64-byte aligned storage, so one pass over a point's features yields its
+ * distances to a whole block. The block kernel (AVX-512F, AVX2 or scalar)
+ * is chosen at run time. Each lane accumulates in feature order with
+ * separate multiply and add, so distances, and hence memberships, are
+ * bit-identical to common_euclidDist2/common_findNearestPoint. Setting
+ * KMEANS_NO_SIMD in the environment forces the scalar kernel.
+ */
+#define COMMON_CENTER_BLOCK (16)
+
+typedef struct common_centers {
+    float* blocks;   /* [numBlock][nfeatures][COMMON_CENTER_BLOCK] */
+    int    nclusters;
+    int    nfeatures;
+    int    numBlock;
+} common_centers_t;
+
+
+/* =============================================================================
+ * common_allocCenters
+ * =============================================================================
+ */
+common_centers_t*
+common_allocCenters (int nclusters, int nfeatures);
+
+
+/* =============================================================================
+ * common_packCenters
+ * -- Copies clusters[nclusters][nfeatures] into the packed layout
+ * =============================================================================
+ */
+void
+common_packCenters (common_centers_t* centersPtr, float** clusters);
+
+
+/* =============================================================================
+ * common_freeCenters
+ * =============================================================================
+ */
+void
+common_freeCenters (common_centers_t* centersPtr);
+
+
+/* =============================================================================
+ * common_findNearestCenter
+ * -- Same result as common_findNearestPoint on the unpacked centres
+ * =============================================================================
+ */
+int
+common_findNearestCenter (const common_centers_t* centersPtr, const float* pt);
+
+
+/* =============================================================================
+ * common_findNearestCenterBounds
+ * -- As common_findNearestCenter; also returns the squared distance to the
+ *    chosen centre and the smallest squared distance to any other centre
+ * =============================================================================
+ */
+int
+common_findNearestCenterBounds (const common_centers_t* centersPtr,
+                                const float* pt,
+                                float* nearestDistPtr,
+                                float* otherDistPtr);
+
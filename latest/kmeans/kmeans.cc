@@ -10,6 +10,8 @@
  *   ascii  file: containing 1 data point per line
  *   binary file: first int is the number of objects
  *                2nd int is the no. of features of each object
+ *   cache  file: (-c) written after the first ascii parse and reused while
+ *                the ascii file's size and mtime match; see loader.h
  *
  * This example performs a fuzzy c-means clustering on the data. Fuzzy clustering
  * is performed using min to max clusters and the clustering that gets the best
@@ -106,12 +108,10 @@
 #include "cluster.h"
 #include "normal.h"
 #include "common.h"
+#include "loader.h"
 #include "thread.h"
 #include "util.h"
 
-#define MAX_LINE_LENGTH 1000000 /* max input is 400000 one digit input + spaces */
-
-
 /* =============================================================================
  * usage
  * =============================================================================
@@ -123,10 +123,13 @@ usage (char* argv0)
         "Usage: %s [switches] -i filename\n"
         "       -i filename:     file containing data to be clustered\n"
         "       -b               input file is in binary format\n"
+        "       -c cachefile:    reuse (or create) a binary cache of the input\n"
         "       -m max_clusters: maximum number of clusters allowed\n"
         "       -n min_clusters: minimum number of clusters allowed\n"
         "       -z             : don't zscore transform data\n"
         "       -T threshold   : threshold value\n"
+        "       -H             : prune distance computations with bounds\n"
+        "       -W             : warm-start each k from the k-1 centres\n"
         "       -t nproc       : number of threads\n";
     fprintf(stderr, help, argv0);
     exit(-1);
@@ -146,29 +149,28 @@ int main (int argc, char** argv)
     float** attributes;
     float** cluster_centres = NULL;
     int     i;
-    int     j;
     int     best_nclusters;
     int*    cluster_assign;
     int     numAttributes;
     int     numObjects;
     int     use_zscore_transform = 1;
-    char*   line;
     int     isBinaryFile = 0;
+    const char* cacheName = NULL;
     int     nloops;
     /* int     len; */
     int     nthreads;
     float   threshold = 0.00001;
     int     opt;
 
-    line = (char*)malloc(MAX_LINE_LENGTH); /* reserve memory line */
-
     nthreads = 1;
-    while ((opt = getopt(argc,(char**)argv,"t:i:m:n:T:bzL")) != EOF) {
+    while ((opt = getopt(argc,(char**)argv,"t:i:m:n:T:c:bzLHW")) != EOF) {
         switch (opt) {
             case 'i': filename = optarg;
                       break;
             case 'b': isBinaryFile = 1;
                       break;
+            case 'c': cacheName = optarg;
+                      break;
             case 'T': threshold = atof(optarg);
                       break;
             case 'm': max_nclusters = atoi(optarg);
@@ -179,6 +181,10 @@ int main (int argc, char** argv)
                       break;
             case 'L': max_nclusters = min_nclusters = 40;
                       break;
+            case 'H': global_useBounds = 1;
+                      break;
+            case 'W': global_warmStart = 1;
+                      break;
             case 't': nthreads = atoi(optarg);
                       break;
             case '?': usage((char*)argv[0]);
@@ -200,78 +206,37 @@ int main (int argc, char** argv)
     numAttributes = 0;
     numObjects = 0;
 
-    /*
-     * From the input file, get the numAttributes and numObjects
-     */
-    if (isBinaryFile) {
-        int infile;
-        if ((infile = open(filename, O_RDONLY, "0600")) == -1) {
-            fprintf(stderr, "Error: no such file (%s)\n", filename);
-            exit(1);
-        }
-        read(infile, &numObjects, sizeof(int));
-        read(infile, &numAttributes, sizeof(int));
+    /* The text loader parses on the thread pool */
+    thread_startup(nthreads);
 
-        /* Allocate space for attributes[] and read attributes of all objects */
-        buf = (float*)malloc(numObjects * numAttributes * sizeof(float));
-        assert(buf);
-        attributes = (float**)malloc(numObjects * sizeof(float*));
-        assert(attributes);
-        attributes[0] = (float*)malloc(numObjects * numAttributes * sizeof(float));
-        assert(attributes[0]);
-        for (i = 1; i < numObjects; i++) {
-            attributes[i] = attributes[i-1] + numAttributes;
-        }
-        read(infile, buf, (numObjects * numAttributes * sizeof(float)));
-        close(infile);
+    buf = NULL;
+    if (isBinaryFile) {
+        buf = loader_readBinary(filename, &numObjects, &numAttributes);
     } else {
-        FILE *infile;
-        if ((infile = fopen(filename, "r")) == NULL) {
-            fprintf(stderr, "Error: no such file (%s)\n", filename);
-            exit(1);
+        if (cacheName) {
+            buf = loader_readCache(cacheName, filename,
+                                   &numObjects, &numAttributes);
         }
-        while (fgets(line, MAX_LINE_LENGTH, infile) != NULL) {
-            if (strtok(line, " \t\n") != 0) {
-                numObjects++;
+        if (buf == NULL) {
+            buf = loader_readText(filename, &numObjects, &numAttributes);
+            if (buf && cacheName) {
+                loader_writeCache(cacheName, filename,
+                                  buf, numObjects, numAttributes);
             }
         }
-        rewind(infile);
-        while (fgets(line, MAX_LINE_LENGTH, infile) != NULL) {
-            if (strtok(line, " \t\n") != 0) {
-                /* Ignore the id (first attribute): numAttributes = 1; */
-                while (strtok(NULL, " ,\t\n") != NULL) {
-                    numAttributes++;
-                }
-                break;
-            }
-        }
-
-        /* Allocate space for attributes[] and read attributes of all objects */
-        buf = (float*)malloc(numObjects * numAttributes * sizeof(float));
-        assert(buf);
-        attributes = (float**)malloc(numObjects * sizeof(float*));
-        assert(attributes);
-        attributes[0] = (float*)malloc(numObjects * numAttributes * sizeof(float));
-        assert(attributes[0]);
-        for (i = 1; i < numObjects; i++) {
-            attributes[i] = attributes[i-1] + numAttributes;
-        }
-        rewind(infile);
-        i = 0;
-        while (fgets(line, MAX_LINE_LENGTH, infile) != NULL) {
-            if (strtok(line, " \t\n") == NULL) {
-                continue;
-            }
-            for (j = 0; j < numAttributes; j++) {
-                buf[i] = atof(strtok(NULL, " ,\t\n"));
-                i++;
-            }
-        }
-        fclose(infile);
     }
-    free(line);
+    if (buf == NULL) {
+        exit(1);
+    }
 
-    thread_startup(nthreads);
+    /* Allocate space for attributes[] */
+    attributes = (float**)malloc(numObjects * sizeof(float*));
+    assert(attributes);
+    attributes[0] = (float*)malloc(numObjects * numAttributes * sizeof(float));
+    assert(attributes[0]);
+    for (i = 1; i < numObjects; i++) {
+        attributes[i] = attributes[i-1] + numAttributes;
+    }
 
     /*
      * The core of the clustering
@@ -331,6 +296,7 @@ int main (int argc, char** argv)
         FILE* cluster_centre_file;
         FILE* clustering_file;
         char outFileName[1024];
+        int j;
 
         sprintf(outFileName, "%s.cluster_centres", filename);
         cluster_centre_file = fopen(outFileName, "w");
@@ -355,6 +321,8 @@ int main (int argc, char** argv)
 
 #ifdef OUTPUT_TO_STDOUT
     {
+        int j;
+
         /* Output: the coordinates of the cluster centres */
         for (i = 0; i < best_nclusters; i++) {
             printf("%d ", i);
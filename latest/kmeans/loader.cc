@@ -0,0 +1,753 @@
+/* =============================================================================
+ *
+ * loader.cc
+ * -- Parallel text loader and binary cache for kmeans inputs
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "loader.h"
+#include "thread.h"
+
+#define LOADER_CACHE_MAGIC   (0x4b4d4e43) /* "CNMK" */
+#define LOADER_CACHE_VERSION (1)
+
+typedef struct loader_cacheHeader {
+    unsigned int       magic;
+    unsigned int       version;
+    int                numObjects;
+    int                numAttributes;
+    long long          sourceSize;
+    long long          sourceMtime;
+    unsigned long long checksum;
+} loader_cacheHeader_t;
+
+typedef struct loader_chunk {
+    const char* start;
+    const char* stop;
+    long        numLine;   /* non-blank lines in [start, stop) */
+    long        firstRow;
+    const char* badLine;   /* first line with too few attributes */
+} loader_chunk_t;
+
+typedef struct loader_args {
+    loader_chunk_t* chunks;
+    int             numAttributes;
+    float*          buf;
+} loader_args_t;
+
+/* Every power of ten up to 1e22 is exact in a double */
+static const double global_pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+
+/* =============================================================================
+ * isIdDelim, isAttrDelim
+ * -- Same separators the strtok-based reader used
+ * =============================================================================
+ */
+static inline bool
+isIdDelim (char c)
+{
+    return (c == ' ' || c == '\t' || c == '\n');
+}
+
+static inline bool
+isAttrDelim (char c)
+{
+    return (isIdDelim(c) || c == ',');
+}
+
+
+/* =============================================================================
+ * isBlank
+ * =============================================================================
+ */
+static bool
+isBlank (const char* p, const char* eol)
+{
+    for (; p < eol; p++) {
+        if (!isIdDelim(*p)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/* =============================================================================
+ * parseFloatSlow
+ * -- strtod on a NUL-terminated copy; the token may end at the mapping's edge
+ * =============================================================================
+ */
+static float
+parseFloatSlow (const char* p, const char* q)
+{
+    char tmp[128];
+    size_t len = q - p;
+
+    if (len >= sizeof(tmp)) {
+        len = sizeof(tmp) - 1;
+    }
+    memcpy(tmp, p, len);
+    tmp[len] = '\0';
+
+    return (float)strtod(tmp, NULL);
+}
+
+
+/* =============================================================================
+ * parseFloat
+ * -- Clinger's fast path: up to 19 significant digits and a power of ten that
+ *    is exact in a double give the correctly rounded double, so the result
+ *    matches (float)atof(); anything else goes to strtod
+ * =============================================================================
+ */
+static float
+parseFloat (const char* p, const char* q)
+{
+    const char* s = p;
+    bool isNegative = false;
+    unsigned long long mantissa = 0;
+    int numDigit = 0;
+    int exp10 = 0;
+    bool hasDigit = false;
+
+    if (s < q && (*s == '-' || *s == '+')) {
+        isNegative = (*s == '-');
+        s++;
+    }
+    for (; s < q && *s >= '0' && *s <= '9'; s++) {
+        hasDigit = true;
+        if (mantissa == 0 && *s == '0') {
+            continue;
+        }
+        if (numDigit == 19) {
+            return parseFloatSlow(p, q);
+        }
+        mantissa = mantissa * 10 + (*s - '0');
+        numDigit++;
+    }
+    if (s < q && *s == '.') {
+        for (s++; s < q && *s >= '0' && *s <= '9'; s++) {
+            hasDigit = true;
+            if (mantissa == 0 && *s == '0') {
+                exp10--;
+                continue;
+            }
+            if (numDigit == 19) {
+                return parseFloatSlow(p, q);
+            }
+            mantissa = mantissa * 10 + (*s - '0');
+            numDigit++;
+            exp10--;
+        }
+    }
+    if (!hasDigit) {
+        return parseFloatSlow(p, q);
+    }
+    if (s < q && (*s == 'e' || *s == 'E')) {
+        int sign = 1;
+        int e = 0;
+        s++;
+        if (s < q && (*s == '-' || *s == '+')) {
+            sign = ((*s == '-') ? -1 : 1);
+            s++;
+        }
+        if (s == q || *s < '0' || *s > '9') {
+            return parseFloatSlow(p, q);
+        }
+        for (; s < q && *s >= '0' && *s <= '9'; s++) {
+            if (e < 10000) {
+                e = e * 10 + (*s - '0');
+            }
+        }
+        exp10 += sign * e;
+    }
+    if (s != q) {
+        return parseFloatSlow(p, q);
+    }
+
+    if (mantissa == 0) {
+        return (isNegative ? -0.0F : 0.0F);
+    }
+    if ((mantissa >> 53) != 0 || exp10 < -22 || exp10 > 22) {
+        return parseFloatSlow(p, q);
+    }
+
+    double value = (double)mantissa;
+    if (exp10 < 0) {
+        value /= global_pow10[-exp10];
+    } else {
+        value *= global_pow10[exp10];
+    }
+
+    return (float)(isNegative ? -value : value);
+}
+
+
+/* =============================================================================
+ * nextLine
+ * =============================================================================
+ */
+static inline const char*
+nextLine (const char* p, const char* stop)
+{
+    const char* eol = (const char*)memchr(p, '\n', stop - p);
+    return ((eol == NULL) ? stop : eol);
+}
+
+
+/* =============================================================================
+ * parseLine
+ * -- Skips the id, then reads numAttributes values; returns false if short
+ * =============================================================================
+ */
+static bool
+parseLine (const char* p, const char* eol, int numAttributes, float* out)
+{
+    int j;
+
+    while (p < eol && isIdDelim(*p)) {
+        p++;
+    }
+    while (p < eol && !isIdDelim(*p)) {
+        p++;
+    }
+    for (j = 0; j < numAttributes; j++) {
+        while (p < eol && isAttrDelim(*p)) {
+            p++;
+        }
+        if (p == eol) {
+            return false;
+        }
+        const char* q = p;
+        while (q < eol && !isAttrDelim(*q)) {
+            q++;
+        }
+        out[j] = parseFloat(p, q);
+        p = q;
+    }
+
+    return true;
+}
+
+
+/* =============================================================================
+ * countAttributes
+ * -- Tokens after the id on the first non-blank line
+ * =============================================================================
+ */
+static int
+countAttributes (const char* p, const char* stop)
+{
+    while (p < stop) {
+        const char* eol = nextLine(p, stop);
+        if (!isBlank(p, eol)) {
+            int numAttributes = 0;
+            while (p < eol && isIdDelim(*p)) {
+                p++;
+            }
+            while (p < eol && !isIdDelim(*p)) {
+                p++;
+            }
+            while (1) {
+                while (p < eol && isAttrDelim(*p)) {
+                    p++;
+                }
+                if (p == eol) {
+                    break;
+                }
+                while (p < eol && !isAttrDelim(*p)) {
+                    p++;
+                }
+                numAttributes++;
+            }
+            return numAttributes;
+        }
+        p = eol + 1;
+    }
+
+    return 0;
+}
+
+
+/* =============================================================================
+ * countLines
+ * -- One chunk per thread
+ * =============================================================================
+ */
+static void
+countLines (void* argPtr)
+{
+    loader_args_t* argsPtr = (loader_args_t*)argPtr;
+    loader_chunk_t* chunkPtr = &argsPtr->chunks[thread_getId()];
+    const char* p = chunkPtr->start;
+    const char* stop = chunkPtr->stop;
+    long numLine = 0;
+
+    while (p < stop) {
+        const char* eol = nextLine(p, stop);
+        if (!isBlank(p, eol)) {
+            numLine++;
+        }
+        p = eol + 1;
+    }
+
+    chunkPtr->numLine = numLine;
+}
+
+
+/* =============================================================================
+ * parseLines
+ * -- One chunk per thread; rows start at the chunk's prefix-summed offset
+ * =============================================================================
+ */
+static void
+parseLines (void* argPtr)
+{
+    loader_args_t* argsPtr = (loader_args_t*)argPtr;
+    loader_chunk_t* chunkPtr = &argsPtr->chunks[thread_getId()];
+    int numAttributes = argsPtr->numAttributes;
+    const char* p = chunkPtr->start;
+    const char* stop = chunkPtr->stop;
+    float* out = argsPtr->buf + (size_t)chunkPtr->firstRow * numAttributes;
+
+    while (p < stop) {
+        const char* eol = nextLine(p, stop);
+        if (!isBlank(p, eol)) {
+            if (!parseLine(p, eol, numAttributes, out)) {
+                chunkPtr->badLine = p;
+                return;
+            }
+            out += numAttributes;
+        }
+        p = eol + 1;
+    }
+}
+
+
+/* =============================================================================
+ * loader_readText
+ * -- Returns malloc'd [numObjects][numAttributes] buffer, NULL on failure
+ * =============================================================================
+ */
+float*
+loader_readText (const char* filename, int* numObjectsPtr, int* numAttributesPtr)
+{
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1) {
+        fprintf(stderr, "Error: no such file (%s)\n", filename);
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        fprintf(stderr, "Error: empty input (%s)\n", filename);
+        close(fd);
+        return NULL;
+    }
+    size_t size = (size_t)st.st_size;
+    const char* data =
+        (const char*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == (const char*)MAP_FAILED) {
+        fprintf(stderr, "Error: cannot map %s (%s)\n", filename, strerror(errno));
+        return NULL;
+    }
+    madvise((void*)data, size, MADV_SEQUENTIAL);
+
+    const char* stop = data + size;
+    int numAttributes = countAttributes(data, stop);
+    if (numAttributes == 0) {
+        fprintf(stderr, "Error: no attributes in %s\n", filename);
+        munmap((void*)data, size);
+        return NULL;
+    }
+
+    /* Cut the file into one line-aligned chunk per thread */
+    long numThread = thread_getNumThread();
+    loader_chunk_t* chunks =
+        (loader_chunk_t*)malloc(numThread * sizeof(loader_chunk_t));
+    assert(chunks);
+    const char* p = data;
+    long t;
+    for (t = 0; t < numThread; t++) {
+        const char* q = data + (size_t)((double)size * (t + 1) / numThread);
+        if (t == numThread - 1 || q >= stop) {
+            q = stop;
+        } else if (q < p) {
+            q = p;
+        } else {
+            q = nextLine(q, stop);
+            q = ((q < stop) ? (q + 1) : stop);
+        }
+        chunks[t].start   = p;
+        chunks[t].stop    = q;
+        chunks[t].numLine = 0;
+        chunks[t].badLine = NULL;
+        p = q;
+    }
+
+    loader_args_t args;
+    args.chunks        = chunks;
+    args.numAttributes = numAttributes;
+    args.buf           = NULL;
+    thread_start(countLines, (void*)&args);
+
+    long numObject = 0;
+    for (t = 0; t < numThread; t++) {
+        chunks[t].firstRow = numObject;
+        numObject += chunks[t].numLine;
+    }
+    if ((double)numObject * numAttributes > 2147483647.0) {
+        fprintf(stderr, "Error: %s is too large\n", filename);
+        free(chunks);
+        munmap((void*)data, size);
+        return NULL;
+    }
+
+    args.buf = (float*)malloc((size_t)numObject * numAttributes * sizeof(float));
+    assert(args.buf);
+    thread_start(parseLines, (void*)&args);
+
+    float* buf = args.buf;
+    for (t = 0; t < numThread; t++) {
+        if (chunks[t].badLine) {
+            fprintf(stderr,
+                    "Error: %s: line at byte %ld has fewer than %d attributes\n",
+                    filename, (long)(chunks[t].badLine - data), numAttributes);
+            free(buf);
+            buf = NULL;
+            break;
+        }
+    }
+
+    free(chunks);
+    munmap((void*)data, size);
+
+    *numObjectsPtr = (int)numObject;
+    *numAttributesPtr = numAttributes;
+
+    return buf;
+}
+
+
+/* =============================================================================
+ * readAll
+ * =============================================================================
+ */
+static bool
+readAll (int fd, void* dst, size_t size)
+{
+    char* p = (char*)dst;
+
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+
+    return true;
+}
+
+
+/* =============================================================================
+ * writeAll
+ * =============================================================================
+ */
+static bool
+writeAll (int fd, const void* src, size_t size)
+{
+    const char* p = (const char*)src;
+
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+
+    return true;
+}
+
+
+/* =============================================================================
+ * loader_readBinary
+ * -- Returns malloc'd buffer, NULL on failure
+ * =============================================================================
+ */
+float*
+loader_readBinary (const char* filename, int* numObjectsPtr, int* numAttributesPtr)
+{
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1) {
+        fprintf(stderr, "Error: no such file (%s)\n", filename);
+        return NULL;
+    }
+
+    int numObjects;
+    int numAttributes;
+    struct stat st;
+    if (!readAll(fd, &numObjects, sizeof(int)) ||
+        !readAll(fd, &numAttributes, sizeof(int)) ||
+        fstat(fd, &st) != 0 ||
+        numObjects <= 0 ||
+        numAttributes <= 0 ||
+        (long long)st.st_size !=
+            (long long)(2 * sizeof(int)) +
+            (long long)numObjects * numAttributes * (long long)sizeof(float))
+    {
+        fprintf(stderr, "Error: malformed binary input (%s)\n", filename);
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = (size_t)numObjects * numAttributes * sizeof(float);
+    float* buf = (float*)malloc(size);
+    assert(buf);
+    if (!readAll(fd, buf, size)) {
+        fprintf(stderr, "Error: short read (%s)\n", filename);
+        free(buf);
+        buf = NULL;
+    }
+    close(fd);
+
+    *numObjectsPtr = numObjects;
+    *numAttributesPtr = numAttributes;
+
+    return buf;
+}
+
+
+/* =============================================================================
+ * computeChecksum
+ * -- Fletcher-64 over 32-bit words
+ * =============================================================================
+ */
+static unsigned long long
+computeChecksum (const float* buf, size_t numWord)
+{
+    const unsigned int* words = (const unsigned int*)buf;
+    unsigned long long a = 0;
+    unsigned long long b = 0;
+    size_t i = 0;
+
+    /* 16384 words cannot overflow b before the modular reduction */
+    while (i < numWord) {
+        size_t stop = (((numWord - i) > 16384) ? (i + 16384) : numWord);
+        for (; i < stop; i++) {
+            a += words[i];
+            b += a;
+        }
+        a %= 0xffffffffULL;
+        b %= 0xffffffffULL;
+    }
+
+    return ((b << 32) | a);
+}
+
+
+/* =============================================================================
+ * loader_readCache
+ * -- Returns NULL if the cache is missing, corrupt, or older than sourceName
+ * =============================================================================
+ */
+float*
+loader_readCache (const char* cacheName,
+                  const char* sourceName,
+                  int* numObjectsPtr,
+                  int* numAttributesPtr)
+{
+    struct stat sourceStat;
+    if (stat(sourceName, &sourceStat) != 0) {
+        return NULL;
+    }
+
+    int fd = open(cacheName, O_RDONLY);
+    if (fd == -1) {
+        return NULL;
+    }
+
+    loader_cacheHeader_t header;
+    struct stat st;
+    if (!readAll(fd, &header, sizeof(header)) ||
+        fstat(fd, &st) != 0 ||
+        header.magic != LOADER_CACHE_MAGIC ||
+        header.version != LOADER_CACHE_VERSION ||
+        header.numObjects <= 0 ||
+        header.numAttributes <= 0 ||
+        header.sourceSize != (long long)sourceStat.st_size ||
+        header.sourceMtime != (long long)sourceStat.st_mtime ||
+        (long long)st.st_size !=
+            (long long)sizeof(header) +
+            (long long)header.numObjects * header.numAttributes *
+            (long long)sizeof(float))
+    {
+        close(fd);
+        return NULL;
+    }
+
+    size_t numWord = (size_t)header.numObjects * header.numAttributes;
+    float* buf = (float*)malloc(numWord * sizeof(float));
+    assert(buf);
+    if (!readAll(fd, buf, numWord * sizeof(float)) ||
+        computeChecksum(buf, numWord) != header.checksum)
+    {
+        fprintf(stderr, "Warning: ignoring corrupt cache %s\n", cacheName);
+        free(buf);
+        close(fd);
+        return NULL;
+    }
+    close(fd);
+
+    *numObjectsPtr = header.numObjects;
+    *numAttributesPtr = header.numAttributes;
+
+    return buf;
+}
+
+
+/* =============================================================================
+ * loader_writeCache
+ * -- Returns false on failure; an existing cache is replaced atomically
+ * =============================================================================
+ */
+bool
+loader_writeCache (const char* cacheName,
+                   const char* sourceName,
+                   const float* buf,
+                   int numObjects,
+                   int numAttributes)
+{
+    struct stat sourceStat;
+    if (stat(sourceName, &sourceStat) != 0) {
+        return false;
+    }
+
+    loader_cacheHeader_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic         = LOADER_CACHE_MAGIC;
+    header.version       = LOADER_CACHE_VERSION;
+    header.numObjects    = numObjects;
+    header.numAttributes = numAttributes;
+    header.sourceSize    = (long long)sourceStat.st_size;
+    header.sourceMtime   = (long long)sourceStat.st_mtime;
+    header.checksum      = computeChecksum(buf, (size_t)numObjects * numAttributes);
+
+    size_t len = strlen(cacheName);
+    char* tmpName = (char*)malloc(len + 5);
+    assert(tmpName);
+    memcpy(tmpName, cacheName, len);
+    memcpy(tmpName + len, ".tmp", 5);
+
+    bool status = false;
+    int fd = open(tmpName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd != -1) {
+        status =
+            writeAll(fd, &header, sizeof(header)) &&
+            writeAll(fd, buf, (size_t)numObjects * numAttributes * sizeof(float));
+        status = (close(fd) == 0) && status;
+        if (status) {
+            status = (rename(tmpName, cacheName) == 0);
+        }
+        if (!status) {
+            unlink(tmpName);
+        }
+    }
+    if (!status) {
+        fprintf(stderr, "Warning: cannot write cache %s\n", cacheName);
+    }
+    free(tmpName);
+
+    return status;
+}
+
+
+/* =============================================================================
+ *
+ * End of loader.cc
+ *
+ * =============================================================================
+ */
@@ -0,0 +1,121 @@
+/* =============================================================================
+ *
+ * loader.h
+ * -- Parallel text loader and binary cache for kmeans inputs
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+#pragma once
+
+
+/* =============================================================================
+ * loader_readText
+ * -- Parses "id attr attr ..." lines in parallel over the thread pool
+ * -- Requires thread_startup()
+ * -- Returns malloc'd [numObjects][numAttributes] buffer, NULL on failure
+ * =============================================================================
+ */
+float*
+loader_readText (const char* filename, int* numObjectsPtr, int* numAttributesPtr);
+
+
+/* =============================================================================
+ * loader_readBinary
+ * -- Reads the raw -b format: int numObjects, int numAttributes, floats
+ * -- Returns malloc'd buffer, NULL on failure
+ * =============================================================================
+ */
+float*
+loader_readBinary (const char* filename, int* numObjectsPtr, int* numAttributesPtr);
+
+
+/* =============================================================================
+ * loader_readCache
+ * -- Returns NULL if the cache is missing, corrupt, or older than sourceName
+ * =============================================================================
+ */
+float*
+loader_readCache (const char* cacheName,
+                  const char* sourceName,
+                  int* numObjectsPtr,
+                  int* numAttributesPtr);
+
+
+/* =============================================================================
+ * loader_writeCache
+ * -- Returns false on failure; an existing cache is replaced atomically
+ * =============================================================================
+ */
+bool
+loader_writeCache (const char* cacheName,
+                   const char* sourceName,
+                   const float* buf,
+                   int numObjects,
+                   int numAttributes);
+
+
+/* =============================================================================
+ *
+ * End of loader.h
+ *
+ * =============================================================================
+ */
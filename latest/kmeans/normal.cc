@@ -89,11 +89,14 @@
 #include <math.h>
 #include "common.h"
 #include "normal.h"
+#include "parallel.h"
 #include "thread.h"
 #include "timer.h"
 #include "util.h"
 
 double global_time = 0.0;
+int global_numIteration = 0;
+int global_useBounds = 0;
 
 typedef struct args {
     float** feature;
@@ -101,9 +104,18 @@ typedef struct args {
     int     npoints;
     int     nclusters;
     int*    membership;
-    float** clusters;
+    common_centers_t* centers;
     long**   new_centers_len;
     float** new_centers;
+    /* Hamerly bounds (NULL unless global_useBounds) */
+    float** clusters;
+    double* upper;          /* [npoints]: >= distance to assigned centre */
+    double* lower;          /* [npoints]: <= distance to any other centre */
+    double* drift;          /* [nclusters]: distance moved last iteration */
+    double* separation;     /* [nclusters]: distance to nearest other centre */
+    double  maxDrift;
+    double  secondMaxDrift;
+    int     maxDriftIndex;
 } args_t;
 
 float global_delta;
@@ -111,6 +123,128 @@ long global_i; /* index into task queue */
 
 #define CHUNK 3
 
+/*
+ * A point keeps its centre only if every other centre is farther by more
+ * than this factor, which covers the 0.99999 tie limit in the assignment
+ * kernel so bounded and exhaustive runs pick the same centres. BOUND_SLACK
+ * widens the bounds to absorb single-precision rounding in the kernel.
+ */
+#define BOUND_RATIO (1.0001)
+#define BOUND_SLACK (1e-5)
+
+
+/* =============================================================================
+ * assignWithBounds
+ * -- Hamerly's single lower bound: skips the kernel when the assigned centre
+ *    is provably still the nearest
+ * =============================================================================
+ */
+static int
+assignWithBounds (args_t* args, int i)
+{
+    float* pt = args->feature[i];
+    int a = args->membership[i];
+    float nearestDist;
+    float otherDist;
+    int index;
+
+    if (a >= 0) {
+        double u = args->upper[i] + args->drift[a];
+        double l = args->lower[i] -
+                   ((a == args->maxDriftIndex) ?
+                    args->secondMaxDrift : args->maxDrift);
+        double z = args->separation[a] - u;
+        if (l > z) {
+            z = l;
+        }
+        if (u * BOUND_RATIO >= z) {
+            /* Tighten the upper bound and try again */
+            u = sqrt((double)common_euclidDist2(pt,
+                                                args->clusters[a],
+                                                args->nfeatures)) *
+                (1.0 + BOUND_SLACK);
+            z = args->separation[a] - u;
+            if (l > z) {
+                z = l;
+            }
+        }
+        args->upper[i] = u;
+        args->lower[i] = l;
+        if (u * BOUND_RATIO < z) {
+            return a;
+        }
+    }
+
+    index = common_findNearestCenterBounds(args->centers,
+                                           pt,
+                                           &nearestDist,
+                                           &otherDist);
+    args->upper[i] = sqrt((double)nearestDist) * (1.0 + BOUND_SLACK);
+    args->lower[i] = sqrt((double)otherDist) * (1.0 - BOUND_SLACK);
+
+    return index;
+}
+
+
+/* =============================================================================
+ * updateBounds
+ * -- Records how far each centre moved and how far apart the centres are
+ * =============================================================================
+ */
+static void
+updateBounds (args_t* args, float** old_clusters)
+{
+    float** clusters = args->clusters;
+    int nclusters = args->nclusters;
+    int nfeatures = args->nfeatures;
+    int i;
+    int j;
+    int k;
+
+    args->maxDrift = 0.0;
+    args->secondMaxDrift = 0.0;
+    args->maxDriftIndex = -1;
+
+    for (i = 0; i < nclusters; i++) {
+        double sum = 0.0;
+        if (old_clusters) {
+            for (k = 0; k < nfeatures; k++) {
+                double diff = (double)clusters[i][k] - (double)old_clusters[i][k];
+                sum += diff * diff;
+            }
+        }
+        double d = sqrt(sum) * (1.0 + BOUND_SLACK);
+        args->drift[i] = d;
+        if (d > args->maxDrift) {
+            args->secondMaxDrift = args->maxDrift;
+            args->maxDrift = d;
+            args->maxDriftIndex = i;
+        } else if (d > args->secondMaxDrift) {
+            args->secondMaxDrift = d;
+        }
+    }
+
+    for (i = 0; i < nclusters; i++) {
+        args->separation[i] = DBL_MAX;
+    }
+    for (i = 0; i < nclusters; i++) {
+        for (j = i + 1; j < nclusters; j++) {
+            double sum = 0.0;
+            for (k = 0; k < nfeatures; k++) {
+                double diff = (double)clusters[i][k] - (double)clusters[j][k];
+                sum += diff * diff;
+            }
+            double d = sqrt(sum) * (1.0 - BOUND_SLACK);
+            if (d < args->separation[i]) {
+                args->separation[i] = d;
+            }
+            if (d < args->separation[j]) {
+                args->separation[j] = d;
+            }
+        }
+    }
+}
+
 
 /* =============================================================================
  * work
@@ -123,9 +257,8 @@ work (void* argPtr)
     float** feature         = args->feature;
     int     nfeatures       = args->nfeatures;
     int     npoints         = args->npoints;
-    int     nclusters       = args->nclusters;
     int*    membership      = args->membership;
-    float** clusters        = args->clusters;
+    common_centers_t* centers = args->centers;
     long**  new_centers_len = args->new_centers_len;
     float** new_centers     = args->new_centers;
     float delta = 0.0;
@@ -144,10 +277,11 @@ work (void* argPtr)
         stop = (((start + CHUNK) < npoints) ? (start + CHUNK) : npoints);
         for (i = start; i < stop; i++) {
 
-            index = common_findNearestPoint(feature[i],
-                                            nfeatures,
-                                            clusters,
-                                            nclusters);
+            if (args->upper) {
+                index = assignWithBounds(args, i);
+            } else {
+                index = common_findNearestCenter(centers, feature[i]);
+            }
             /*
              * If membership changes, increase delta by 1.
              * membership[i] cannot be changed by other threads
@@ -182,11 +316,80 @@ work (void* argPtr)
         }
     }
 
-    __transaction_atomic {
-        global_delta = global_delta + delta;
+    delta = parallel_reduceSumFloat(delta);
+    if (myId == 0) {
+        global_delta = delta;
+    }
+
+}
+
+
+/* =============================================================================
+ * seedPlusPlus
+ * -- Picks clusters[nseed..nclusters-1] from the points with probability
+ *    proportional to the squared distance to the nearest center so far
+ * =============================================================================
+ */
+static void
+seedPlusPlus (float** feature,
+              int     nfeatures,
+              int     npoints,
+              float** clusters,
+              int     nseed,
+              int     nclusters,
+              std::mt19937* randomPtr)
+{
+    double* dist = (double*)malloc(npoints * sizeof(double));
+    assert(dist);
+    int c;
+    int i;
+    int j;
+
+    for (i = 0; i < npoints; i++) {
+        double d = DBL_MAX;
+        for (c = 0; c < nseed; c++) {
+            double d2 = common_euclidDist2(feature[i], clusters[c], nfeatures);
+            if (d2 < d) {
+                d = d2;
+            }
+        }
+        dist[i] = d;
     }
 
+    for (c = nseed; c < nclusters; c++) {
+        double total = 0.0;
+        int n = -1;
+        if (c > 0) {
+            for (i = 0; i < npoints; i++) {
+                total += dist[i];
+            }
+        }
+        if (total > 0.0) {
+            double r = ((double)randomPtr->operator()() / 4294967296.0) * total;
+            for (i = 0; i < npoints; i++) {
+                if (dist[i] > 0.0) {
+                    n = i;
+                    r -= dist[i];
+                    if (r < 0.0) {
+                        break;
+                    }
+                }
+            }
+        } else {
+            n = (int)(randomPtr->operator()() % npoints);
+        }
+        for (j = 0; j < nfeatures; j++) {
+            clusters[c][j] = feature[n][j];
+        }
+        for (i = 0; i < npoints; i++) {
+            double d2 = common_euclidDist2(feature[i], clusters[c], nfeatures);
+            if (d2 < dist[i]) {
+                dist[i] = d2;
+            }
+        }
+    }
 
+    free(dist);
 }
 
 
@@ -202,15 +405,20 @@ normal_exec (int       nthreads,
              int       nclusters,
              float     threshold,
              int*      membership,
-             std::mt19937* randomPtr) /* out: [npoints] */
+             std::mt19937* randomPtr,
+             float**   seed_clusters,  /* in: [nseed_clusters][nfeatures] */
+             int       nseed_clusters) /* out: [npoints] */
 {
     int i;
     int j;
     int loop = 0;
+    int numIteration = 0;
     long** new_centers_len; /* [nclusters]: no. of points in each cluster */
     float delta;
     float** clusters;      /* out: [nclusters][nfeatures] */
     float** new_centers;   /* [nclusters][nfeatures] */
+    float** old_clusters = NULL; /* [nclusters][nfeatures], bounds mode only */
+    common_centers_t* centers; /* clusters, packed for the assignment kernel */
     void* alloc_memory = NULL;
     args_t args;
     TIMER_T start;
@@ -225,11 +433,23 @@ normal_exec (int       nthreads,
         clusters[i] = clusters[i-1] + nfeatures;
     }
 
-    /* Randomly pick cluster centers */
-    for (i = 0; i < nclusters; i++) {
-        int n = (int)(randomPtr->operator()() % npoints);
-        for (j = 0; j < nfeatures; j++) {
-            clusters[i][j] = feature[n][j];
+    if (seed_clusters) {
+        /* Keep the seeds and spread the remaining centers k-means++ style */
+        assert(nseed_clusters <= nclusters);
+        for (i = 0; i < nseed_clusters; i++) {
+            for (j = 0; j < nfeatures; j++) {
+                clusters[i][j] = seed_clusters[i][j];
+            }
+        }
+        seedPlusPlus(feature, nfeatures, npoints,
+                     clusters, nseed_clusters, nclusters, randomPtr);
+    } else {
+        /* Randomly pick cluster centers */
+        for (i = 0; i < nclusters; i++) {
+            int n = (int)(randomPtr->operator()() % npoints);
+            for (j = 0; j < nfeatures; j++) {
+                clusters[i][j] = feature[n][j];
+            }
         }
     }
 
@@ -237,6 +457,31 @@ normal_exec (int       nthreads,
         membership[i] = -1;
     }
 
+    centers = common_allocCenters(nclusters, nfeatures);
+
+    args.nfeatures  = nfeatures;
+    args.nclusters  = nclusters;
+    args.clusters   = clusters;
+    args.upper      = NULL;
+    args.lower      = NULL;
+    args.drift      = NULL;
+    args.separation = NULL;
+    if (global_useBounds) {
+        args.upper = (double*)malloc(npoints * sizeof(double));
+        args.lower = (double*)malloc(npoints * sizeof(double));
+        args.drift = (double*)malloc(nclusters * sizeof(double));
+        args.separation = (double*)malloc(nclusters * sizeof(double));
+        old_clusters = (float**)malloc(nclusters * sizeof(float*));
+        assert(args.upper && args.lower && args.drift && args.separation);
+        assert(old_clusters);
+        old_clusters[0] = (float*)malloc(nclusters * nfeatures * sizeof(float));
+        assert(old_clusters[0]);
+        for (i = 1; i < nclusters; i++) {
+            old_clusters[i] = old_clusters[i-1] + nfeatures;
+        }
+        updateBounds(&args, NULL);
+    }
+
     /*
      * Need to initialize new_centers_len and new_centers[0] to all 0.
      * Allocate clusters on different cache lines to reduce false sharing.
@@ -261,18 +506,20 @@ normal_exec (int       nthreads,
 
     do {
         delta = 0.0;
+        numIteration++;
 
         args.feature         = feature;
         args.nfeatures       = nfeatures;
         args.npoints         = npoints;
         args.nclusters       = nclusters;
         args.membership      = membership;
-        args.clusters        = clusters;
+        args.centers         = centers;
         args.new_centers_len = new_centers_len;
         args.new_centers     = new_centers;
 
         global_i = nthreads * CHUNK;
-        global_delta = delta;
+
+        common_packCenters(centers, clusters);
 
 #ifdef OTM
 #pragma omp parallel
@@ -285,6 +532,14 @@ normal_exec (int       nthreads,
 
         delta = global_delta;
 
+        if (old_clusters) {
+            for (i = 0; i < nclusters; i++) {
+                for (j = 0; j < nfeatures; j++) {
+                    old_clusters[i][j] = clusters[i][j];
+                }
+            }
+        }
+
         /* Replace old cluster centers with new_centers */
         for (i = 0; i < nclusters; i++) {
             for (j = 0; j < nfeatures; j++) {
@@ -296,13 +551,27 @@ normal_exec (int       nthreads,
             *new_centers_len[i] = 0;   /* set back to 0 */
         }
 
+        if (old_clusters) {
+            updateBounds(&args, old_clusters);
+        }
+
         delta /= npoints;
 
     } while ((delta > threshold) && (loop++ < 500));
 
     TIMER_READ(stop);
     global_time += TIMER_DIFF_SECONDS(start, stop);
-
+    global_numIteration = numIteration;
+
+    common_freeCenters(centers);
+    if (old_clusters) {
+        free(old_clusters[0]);
+        free(old_clusters);
+        free(args.upper);
+        free(args.lower);
+        free(args.drift);
+        free(args.separation);
+    }
     free(alloc_memory);
     free(new_centers);
     free(new_centers_len);
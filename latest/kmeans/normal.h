@@ -71,11 +71,15 @@
 
 
 extern double global_time;
+extern int global_numIteration; /* iterations taken by the last normal_exec */
 extern double global_parallelTime;
+extern int global_useBounds; /* prune assignments with Hamerly bounds */
 
 
 /* =============================================================================
  * normal_exec
+ * -- seed_clusters (may be NULL) become the first nseed_clusters centers and
+ *    the rest are chosen k-means++ style; otherwise all are picked at random
  * =============================================================================
  */
 float**
@@ -86,4 +90,6 @@ normal_exec (int       nthreads,
              int       nclusters,
              float     threshold,
              int*      membership,
-             std::mt19937* randomPtr); /* out: [npoints] */
+             std::mt19937* randomPtr,
+             float**   seed_clusters,  /* in: [nseed_clusters][nfeatures] */
+             int       nseed_clusters); /* out: [npoints] */
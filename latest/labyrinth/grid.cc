@@ -276,13 +276,13 @@ grid_addPath (grid_t* gridPtr, vector_t* pointVectorPtr)
 __attribute__((transaction_safe))
 //void
 bool
-TMgrid_addPath (vector_t* pointVectorPtr)
+TMgrid_addPath (long** gridPointPtrs, long numPoint)
 {
     long i;
-    long n = vector_getSize(pointVectorPtr);
+    long n = numPoint;
 #if 0
     for (i = 1; i < (n-1); i++) {
-        long* gridPointPtr = (long*)vector_at(pointVectorPtr, i);
+        long* gridPointPtr = gridPointPtrs[i];
         long value = (long)TM_SHARED_READ(*gridPointPtr);
         if (value != GRID_POINT_EMPTY) {
           _ITM_abortTransaction(2);
@@ -292,7 +292,7 @@ TMgrid_addPath (vector_t* pointVectorPtr)
 #endif
     //[wer210] a check loop and a write loop
     for (i = 1; i < (n-1); i++) {
-      long* gridPointPtr = (long*)vector_at(pointVectorPtr, i);
+      long* gridPointPtr = gridPointPtrs[i];
       long value = *gridPointPtr;
       if (value != GRID_POINT_EMPTY) {
         return false;
@@ -301,7 +301,7 @@ TMgrid_addPath (vector_t* pointVectorPtr)
     }
 
     for (i = 1; i < (n-1); i++) {
-      long* gridPointPtr = (long*)vector_at(pointVectorPtr, i);
+      long* gridPointPtr = gridPointPtrs[i];
       *gridPointPtr = (long)GRID_POINT_FULL;
     }
     return true;
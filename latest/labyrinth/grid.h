@@ -190,12 +190,14 @@ grid_addPath (grid_t* gridPtr, vector_t* pointVectorPtr);
 
 /* =============================================================================
  * TMgrid_addPath
+ * -- Endpoints gridPointPtrs[0] and gridPointPtrs[numPoint-1] are not checked
+ * -- Returns false, writing nothing, if any other point is not empty
  * =============================================================================
  */
 __attribute__((transaction_safe))
 //void
 bool
-TMgrid_addPath (vector_t* pointVectorPtr);
+TMgrid_addPath (long** gridPointPtrs, long numPoint);
 
 
 /* =============================================================================
@@ -209,7 +211,7 @@ grid_print (grid_t* gridPtr);
 #define PGRID_ALLOC(x, y, z)            grid_alloc(x, y, z)
 #define PGRID_FREE(g)                   grid_free(g)
 
-#define TMGRID_ADDPATH(p)            TMgrid_addPath(p)
+#define TMGRID_ADDPATH(p, n)         TMgrid_addPath(p, n)
 
 
 #endif /* GRID_H */
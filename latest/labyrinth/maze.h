@@ -82,7 +82,7 @@
 
 typedef struct maze {
     grid_t* gridPtr;
-    queue_t* workQueuePtr;   /* contains source/destination pairs to route */
+    mpmcqueue_t* workQueuePtr; /* contains source/destination pairs to route */
     vector_t* wallVectorPtr; /* obstacles */
     vector_t* srcVectorPtr;  /* sources */
     vector_t* dstVectorPtr;  /* destinations */
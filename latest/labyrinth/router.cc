@@ -75,6 +75,7 @@
 #include "grid.h"
 #include "queue.h"
 #include "router.h"
+#include "svector.h"
 #include "vector.h"
 #include "tm_transition.h"
 
@@ -103,6 +104,14 @@ point_t MOVE_NEGX = {-1,  0,  0,  0, MOMENTUM_NEGX};
 point_t MOVE_NEGY = { 0, -1,  0,  0, MOMENTUM_NEGY};
 point_t MOVE_NEGZ = { 0,  0, -1,  0, MOMENTUM_NEGZ};
 
+/*
+ * Each thread traces into one reusable buffer; only a path that is actually
+ * added to the grid gets copied out into an exact-size vector_t.
+ */
+#define ROUTER_TRACE_INLINE (64)
+
+typedef svector_t<long*, ROUTER_TRACE_INLINE> trace_vector_t;
+
 
 /* =============================================================================
  * router_alloc
@@ -274,16 +283,18 @@ traceToNeighbor (grid_t* myGridPtr,
 
 /* =============================================================================
  * PdoTraceback
+ * -- Fills traceVectorPtr with the path from dst back to src
+ * -- Returns false if no path can be traced
  * =============================================================================
  */
 //static TM_PURE
 __attribute__((transaction_safe))
-vector_t*
+bool
 PdoTraceback (grid_t* gridPtr, grid_t* myGridPtr,
-              coordinate_t* dstPtr, long bendCost)
+              coordinate_t* dstPtr, long bendCost,
+              trace_vector_t* traceVectorPtr)
 {
-    vector_t* pointVectorPtr = PVECTOR_ALLOC(1);
-    assert(pointVectorPtr);
+    svector_clear(traceVectorPtr);
 
     point_t next;
     next.x = dstPtr->x;
@@ -295,7 +306,8 @@ PdoTraceback (grid_t* gridPtr, grid_t* myGridPtr,
     while (1) {
 
         long* gridPointPtr = grid_getPointRef(gridPtr, next.x, next.y, next.z);
-        PVECTOR_PUSHBACK(pointVectorPtr, (void*)gridPointPtr);
+        bool status = svector_pushBack(traceVectorPtr, gridPointPtr);
+        assert(status);
         grid_setPoint(myGridPtr, next.x, next.y, next.z, GRID_POINT_FULL);
 
         /* Check if we are done */
@@ -339,11 +351,10 @@ PdoTraceback (grid_t* gridPtr, grid_t* myGridPtr,
                 (curr.y == next.y) &&
                 (curr.z == next.z))
             {
-                PVECTOR_FREE(pointVectorPtr);
 #ifdef DEBUG
                 puts("[dead]");
 #endif
-                return NULL; /* cannot find path */
+                return false; /* cannot find path */
             }
         }
     }
@@ -352,7 +363,7 @@ PdoTraceback (grid_t* gridPtr, grid_t* myGridPtr,
     puts("");
 #endif /* DEBUG */
 
-    return pointVectorPtr;
+    return true;
 }
 
 
@@ -369,13 +380,15 @@ router_solve (void* argPtr)
     vector_t* myPathVectorPtr = PVECTOR_ALLOC(1);
     assert(myPathVectorPtr);
 
-    queue_t* workQueuePtr = mazePtr->workQueuePtr;
+    mpmcqueue_t* workQueuePtr = mazePtr->workQueuePtr;
     grid_t* gridPtr = mazePtr->gridPtr;
     grid_t* myGridPtr =
         PGRID_ALLOC(gridPtr->width, gridPtr->height, gridPtr->depth);
     assert(myGridPtr);
     long bendCost = routerPtr->bendCost;
     queue_t* myExpansionQueuePtr = TMQUEUE_ALLOC(-1);
+    trace_vector_t traceVector;
+    svector_init(&traceVector);
 
     /*
      * Iterate over work list to route each path. This involves an
@@ -383,14 +396,7 @@ router_solve (void* argPtr)
      */
     while (1) {
 
-        pair_t* coordinatePairPtr;
-        __transaction_atomic {
-          if (TMQUEUE_ISEMPTY(workQueuePtr)) {
-            coordinatePairPtr = NULL;
-          } else {
-            coordinatePairPtr = (pair_t*)TMQUEUE_POP(workQueuePtr);
-          }
-        }
+        pair_t* coordinatePairPtr = (pair_t*)mpmcqueue_pop(workQueuePtr);
         if (coordinatePairPtr == NULL) {
             break;
         }
@@ -431,14 +437,14 @@ router_solve (void* argPtr)
           /* ok if not most up-to-date */
           // see if there is a valid path we can use
           if (PdoExpansion(routerPtr, myGridPtr, myExpansionQueuePtr, srcPtr, dstPtr)) {
-            pointVectorPtr = PdoTraceback(gridPtr, myGridPtr, dstPtr, bendCost);
-
-            if (pointVectorPtr) {
+            if (PdoTraceback(gridPtr, myGridPtr, dstPtr, bendCost, &traceVector)) {
               // we've got a valid path.  Use a transaction to validate and finalize it
                 bool validity = false;
+                long** gridPointPtrs = svector_getElements(&traceVector);
+                long numPoint = svector_getSize(&traceVector);
 
                 __transaction_atomic {
-                  validity = TMGRID_ADDPATH(pointVectorPtr);
+                  validity = TMGRID_ADDPATH(gridPointPtrs, numPoint);
                 }
 
               // if the operation was valid, we just finalized the path
@@ -447,11 +453,9 @@ router_solve (void* argPtr)
                 break;
               }
 
-              // otherwise we need to resample the grid
+              // otherwise we need to resample the grid; the trace buffer
+              // is simply reused, so a failed attempt costs no allocation
               else {
-                // NB: doing things this way means we can fix a memory
-                // leak from the original STAMP labyrinth
-                PVECTOR_FREE(pointVectorPtr);
                 continue;
               }
             }
@@ -469,6 +473,15 @@ router_solve (void* argPtr)
         }
         //////// end of change
         if (success) {
+            long numPoint = svector_getSize(&traceVector);
+            pointVectorPtr = PVECTOR_ALLOC(numPoint);
+            assert(pointVectorPtr);
+            long p;
+            for (p = 0; p < numPoint; p++) {
+                bool status = PVECTOR_PUSHBACK(pointVectorPtr,
+                                               (void*)svector_at(&traceVector, p));
+                assert(status);
+            }
             bool status = PVECTOR_PUSHBACK(myPathVectorPtr,
                                              (void*)pointVectorPtr);
             assert(status);
@@ -486,6 +499,7 @@ router_solve (void* argPtr)
 
     grid_free(myGridPtr);
     TMQUEUE_FREE(myExpansionQueuePtr);
+    svector_free(&traceVector);
 
 #ifdef DEBUG
     puts("\nFinal Grid:");
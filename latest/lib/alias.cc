@@ -0,0 +1,261 @@
+/* =============================================================================
+ *
+ * alias.cc
+ * -- Alias tables for sampling fixed discrete distributions
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include "alias.h"
+
+/* =============================================================================
+ * alias_alloc
+ * -- weights need not be normalized; at least one must be positive
+ * -- Returns NULL on failure
+ * =============================================================================
+ */
+alias_t*
+alias_alloc (const double* weights, long numOutcome)
+{
+    alias_t* aliasPtr;
+    double* probs;
+    long* smalls;
+    long* larges;
+    long numSmall = 0;
+    long numLarge = 0;
+    double sum = 0.0;
+    long i;
+
+    assert((numOutcome > 0) && (numOutcome <= (1L << 32)));
+
+    for (i = 0; i < numOutcome; i++) {
+        assert(weights[i] >= 0.0);
+        sum += weights[i];
+    }
+    if (!(sum > 0.0)) {
+        return NULL;
+    }
+
+    aliasPtr = (alias_t*)malloc(sizeof(alias_t));
+    if (aliasPtr == NULL) {
+        return NULL;
+    }
+    aliasPtr->numOutcome = numOutcome;
+    aliasPtr->thresholds =
+        (unsigned int*)malloc(numOutcome * sizeof(unsigned int));
+    aliasPtr->aliases = (unsigned int*)malloc(numOutcome * sizeof(unsigned int));
+    probs = (double*)malloc(numOutcome * sizeof(double));
+    smalls = (long*)malloc(numOutcome * sizeof(long));
+    larges = (long*)malloc(numOutcome * sizeof(long));
+    if ((aliasPtr->thresholds == NULL) || (aliasPtr->aliases == NULL) ||
+        (probs == NULL) || (smalls == NULL) || (larges == NULL))
+    {
+        free(probs);
+        free(smalls);
+        free(larges);
+        alias_free(aliasPtr);
+        return NULL;
+    }
+
+    /* Scale so the average column holds exactly 1 */
+    for (i = 0; i < numOutcome; i++) {
+        probs[i] = weights[i] * (double)numOutcome / sum;
+        if (probs[i] < 1.0) {
+            smalls[numSmall++] = i;
+        } else {
+            larges[numLarge++] = i;
+        }
+    }
+
+    /* Top up each small column from a large one (Vose) */
+    while ((numSmall > 0) && (numLarge > 0)) {
+        long s = smalls[--numSmall];
+        long l = larges[numLarge - 1];
+        aliasPtr->thresholds[s] = (unsigned int)(probs[s] * 4294967296.0);
+        aliasPtr->aliases[s] = (unsigned int)l;
+        probs[l] -= (1.0 - probs[s]);
+        if (probs[l] < 1.0) {
+            numLarge--;
+            smalls[numSmall++] = l;
+        }
+    }
+
+    /* Whatever is left is full up to rounding */
+    while (numLarge > 0) {
+        long l = larges[--numLarge];
+        aliasPtr->thresholds[l] = ~0U;
+        aliasPtr->aliases[l] = (unsigned int)l;
+    }
+    while (numSmall > 0) {
+        long s = smalls[--numSmall];
+        aliasPtr->thresholds[s] = ~0U;
+        aliasPtr->aliases[s] = (unsigned int)s;
+    }
+
+    free(probs);
+    free(smalls);
+    free(larges);
+
+    return aliasPtr;
+}
+
+
+/* =============================================================================
+ * alias_free
+ * =============================================================================
+ */
+void
+alias_free (alias_t* aliasPtr)
+{
+    free(aliasPtr->thresholds);
+    free(aliasPtr->aliases);
+    free(aliasPtr);
+}
+
+
+/* =============================================================================
+ * TEST_ALIAS
+ * =============================================================================
+ */
+#ifdef TEST_ALIAS
+
+
+#include <math.h>
+#include <stdio.h>
+#include <random>
+
+
+#define NUM_OUTCOME (1000)
+#define NUM_SAMPLE  (10000000)
+
+
+int
+main ()
+{
+    double weights[NUM_OUTCOME];
+    long counts[NUM_OUTCOME] = { 0 };
+    double sum = 0.0;
+    std::mt19937 random;
+    alias_t* aliasPtr;
+    long numError = 0;
+    long i;
+
+    puts("Starting...");
+
+    /* Zipfian with theta = 0.99, plus a zero-weight outcome */
+    for (i = 0; i < NUM_OUTCOME; i++) {
+        weights[i] = pow((double)(i + 1), -0.99);
+        sum += weights[i];
+    }
+    sum -= weights[NUM_OUTCOME / 2];
+    weights[NUM_OUTCOME / 2] = 0.0;
+
+    aliasPtr = alias_alloc(weights, NUM_OUTCOME);
+    assert(aliasPtr != NULL);
+
+    for (i = 0; i < NUM_SAMPLE; i++) {
+        unsigned long r = random();
+        unsigned long coin = random();
+        long outcome = alias_sample(aliasPtr, r, coin);
+        assert((outcome >= 0) && (outcome < NUM_OUTCOME));
+        counts[outcome]++;
+    }
+
+    /* Every outcome within 5 standard deviations of its expectation */
+    for (i = 0; i < NUM_OUTCOME; i++) {
+        double p = weights[i] / sum;
+        double expected = p * NUM_SAMPLE;
+        double deviation = sqrt(NUM_SAMPLE * p * (1.0 - p));
+        if (fabs((double)counts[i] - expected) > (5.0 * deviation + 1e-9)) {
+            printf("outcome %li: %li, expected %.1f: FAILED\n",
+                   i, counts[i], expected);
+            numError++;
+        }
+    }
+    printf("p(0) = %.4f, expected %.4f\n",
+           (double)counts[0] / NUM_SAMPLE, weights[0] / sum);
+
+    alias_free(aliasPtr);
+
+    /* All-zero weights are rejected */
+    for (i = 0; i < NUM_OUTCOME; i++) {
+        weights[i] = 0.0;
+    }
+    assert(alias_alloc(weights, NUM_OUTCOME) == NULL);
+
+    puts((numError == 0) ? "All tests passed." : "FAILED");
+
+    return ((numError == 0) ? 0 : 1);
+}
+
+
+#endif /* TEST_ALIAS */
+
+
+/* =============================================================================
+ *
+ * End of alias.cc
+ *
+ * =============================================================================
+ */
@@ -0,0 +1,128 @@
+/* =============================================================================
+ *
+ * alias.h
+ * -- Alias tables for sampling fixed discrete distributions
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+
+#pragma once
+
+/*
+ * Walker/Vose alias table: after O(n) setup, drawing one of n outcomes with
+ * arbitrary fixed weights costs one modulo, two table reads and a compare,
+ * independent of the shape of the distribution. The table is read-only once
+ * built, so any number of threads may sample it concurrently. Sampling takes
+ * two random words rather than a generator so callers keep their own
+ * generators (and their sequences).
+ */
+
+typedef struct alias {
+    long numOutcome;
+    unsigned int* thresholds;  /* keep outcome i if coin < thresholds[i] */
+    unsigned int* aliases;     /* else take aliases[i] */
+} alias_t;
+
+
+/* =============================================================================
+ * alias_alloc
+ * -- weights need not be normalized; at least one must be positive
+ * -- Returns NULL on failure
+ * =============================================================================
+ */
+alias_t*
+alias_alloc (const double* weights, long numOutcome);
+
+
+/* =============================================================================
+ * alias_free
+ * =============================================================================
+ */
+void
+alias_free (alias_t* aliasPtr);
+
+
+/* =============================================================================
+ * alias_sample
+ * -- r and coin should be independent uniform words (only the low 32 bits of
+ *    coin are used); returns an outcome in [0, numOutcome)
+ * =============================================================================
+ */
+static inline long
+alias_sample (const alias_t* aliasPtr, unsigned long r, unsigned long coin)
+{
+    long i = (long)(r % (unsigned long)aliasPtr->numOutcome);
+
+    if ((unsigned int)coin < aliasPtr->thresholds[i]) {
+        return i;
+    }
+
+    return (long)aliasPtr->aliases[i];
+}
+
+
+/* =============================================================================
+ *
+ * End of alias.h
+ *
+ * =============================================================================
+ */
@@ -107,7 +107,7 @@ TMheapify (heap_t* heapPtr, long startIndex);
  * =============================================================================
  */
 heap_t*
-heap_alloc (long initCapacity, long (*compare)(const void*, const void*))
+heap_alloc (long initCapacity, TM_SAFE long (*compare)(const void*, const void*))
 {
     heap_t* heapPtr;
 
@@ -371,6 +371,22 @@ heap_remove (heap_t* heapPtr)
     return dataPtr;
 }
 
+/* =============================================================================
+ * heap_peek
+ * -- Returns NULL if empty
+ * =============================================================================
+ */
+TM_SAFE
+void*
+heap_peek (heap_t* heapPtr)
+{
+    if (heapPtr->size < 1) {
+        return NULL;
+    }
+
+    return heapPtr->elements[1];
+}
+
 /* =============================================================================
  * heap_isValid
  * =============================================================================
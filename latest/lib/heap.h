@@ -80,7 +80,8 @@ struct heap_t;
  */
 //[wer210] called once in yada, outside of tx
 heap_t*
-heap_alloc (long initCapacity, long (*compare)(const void*, const void*));
+heap_alloc (long initCapacity,
+            __attribute__((transaction_safe)) long (*compare)(const void*, const void*));
 
 
 /* =============================================================================
@@ -111,6 +112,16 @@ void*
 heap_remove (heap_t* heapPtr);
 
 
+/* =============================================================================
+ * heap_peek
+ * -- Returns highest-priority element without removing it, or NULL if empty
+ * =============================================================================
+ */
+__attribute__((transaction_safe))
+void*
+heap_peek (heap_t* heapPtr);
+
+
 /* =============================================================================
  * heap_isValid
  * =============================================================================
@@ -122,3 +133,4 @@ heap_isValid (heap_t* heapPtr);
 
 #define TMHEAP_INSERT(h, d)             heap_insert((h), (d))
 #define TMHEAP_REMOVE(h)                heap_remove((h))
+#define TMHEAP_PEEK(h)                  heap_peek((h))
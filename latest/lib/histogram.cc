@@ -0,0 +1,347 @@
+/* =============================================================================
+ *
+ * histogram.cc
+ * -- Log-linear histogram for latency percentiles
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "histogram.h"
+
+/* =============================================================================
+ * getBucket
+ * =============================================================================
+ */
+static inline long
+getBucket (unsigned long value)
+{
+    if (value < (2UL * HISTOGRAM_SUB_BUCKET_HALF)) {
+        return (long)value;
+    }
+
+    /* Keep the top HISTOGRAM_SUB_BUCKET_BITS bits */
+    long msb = 63 - __builtin_clzl(value);
+    long shift = msb - (HISTOGRAM_SUB_BUCKET_BITS - 1);
+
+    return (shift * HISTOGRAM_SUB_BUCKET_HALF) + (long)(value >> shift);
+}
+
+
+/* =============================================================================
+ * getHighestValue
+ * -- Largest value that falls into bucket
+ * =============================================================================
+ */
+static inline unsigned long
+getHighestValue (long bucket)
+{
+    if (bucket < (2 * HISTOGRAM_SUB_BUCKET_HALF)) {
+        return (unsigned long)bucket;
+    }
+
+    long shift = (bucket / HISTOGRAM_SUB_BUCKET_HALF) - 1;
+    unsigned long lowest =
+        (unsigned long)(bucket - (shift * HISTOGRAM_SUB_BUCKET_HALF)) << shift;
+
+    return lowest + ((1UL << shift) - 1);
+}
+
+
+/* =============================================================================
+ * histogram_alloc
+ * -- Returns NULL on failure
+ * =============================================================================
+ */
+histogram_t*
+histogram_alloc ()
+{
+    histogram_t* histogramPtr = (histogram_t*)malloc(sizeof(histogram_t));
+    if (histogramPtr == NULL) {
+        return NULL;
+    }
+
+    histogram_clear(histogramPtr);
+
+    return histogramPtr;
+}
+
+
+/* =============================================================================
+ * histogram_free
+ * =============================================================================
+ */
+void
+histogram_free (histogram_t* histogramPtr)
+{
+    free(histogramPtr);
+}
+
+
+/* =============================================================================
+ * histogram_clear
+ * =============================================================================
+ */
+void
+histogram_clear (histogram_t* histogramPtr)
+{
+    histogramPtr->numValue = 0;
+    histogramPtr->minValue = ~0UL;
+    histogramPtr->maxValue = 0;
+    histogramPtr->sum = 0.0;
+    memset(histogramPtr->counts, 0, sizeof(histogramPtr->counts));
+}
+
+
+/* =============================================================================
+ * histogram_record
+ * =============================================================================
+ */
+void
+histogram_record (histogram_t* histogramPtr, unsigned long value)
+{
+    histogramPtr->counts[getBucket(value)]++;
+    histogramPtr->numValue++;
+    histogramPtr->sum += (double)value;
+    if (value < histogramPtr->minValue) {
+        histogramPtr->minValue = value;
+    }
+    if (value > histogramPtr->maxValue) {
+        histogramPtr->maxValue = value;
+    }
+}
+
+
+/* =============================================================================
+ * histogram_add
+ * -- Merges the values of src into dst
+ * =============================================================================
+ */
+void
+histogram_add (histogram_t* dstPtr, histogram_t* srcPtr)
+{
+    long b;
+
+    for (b = 0; b < HISTOGRAM_NUM_BUCKET; b++) {
+        dstPtr->counts[b] += srcPtr->counts[b];
+    }
+    dstPtr->numValue += srcPtr->numValue;
+    dstPtr->sum += srcPtr->sum;
+    if (srcPtr->minValue < dstPtr->minValue) {
+        dstPtr->minValue = srcPtr->minValue;
+    }
+    if (srcPtr->maxValue > dstPtr->maxValue) {
+        dstPtr->maxValue = srcPtr->maxValue;
+    }
+}
+
+
+/* =============================================================================
+ * histogram_getPercentile
+ * -- Smallest recorded value v (to bucket precision) such that at least
+ *    'percentile' percent of the values are <= v; returns 0 if empty
+ * =============================================================================
+ */
+unsigned long
+histogram_getPercentile (histogram_t* histogramPtr, double percentile)
+{
+    if (histogramPtr->numValue == 0) {
+        return 0;
+    }
+
+    if (percentile > 100.0) {
+        percentile = 100.0;
+    }
+    long rank = (long)((percentile / 100.0) * (double)histogramPtr->numValue
+                       + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    long numSeen = 0;
+    long b;
+    for (b = 0; b < HISTOGRAM_NUM_BUCKET; b++) {
+        numSeen += histogramPtr->counts[b];
+        if (numSeen >= rank) {
+            break;
+        }
+    }
+    assert(b < HISTOGRAM_NUM_BUCKET);
+
+    /* Bucket bounds are coarser than the exact extremes */
+    unsigned long value = getHighestValue(b);
+    if (value > histogramPtr->maxValue) {
+        value = histogramPtr->maxValue;
+    }
+    if (value < histogramPtr->minValue) {
+        value = histogramPtr->minValue;
+    }
+
+    return value;
+}
+
+
+/* =============================================================================
+ * histogram_getMean
+ * -- Exact; returns 0 if empty
+ * =============================================================================
+ */
+double
+histogram_getMean (histogram_t* histogramPtr)
+{
+    if (histogramPtr->numValue == 0) {
+        return 0.0;
+    }
+
+    return histogramPtr->sum / (double)histogramPtr->numValue;
+}
+
+
+/* =============================================================================
+ * TEST_HISTOGRAM
+ * =============================================================================
+ */
+#ifdef TEST_HISTOGRAM
+
+
+#include <stdio.h>
+
+
+static bool
+isClose (unsigned long actual, unsigned long expected)
+{
+    double error = ((double)actual - (double)expected) / (double)expected;
+    return ((error >= 0.0) &&
+            (error <= (1.0 / (double)HISTOGRAM_SUB_BUCKET_HALF)));
+}
+
+
+int
+main ()
+{
+    histogram_t* aPtr;
+    histogram_t* bPtr;
+    unsigned long v;
+    long i;
+    long numError = 0;
+
+    puts("Starting...");
+
+    aPtr = histogram_alloc();
+    bPtr = histogram_alloc();
+    assert(aPtr && bPtr);
+
+    /* Buckets are contiguous and each value lies inside its bucket */
+    for (v = 1; v < (1UL << 24); v = v + 1 + (v >> 6)) {
+        long b = getBucket(v);
+        if ((b >= HISTOGRAM_NUM_BUCKET) || (getHighestValue(b) < v) ||
+            ((b > 0) && (getHighestValue(b - 1) >= v)))
+        {
+            printf("bucket of %lu: FAILED\n", v);
+            numError++;
+            break;
+        }
+    }
+    assert(getBucket(~0UL) == HISTOGRAM_NUM_BUCKET - 1);
+
+    /* 1..100000 in a, 100001..200000 in b */
+    for (i = 1; i <= 100000; i++) {
+        histogram_record(aPtr, (unsigned long)i);
+        histogram_record(bPtr, (unsigned long)(i + 100000));
+    }
+    histogram_add(aPtr, bPtr);
+
+    double percentiles[] = { 0.0, 50.0, 99.0, 99.9, 100.0 };
+    unsigned long expected[] = { 1, 100000, 198000, 199800, 200000 };
+    for (i = 0; i < (long)(sizeof(percentiles) / sizeof(percentiles[0])); i++) {
+        v = histogram_getPercentile(aPtr, percentiles[i]);
+        bool isPassed = isClose(v, expected[i]);
+        printf("p%g = %lu: %s\n", percentiles[i], v,
+               (isPassed ? "passed" : "FAILED"));
+        numError += (isPassed ? 0 : 1);
+    }
+    assert(aPtr->numValue == 200000);
+    assert(histogram_getMean(aPtr) == 100000.5);
+
+    histogram_clear(aPtr);
+    assert(histogram_getPercentile(aPtr, 50.0) == 0);
+
+    histogram_free(aPtr);
+    histogram_free(bPtr);
+
+    puts("Done.");
+
+    return ((numError == 0) ? 0 : 1);
+}
+
+
+#endif /* TEST_HISTOGRAM */
+
+
+/* =============================================================================
+ *
+ * End of histogram.cc
+ *
+ * =============================================================================
+ */
@@ -0,0 +1,164 @@
+/* =============================================================================
+ *
+ * histogram.h
+ * -- Log-linear histogram for latency percentiles
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+
+#pragma once
+
+/*
+ * Log-linear latency histogram in the style of HdrHistogram. Values below
+ * 2^HISTOGRAM_SUB_BUCKET_BITS get a bucket each; above that, every power of
+ * two is split into 2^(HISTOGRAM_SUB_BUCKET_BITS-1) equal buckets, so any
+ * recorded value is reported within a relative error of
+ * 2^-(HISTOGRAM_SUB_BUCKET_BITS-1) over the full unsigned long range.
+ * Recording is a couple of shifts and an increment with no allocation, and
+ * a histogram is not thread-safe: keep one per thread and merge them with
+ * histogram_add() once the threads are done.
+ */
+
+#ifndef HISTOGRAM_SUB_BUCKET_BITS
+#  define HISTOGRAM_SUB_BUCKET_BITS (8)  /* < 0.8% relative error */
+#endif
+
+#define HISTOGRAM_SUB_BUCKET_HALF   (1L << (HISTOGRAM_SUB_BUCKET_BITS - 1))
+#define HISTOGRAM_NUM_BUCKET \
+    ((66 - HISTOGRAM_SUB_BUCKET_BITS) * HISTOGRAM_SUB_BUCKET_HALF)
+
+typedef struct histogram {
+    long numValue;
+    unsigned long minValue;
+    unsigned long maxValue;
+    double sum;
+    long counts[HISTOGRAM_NUM_BUCKET];
+} histogram_t;
+
+
+/* =============================================================================
+ * histogram_alloc
+ * -- Returns NULL on failure
+ * =============================================================================
+ */
+histogram_t*
+histogram_alloc ();
+
+
+/* =============================================================================
+ * histogram_free
+ * =============================================================================
+ */
+void
+histogram_free (histogram_t* histogramPtr);
+
+
+/* =============================================================================
+ * histogram_clear
+ * =============================================================================
+ */
+void
+histogram_clear (histogram_t* histogramPtr);
+
+
+/* =============================================================================
+ * histogram_record
+ * =============================================================================
+ */
+void
+histogram_record (histogram_t* histogramPtr, unsigned long value);
+
+
+/* =============================================================================
+ * histogram_add
+ * -- Merges the values of src into dst
+ * =============================================================================
+ */
+void
+histogram_add (histogram_t* dstPtr, histogram_t* srcPtr);
+
+
+/* =============================================================================
+ * histogram_getPercentile
+ * -- Smallest recorded value v (to bucket precision) such that at least
+ *    'percentile' percent of the values are <= v; returns 0 if empty
+ * =============================================================================
+ */
+unsigned long
+histogram_getPercentile (histogram_t* histogramPtr, double percentile);
+
+
+/* =============================================================================
+ * histogram_getMean
+ * -- Exact; returns 0 if empty
+ * =============================================================================
+ */
+double
+histogram_getMean (histogram_t* histogramPtr);
+
+
+/* =============================================================================
+ *
+ * End of histogram.h
+ *
+ * =============================================================================
+ */
@@ -213,6 +213,38 @@
 #  define TMMAP_REMOVE(map, key)      TMRBTREE_DELETE(map, (void*)(key))
 
 
+#elif defined(MAP_USE_TRBTREE)
+
+/*
+ * Typed red-black tree; the comparator is fixed at compile time, so the
+ * cmp argument of MAP_ALLOC is ignored. Keys default to long compared
+ * numerically; define MAP_KEY_T and MAP_KEY_COMPARE to override.
+ */
+
+#  include "trbtree.h"
+
+#  ifndef MAP_KEY_T
+#    define MAP_KEY_T                 long
+#    define MAP_KEY_COMPARE           trbtree_compareLong
+#  endif
+
+#  define MAP_T                       trbtree_t<MAP_KEY_T, void*, MAP_KEY_COMPARE>
+#  define MAP_ALLOC(hash, cmp)        trbtree_alloc<MAP_KEY_T, void*, MAP_KEY_COMPARE>()
+#  define MAP_FREE(map)               trbtree_free(map)
+
+#  define MAP_CONTAINS(map, key)      trbtree_contains(map, (MAP_KEY_T)(key))
+#  define MAP_FIND(map, key)          trbtree_get(map, (MAP_KEY_T)(key))
+#  define MAP_INSERT(map, key, data) \
+    trbtree_insert(map, (MAP_KEY_T)(key), (void*)(data))
+#  define MAP_REMOVE(map, key)        trbtree_delete(map, (MAP_KEY_T)(key))
+
+#  define TMMAP_CONTAINS(map, key)    TMTRBTREE_CONTAINS(map, (MAP_KEY_T)(key))
+#  define TMMAP_FIND(map, key)        TMTRBTREE_GET(map, (MAP_KEY_T)(key))
+#  define TMMAP_INSERT(map, key, data) \
+    TMTRBTREE_INSERT(map, (MAP_KEY_T)(key), (void*)(data))
+#  define TMMAP_REMOVE(map, key)      TMTRBTREE_DELETE(map, (MAP_KEY_T)(key))
+
+
 #elif defined(MAP_USE_SKIPLIST)
 
 #  include "skiplist.h"
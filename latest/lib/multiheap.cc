@@ -0,0 +1,281 @@
+/* =============================================================================
+ *
+ * multiheap.c
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+
+#include <stdlib.h>
+#include <assert.h>
+#include "heap.h"
+#include "multiheap.h"
+#include "tm.h"
+
+/* ??? Cacheline size is fixed. */
+#define MULTIHEAP_CACHE_LINE_SIZE (64)
+
+typedef struct multiheap_slot {
+    heap_t* heapPtr;
+    char pad[MULTIHEAP_CACHE_LINE_SIZE - sizeof(heap_t*)];
+} multiheap_slot_t;
+
+struct multiheap_t {
+    multiheap_slot_t* slots;
+    long numHeap;
+    TM_SAFE long (*compare)(const void*, const void*);
+};
+
+
+/* =============================================================================
+ * nextRandom
+ * -- xorshift64*; state lives with the caller so it is never shared
+ * =============================================================================
+ */
+TM_SAFE
+static unsigned long
+nextRandom (unsigned long* seedPtr)
+{
+    unsigned long x = *seedPtr;
+    if (x == 0) {
+        x = 0x9e3779b97f4a7c15UL;
+    }
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *seedPtr = x;
+    return (x * 0x2545f4914f6cdd1dUL);
+}
+
+
+/* =============================================================================
+ * multiheap_alloc
+ * -- Returns NULL on failure
+ * =============================================================================
+ */
+multiheap_t*
+multiheap_alloc (long numHeap,
+                 long initCapacity,
+                 TM_SAFE long (*compare)(const void*, const void*))
+{
+    multiheap_t* multiheapPtr;
+
+    multiheapPtr = (multiheap_t*)malloc(sizeof(multiheap_t));
+    if (multiheapPtr) {
+        numHeap = ((numHeap > 0) ? (numHeap) : (1));
+        multiheapPtr->slots =
+            (multiheap_slot_t*)malloc(numHeap * sizeof(multiheap_slot_t));
+        assert(multiheapPtr->slots);
+        long capacity = (initCapacity + numHeap - 1) / numHeap;
+        long h;
+        for (h = 0; h < numHeap; h++) {
+            multiheapPtr->slots[h].heapPtr = heap_alloc(capacity, compare);
+            assert(multiheapPtr->slots[h].heapPtr);
+        }
+        multiheapPtr->numHeap = numHeap;
+        multiheapPtr->compare = compare;
+    }
+
+    return multiheapPtr;
+}
+
+
+/* =============================================================================
+ * multiheap_free
+ * =============================================================================
+ */
+void
+multiheap_free (multiheap_t* multiheapPtr)
+{
+    long h;
+    for (h = 0; h < multiheapPtr->numHeap; h++) {
+        heap_free(multiheapPtr->slots[h].heapPtr);
+    }
+    free(multiheapPtr->slots);
+    free(multiheapPtr);
+}
+
+
+/* =============================================================================
+ * multiheap_insert
+ * -- Returns false on failure
+ * =============================================================================
+ */
+TM_SAFE
+bool
+multiheap_insert (multiheap_t* multiheapPtr, void* dataPtr, unsigned long* seedPtr)
+{
+    long numHeap = multiheapPtr->numHeap;
+    long h = (long)(nextRandom(seedPtr) % (unsigned long)numHeap);
+
+    return heap_insert(multiheapPtr->slots[h].heapPtr, dataPtr);
+}
+
+
+/* =============================================================================
+ * multiheap_remove
+ * -- Returns NULL only if all heaps are empty
+ * =============================================================================
+ */
+TM_SAFE
+void*
+multiheap_remove (multiheap_t* multiheapPtr, unsigned long* seedPtr)
+{
+    multiheap_slot_t* slots = multiheapPtr->slots;
+    long numHeap = multiheapPtr->numHeap;
+    unsigned long r = nextRandom(seedPtr);
+    long a = (long)(r % (unsigned long)numHeap);
+    long b = (long)((r >> 32) % (unsigned long)numHeap);
+
+    void* aPtr = heap_peek(slots[a].heapPtr);
+    void* bPtr = heap_peek(slots[b].heapPtr);
+
+    if (aPtr != NULL && bPtr != NULL) {
+        TM_SAFE long (*compare)(const void*, const void*) =
+            multiheapPtr->compare;
+        if (compare(aPtr, bPtr) < 0) {
+            a = b;
+        }
+        return heap_remove(slots[a].heapPtr);
+    }
+    if (aPtr != NULL) {
+        return heap_remove(slots[a].heapPtr);
+    }
+    if (bPtr != NULL) {
+        return heap_remove(slots[b].heapPtr);
+    }
+
+    /* Both samples empty: only now pay for looking at every heap */
+    long i;
+    for (i = 1; i < numHeap; i++) {
+        long h = (a + i) % numHeap;
+        if (heap_peek(slots[h].heapPtr) != NULL) {
+            return heap_remove(slots[h].heapPtr);
+        }
+    }
+
+    return NULL;
+}
+
+
+/* =============================================================================
+ * TEST_MULTIHEAP
+ * =============================================================================
+ */
+#ifdef TEST_MULTIHEAP
+
+
+#include <stdio.h>
+
+
+TM_SAFE static long
+compare (const void* a, const void* b)
+{
+    return (*((const long*)a) - *((const long*)b));
+}
+
+
+long global_data[] = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5, 8, 9};
+long global_numData = sizeof(global_data) / sizeof(global_data[0]);
+
+int
+main ()
+{
+    puts("Starting...");
+
+    multiheap_t* multiheapPtr = multiheap_alloc(4, 1, &compare);
+    assert(multiheapPtr);
+    unsigned long seed = 1;
+
+    long i;
+    long sum = 0;
+    for (i = 0; i < global_numData; i++) {
+        assert(multiheap_insert(multiheapPtr, &global_data[i], &seed));
+        sum += global_data[i];
+    }
+
+    for (i = 0; i < global_numData; i++) {
+        long* data = (long*)multiheap_remove(multiheapPtr, &seed);
+        assert(data);
+        printf("Removing: %li\n", *data);
+        sum -= *data;
+    }
+
+    assert(sum == 0);
+    assert(multiheap_remove(multiheapPtr, &seed) == NULL); /* empty */
+
+    multiheap_free(multiheapPtr);
+
+    puts("Passed all tests.");
+
+    return 0;
+}
+
+
+#endif /* TEST_MULTIHEAP */
+
+
+/* =============================================================================
+ *
+ * End of multiheap.c
+ *
+ * =============================================================================
+ */
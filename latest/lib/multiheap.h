@@ -0,0 +1,124 @@
+/* =============================================================================
+ *
+ * multiheap.h
+ * -- Relaxed concurrent priority queue built from several heap_t
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+#pragma once
+
+#include "heap.h"
+
+/*
+ * A MultiQueue (Rihani, Sanders, and Dementiev, 2015): numHeap independent
+ * heaps with random insertion and "power of two choices" removal. Each
+ * transaction touches at most two heaps, so concurrent inserts and removes
+ * rarely conflict, at the price of only approximately removing the best
+ * element. Callers pass a private seed that is advanced on every operation.
+ */
+struct multiheap_t;
+
+
+/* =============================================================================
+ * multiheap_alloc
+ * -- Returns NULL on failure
+ * =============================================================================
+ */
+multiheap_t*
+multiheap_alloc (long numHeap,
+                 long initCapacity,
+                 __attribute__((transaction_safe)) long (*compare)(const void*, const void*));
+
+
+/* =============================================================================
+ * multiheap_free
+ * =============================================================================
+ */
+void
+multiheap_free (multiheap_t* multiheapPtr);
+
+
+/* =============================================================================
+ * multiheap_insert
+ * -- Inserts into a randomly chosen heap
+ * -- Returns false on failure
+ * =============================================================================
+ */
+__attribute__((transaction_safe))
+bool
+multiheap_insert (multiheap_t* multiheapPtr, void* dataPtr, unsigned long* seedPtr);
+
+
+/* =============================================================================
+ * multiheap_remove
+ * -- Removes the better of the tops of two randomly chosen heaps; if both are
+ *    empty, falls back to scanning all heaps
+ * -- Returns NULL only if all heaps are empty
+ * =============================================================================
+ */
+__attribute__((transaction_safe))
+void*
+multiheap_remove (multiheap_t* multiheapPtr, unsigned long* seedPtr);
+
+
+#define TMMULTIHEAP_INSERT(m, d, s)     multiheap_insert((m), (d), (s))
+#define TMMULTIHEAP_REMOVE(m, s)        multiheap_remove((m), (s))
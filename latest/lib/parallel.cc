@@ -0,0 +1,470 @@
+/* =============================================================================
+ *
+ * parallel.c
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+
+#include <assert.h>
+#include <string.h>
+#include "parallel.h"
+#include "thread.h"
+
+/*
+ * Each call publishes one value per thread into a slot and passes one
+ * barrier, after which every thread combines the slots it needs by itself.
+ * Calls alternate between two slot sets: a thread can only start writing the
+ * set of call N+2 after the barrier of call N+1, i.e. after every thread has
+ * finished reading the slots of call N. The count restarts in every
+ * parallel region so that threads of a new pool agree on it.
+ */
+
+typedef struct parallel_slot {
+    char value[PARALLEL_VALUE_SIZE];
+} __attribute__((aligned(64))) parallel_slot_t;
+
+static parallel_slot_t global_slot[2][PARALLEL_MAX_THREAD];
+static __thread long   global_region = -1;
+static __thread long   global_round  = 0;
+
+
+/* =============================================================================
+ * publish
+ * -- Returns the slot set with every thread's value once all have arrived
+ * =============================================================================
+ */
+static parallel_slot_t*
+publish (const void* valuePtr, long size)
+{
+    long myId = thread_getId();
+    long numThread = thread_getNumThread();
+
+    assert(numThread <= PARALLEL_MAX_THREAD);
+    assert(size <= PARALLEL_VALUE_SIZE);
+
+    long region = thread_getRegion();
+    if (region != global_region) {
+        global_region = region;
+        global_round = 0;
+    }
+
+    parallel_slot_t* slotArray = global_slot[global_round & 1];
+    global_round++;
+
+    memcpy(slotArray[myId].value, valuePtr, size);
+
+    if (numThread > 1) {
+        thread_barrier_wait();
+    }
+
+    return slotArray;
+}
+
+
+/* =============================================================================
+ * addLong
+ * =============================================================================
+ */
+static void
+addLong (void* accumPtr, const void* valuePtr)
+{
+    *(long*)accumPtr += *(const long*)valuePtr;
+}
+
+
+/* =============================================================================
+ * maxLong
+ * =============================================================================
+ */
+static void
+maxLong (void* accumPtr, const void* valuePtr)
+{
+    if (*(const long*)valuePtr > *(long*)accumPtr) {
+        *(long*)accumPtr = *(const long*)valuePtr;
+    }
+}
+
+
+/* =============================================================================
+ * addFloat
+ * =============================================================================
+ */
+static void
+addFloat (void* accumPtr, const void* valuePtr)
+{
+    *(float*)accumPtr += *(const float*)valuePtr;
+}
+
+
+/* =============================================================================
+ * parallel_getRange
+ * =============================================================================
+ */
+void
+parallel_getRange (long numElement, long* startPtr, long* stopPtr)
+{
+    long myId = thread_getId();
+    long numThread = thread_getNumThread();
+
+    *startPtr = (numElement * myId) / numThread;
+    *stopPtr = (numElement * (myId + 1)) / numThread;
+}
+
+
+/* =============================================================================
+ * parallel_reduce
+ * =============================================================================
+ */
+void
+parallel_reduce (void* valuePtr, long size, parallel_op_t op)
+{
+    long numThread = thread_getNumThread();
+    parallel_slot_t* slotArray = publish(valuePtr, size);
+
+    memcpy(valuePtr, slotArray[0].value, size);
+
+    long t;
+    for (t = 1; t < numThread; t++) {
+        op(valuePtr, slotArray[t].value);
+    }
+}
+
+
+/* =============================================================================
+ * parallel_reduceSumLong
+ * =============================================================================
+ */
+long
+parallel_reduceSumLong (long value)
+{
+    parallel_reduce(&value, sizeof(long), &addLong);
+
+    return value;
+}
+
+
+/* =============================================================================
+ * parallel_reduceMaxLong
+ * =============================================================================
+ */
+long
+parallel_reduceMaxLong (long value)
+{
+    parallel_reduce(&value, sizeof(long), &maxLong);
+
+    return value;
+}
+
+
+/* =============================================================================
+ * parallel_reduceSumFloat
+ * =============================================================================
+ */
+float
+parallel_reduceSumFloat (float value)
+{
+    parallel_reduce(&value, sizeof(float), &addFloat);
+
+    return value;
+}
+
+
+/* =============================================================================
+ * parallel_scanThread
+ * =============================================================================
+ */
+long
+parallel_scanThread (long value, long* totalPtr)
+{
+    long myId = thread_getId();
+    long numThread = thread_getNumThread();
+    parallel_slot_t* slotArray = publish(&value, sizeof(long));
+
+    long prefix = 0;
+    long total = 0;
+    long t;
+    for (t = 0; t < numThread; t++) {
+        if (t == myId) {
+            prefix = total;
+        }
+        total += *(long*)slotArray[t].value;
+    }
+
+    if (totalPtr) {
+        *totalPtr = total;
+    }
+
+    return prefix;
+}
+
+
+/* =============================================================================
+ * parallel_exclusiveScan
+ * =============================================================================
+ */
+long
+parallel_exclusiveScan (long* resultArray, const long* inputArray, long numElement)
+{
+    long i_start;
+    long i_stop;
+    parallel_getRange(numElement, &i_start, &i_stop);
+
+    long sum = 0;
+    long i;
+    for (i = i_start; i < i_stop; i++) {
+        sum += inputArray[i];
+    }
+
+    long total;
+    sum = parallel_scanThread(sum, &total);
+
+    for (i = i_start; i < i_stop; i++) {
+        long value = inputArray[i];
+        resultArray[i] = sum;
+        sum += value;
+    }
+
+    return total;
+}
+
+
+/* =============================================================================
+ * parallel_partition
+ * =============================================================================
+ */
+long
+parallel_partition (void* dstArray,
+                    const void* srcArray,
+                    long numElement,
+                    long elementSize,
+                    bool (*isFirst)(const void* elementPtr, void* argPtr),
+                    void* argPtr)
+{
+    const char* src = (const char*)srcArray;
+    char* dst = (char*)dstArray;
+
+    long i_start;
+    long i_stop;
+    parallel_getRange(numElement, &i_start, &i_stop);
+
+    long numFirst = 0;
+    long i;
+    for (i = i_start; i < i_stop; i++) {
+        if (isFirst(src + i * elementSize, argPtr)) {
+            numFirst++;
+        }
+    }
+
+    long totalFirst;
+    long firstIndex = parallel_scanThread(numFirst, &totalFirst);
+    long secondIndex = totalFirst + (i_start - firstIndex);
+
+    for (i = i_start; i < i_stop; i++) {
+        const char* elementPtr = src + i * elementSize;
+        if (isFirst(elementPtr, argPtr)) {
+            memcpy(dst + (firstIndex++) * elementSize, elementPtr, elementSize);
+        } else {
+            memcpy(dst + (secondIndex++) * elementSize, elementPtr, elementSize);
+        }
+    }
+
+    return totalFirst;
+}
+
+
+/* =============================================================================
+ * TEST_PARALLEL
+ * =============================================================================
+ */
+#ifdef TEST_PARALLEL
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+#define NUM_ELEMENT  100003
+#define NUM_ROUND    50
+
+static long global_input[NUM_ELEMENT];
+static long global_scan[NUM_ELEMENT];
+static long global_partition[NUM_ELEMENT];
+static long global_numError = 0;
+
+
+static bool
+isEven (const void* elementPtr, void* argPtr __attribute__((unused)))
+{
+    return ((*(const long*)elementPtr % 2) == 0);
+}
+
+
+static void
+concat (void* accumPtr, const void* valuePtr)
+{
+    /* Non-commutative: accum = accum * 10 + value */
+    *(long*)accumPtr = *(long*)accumPtr * 10 + *(const long*)valuePtr;
+}
+
+
+static void
+check (void* argPtr __attribute__((unused)))
+{
+    long myId = thread_getId();
+    long numThread = thread_getNumThread();
+    long r;
+
+    for (r = 0; r < NUM_ROUND; r++) {
+        long sum = parallel_reduceSumLong(myId + r);
+        long max = parallel_reduceMaxLong(myId * r);
+        long digit = myId + 1;
+        parallel_reduce(&digit, sizeof(long), &concat);
+        long prefix = parallel_scanThread(myId + 1, NULL);
+
+        long expectDigit = 0;
+        long t;
+        for (t = 0; t < numThread; t++) {
+            expectDigit = expectDigit * 10 + (t + 1);
+        }
+        if (sum != (numThread * (numThread - 1) / 2 + numThread * r) ||
+            max != (numThread - 1) * r ||
+            digit != expectDigit ||
+            prefix != (myId * (myId + 1) / 2))
+        {
+            __transaction_atomic {
+                global_numError++;
+            }
+        }
+    }
+
+    parallel_reduceSumLong(0); /* odd number of calls per region */
+
+    long total = parallel_exclusiveScan(global_scan, global_input, NUM_ELEMENT);
+    long numEven = parallel_partition(global_partition, global_input,
+                                      NUM_ELEMENT, sizeof(long), &isEven, NULL);
+
+    thread_barrier_wait();
+
+    if (myId == 0) {
+        long expect = 0;
+        long i;
+        for (i = 0; i < NUM_ELEMENT; i++) {
+            if (global_scan[i] != expect) {
+                global_numError++;
+            }
+            expect += global_input[i];
+        }
+        if (total != expect) {
+            global_numError++;
+        }
+        long e = 0;
+        long o = numEven;
+        for (i = 0; i < NUM_ELEMENT; i++) {
+            long* dstPtr = (global_input[i] % 2 == 0) ?
+                           &global_partition[e++] : &global_partition[o++];
+            if (*dstPtr != global_input[i]) {
+                global_numError++;
+            }
+        }
+        if (e != numEven) {
+            global_numError++;
+        }
+    }
+}
+
+
+int
+main ()
+{
+    long numThread;
+    long i;
+
+    puts("Starting...");
+
+    for (i = 0; i < NUM_ELEMENT; i++) {
+        global_input[i] = (i * 7919) % 1000;
+    }
+
+    for (numThread = 1; numThread <= 8; numThread *= 2) {
+        thread_startup(numThread);
+        thread_start(check, NULL);
+        thread_start(check, NULL);
+        thread_shutdown();
+        printf("%li threads: %s\n",
+               numThread, ((global_numError == 0) ? "passed" : "FAILED"));
+    }
+
+    puts("Done.");
+
+    return ((global_numError == 0) ? 0 : 1);
+}
+
+
+#endif /* TEST_PARALLEL */
+
+
+/* =============================================================================
+ *
+ * End of parallel.c
+ *
+ * =============================================================================
+ */
@@ -0,0 +1,162 @@
+/* =============================================================================
+ *
+ * parallel.h
+ * -- Scan, reduce and partition across the threads of thread_start()
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+#pragma once
+
+/*
+ * Collective operations for the threads of a thread_start() region. Every
+ * thread of the region must make the same sequence of calls. Each call costs
+ * one barrier (none with a single thread) and uses static per-thread slots,
+ * so nothing is allocated per call. Array results are written per thread;
+ * elements written by other threads are visible after the next
+ * thread_barrier_wait().
+ */
+
+#define PARALLEL_MAX_THREAD  256
+#define PARALLEL_VALUE_SIZE  64   /* max bytes per reduced value */
+
+typedef void (*parallel_op_t)(void* accumPtr, const void* valuePtr);
+
+
+/* =============================================================================
+ * parallel_getRange
+ * -- Contiguous block [*startPtr, *stopPtr) of [0, numElement) for this thread
+ * =============================================================================
+ */
+void
+parallel_getRange (long numElement, long* startPtr, long* stopPtr);
+
+
+/* =============================================================================
+ * parallel_reduce
+ * -- Combines every thread's *valuePtr with op in thread order; op must be
+ *    associative but need not be commutative
+ * -- On return *valuePtr holds the result on every thread
+ * =============================================================================
+ */
+void
+parallel_reduce (void* valuePtr, long size, parallel_op_t op);
+
+
+/* =============================================================================
+ * parallel_reduceSumLong
+ * =============================================================================
+ */
+long
+parallel_reduceSumLong (long value);
+
+
+/* =============================================================================
+ * parallel_reduceMaxLong
+ * =============================================================================
+ */
+long
+parallel_reduceMaxLong (long value);
+
+
+/* =============================================================================
+ * parallel_reduceSumFloat
+ * =============================================================================
+ */
+float
+parallel_reduceSumFloat (float value);
+
+
+/* =============================================================================
+ * parallel_scanThread
+ * -- Returns the sum of value over lower thread ids; *totalPtr gets the sum
+ *    over all threads if totalPtr is not NULL
+ * =============================================================================
+ */
+long
+parallel_scanThread (long value, long* totalPtr);
+
+
+/* =============================================================================
+ * parallel_exclusiveScan
+ * -- resultArray[i] = inputArray[0] + ... + inputArray[i-1]; may be in place
+ * -- Returns the sum of all elements on every thread
+ * =============================================================================
+ */
+long
+parallel_exclusiveScan (long* resultArray, const long* inputArray, long numElement);
+
+
+/* =============================================================================
+ * parallel_partition
+ * -- Stable: copies the elements of srcArray for which isFirst is true to the
+ *    front of dstArray, the others after them
+ * -- Returns the number of elements for which isFirst is true
+ * =============================================================================
+ */
+long
+parallel_partition (void* dstArray,
+                    const void* srcArray,
+                    long numElement,
+                    long elementSize,
+                    bool (*isFirst)(const void* elementPtr, void* argPtr),
+                    void* argPtr);
+
@@ -142,6 +142,22 @@ queue_isEmpty (queue_t* queuePtr)
     return (((pop + 1) % capacity == push) ? true : false);
 }
 
+
+/* =============================================================================
+ * queue_getSize
+ * =============================================================================
+ */
+TM_SAFE
+long
+queue_getSize (queue_t* queuePtr)
+{
+    long pop      = queuePtr->pop;
+    long push     = queuePtr->push;
+    long capacity = queuePtr->capacity;
+
+    return ((push - pop - 1 + capacity) % capacity);
+}
+
 /* =============================================================================
  * queue_clear
  * =============================================================================
@@ -270,6 +286,203 @@ queue_pop (queue_t* queuePtr)
 }
 
 
+/* =============================================================================
+ * mpmcqueue_t
+ * -- The producer and consumer indices live on separate cache lines; slot i
+ *    holds data for index pos when its sequence equals pos + 1, and is free
+ *    for index pos when its sequence equals pos
+ * =============================================================================
+ */
+
+#define MPMCQUEUE_LINE (64)
+
+struct mpmcqueue_cell_t {
+    unsigned long sequence;
+    void* dataPtr;
+};
+
+struct mpmcqueue_t {
+    mpmcqueue_cell_t* cells;
+    unsigned long mask;
+    char pad0[MPMCQUEUE_LINE - sizeof(mpmcqueue_cell_t*) - sizeof(unsigned long)];
+    unsigned long pushPos;
+    char pad1[MPMCQUEUE_LINE - sizeof(unsigned long)];
+    unsigned long popPos;
+    char pad2[MPMCQUEUE_LINE - sizeof(unsigned long)];
+};
+
+
+/* =============================================================================
+ * mpmcqueue_alloc
+ * =============================================================================
+ */
+mpmcqueue_t*
+mpmcqueue_alloc (long capacity)
+{
+    unsigned long size = 2;
+    while ((long)size < capacity) {
+        size <<= 1;
+    }
+
+    mpmcqueue_t* queuePtr = NULL;
+    if (posix_memalign((void**)&queuePtr, MPMCQUEUE_LINE, sizeof(mpmcqueue_t))) {
+        return NULL;
+    }
+    queuePtr->cells =
+        (mpmcqueue_cell_t*)malloc(size * sizeof(mpmcqueue_cell_t));
+    if (queuePtr->cells == NULL) {
+        free(queuePtr);
+        return NULL;
+    }
+
+    unsigned long i;
+    for (i = 0; i < size; i++) {
+        queuePtr->cells[i].sequence = i;
+        queuePtr->cells[i].dataPtr = NULL;
+    }
+    queuePtr->mask = size - 1;
+    queuePtr->pushPos = 0;
+    queuePtr->popPos = 0;
+
+    return queuePtr;
+}
+
+
+/* =============================================================================
+ * mpmcqueue_free
+ * =============================================================================
+ */
+void
+mpmcqueue_free (mpmcqueue_t* queuePtr)
+{
+    free(queuePtr->cells);
+    free(queuePtr);
+}
+
+
+/* =============================================================================
+ * mpmcqueue_isEmpty
+ * =============================================================================
+ */
+bool
+mpmcqueue_isEmpty (mpmcqueue_t* queuePtr)
+{
+    unsigned long popPos = __atomic_load_n(&queuePtr->popPos, __ATOMIC_ACQUIRE);
+    unsigned long pushPos = __atomic_load_n(&queuePtr->pushPos, __ATOMIC_ACQUIRE);
+
+    return ((long)(pushPos - popPos) <= 0);
+}
+
+
+/* =============================================================================
+ * mpmcqueue_push
+ * =============================================================================
+ */
+bool
+mpmcqueue_push (mpmcqueue_t* queuePtr, void* dataPtr)
+{
+    mpmcqueue_cell_t* cells = queuePtr->cells;
+    unsigned long mask = queuePtr->mask;
+    unsigned long pos = __atomic_load_n(&queuePtr->pushPos, __ATOMIC_RELAXED);
+    mpmcqueue_cell_t* cellPtr;
+
+    while (1) {
+        cellPtr = &cells[pos & mask];
+        unsigned long sequence =
+            __atomic_load_n(&cellPtr->sequence, __ATOMIC_ACQUIRE);
+        long diff = (long)(sequence - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&queuePtr->pushPos, &pos, (pos + 1),
+                                            true, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false; /* full */
+        } else {
+            pos = __atomic_load_n(&queuePtr->pushPos, __ATOMIC_RELAXED);
+        }
+    }
+
+    cellPtr->dataPtr = dataPtr;
+    __atomic_store_n(&cellPtr->sequence, (pos + 1), __ATOMIC_RELEASE);
+
+    return true;
+}
+
+
+/* =============================================================================
+ * mpmcqueue_pop
+ * =============================================================================
+ */
+void*
+mpmcqueue_pop (mpmcqueue_t* queuePtr)
+{
+    void* dataPtr;
+
+    return ((mpmcqueue_popBatch(queuePtr, &dataPtr, 1) == 1) ? dataPtr : NULL);
+}
+
+
+/* =============================================================================
+ * mpmcqueue_popBatch
+ * -- Counts the ready slots from popPos, claims them all with one CAS, then
+ *    reads and releases them; a claimed slot cannot be reused by a producer
+ *    until its sequence is advanced here
+ * =============================================================================
+ */
+long
+mpmcqueue_popBatch (mpmcqueue_t* queuePtr, void** dataPtrs, long maxNumData)
+{
+    mpmcqueue_cell_t* cells = queuePtr->cells;
+    unsigned long mask = queuePtr->mask;
+    unsigned long pos = __atomic_load_n(&queuePtr->popPos, __ATOMIC_RELAXED);
+    long numData;
+
+    if (maxNumData > (long)(mask + 1)) {
+        maxNumData = (long)(mask + 1);
+    }
+
+    while (1) {
+        numData = 0;
+        while (numData < maxNumData) {
+            mpmcqueue_cell_t* cellPtr = &cells[(pos + numData) & mask];
+            unsigned long sequence =
+                __atomic_load_n(&cellPtr->sequence, __ATOMIC_ACQUIRE);
+            if (sequence != (pos + numData + 1)) {
+                break;
+            }
+            numData++;
+        }
+        if (numData == 0) {
+            mpmcqueue_cell_t* cellPtr = &cells[pos & mask];
+            unsigned long sequence =
+                __atomic_load_n(&cellPtr->sequence, __ATOMIC_ACQUIRE);
+            if ((long)(sequence - (pos + 1)) < 0) {
+                return 0; /* empty */
+            }
+            pos = __atomic_load_n(&queuePtr->popPos, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (__atomic_compare_exchange_n(&queuePtr->popPos, &pos, (pos + numData),
+                                        true, __ATOMIC_RELAXED,
+                                        __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+
+    long i;
+    for (i = 0; i < numData; i++) {
+        mpmcqueue_cell_t* cellPtr = &cells[(pos + i) & mask];
+        dataPtrs[i] = cellPtr->dataPtr;
+        __atomic_store_n(&cellPtr->sequence, (pos + i + mask + 1),
+                         __ATOMIC_RELEASE);
+    }
+
+    return numData;
+}
+
+
 /* =============================================================================
  * TEST_QUEUE
  * =============================================================================
@@ -359,6 +572,94 @@ main ()
 #endif /* TEST_QUEUE */
 
 
+/* =============================================================================
+ * TEST_MPMCQUEUE
+ * =============================================================================
+ */
+#ifdef TEST_MPMCQUEUE
+
+#include <assert.h>
+#include <stdio.h>
+#include "thread.h"
+
+#define TEST_NUM_DATA (100000)
+
+static mpmcqueue_t* global_queuePtr;
+static long*        global_seen;
+
+
+static void
+testPop (void* argPtr)
+{
+    void* dataPtrs[7];
+
+    while (1) {
+        long n = mpmcqueue_popBatch(global_queuePtr, dataPtrs,
+                                    (1 + (thread_getId() % 7)));
+        if (n == 0) {
+            break;
+        }
+        long i;
+        for (i = 0; i < n; i++) {
+            long d = (long)dataPtrs[i];
+            global_seen[d] = global_seen[d] + 1; /* each index is popped once */
+        }
+    }
+}
+
+
+int
+main ()
+{
+    puts("Starting tests...");
+
+    mpmcqueue_t* queuePtr = mpmcqueue_alloc(5);
+    assert(mpmcqueue_isEmpty(queuePtr));
+    long i;
+    for (i = 1; i <= 8; i++) {
+        assert(mpmcqueue_push(queuePtr, (void*)i));
+    }
+    assert(!mpmcqueue_push(queuePtr, (void*)9L));
+    void* dataPtrs[3];
+    assert(mpmcqueue_popBatch(queuePtr, dataPtrs, 3) == 3);
+    assert((long)dataPtrs[0] == 1 && (long)dataPtrs[2] == 3);
+    for (i = 9; i <= 11; i++) {
+        assert(mpmcqueue_push(queuePtr, (void*)i));
+    }
+    for (i = 4; i <= 11; i++) {
+        assert((long)mpmcqueue_pop(queuePtr) == i);
+    }
+    assert(mpmcqueue_pop(queuePtr) == NULL);
+    assert(mpmcqueue_isEmpty(queuePtr));
+    mpmcqueue_free(queuePtr);
+
+    long numThread;
+    for (numThread = 1; numThread <= 8; numThread *= 2) {
+        global_queuePtr = mpmcqueue_alloc(TEST_NUM_DATA);
+        global_seen = (long*)calloc(TEST_NUM_DATA, sizeof(long));
+        for (i = 0; i < TEST_NUM_DATA; i++) {
+            assert(mpmcqueue_push(global_queuePtr, (void*)i));
+        }
+        thread_startup(numThread);
+        thread_start(testPop, NULL);
+        thread_shutdown();
+        for (i = 0; i < TEST_NUM_DATA; i++) {
+            assert(global_seen[i] == 1);
+        }
+        free(global_seen);
+        mpmcqueue_free(global_queuePtr);
+        printf("%li threads: ok\n", numThread);
+    }
+
+    puts("All tests passed.");
+
+    return 0;
+}
+
+
+#endif /* TEST_MPMCQUEUE */
+
+
 /* =============================================================================
  *
  * End of queue.c
@@ -102,6 +102,15 @@ bool
 queue_isEmpty (  queue_t* queuePtr);
 
 
+/* =============================================================================
+ * queue_getSize
+ * =============================================================================
+ */
+__attribute__((transaction_safe))
+long
+queue_getSize (queue_t* queuePtr);
+
+
 /* =============================================================================
  * queue_clear
  * =============================================================================
@@ -146,3 +155,69 @@ queue_pop (  queue_t* queuePtr);
 #define TMQUEUE_CLEAR(q)    queue_clear(q)
 #define TMQUEUE_PUSH(q, d)  queue_push(q, (void*)(d))
 #define TMQUEUE_POP(q)      queue_pop(q)
+
+
+/*
+ * A bounded multi-producer/multi-consumer ring (Vyukov) for coordination
+ * queues that are filled up front and drained by worker threads. Each slot
+ * carries a sequence number, so producers and consumers only contend on
+ * their own index and never abort each other's transactions. Unlike
+ * queue_t it must NOT be used inside a transaction.
+ */
+struct mpmcqueue_t;
+
+
+/* =============================================================================
+ * mpmcqueue_alloc
+ * -- Capacity is rounded up to a power of two
+ * -- Returns NULL on failure
+ * =============================================================================
+ */
+mpmcqueue_t*
+mpmcqueue_alloc (long capacity);
+
+
+/* =============================================================================
+ * mpmcqueue_free
+ * =============================================================================
+ */
+void
+mpmcqueue_free (mpmcqueue_t* queuePtr);
+
+
+/* =============================================================================
+ * mpmcqueue_isEmpty
+ * -- Only a hint while other threads are pushing or popping
+ * =============================================================================
+ */
+bool
+mpmcqueue_isEmpty (mpmcqueue_t* queuePtr);
+
+
+/* =============================================================================
+ * mpmcqueue_push
+ * -- Returns false if full
+ * =============================================================================
+ */
+bool
+mpmcqueue_push (mpmcqueue_t* queuePtr, void* dataPtr);
+
+
+/* =============================================================================
+ * mpmcqueue_pop
+ * -- Returns NULL if empty
+ * =============================================================================
+ */
+void*
+mpmcqueue_pop (mpmcqueue_t* queuePtr);
+
+
+/* =============================================================================
+ * mpmcqueue_popBatch
+ * -- Pops up to maxNumData consecutive elements with one index update
+ * -- Returns the number popped; 0 if empty
+ * =============================================================================
+ */
+long
+mpmcqueue_popBatch (mpmcqueue_t* queuePtr, void** dataPtrs, long maxNumData);
+
@@ -0,0 +1,317 @@
+/* =============================================================================
+ *
+ * svector.h
+ * -- Typed vector with inline small-buffer storage
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+
+#pragma once
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tm_transition.h"
+
+/*
+ * Unlike vector_t, elements are stored by value and the first N live inside
+ * the struct, so short vectors never touch the allocator. Growth doubles
+ * into the heap; svector_clear() keeps whatever capacity has been reached,
+ * and svector_reserve() lets callers size the buffer up front. T must be
+ * trivially copyable. Since elements may point into the struct itself, an
+ * svector_t must not be copied bitwise once initialized: use svector_copy()
+ * or svector_move() instead.
+ */
+template <typename T, long N>
+struct svector_t {
+    long size;
+    long capacity;
+    T* elements;
+    T inlineElements[N];
+};
+
+
+/* =============================================================================
+ * svector_init
+ * =============================================================================
+ */
+template <typename T, long N>
+__attribute__((transaction_safe))
+void
+svector_init (svector_t<T, N>* vectorPtr)
+{
+    vectorPtr->size = 0;
+    vectorPtr->capacity = N;
+    vectorPtr->elements = vectorPtr->inlineElements;
+}
+
+
+/* =============================================================================
+ * svector_free
+ * -- Releases any heap storage; the vector is left empty and reusable
+ * =============================================================================
+ */
+template <typename T, long N>
+__attribute__((transaction_safe))
+void
+svector_free (svector_t<T, N>* vectorPtr)
+{
+    if (vectorPtr->elements != vectorPtr->inlineElements) {
+        free(vectorPtr->elements);
+    }
+    svector_init(vectorPtr);
+}
+
+
+/* =============================================================================
+ * svector_reserve
+ * -- Returns false if fail, else true
+ * =============================================================================
+ */
+template <typename T, long N>
+__attribute__((transaction_safe))
+bool
+svector_reserve (svector_t<T, N>* vectorPtr, long capacity)
+{
+    if (capacity <= vectorPtr->capacity) {
+        return true;
+    }
+
+    T* elements = (T*)malloc(capacity * sizeof(T));
+    if (elements == NULL) {
+        return false;
+    }
+    memcpy(elements, vectorPtr->elements, (vectorPtr->size * sizeof(T)));
+    if (vectorPtr->elements != vectorPtr->inlineElements) {
+        free(vectorPtr->elements);
+    }
+    vectorPtr->elements = elements;
+    vectorPtr->capacity = capacity;
+
+    return true;
+}
+
+
+/* =============================================================================
+ * svector_at
+ * =============================================================================
+ */
+template <typename T, long N>
+__attribute__((transaction_safe))
+T
+svector_at (svector_t<T, N>* vectorPtr, long i)
+{
+    assert((i >= 0) && (i < vectorPtr->size));
+
+    return vectorPtr->elements[i];
+}
+
+
+/* =============================================================================
+ * svector_pushBack
+ * -- Returns false if fail, else true
+ * =============================================================================
+ */
+template <typename T, long N>
+__attribute__((transaction_safe))
+bool
+svector_pushBack (svector_t<T, N>* vectorPtr, T data)
+{
+    if (vectorPtr->size == vectorPtr->capacity) {
+        if (!svector_reserve(vectorPtr, (vectorPtr->capacity * 2))) {
+            return false;
+        }
+    }
+    vectorPtr->elements[vectorPtr->size++] = data;
+
+    return true;
+}
+
+
+/* =============================================================================
+ * svector_popBack
+ * -- Vector must not be empty
+ * =============================================================================
+ */
+template <typename T, long N>
+__attribute__((transaction_safe))
+T
+svector_popBack (svector_t<T, N>* vectorPtr)
+{
+    assert(vectorPtr->size > 0);
+
+    return vectorPtr->elements[--(vectorPtr->size)];
+}
+
+
+/* =============================================================================
+ * svector_getSize
+ * =============================================================================
+ */
+template <typename T, long N>
+__attribute__((transaction_safe))
+long
+svector_getSize (svector_t<T, N>* vectorPtr)
+{
+    return vectorPtr->size;
+}
+
+
+/* =============================================================================
+ * svector_getElements
+ * -- Contiguous; valid until the next call that may grow the vector
+ * =============================================================================
+ */
+template <typename T, long N>
+__attribute__((transaction_safe))
+T*
+svector_getElements (svector_t<T, N>* vectorPtr)
+{
+    return vectorPtr->elements;
+}
+
+
+/* =============================================================================
+ * svector_clear
+ * -- Keeps capacity
+ * =============================================================================
+ */
+template <typename T, long N>
+__attribute__((transaction_safe))
+void
+svector_clear (svector_t<T, N>* vectorPtr)
+{
+    vectorPtr->size = 0;
+}
+
+
+/* =============================================================================
+ * svector_copy
+ * -- Returns false if fail, else true
+ * =============================================================================
+ */
+template <typename T, long N, long M>
+__attribute__((transaction_safe))
+bool
+svector_copy (svector_t<T, N>* dstVectorPtr, svector_t<T, M>* srcVectorPtr)
+{
+    long srcSize = srcVectorPtr->size;
+    dstVectorPtr->size = 0;
+    if (!svector_reserve(dstVectorPtr, srcSize)) {
+        return false;
+    }
+    memcpy(dstVectorPtr->elements, srcVectorPtr->elements, (srcSize * sizeof(T)));
+    dstVectorPtr->size = srcSize;
+
+    return true;
+}
+
+
+/* =============================================================================
+ * svector_move
+ * -- Takes over the heap buffer of srcVectorPtr if it has one; otherwise
+ *    copies the inline elements. srcVectorPtr is left empty and inline.
+ * =============================================================================
+ */
+template <typename T, long N>
+__attribute__((transaction_safe))
+void
+svector_move (svector_t<T, N>* dstVectorPtr, svector_t<T, N>* srcVectorPtr)
+{
+    svector_free(dstVectorPtr);
+    if (srcVectorPtr->elements != srcVectorPtr->inlineElements) {
+        dstVectorPtr->elements = srcVectorPtr->elements;
+        dstVectorPtr->capacity = srcVectorPtr->capacity;
+    } else {
+        memcpy(dstVectorPtr->inlineElements, srcVectorPtr->inlineElements,
+               (srcVectorPtr->size * sizeof(T)));
+    }
+    dstVectorPtr->size = srcVectorPtr->size;
+    svector_init(srcVectorPtr);
+}
+
+
+/* =============================================================================
+ * svector_sort
+ * -- Stable insertion sort; linear when the input is nearly sorted
+ * =============================================================================
+ */
+template <typename T, long N>
+__attribute__((transaction_safe))
+void
+svector_sort (svector_t<T, N>* vectorPtr,
+              __attribute__((transaction_safe)) long (*compare)(const T*, const T*))
+{
+    T* elements = vectorPtr->elements;
+    long size = vectorPtr->size;
+    long i;
+
+    for (i = 1; i < size; i++) {
+        T data = elements[i];
+        long j = i;
+        while ((j > 0) && (compare(&data, &elements[j-1]) < 0)) {
+            elements[j] = elements[j-1];
+            j--;
+        }
+        elements[j] = data;
+    }
+}
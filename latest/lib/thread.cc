@@ -83,6 +83,7 @@ static pthread_t*         global_threads           = NULL;
 static void               (*global_funcPtr)(void*) = NULL;
 static void*              global_argPtr            = NULL;
 static volatile bool      global_doShutdown        = false;
+static long               global_region            = 0;
 
 /**
  * threadWait: Synchronizes all threads to start/stop parallel section
@@ -152,6 +153,7 @@ void thread_start(void (*funcPtr)(void*), void* argPtr)
 {
     global_funcPtr = funcPtr;
     global_argPtr = argPtr;
+    global_region++;
 
     long threadId = 0; /* primary */
     threadWait((void*)&threadId);
@@ -202,6 +204,15 @@ long thread_getNumThread()
     return global_numThread;
 }
 
+/**
+ * thread_getRegion: Call after thread_start() to get a number that differs
+ *                   between consecutive parallel regions
+ */
+long thread_getRegion()
+{
+    return global_region;
+}
+
 /**
  * thread_barrier_wait: Call after thread_start() to synchronize threads
  *                      inside parallel region
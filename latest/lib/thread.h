@@ -117,6 +117,16 @@ long
 thread_getNumThread();
 
 
+/* =============================================================================
+ * thread_getRegion
+ * -- Call after thread_start() to get a number that differs between
+ *    consecutive parallel regions
+ * =============================================================================
+ */
+long
+thread_getRegion();
+
+
 /* =============================================================================
  * thread_barrier_wait
  * -- Call after thread_start() to synchronize threads inside parallel region
@@ -0,0 +1,336 @@
+/* =============================================================================
+ *
+ * tmretry.cc
+ * -- Backoff and serial fallback for user-cancelled transactions
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+
+#include <stdio.h>
+#include "thread.h"
+#include "tmretry.h"
+
+/*
+ * Written only by serial attempts, read by every guarded transaction; it is
+ * the value's conflict footprint that matters, not the value itself.
+ */
+static long            global_tmretryToken   = 0;
+static tmretry_site_t* global_tmretrySitePtr = NULL;
+
+
+/* =============================================================================
+ * tmretryPause
+ * =============================================================================
+ */
+static inline void
+tmretryPause ()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __asm__ __volatile__ ("pause" ::: "memory");
+#else
+    __asm__ __volatile__ ("" ::: "memory");
+#endif
+}
+
+
+/* =============================================================================
+ * tmretryRandom
+ * -- xorshift64
+ * =============================================================================
+ */
+static inline unsigned long
+tmretryRandom (tmretry_t* retryPtr)
+{
+    unsigned long x = retryPtr->seed;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    retryPtr->seed = x;
+    return x;
+}
+
+
+/* =============================================================================
+ * tmretryRegister
+ * -- Links the site into the list walked by tmretry_printStats
+ * =============================================================================
+ */
+static void
+tmretryRegister (tmretry_site_t* sitePtr)
+{
+    long expected = 0;
+    if (!__atomic_compare_exchange_n(&sitePtr->isRegistered, &expected, 1,
+                                     false, __ATOMIC_ACQ_REL,
+                                     __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    tmretry_site_t* headPtr = __atomic_load_n(&global_tmretrySitePtr,
+                                              __ATOMIC_ACQUIRE);
+    do {
+        sitePtr->nextPtr = headPtr;
+    } while (!__atomic_compare_exchange_n(&global_tmretrySitePtr, &headPtr,
+                                          sitePtr, true, __ATOMIC_RELEASE,
+                                          __ATOMIC_ACQUIRE));
+}
+
+
+/* =============================================================================
+ * tmretry_start
+ * =============================================================================
+ */
+void
+tmretry_start (tmretry_t* retryPtr, tmretry_site_t* sitePtr)
+{
+    retryPtr->sitePtr = sitePtr;
+    retryPtr->numCancel = 0;
+    retryPtr->isSerial = false;
+    retryPtr->seed = 0;
+    retryPtr->token = 0;
+}
+
+
+/* =============================================================================
+ * tmretry_enter
+ * =============================================================================
+ */
+__attribute__((transaction_safe))
+void
+tmretry_enter (tmretry_t* retryPtr)
+{
+    if (retryPtr->isSerial) {
+        global_tmretryToken = global_tmretryToken + 1;
+    } else {
+        retryPtr->token = global_tmretryToken;
+    }
+}
+
+
+/* =============================================================================
+ * tmretry_backoff
+ * =============================================================================
+ */
+void
+tmretry_backoff (tmretry_t* retryPtr)
+{
+    long numCancel = ++retryPtr->numCancel;
+
+    if (numCancel >= TMRETRY_SERIAL_THRESHOLD) {
+        retryPtr->isSerial = true;
+    }
+
+    if (retryPtr->seed == 0) {
+        retryPtr->seed = ((unsigned long)(thread_getId() + 1) *
+                          0x9E3779B97F4A7C15UL) ^ (unsigned long)retryPtr;
+    }
+
+    long limit = TMRETRY_BACKOFF_MIN;
+    long c;
+    for (c = 1; (c < numCancel) && (limit < TMRETRY_BACKOFF_MAX); c++) {
+        limit *= 2;
+    }
+    if (limit > TMRETRY_BACKOFF_MAX) {
+        limit = TMRETRY_BACKOFF_MAX;
+    }
+
+    long numSpin = (long)(tmretryRandom(retryPtr) % (unsigned long)limit);
+    long s;
+    for (s = 0; s < numSpin; s++) {
+        tmretryPause();
+    }
+}
+
+
+/* =============================================================================
+ * tmretry_finish
+ * =============================================================================
+ */
+void
+tmretry_finish (tmretry_t* retryPtr)
+{
+    long numCancel = retryPtr->numCancel;
+    if (numCancel == 0) {
+        return;
+    }
+
+    tmretry_site_t* sitePtr = retryPtr->sitePtr;
+    __atomic_fetch_add(&sitePtr->numRetried, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&sitePtr->numCancel, numCancel, __ATOMIC_RELAXED);
+    if (retryPtr->isSerial) {
+        __atomic_fetch_add(&sitePtr->numSerial, 1, __ATOMIC_RELAXED);
+    }
+    long maxCancel = __atomic_load_n(&sitePtr->maxCancel, __ATOMIC_RELAXED);
+    while ((numCancel > maxCancel) &&
+           !__atomic_compare_exchange_n(&sitePtr->maxCancel, &maxCancel,
+                                        numCancel, true, __ATOMIC_RELAXED,
+                                        __ATOMIC_RELAXED)) {
+        /* maxCancel reloaded by the failed exchange */
+    }
+
+    tmretryRegister(sitePtr);
+}
+
+
+/* =============================================================================
+ * tmretry_printStats
+ * =============================================================================
+ */
+void
+tmretry_printStats ()
+{
+    tmretry_site_t* sitePtr = __atomic_load_n(&global_tmretrySitePtr,
+                                              __ATOMIC_ACQUIRE);
+    for (; sitePtr != NULL; sitePtr = sitePtr->nextPtr) {
+        printf("Retry %-24s: retried=%li cancels=%li serial=%li max=%li\n",
+               sitePtr->name, sitePtr->numRetried, sitePtr->numCancel,
+               sitePtr->numSerial, sitePtr->maxCancel);
+    }
+}
+
+
+/* =============================================================================
+ * TEST_TMRETRY
+ * =============================================================================
+ */
+#ifdef TEST_TMRETRY
+
+
+#include <stdlib.h>
+
+
+#define NUM_ITERATION  10000
+#define NUM_CANCEL     (TMRETRY_SERIAL_THRESHOLD + 2)
+
+static tmretry_site_t global_testRetrySite = TMRETRY_SITE_INIT("test");
+static long           global_counter       = 0;
+
+
+static void
+work (void*)
+{
+    long i;
+    for (i = 0; i < NUM_ITERATION; i++) {
+        /* Every 100th call cancels NUM_CANCEL times before committing */
+        long numCancelWanted = (((i % 100) == 0) ? NUM_CANCEL : 0);
+        tmretry_t retry;
+        tmretry_start(&retry, &global_testRetrySite);
+        while (1) {
+            __transaction_atomic {
+                tmretry_enter(&retry);
+                if (retry.numCancel >= numCancelWanted) {
+                    global_counter++;
+                    break;
+                }
+                __transaction_cancel;
+            }
+            tmretry_backoff(&retry);
+        }
+        tmretry_finish(&retry);
+    }
+}
+
+
+int
+main ()
+{
+    long numThread;
+    long numError = 0;
+
+    puts("Starting...");
+
+    for (numThread = 1; numThread <= 8; numThread *= 2) {
+        tmretry_site_t* sitePtr = &global_testRetrySite;
+        long numRetried = sitePtr->numRetried;
+        long numCancel = sitePtr->numCancel;
+        long numSerial = sitePtr->numSerial;
+        global_counter = 0;
+        thread_startup(numThread);
+        thread_start(work, NULL);
+        thread_shutdown();
+        long numCall = numThread * NUM_ITERATION / 100;
+        bool isPassed =
+            ((global_counter == numThread * NUM_ITERATION) &&
+             (sitePtr->numRetried - numRetried == numCall) &&
+             (sitePtr->numCancel - numCancel == numCall * NUM_CANCEL) &&
+             (sitePtr->numSerial - numSerial == numCall) &&
+             (sitePtr->maxCancel == NUM_CANCEL));
+        printf("%li threads: %s\n", numThread, (isPassed ? "passed" : "FAILED"));
+        numError += (isPassed ? 0 : 1);
+    }
+
+    tmretry_printStats();
+
+    puts("Done.");
+
+    return ((numError == 0) ? 0 : 1);
+}
+
+
+#endif /* TEST_TMRETRY */
+
+
+/* =============================================================================
+ *
+ * End of tmretry.cc
+ *
+ * =============================================================================
+ */
@@ -0,0 +1,183 @@
+/* =============================================================================
+ *
+ * tmretry.h
+ * -- Backoff and serial fallback for user-cancelled transactions
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+#pragma once
+
+/*
+ * Replaces hand-written
+ *
+ *     while (1) {
+ *         __transaction_atomic { ...; if (done) break; else __transaction_cancel; }
+ *     }
+ *
+ * loops, which retry immediately and forever. Usage:
+ *
+ *     static tmretry_site_t global_fooRetrySite = TMRETRY_SITE_INIT("foo");
+ *
+ *     tmretry_t retry;
+ *     tmretry_start(&retry, &global_fooRetrySite);
+ *     while (1) {
+ *         __transaction_atomic {
+ *             tmretry_enter(&retry);
+ *             ...
+ *             if (done) break;
+ *             else __transaction_cancel;
+ *         }
+ *         tmretry_backoff(&retry);
+ *     }
+ *     tmretry_finish(&retry);
+ *
+ * Each cancel is followed by a randomized, exponentially growing spin. After
+ * TMRETRY_SERIAL_THRESHOLD cancels the attempt goes serial: tmretry_enter()
+ * then writes a global token that every other tmretry_enter() reads, so the
+ * serial attempt conflicts with (and is isolated from) all other guarded
+ * transactions while remaining cancellable. Statistics are only touched on
+ * the retry path; a site shows up in tmretry_printStats() once it has
+ * retried.
+ */
+
+#ifndef TMRETRY_BACKOFF_MIN
+#  define TMRETRY_BACKOFF_MIN       (16)     /* spins after the first cancel */
+#endif
+#ifndef TMRETRY_BACKOFF_MAX
+#  define TMRETRY_BACKOFF_MAX       (16384)
+#endif
+#ifndef TMRETRY_SERIAL_THRESHOLD
+#  define TMRETRY_SERIAL_THRESHOLD  (8)      /* cancels before going serial */
+#endif
+
+typedef struct tmretry_site {
+    const char* name;
+    long numRetried;  /* calls that were cancelled at least once */
+    long numCancel;
+    long numSerial;   /* calls that needed the serial fallback */
+    long maxCancel;   /* most cancels seen by a single call */
+    long isRegistered;
+    struct tmretry_site* nextPtr;
+} tmretry_site_t;
+
+#define TMRETRY_SITE_INIT(name)  { name, 0, 0, 0, 0, 0, NULL }
+
+typedef struct tmretry {
+    tmretry_site_t* sitePtr;
+    long numCancel;
+    bool isSerial;
+    unsigned long seed;
+    long token;       /* last serial token read; keeps the read alive */
+} tmretry_t;
+
+
+/* =============================================================================
+ * tmretry_start
+ * =============================================================================
+ */
+void
+tmretry_start (tmretry_t* retryPtr, tmretry_site_t* sitePtr);
+
+
+/* =============================================================================
+ * tmretry_enter
+ * -- Must be the first statement of the guarded transaction
+ * =============================================================================
+ */
+__attribute__((transaction_safe))
+void
+tmretry_enter (tmretry_t* retryPtr);
+
+
+/* =============================================================================
+ * tmretry_backoff
+ * -- Call after each cancelled attempt, outside the transaction
+ * =============================================================================
+ */
+void
+tmretry_backoff (tmretry_t* retryPtr);
+
+
+/* =============================================================================
+ * tmretry_finish
+ * -- Call once the transaction has committed
+ * =============================================================================
+ */
+void
+tmretry_finish (tmretry_t* retryPtr);
+
+
+/* =============================================================================
+ * tmretry_printStats
+ * -- Prints every site that has retried; prints nothing otherwise
+ * =============================================================================
+ */
+void
+tmretry_printStats ();
+
+
+/* =============================================================================
+ *
+ * End of tmretry.h
+ *
+ * =============================================================================
+ */
@@ -0,0 +1,766 @@
+/* =============================================================================
+ *
+ * trbtree.h
+ * -- Red-black tree with typed keys and a compile-time comparator
+ *
+ * =============================================================================
+ *
+ * Copyright (C) Sun Microsystems Inc., 2006.  All Rights Reserved.
+ * Authors: Dave Dice, Nir Shavit, Ori Shalev.
+ *
+ * STM: Transactional Locking for Disjoint Access Parallelism
+ *
+ * Transactional Locking II,
+ * Dave Dice, Ori Shalev, Nir Shavit
+ * DISC 2006, Sept 2006, Stockholm, Sweden.
+ *
+ * =============================================================================
+ *
+ * Modified by Chi Cao Minh
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ *
+ * ------------------------------------------------------------------------
+ *
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ *
+ * ------------------------------------------------------------------------
+ *
+ * Unless otherwise noted, the following license applies to STAMP files:
+ *
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "tm_transition.h"
+
+/*
+ * Same algorithm as rbtree.cc (Doug Lea's TreeMap, no nil sentinel), but keys
+ * and values are typed and the ordering is a template argument C providing
+ *
+ *     static long compare (K a, K b);   returns {<0, 0, >0}, 0 -> equal
+ *
+ * so every comparison on the lookup path is an inlined call instead of an
+ * indirect transaction_safe call through rbtree_t::compare. map.h exposes
+ * it as the MAP_USE_TRBTREE backend.
+ */
+template <typename K, typename V>
+struct trbtree_node_t {
+    K k;
+    V v;
+    trbtree_node_t<K, V>* p;
+    trbtree_node_t<K, V>* l;
+    trbtree_node_t<K, V>* r;
+    long c;
+};
+
+template <typename K, typename V, typename C>
+struct trbtree_t {
+    trbtree_node_t<K, V>* root;
+};
+
+#define TRBTREE_RED   (0L)
+#define TRBTREE_BLACK (1L)
+
+
+/* =============================================================================
+ * trbtree_compareLong
+ * -- Comparator for integer keys (ids, flow ids)
+ * =============================================================================
+ */
+struct trbtree_compareLong {
+    __attribute__((transaction_safe))
+    static long
+    compare (long a, long b)
+    {
+        return ((a < b) ? -1 : ((a > b) ? 1 : 0));
+    }
+};
+
+
+/* =============================================================================
+ * trbtree_lookup
+ * =============================================================================
+ */
+template <typename K, typename V, typename C>
+__attribute__((transaction_safe))
+inline trbtree_node_t<K, V>*
+trbtree_lookup (trbtree_t<K, V, C>* s, K k)
+{
+    trbtree_node_t<K, V>* p = s->root;
+
+    while (p != NULL) {
+        long cmp = C::compare(k, p->k);
+        if (cmp == 0) {
+            return p;
+        }
+        p = ((cmp < 0) ? p->l : p->r);
+    }
+
+    return NULL;
+}
+
+
+/* =============================================================================
+ * trbtree_rotateLeft
+ * =============================================================================
+ */
+template <typename K, typename V, typename C>
+__attribute__((transaction_safe))
+void
+trbtree_rotateLeft (trbtree_t<K, V, C>* s, trbtree_node_t<K, V>* x)
+{
+    trbtree_node_t<K, V>* r = x->r;
+    trbtree_node_t<K, V>* rl = r->l;
+    x->r = rl;
+    if (rl != NULL) {
+        rl->p = x;
+    }
+    trbtree_node_t<K, V>* xp = x->p;
+    r->p = xp;
+    if (xp == NULL) {
+        s->root = r;
+    } else if (xp->l == x) {
+        xp->l = r;
+    } else {
+        xp->r = r;
+    }
+    r->l = x;
+    x->p = r;
+}
+
+
+/* =============================================================================
+ * trbtree_rotateRight
+ * =============================================================================
+ */
+template <typename K, typename V, typename C>
+__attribute__((transaction_safe))
+void
+trbtree_rotateRight (trbtree_t<K, V, C>* s, trbtree_node_t<K, V>* x)
+{
+    trbtree_node_t<K, V>* l = x->l;
+    trbtree_node_t<K, V>* lr = l->r;
+    x->l = lr;
+    if (lr != NULL) {
+        lr->p = x;
+    }
+    trbtree_node_t<K, V>* xp = x->p;
+    l->p = xp;
+    if (xp == NULL) {
+        s->root = l;
+    } else if (xp->r == x) {
+        xp->r = l;
+    } else {
+        xp->l = l;
+    }
+    l->r = x;
+    x->p = l;
+}
+
+
+/*
+ * Null-tolerant accessors used by the rebalancing code
+ */
+template <typename K, typename V>
+__attribute__((transaction_safe))
+inline trbtree_node_t<K, V>*
+trbtree_parentOf (trbtree_node_t<K, V>* n)
+{
+    return (n ? n->p : NULL);
+}
+
+template <typename K, typename V>
+__attribute__((transaction_safe))
+inline trbtree_node_t<K, V>*
+trbtree_leftOf (trbtree_node_t<K, V>* n)
+{
+    return (n ? n->l : NULL);
+}
+
+template <typename K, typename V>
+__attribute__((transaction_safe))
+inline trbtree_node_t<K, V>*
+trbtree_rightOf (trbtree_node_t<K, V>* n)
+{
+    return (n ? n->r : NULL);
+}
+
+template <typename K, typename V>
+__attribute__((transaction_safe))
+inline long
+trbtree_colorOf (trbtree_node_t<K, V>* n)
+{
+    return (n ? n->c : TRBTREE_BLACK);
+}
+
+template <typename K, typename V>
+__attribute__((transaction_safe))
+inline void
+trbtree_setColor (trbtree_node_t<K, V>* n, long c)
+{
+    if (n != NULL) {
+        n->c = c;
+    }
+}
+
+
+/* =============================================================================
+ * trbtree_fixAfterInsertion
+ * =============================================================================
+ */
+template <typename K, typename V, typename C>
+__attribute__((transaction_safe))
+void
+trbtree_fixAfterInsertion (trbtree_t<K, V, C>* s, trbtree_node_t<K, V>* x)
+{
+    x->c = TRBTREE_RED;
+    while (x != NULL && x != s->root) {
+        trbtree_node_t<K, V>* xp = x->p;
+        if (xp->c != TRBTREE_RED) {
+            break;
+        }
+        trbtree_node_t<K, V>* xpp = trbtree_parentOf(xp);
+        if (xp == trbtree_leftOf(xpp)) {
+            trbtree_node_t<K, V>* y = trbtree_rightOf(xpp);
+            if (trbtree_colorOf(y) == TRBTREE_RED) {
+                trbtree_setColor(xp, TRBTREE_BLACK);
+                trbtree_setColor(y, TRBTREE_BLACK);
+                trbtree_setColor(xpp, TRBTREE_RED);
+                x = xpp;
+            } else {
+                if (x == trbtree_rightOf(xp)) {
+                    x = xp;
+                    trbtree_rotateLeft(s, x);
+                }
+                trbtree_setColor(trbtree_parentOf(x), TRBTREE_BLACK);
+                xpp = trbtree_parentOf(trbtree_parentOf(x));
+                trbtree_setColor(xpp, TRBTREE_RED);
+                if (xpp != NULL) {
+                    trbtree_rotateRight(s, xpp);
+                }
+            }
+        } else {
+            trbtree_node_t<K, V>* y = trbtree_leftOf(xpp);
+            if (trbtree_colorOf(y) == TRBTREE_RED) {
+                trbtree_setColor(xp, TRBTREE_BLACK);
+                trbtree_setColor(y, TRBTREE_BLACK);
+                trbtree_setColor(xpp, TRBTREE_RED);
+                x = xpp;
+            } else {
+                if (x == trbtree_leftOf(xp)) {
+                    x = xp;
+                    trbtree_rotateRight(s, x);
+                }
+                trbtree_setColor(trbtree_parentOf(x), TRBTREE_BLACK);
+                xpp = trbtree_parentOf(trbtree_parentOf(x));
+                trbtree_setColor(xpp, TRBTREE_RED);
+                if (xpp != NULL) {
+                    trbtree_rotateLeft(s, xpp);
+                }
+            }
+        }
+    }
+    trbtree_node_t<K, V>* ro = s->root;
+    if (ro->c != TRBTREE_BLACK) {
+        ro->c = TRBTREE_BLACK;
+    }
+}
+
+
+/* =============================================================================
+ * trbtree_insertNode
+ * -- Links n in and returns NULL, or returns the existing node for k
+ * =============================================================================
+ */
+template <typename K, typename V, typename C>
+__attribute__((transaction_safe))
+trbtree_node_t<K, V>*
+trbtree_insertNode (trbtree_t<K, V, C>* s, K k, V v, trbtree_node_t<K, V>* n)
+{
+    trbtree_node_t<K, V>* t = s->root;
+
+    if (t == NULL) {
+        n->l = NULL;
+        n->r = NULL;
+        n->p = NULL;
+        n->k = k;
+        n->v = v;
+        n->c = TRBTREE_BLACK;
+        s->root = n;
+        return NULL;
+    }
+
+    for (;;) {
+        long cmp = C::compare(k, t->k);
+        if (cmp == 0) {
+            return t;
+        }
+        trbtree_node_t<K, V>* next = ((cmp < 0) ? t->l : t->r);
+        if (next != NULL) {
+            t = next;
+            continue;
+        }
+        n->l = NULL;
+        n->r = NULL;
+        n->k = k;
+        n->v = v;
+        n->p = t;
+        if (cmp < 0) {
+            t->l = n;
+        } else {
+            t->r = n;
+        }
+        trbtree_fixAfterInsertion(s, n);
+        return NULL;
+    }
+}
+
+
+/* =============================================================================
+ * trbtree_successor
+ * =============================================================================
+ */
+template <typename K, typename V>
+__attribute__((transaction_safe))
+trbtree_node_t<K, V>*
+trbtree_successor (trbtree_node_t<K, V>* t)
+{
+    if (t == NULL) {
+        return NULL;
+    } else if (t->r != NULL) {
+        trbtree_node_t<K, V>* p = t->r;
+        while (p->l != NULL) {
+            p = p->l;
+        }
+        return p;
+    } else {
+        trbtree_node_t<K, V>* p = t->p;
+        trbtree_node_t<K, V>* ch = t;
+        while (p != NULL && ch == p->r) {
+            ch = p;
+            p = p->p;
+        }
+        return p;
+    }
+}
+
+
+/* =============================================================================
+ * trbtree_fixAfterDeletion
+ * =============================================================================
+ */
+template <typename K, typename V, typename C>
+__attribute__((transaction_safe))
+void
+trbtree_fixAfterDeletion (trbtree_t<K, V, C>* s, trbtree_node_t<K, V>* x)
+{
+    while (x != s->root && trbtree_colorOf(x) == TRBTREE_BLACK) {
+        if (x == trbtree_leftOf(trbtree_parentOf(x))) {
+            trbtree_node_t<K, V>* sib = trbtree_rightOf(trbtree_parentOf(x));
+            if (trbtree_colorOf(sib) == TRBTREE_RED) {
+                trbtree_setColor(sib, TRBTREE_BLACK);
+                trbtree_setColor(trbtree_parentOf(x), TRBTREE_RED);
+                trbtree_rotateLeft(s, trbtree_parentOf(x));
+                sib = trbtree_rightOf(trbtree_parentOf(x));
+            }
+            if (trbtree_colorOf(trbtree_leftOf(sib)) == TRBTREE_BLACK &&
+                trbtree_colorOf(trbtree_rightOf(sib)) == TRBTREE_BLACK) {
+                trbtree_setColor(sib, TRBTREE_RED);
+                x = trbtree_parentOf(x);
+            } else {
+                if (trbtree_colorOf(trbtree_rightOf(sib)) == TRBTREE_BLACK) {
+                    trbtree_setColor(trbtree_leftOf(sib), TRBTREE_BLACK);
+                    trbtree_setColor(sib, TRBTREE_RED);
+                    trbtree_rotateRight(s, sib);
+                    sib = trbtree_rightOf(trbtree_parentOf(x));
+                }
+                trbtree_setColor(sib, trbtree_colorOf(trbtree_parentOf(x)));
+                trbtree_setColor(trbtree_parentOf(x), TRBTREE_BLACK);
+                trbtree_setColor(trbtree_rightOf(sib), TRBTREE_BLACK);
+                trbtree_rotateLeft(s, trbtree_parentOf(x));
+                x = s->root;
+            }
+        } else { /* symmetric */
+            trbtree_node_t<K, V>* sib = trbtree_leftOf(trbtree_parentOf(x));
+            if (trbtree_colorOf(sib) == TRBTREE_RED) {
+                trbtree_setColor(sib, TRBTREE_BLACK);
+                trbtree_setColor(trbtree_parentOf(x), TRBTREE_RED);
+                trbtree_rotateRight(s, trbtree_parentOf(x));
+                sib = trbtree_leftOf(trbtree_parentOf(x));
+            }
+            if (trbtree_colorOf(trbtree_rightOf(sib)) == TRBTREE_BLACK &&
+                trbtree_colorOf(trbtree_leftOf(sib)) == TRBTREE_BLACK) {
+                trbtree_setColor(sib, TRBTREE_RED);
+                x = trbtree_parentOf(x);
+            } else {
+                if (trbtree_colorOf(trbtree_leftOf(sib)) == TRBTREE_BLACK) {
+                    trbtree_setColor(trbtree_rightOf(sib), TRBTREE_BLACK);
+                    trbtree_setColor(sib, TRBTREE_RED);
+                    trbtree_rotateLeft(s, sib);
+                    sib = trbtree_leftOf(trbtree_parentOf(x));
+                }
+                trbtree_setColor(sib, trbtree_colorOf(trbtree_parentOf(x)));
+                trbtree_setColor(trbtree_parentOf(x), TRBTREE_BLACK);
+                trbtree_setColor(trbtree_leftOf(sib), TRBTREE_BLACK);
+                trbtree_rotateRight(s, trbtree_parentOf(x));
+                x = s->root;
+            }
+        }
+    }
+
+    if (x != NULL && x->c != TRBTREE_BLACK) {
+        x->c = TRBTREE_BLACK;
+    }
+}
+
+
+/* =============================================================================
+ * trbtree_deleteNode
+ * -- Unlinks p; returns the node that should be released
+ * =============================================================================
+ */
+template <typename K, typename V, typename C>
+__attribute__((transaction_safe))
+trbtree_node_t<K, V>*
+trbtree_deleteNode (trbtree_t<K, V, C>* s, trbtree_node_t<K, V>* p)
+{
+    /*
+     * If strictly internal, copy successor's element to p and then make p
+     * point to successor
+     */
+    if (p->l != NULL && p->r != NULL) {
+        trbtree_node_t<K, V>* succ = trbtree_successor(p);
+        p->k = succ->k;
+        p->v = succ->v;
+        p = succ;
+    }
+
+    /* Start fixup at replacement node, if it exists */
+    trbtree_node_t<K, V>* replacement = ((p->l != NULL) ? p->l : p->r);
+
+    if (replacement != NULL) {
+        trbtree_node_t<K, V>* pp = p->p;
+        replacement->p = pp;
+        if (pp == NULL) {
+            s->root = replacement;
+        } else if (p == pp->l) {
+            pp->l = replacement;
+        } else {
+            pp->r = replacement;
+        }
+
+        /* Null out links so they are OK to use by fixAfterDeletion */
+        p->l = NULL;
+        p->r = NULL;
+        p->p = NULL;
+
+        if (p->c == TRBTREE_BLACK) {
+            trbtree_fixAfterDeletion(s, replacement);
+        }
+    } else if (p->p == NULL) { /* we are the only node */
+        s->root = NULL;
+    } else { /* No children. Use self as phantom replacement and unlink */
+        if (p->c == TRBTREE_BLACK) {
+            trbtree_fixAfterDeletion(s, p);
+        }
+        trbtree_node_t<K, V>* pp = p->p;
+        if (pp != NULL) {
+            if (p == pp->l) {
+                pp->l = NULL;
+            } else if (p == pp->r) {
+                pp->r = NULL;
+            }
+            p->p = NULL;
+        }
+    }
+
+    return p;
+}
+
+
+/* =============================================================================
+ * trbtree_alloc
+ * =============================================================================
+ */
+template <typename K, typename V, typename C>
+__attribute__((transaction_safe))
+trbtree_t<K, V, C>*
+trbtree_alloc ()
+{
+    trbtree_t<K, V, C>* s = (trbtree_t<K, V, C>*)malloc(sizeof(*s));
+    if (s) {
+        s->root = NULL;
+    }
+    return s;
+}
+
+
+/* =============================================================================
+ * trbtree_free
+ * =============================================================================
+ */
+template <typename K, typename V, typename C>
+__attribute__((transaction_safe))
+void
+trbtree_free (trbtree_t<K, V, C>* s)
+{
+    /* Iterative post-order walk; the tree is dismantled as it goes */
+    trbtree_node_t<K, V>* n = s->root;
+    while (n != NULL) {
+        if (n->l != NULL) {
+            n = n->l;
+        } else if (n->r != NULL) {
+            n = n->r;
+        } else {
+            trbtree_node_t<K, V>* p = n->p;
+            if (p != NULL) {
+                if (p->l == n) {
+                    p->l = NULL;
+                } else {
+                    p->r = NULL;
+                }
+            }
+            free(n);
+            n = p;
+        }
+    }
+    free(s);
+}
+
+
+/* =============================================================================
+ * trbtree_insert
+ * -- Returns true on success, false if key already present
+ * =============================================================================
+ */
+template <typename K, typename V, typename C>
+__attribute__((transaction_safe))
+bool
+trbtree_insert (trbtree_t<K, V, C>* s, K key, V val)
+{
+    trbtree_node_t<K, V>* n =
+        (trbtree_node_t<K, V>*)malloc(sizeof(trbtree_node_t<K, V>));
+    trbtree_node_t<K, V>* ex = trbtree_insertNode(s, key, val, n);
+    if (ex != NULL) {
+        free(n);
+        return false;
+    }
+    return true;
+}
+
+
+/* =============================================================================
+ * trbtree_delete
+ * -- Returns true if key existed
+ * =============================================================================
+ */
+template <typename K, typename V, typename C>
+__attribute__((transaction_safe))
+bool
+trbtree_delete (trbtree_t<K, V, C>* s, K key)
+{
+    trbtree_node_t<K, V>* n = trbtree_lookup(s, key);
+    if (n == NULL) {
+        return false;
+    }
+    free(trbtree_deleteNode(s, n));
+    return true;
+}
+
+
+/* =============================================================================
+ * trbtree_update
+ * -- Return false if had to insert node first
+ * =============================================================================
+ */
+template <typename K, typename V, typename C>
+__attribute__((transaction_safe))
+bool
+trbtree_update (trbtree_t<K, V, C>* s, K key, V val)
+{
+    trbtree_node_t<K, V>* n =
+        (trbtree_node_t<K, V>*)malloc(sizeof(trbtree_node_t<K, V>));
+    trbtree_node_t<K, V>* ex = trbtree_insertNode(s, key, val, n);
+    if (ex != NULL) {
+        ex->v = val;
+        free(n);
+        return true;
+    }
+    return false;
+}
+
+
+/* =============================================================================
+ * trbtree_get
+ * -- Returns V() (e.g., NULL) if key is absent
+ * =============================================================================
+ */
+template <typename K, typename V, typename C>
+__attribute__((transaction_safe))
+inline V
+trbtree_get (trbtree_t<K, V, C>* s, K key)
+{
+    trbtree_node_t<K, V>* n = trbtree_lookup(s, key);
+    return ((n != NULL) ? n->v : V());
+}
+
+
+/* =============================================================================
+ * trbtree_contains
+ * =============================================================================
+ */
+template <typename K, typename V, typename C>
+__attribute__((transaction_safe))
+inline bool
+trbtree_contains (trbtree_t<K, V, C>* s, K key)
+{
+    return (trbtree_lookup(s, key) != NULL);
+}
+
+
+/* =============================================================================
+ * trbtree_verifyRedBlack
+ * -- Returns black height of the subtree, or 0 if it is not red-black
+ * =============================================================================
+ */
+template <typename K, typename V>
+long
+trbtree_verifyRedBlack (trbtree_node_t<K, V>* root)
+{
+    if (root == NULL) {
+        return 1;
+    }
+
+    long heightLeft  = trbtree_verifyRedBlack(root->l);
+    long heightRight = trbtree_verifyRedBlack(root->r);
+    if (heightLeft == 0 || heightRight == 0 || heightLeft != heightRight) {
+        return 0;
+    }
+    if ((root->l != NULL && root->l->p != root) ||
+        (root->r != NULL && root->r->p != root))
+    {
+        return 0;
+    }
+
+    if (root->c == TRBTREE_RED) {
+        if ((root->l != NULL && root->l->c != TRBTREE_BLACK) ||
+            (root->r != NULL && root->r->c != TRBTREE_BLACK))
+        {
+            return 0;
+        }
+        return heightLeft;
+    }
+    if (root->c != TRBTREE_BLACK) {
+        return 0;
+    }
+
+    return (heightLeft + 1);
+}
+
+
+/* =============================================================================
+ * trbtree_verify
+ * -- Returns black height (> 0) if valid, else <= 0
+ * =============================================================================
+ */
+template <typename K, typename V, typename C>
+long
+trbtree_verify (trbtree_t<K, V, C>* s, long verbose)
+{
+    trbtree_node_t<K, V>* root = s->root;
+    if (root == NULL) {
+        return 1;
+    }
+    if (root->p != NULL || root->c != TRBTREE_BLACK) {
+        return -1;
+    }
+
+    long numNode = 0;
+    trbtree_node_t<K, V>* its = root;
+    while (its->l != NULL) {
+        its = its->l;
+    }
+    while (its != NULL) {
+        numNode++;
+        trbtree_node_t<K, V>* nxt = trbtree_successor(its);
+        if (nxt != NULL && C::compare(its->k, nxt->k) >= 0) {
+            return -3;
+        }
+        its = nxt;
+    }
+
+    long height = trbtree_verifyRedBlack(root);
+    if (verbose) {
+        printf("Integrity check: Nodes=%ld Depth=%ld\n", numNode, height);
+    }
+
+    return height;
+}
+
+
+#define TMTRBTREE_INSERT(r, k, v)  trbtree_insert(r, k, v)
+#define TMTRBTREE_DELETE(r, k)     trbtree_delete(r, k)
+#define TMTRBTREE_UPDATE(r, k, v)  trbtree_update(r, k, v)
+#define TMTRBTREE_GET(r, k)        trbtree_get(r, k)
+#define TMTRBTREE_CONTAINS(r, k)   trbtree_contains(r, k)
+
+
+/* =============================================================================
+ *
+ * End of trbtree.h
+ *
+ * =============================================================================
+ */
@@ -67,276 +67,258 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "alg_radix_smp.h"
 #include "createPartition.h"
 #include "thread.h"
 
-#define BITS(x, k, j)  ((x>>k) & ~(~0<<j))
+/*
+ * LSD radix sort with 8-bit digits. Scatter goes through per-thread,
+ * per-bucket staging lines (software write-combining), so each store to the
+ * output is a full cache line instead of a random 8-byte write. Histograms,
+ * staging lines and the ping-pong buffers persist across passes and calls;
+ * all_radixsort_release() frees them.
+ */
+
+#define RADIX_BITS    8
+#define RADIX_BUCKET  (1 << RADIX_BITS)
+#define RADIX_MASK    (RADIX_BUCKET - 1)
+#define RADIX_LINE    (64 / sizeof(unsigned long))
+
+typedef struct radix_thread {
+    long histo[RADIX_BUCKET]; /* counts, then next output offset */
+    long fill[RADIX_BUCKET];  /* entries staged per bucket */
+    unsigned long keyLine[RADIX_BUCKET][RADIX_LINE];
+    unsigned long auxLine[RADIX_BUCKET][RADIX_LINE];
+} radix_thread_t;
 
-static long*          global_myHisto = NULL;
-static long*          global_psHisto = NULL;
-static unsigned long* global_lTemp   = NULL;
-static unsigned long* global_lTemp2  = NULL;
+static radix_thread_t* global_radixThread    = NULL;
+static long            global_radixNumThread = 0;
+static unsigned long*  global_radixKeyTemp   = NULL;
+static unsigned long*  global_radixAuxTemp   = NULL;
+static long            global_radixCapacity  = 0;
 
 
 /* =============================================================================
- * all_countsort_node
- *
- * R (range)      must be a multiple of NODES
- * q (elems/proc) must be a multiple of NODES
+ * radixBarrier
  * =============================================================================
  */
-void
-all_countsort_node (long q,
-                    unsigned long* lKey,
-                    unsigned long* lSorted,
-                    long R,
-                    long bitOff,
-                    long m)
+static void
+radixBarrier (long numThread)
 {
-    long myId = thread_getId();
-    long numThread = thread_getNumThread();
+    if (numThread > 1) {
+        thread_barrier_wait();
+    }
+}
 
-    long* myHisto = NULL;
-    long* psHisto = NULL;
 
-    if (myId == 0) {
-        myHisto = (long*)malloc(numThread * R * sizeof(long));
-        assert(myHisto);
-        global_myHisto = myHisto;
-        psHisto = (long*)malloc(numThread * R * sizeof(long));
-        assert(psHisto);
-        global_psHisto = psHisto;
+/* =============================================================================
+ * radixReserve
+ * -- Grows the persistent scratch; only called by thread 0
+ * =============================================================================
+ */
+static void
+radixReserve (long q, long numThread)
+{
+    if (numThread > global_radixNumThread) {
+        free(global_radixThread);
+        global_radixThread =
+            (radix_thread_t*)malloc(numThread * sizeof(radix_thread_t));
+        assert(global_radixThread);
+        global_radixNumThread = numThread;
     }
 
-    thread_barrier_wait();
-
-    myHisto = global_myHisto;
-    psHisto = global_psHisto;
+    if (q > global_radixCapacity) {
+        free(global_radixKeyTemp);
+        free(global_radixAuxTemp);
+        global_radixKeyTemp = (unsigned long*)malloc(q * sizeof(unsigned long));
+        assert(global_radixKeyTemp);
+        global_radixAuxTemp = (unsigned long*)malloc(q * sizeof(unsigned long));
+        assert(global_radixAuxTemp);
+        global_radixCapacity = q;
+    }
+}
 
-    long* mhp = myHisto + myId * R;
 
-    long k;
-    for (k = 0; k < R; k++) {
-        mhp[k] = 0;
-    }
+/* =============================================================================
+ * radixPass
+ * -- Stable scatter of [0, q) by the digit at bitOff; auxKey may be NULL
+ * =============================================================================
+ */
+static void
+radixPass (long myId,
+           long numThread,
+           long q,
+           unsigned long* lKey,
+           unsigned long* lSorted,
+           unsigned long* auxKey,
+           unsigned long* auxSorted,
+           long bitOff)
+{
+    radix_thread_t* rtp = &global_radixThread[myId];
+    long* histo = rtp->histo;
+    long* fill = rtp->fill;
 
     long k_start;
     long k_stop;
     createPartition(0, q, myId, numThread, &k_start, &k_stop);
 
-    for (k = k_start; k < k_stop; k++) {
-        mhp[BITS(lKey[k],bitOff,m)]++;
+    long k;
+    for (k = 0; k < RADIX_BUCKET; k++) {
+        histo[k] = 0;
+        fill[k] = 0;
     }
 
-    thread_barrier_wait();
-
-    createPartition(0, R, myId, numThread, &k_start, &k_stop);
-
-    long last;
-    long j;
     for (k = k_start; k < k_stop; k++) {
-        last = psHisto[k] = myHisto[k];
-        for (j = 1; j < numThread; j++) {
-            long temp = psHisto[j*R + k] = last + myHisto[j*R + k];
-            last = temp;
-        }
+        histo[(lKey[k] >> bitOff) & RADIX_MASK]++;
     }
 
-    long* allHisto = psHisto + (numThread - 1) * R;
-
-    thread_barrier_wait();
+    radixBarrier(numThread);
 
-    long offset = 0;
-
-    long* mps = psHisto + (myId * R);
-    for (k = 0; k < R; k++) {
-        mhp[k]  = (mps[k] - mhp[k]) + offset;
-        offset += allHisto[k];
+    if (myId == 0) {
+        long offset = 0;
+        long b;
+        for (b = 0; b < RADIX_BUCKET; b++) {
+            long t;
+            for (t = 0; t < numThread; t++) {
+                long count = global_radixThread[t].histo[b];
+                global_radixThread[t].histo[b] = offset;
+                offset += count;
+            }
+        }
     }
 
-    thread_barrier_wait();
-
-    createPartition(0, q, myId, numThread, &k_start, &k_stop);
+    radixBarrier(numThread);
 
     for (k = k_start; k < k_stop; k++) {
-        j = BITS(lKey[k],bitOff,m);
-        lSorted[mhp[j]] = lKey[k];
-        mhp[j]++;
+        long b = (lKey[k] >> bitOff) & RADIX_MASK;
+        long f = fill[b];
+        rtp->keyLine[b][f] = lKey[k];
+        if (auxKey) {
+            rtp->auxLine[b][f] = auxKey[k];
+        }
+        if (++f == (long)RADIX_LINE) {
+            memcpy(&lSorted[histo[b]], rtp->keyLine[b], sizeof(rtp->keyLine[b]));
+            if (auxKey) {
+                memcpy(&auxSorted[histo[b]], rtp->auxLine[b], sizeof(rtp->auxLine[b]));
+            }
+            histo[b] += RADIX_LINE;
+            f = 0;
+        }
+        fill[b] = f;
     }
 
-    thread_barrier_wait();
-
-    if (myId == 0) {
-        free(psHisto);
-        free(myHisto);
+    long b;
+    for (b = 0; b < RADIX_BUCKET; b++) {
+        long f = fill[b];
+        memcpy(&lSorted[histo[b]], rtp->keyLine[b], f * sizeof(unsigned long));
+        if (auxKey) {
+            memcpy(&auxSorted[histo[b]], rtp->auxLine[b], f * sizeof(unsigned long));
+        }
     }
+
+    radixBarrier(numThread);
 }
 
 
 /* =============================================================================
- * all_countsort_node_aux_seq
- *
- * R (range)      must be a multiple of NODES
- * q (elems/proc) must be a multiple of NODES
+ * radixSort
+ * -- Ping-pongs between lSorted and the scratch so the last pass lands in
+ *    lSorted; lKeys and auxKey are left untouched
  * =============================================================================
  */
-void
-all_countsort_node_aux_seq (long q,
-                            unsigned long* lKey,
-                            unsigned long* lSorted,
-                            unsigned long* auxKey,
-                            unsigned long* auxSorted,
-                            long R,
-                            long bitOff,
-                            long m)
+static void
+radixSort (long myId,
+           long numThread,
+           long q,
+           unsigned long* lKeys,
+           unsigned long* lSorted,
+           unsigned long* auxKey,
+           unsigned long* auxSorted,
+           long numBit)
 {
-    long* myHisto = (long*)malloc(R * sizeof(long));
-    assert(myHisto);
-    long* psHisto = (long*)malloc(R * sizeof(long));
-    assert(psHisto);
-
-    long* mhp = myHisto;
+    assert(numBit > 0);
 
-    long k;
-    for (k = 0; k < R; k++) {
-        mhp[k] = 0;
+    if (myId == 0) {
+        radixReserve(q, numThread);
     }
 
-    for (k = 0; k < q; k++) {
-        mhp[BITS(lKey[k],bitOff,m)]++;
-    }
+    radixBarrier(numThread);
 
-    long last;
-    long j;
-    for (k = 0; k < R; k++) {
-        last = psHisto[k] = myHisto[k];
-    }
+    long numPass = (numBit + RADIX_BITS - 1) / RADIX_BITS;
 
-    long* allHisto = psHisto;
+    unsigned long* keyDst[2];
+    unsigned long* auxDst[2];
+    keyDst[numPass % 2] = lSorted;
+    auxDst[numPass % 2] = auxSorted;
+    keyDst[(numPass + 1) % 2] = global_radixKeyTemp;
+    auxDst[(numPass + 1) % 2] = global_radixAuxTemp;
 
-    long offset = 0;
+    unsigned long* keySrc = lKeys;
+    unsigned long* auxSrc = auxKey;
 
-    long* mps = psHisto;
-    for (k = 0; k < R; k++) {
-        mhp[k] = (mps[k] - mhp[k]) + offset;
-        offset += allHisto[k];
+    long p;
+    for (p = 0; p < numPass; p++) {
+        unsigned long* keyOut = keyDst[(p + 1) % 2];
+        unsigned long* auxOut = (auxKey ? auxDst[(p + 1) % 2] : NULL);
+        radixPass(myId, numThread, q,
+                  keySrc, keyOut, auxSrc, auxOut, (p * RADIX_BITS));
+        keySrc = keyOut;
+        auxSrc = auxOut;
     }
+}
 
-    for (k = 0; k < q; k++) {
-        j = BITS(lKey[k], bitOff, m);
-        lSorted[mhp[j]] = lKey[k];
-        auxSorted[mhp[j]] = auxKey[k];
-        mhp[j]++;
-    }
 
-    free(psHisto);
-    free(myHisto);
+/* =============================================================================
+ * all_radixsort_node
+ * =============================================================================
+ */
+void
+all_radixsort_node (long q,
+                    unsigned long* lKeys,
+                    unsigned long* lSorted,
+                    long numBit)
+{
+    radixSort(thread_getId(), thread_getNumThread(), q,
+              lKeys, lSorted, NULL, NULL, numBit);
 }
 
 
 /* =============================================================================
- * all_countsort_node_aux
- *
- * R (range)      must be a multiple of NODES
- * q (elems/proc) must be a multiple of NODES
+ * all_radixsort_node_aux
  * =============================================================================
  */
 void
-all_countsort_node_aux (long q,
-                        unsigned long* lKey,
+all_radixsort_node_aux (long q,
+                        unsigned long* lKeys,
                         unsigned long* lSorted,
                         unsigned long* auxKey,
                         unsigned long* auxSorted,
-                        long R,
-                        long bitOff,
-                        long m)
+                        long numBit)
 {
-    long myId = thread_getId();
-    long numThread = thread_getNumThread();
-
-    long* myHisto = NULL;
-    long* psHisto = NULL;
-
-    if (myId == 0) {
-        myHisto = (long*)malloc(numThread * R * sizeof(long));
-        assert(myHisto);
-        global_myHisto = myHisto;
-        psHisto = (long*)malloc(numThread * R * sizeof(long));
-        assert(psHisto);
-        global_psHisto = psHisto;
-    }
-
-    thread_barrier_wait();
-
-    myHisto = global_myHisto;
-    psHisto = global_psHisto;
-
-    long* mhp = myHisto + myId * R;
-
-    long k;
-    for (k = 0; k < R; k++) {
-        mhp[k] = 0;
-    }
-
-    long k_start;
-    long k_stop;
-    createPartition(0, q, myId, numThread, &k_start, &k_stop);
-
-    for (k = k_start; k < k_stop; k++) {
-        mhp[BITS(lKey[k],bitOff,m)]++;
-    }
-
-    thread_barrier_wait();
-
-    createPartition(0, R, myId, numThread, &k_start, &k_stop);
-
-    long last;
-    long j;
-    for (k = k_start; k < k_stop; k++) {
-        last = psHisto[k] = myHisto[k];
-        for (j = 1; j < numThread; j++) {
-            long temp = psHisto[j*R + k] = last + myHisto[j*R + k];
-            last = temp;
-        }
-    }
-
-    long* allHisto = psHisto + (numThread - 1) * R;
-
-    thread_barrier_wait();
-
-    long offset = 0;
-
-    long* mps = psHisto + (myId * R);
-    for (k = 0; k < R; k++) {
-        mhp[k] = (mps[k] - mhp[k]) + offset;
-        offset += allHisto[k];
-    }
-
-    thread_barrier_wait();
-
-    createPartition(0, q, myId, numThread, &k_start, &k_stop);
-
-    for (k = k_start; k < k_stop; k++) {
-        j = BITS(lKey[k], bitOff, m);
-        lSorted[mhp[j]] = lKey[k];
-        auxSorted[mhp[j]] = auxKey[k];
-        mhp[j]++;
-    }
+    radixSort(thread_getId(), thread_getNumThread(), q,
+              lKeys, lSorted, auxKey, auxSorted, numBit);
+}
 
-    thread_barrier_wait();
 
-    if (myId == 0) {
-        free(psHisto);
-        free(myHisto);
-    }
+/* =============================================================================
+ * all_radixsort_node_aux_seq
+ * =============================================================================
+ */
+void
+all_radixsort_node_aux_seq (long q,
+                            unsigned long* lKeys,
+                            unsigned long* lSorted,
+                            unsigned long* auxKey,
+                            unsigned long* auxSorted,
+                            long numBit)
+{
+    radixSort(0, 1, q, lKeys, lSorted, auxKey, auxSorted, numBit);
 }
 
 
 /* =============================================================================
  * all_radixsort_node_s3
- *
- * q (elems/proc) must be a multiple of NODES
  * =============================================================================
  */
 void
@@ -344,36 +326,12 @@ all_radixsort_node_s3 (long q,
                        unsigned long* lKeys,
                        unsigned long* lSorted)
 {
-    long myId = thread_getId();
-
-    unsigned long* lTemp = NULL;
-
-    if (myId == 0) {
-        lTemp = (unsigned long*)malloc(q * sizeof(unsigned long));
-        assert(lTemp);
-        global_lTemp = lTemp;
-    }
-
-    thread_barrier_wait();
-
-    lTemp = global_lTemp;
-
-    all_countsort_node(q, lKeys,   lSorted, (1<<11),  0, 11);
-    all_countsort_node(q, lSorted, lTemp,   (1<<11), 11, 11);
-    all_countsort_node(q, lTemp,   lSorted, (1<<10), 22, 10);
-
-    thread_barrier_wait();
-
-    if (myId == 0) {
-        free(lTemp);
-    }
+    all_radixsort_node(q, lKeys, lSorted, 32);
 }
 
 
 /* =============================================================================
  * all_radixsort_node_s2
- *
- * q (elems/proc) must be a multiple of NODES
  * =============================================================================
  */
 void
@@ -381,35 +339,12 @@ all_radixsort_node_s2 (long q,
                        unsigned long* lKeys,
                        unsigned long* lSorted)
 {
-    long myId = thread_getId();
-
-    unsigned long* lTemp = NULL;
-
-    if (myId == 0) {
-        lTemp = (unsigned long*)malloc(q * sizeof(unsigned long));
-        assert(lTemp);
-        global_lTemp = lTemp;
-    }
-
-    thread_barrier_wait();
-
-    lTemp = global_lTemp;
-
-    all_countsort_node(q, lKeys, lTemp,   (1<<16),  0, 16);
-    all_countsort_node(q, lTemp, lSorted, (1<<16), 16, 16);
-
-    thread_barrier_wait();
-
-    if (myId == 0) {
-        free(lTemp);
-    }
+    all_radixsort_node(q, lKeys, lSorted, 32);
 }
 
 
 /* =============================================================================
  * all_radixsort_node_aux_s3_seq
- *
- * q (elems/proc) must be a multiple of NODES
  * =============================================================================
  */
 void
@@ -419,27 +354,12 @@ all_radixsort_node_aux_s3_seq (long q,
                                unsigned long* auxKey,
                                unsigned long* auxSorted)
 {
-    unsigned long* lTemp  = NULL;
-    unsigned long* lTemp2 = NULL;
-
-    lTemp = (unsigned long*)malloc(q * sizeof(unsigned long));
-    assert(lTemp);
-    lTemp2 = (unsigned long*)malloc(q * sizeof(unsigned long));
-    assert(lTemp2);
-
-    all_countsort_node_aux_seq(q, lKeys, lSorted, auxKey, auxSorted, (1<<11),  0, 11);
-    all_countsort_node_aux_seq(q, lSorted, lTemp, auxSorted, lTemp2, (1<<11), 11, 11);
-    all_countsort_node_aux_seq(q, lTemp, lSorted, lTemp2, auxSorted, (1<<10), 22, 10);
-
-    free(lTemp);
-    free(lTemp2);
+    all_radixsort_node_aux_seq(q, lKeys, lSorted, auxKey, auxSorted, 32);
 }
 
 
 /* =============================================================================
  * all_radixsort_node_aux_s3
- *
- * q (elems/proc) must be a multiple of NODES
  * =============================================================================
  */
 void
@@ -449,35 +369,25 @@ all_radixsort_node_aux_s3 (long q,
                            unsigned long* auxKey,
                            unsigned long* auxSorted)
 {
-    long myId = thread_getId();
-
-    unsigned long* lTemp  = NULL;
-    unsigned long* lTemp2 = NULL;
-
-    if (myId == 0) {
-        lTemp = (unsigned long*)malloc(q * sizeof(unsigned long));
-        assert(lTemp);
-        global_lTemp = lTemp;
-        lTemp2 = (unsigned long*)malloc(q * sizeof(unsigned long));
-        assert(lTemp2);
-        global_lTemp2 = lTemp2;
-    }
-
-    thread_barrier_wait();
-
-    lTemp  = global_lTemp;
-    lTemp2 = global_lTemp2;
-
-    all_countsort_node_aux(q, lKeys, lSorted, auxKey, auxSorted, (1<<11),  0, 11);
-    all_countsort_node_aux(q, lSorted, lTemp, auxSorted, lTemp2, (1<<11), 11, 11);
-    all_countsort_node_aux(q, lTemp, lSorted, lTemp2, auxSorted, (1<<10), 22, 10);
+    all_radixsort_node_aux(q, lKeys, lSorted, auxKey, auxSorted, 32);
+}
 
-    thread_barrier_wait();
 
-    if (myId == 0) {
-        free(lTemp);
-        free(lTemp2);
-    }
+/* =============================================================================
+ * all_radixsort_release
+ * =============================================================================
+ */
+void
+all_radixsort_release ()
+{
+    free(global_radixThread);
+    global_radixThread = NULL;
+    global_radixNumThread = 0;
+    free(global_radixKeyTemp);
+    global_radixKeyTemp = NULL;
+    free(global_radixAuxTemp);
+    global_radixAuxTemp = NULL;
+    global_radixCapacity = 0;
 }
 
 
@@ -487,4 +397,3 @@ all_radixsort_node_aux_s3 (long q,
  *
  * =============================================================================
  */
-
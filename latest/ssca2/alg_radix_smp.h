@@ -69,61 +69,52 @@
 
 
 /* =============================================================================
- * all_countsort_node
+ * all_radixsort_node
  *
- * R (range)      must be a multiple of NODES
- * q (elems/proc) must be a multiple of NODES
+ * -- Stable sort by the low numBit bits of lKeys; called by all threads
  * =============================================================================
  */
 void
-all_countsort_node (long q,
-                    unsigned long* lKey,
+all_radixsort_node (long q,
+                    unsigned long* lKeys,
                     unsigned long* lSorted,
-                    long R,
-                    long bitOff,
-                    long m);
+                    long numBit);
 
 
 /* =============================================================================
- * all_countsort_node_aux_seq
+ * all_radixsort_node_aux
  *
- * R (range)      must be a multiple of NODES
- * q (elems/proc) must be a multiple of NODES
+ * -- As above, carrying auxKey along into auxSorted
  * =============================================================================
  */
 void
-all_countsort_node_aux_seq (long q,
-                            unsigned long* lKey,
-                            unsigned long* lSorted,
-                            unsigned long* auxKey,
-                            unsigned long* auxSorted,
-                            long R,
-                            long bitOff,
-                            long m);
+all_radixsort_node_aux (long q,
+                        unsigned long* lKeys,
+                        unsigned long* lSorted,
+                        unsigned long* auxKey,
+                        unsigned long* auxSorted,
+                        long numBit);
 
 
 /* =============================================================================
- * all_countsort_node_aux
+ * all_radixsort_node_aux_seq
  *
- * R (range)      must be a multiple of NODES
- * q (elems/proc) must be a multiple of NODES
+ * -- Single-threaded all_radixsort_node_aux; no barriers
  * =============================================================================
  */
 void
-all_countsort_node_aux (long q,
-                        unsigned long* lKey,
-                        unsigned long* lSorted,
-                        unsigned long* auxKey,
-                        unsigned long* auxSorted,
-                        long R,
-                        long bitOff,
-                        long m);
+all_radixsort_node_aux_seq (long q,
+                            unsigned long* lKeys,
+                            unsigned long* lSorted,
+                            unsigned long* auxKey,
+                            unsigned long* auxSorted,
+                            long numBit);
 
 
 /* =============================================================================
  * all_radixsort_node_s3
  *
- * q (elems/proc) must be a multiple of NODES
+ * -- 32-bit keys
  * =============================================================================
  */
 void
@@ -135,7 +126,7 @@ all_radixsort_node_s3 (long q,
 /* =============================================================================
  * all_radixsort_node_s2
  *
- * q (elems/proc) must be a multiple of NODES
+ * -- 32-bit keys
  * =============================================================================
  */
 void
@@ -147,7 +138,7 @@ all_radixsort_node_s2 (long q,
 /* =============================================================================
  * all_radixsort_node_aux_s3_seq
  *
- * q (elems/proc) must be a multiple of NODES
+ * -- 32-bit keys
  * =============================================================================
  */
 void
@@ -161,7 +152,7 @@ all_radixsort_node_aux_s3_seq (long q,
 /* =============================================================================
  * all_radixsort_node_aux_s3
  *
- * q (elems/proc) must be a multiple of NODES
+ * -- 32-bit keys
  * =============================================================================
  */
 void
@@ -172,6 +163,16 @@ all_radixsort_node_aux_s3 (long q,
                            unsigned long* auxSorted);
 
 
+/* =============================================================================
+ * all_radixsort_release
+ *
+ * -- Frees the scratch buffers kept between sorts
+ * =============================================================================
+ */
+void
+all_radixsort_release ();
+
+
 #endif /* ALG_RADIX_SMP */
 
 
@@ -181,4 +182,3 @@ all_radixsort_node_aux_s3 (long q,
  *
  * =============================================================================
  */
-
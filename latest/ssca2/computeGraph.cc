@@ -71,78 +71,65 @@
 #include "createPartition.h"
 #include "defs.h"
 #include "globals.h"
+#include "parallel.h"
 #include "thread.h"
 #include "utility.h"
 #include "tm_transition.h"
 
-static ULONGINT_T*  global_p                 = NULL;
-static ULONGINT_T   global_maxNumVertices    = 0;
-static ULONGINT_T   global_outVertexListSize = 0;
-static ULONGINT_T*  global_impliedEdgeList   = NULL;
-static ULONGINT_T** global_auxArr            = NULL;
+static LONGINT_T*   global_inSlot            = NULL;
+static LONGINT_T*   global_inCount           = NULL;
 
 
 /* =============================================================================
- * prefix_sums
+ * findFirstEdge
+ * -- Returns index of first tuple with startVertex >= v (or numEdge)
+ * -- startVertex must be sorted
  * =============================================================================
  */
-static void
-prefix_sums (ULONGINT_T* result, LONGINT_T* input, ULONGINT_T arraySize)
+static ULONGINT_T
+findFirstEdge (ULONGINT_T* startVertex, ULONGINT_T numEdge, ULONGINT_T v)
 {
-    long myId = thread_getId();
-    long numThread = thread_getNumThread();
-
-    ULONGINT_T* p = NULL;
-    if (myId == 0) {
-        p = (ULONGINT_T*)malloc(NOSHARE(numThread) * sizeof(ULONGINT_T));
-        assert(p);
-        global_p = p;
-    }
-
-    thread_barrier_wait();
-
-    p = global_p;
-
-    long start;
-    long end;
-
-    long r = arraySize / numThread;
-    start = myId * r + 1;
-    end = (myId + 1) * r;
-    if (myId == (numThread - 1)) {
-        end = arraySize;
+    ULONGINT_T low = 0;
+    ULONGINT_T high = numEdge;
+
+    while (low < high) {
+        ULONGINT_T mid = low + (high - low) / 2;
+        if (startVertex[mid] < v) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
     }
 
-    //ULONGINT_T j;
-    long j;
-    for (j = start; j < end; j++) {
-        result[j] = input[j-1] + result[j-1];
-    }
+    return low;
+}
 
-    p[NOSHARE(myId)] = result[end-1];
 
-    thread_barrier_wait();
-
-    if (myId == 0) {
-        for (j = 1; j < numThread; j++) {
-            p[NOSHARE(j)] += p[NOSHARE(j-1)];
+/* =============================================================================
+ * hasOutEdge
+ * -- Binary search of the adjacency list of u, which is sorted by endVertex
+ * =============================================================================
+ */
+bool
+hasOutEdge (graph* GPtr, ULONGINT_T u, ULONGINT_T v)
+{
+    ULONGINT_T low = GPtr->outVertexIndex[u];
+    ULONGINT_T high = low + GPtr->outDegree[u];
+
+    while (low < high) {
+        ULONGINT_T mid = low + (high - low) / 2;
+        ULONGINT_T w = GPtr->outVertexList[mid];
+        if (w == v) {
+            return true;
         }
-    }
-
-    thread_barrier_wait();
-
-    if (myId > 0) {
-        ULONGINT_T add_value = p[NOSHARE(myId-1)];
-        for (j = start-1; j < end; j++) {
-            result[j] += add_value;
+        if (w < v) {
+            low = mid + 1;
+        } else {
+            high = mid;
         }
     }
 
-    thread_barrier_wait();
-
-    if (myId == 0) {
-        free(p);
-    }
+    return false;
 }
 
 
@@ -180,17 +167,7 @@ computeGraph (void* argPtr)
         }
     }
 
-    __transaction_atomic {
-      //long tmp_maxNumVertices = (long)TM_SHARED_READ(global_maxNumVertices);
-      //long new_maxNumVertices = MAX(tmp_maxNumVertices, maxNumVertices + 1);
-      //TM_SHARED_WRITE(global_maxNumVertices, (unsigned long)new_maxNumVertices);
-      if (global_maxNumVertices < maxNumVertices + 1)
-        global_maxNumVertices = maxNumVertices + 1;
-    }
-
-    thread_barrier_wait();
-
-    maxNumVertices = global_maxNumVertices;
+    maxNumVertices = parallel_reduceMaxLong(maxNumVertices + 1);
 
     if (myId == 0) {
 
@@ -198,6 +175,8 @@ computeGraph (void* argPtr)
         GPtr->numEdges    = numEdgesPlaced;
         GPtr->intWeight   = SDGdataPtr->intWeight;
         GPtr->strWeight   = SDGdataPtr->strWeight;
+        GPtr->mapPtr      = NULL;
+        GPtr->mapSize     = 0;
 
         for (i = 0; i < numEdgesPlaced; i++) {
             if (GPtr->intWeight[numEdgesPlaced-i-1] < 0) {
@@ -229,83 +208,36 @@ computeGraph (void* argPtr)
 
     thread_barrier_wait();
 
-    //[wer210] unsigned -1 ?
-    ULONGINT_T i0 = -1UL;
-
-    for (i = i_start; i < i_stop; i++) {
-
-        ULONGINT_T k = i;
-        if ((outVertexListSize == 0) && (k != 0)) {
-            while (i0 == -1UL) {
-                for (j = 0; j < numEdgesPlaced; j++) {
-                    if (k == SDGdataPtr->startVertex[j]) {
-                        i0 = j;
-                        break;
-                    }
-
-                }
-                k--;
-            }
-        }
-
-        if ((outVertexListSize == 0) && (k == 0)) {
-            i0 = 0;
-        }
+    /*
+     * The tuples are sorted by startVertex, so the edges of this thread's
+     * vertices form one contiguous slice: find its start with a binary
+     * search and walk it once. Runs of parallel edges (consecutive equal
+     * endVertex) count as one directed edge.
+     */
 
-        for (j = i0; j < numEdgesPlaced; j++) {
-            if (i == GPtr->numVertices-1) {
-                break;
-            }
-            if ((i != SDGdataPtr->startVertex[j])) {
-                if ((j > 0) && (i == SDGdataPtr->startVertex[j-1])) {
-                    if (j-i0 >= 1) {
-                        outVertexListSize++;
-                        GPtr->outDegree[i]++;
-                        ULONGINT_T t;
-                        for (t = i0+1; t < j; t++) {
-                            if (SDGdataPtr->endVertex[t] !=
-                                SDGdataPtr->endVertex[t-1])
-                            {
-                                outVertexListSize++;
-                                GPtr->outDegree[i] = GPtr->outDegree[i]+1;
-                            }
-                        }
-                    }
-                }
-                i0 = j;
-                break;
-            }
-        }
+    ULONGINT_T* startVertex = SDGdataPtr->startVertex;
+    ULONGINT_T* endVertex = SDGdataPtr->endVertex;
+    ULONGINT_T e_start = findFirstEdge(startVertex, numEdgesPlaced, i_start);
+    ULONGINT_T e = e_start;
 
-        if (i == GPtr->numVertices-1) {
-            if (numEdgesPlaced-i0 >= 0) {
-                outVertexListSize++;
-                GPtr->outDegree[i]++;
-                ULONGINT_T t;
-                for (t = i0+1; t < numEdgesPlaced; t++) {
-                    if (SDGdataPtr->endVertex[t] != SDGdataPtr->endVertex[t-1]) {
-                        outVertexListSize++;
-                        GPtr->outDegree[i]++;
-                    }
+    for (i = i_start; i < i_stop; i++) {
+        LONGINT_T degree = 0;
+        if ((e < numEdgesPlaced) && (startVertex[e] == (ULONGINT_T)i)) {
+            degree++;
+            for (e++; (e < numEdgesPlaced) && (startVertex[e] == (ULONGINT_T)i); e++) {
+                if (endVertex[e] != endVertex[e-1]) {
+                    degree++;
                 }
             }
         }
-
-    } /* for i */
-
-    thread_barrier_wait();
-
-    prefix_sums(GPtr->outVertexIndex, GPtr->outDegree, GPtr->numVertices);
-
-    thread_barrier_wait();
-
-    __transaction_atomic {
-        global_outVertexListSize += outVertexListSize;
+        GPtr->outDegree[i] = degree;
     }
 
     thread_barrier_wait();
 
-    outVertexListSize = global_outVertexListSize;
+    outVertexListSize = parallel_exclusiveScan((long*)GPtr->outVertexIndex,
+                                               GPtr->outDegree,
+                                               GPtr->numVertices);
 
     if (myId == 0) {
         GPtr->numDirectedEdges = outVertexListSize;
@@ -315,7 +247,6 @@ computeGraph (void* argPtr)
         GPtr->paralEdgeIndex =
             (ULONGINT_T*)malloc(outVertexListSize * sizeof(ULONGINT_T));
         assert(GPtr->paralEdgeIndex);
-        GPtr->outVertexList[0] = SDGdataPtr->endVertex[0];
     }
 
     thread_barrier_wait();
@@ -324,80 +255,30 @@ computeGraph (void* argPtr)
      * Evaluate outVertexList
      */
 
-    i0 = -1UL;
+    e = e_start;
 
     for (i = i_start; i < i_stop; i++) {
-
-        ULONGINT_T k = i;
-        while ((i0 == -1UL) && (k != 0)) {
-            for (j = 0; j < numEdgesPlaced; j++) {
-                if (k == SDGdataPtr->startVertex[j]) {
-                    i0 = j;
-                    break;
+        if ((e < numEdgesPlaced) && (startVertex[e] == (ULONGINT_T)i)) {
+            ULONGINT_T ii = GPtr->outVertexIndex[i];
+            GPtr->paralEdgeIndex[ii] = e;
+            GPtr->outVertexList[ii] = endVertex[e];
+            for (e++; (e < numEdgesPlaced) && (startVertex[e] == (ULONGINT_T)i); e++) {
+                if (endVertex[e] != endVertex[e-1]) {
+                    ii++;
+                    GPtr->paralEdgeIndex[ii] = e;
+                    GPtr->outVertexList[ii] = endVertex[e];
                 }
             }
-            k--;
-        }
-
-        if ((i0 == -1) && (k == 0)) {
-            i0 = 0;
         }
-
-        for (j = i0; j < numEdgesPlaced; j++) {
-            if (i == GPtr->numVertices-1) {
-                break;
-            }
-            if (i != SDGdataPtr->startVertex[j]) {
-                if ((j > 0) && (i == SDGdataPtr->startVertex[j-1])) {
-                    if (j-i0 >= 1) {
-                        long ii = GPtr->outVertexIndex[i];
-                        ULONGINT_T r = 0;
-                        GPtr->paralEdgeIndex[ii] = i0;
-                        GPtr->outVertexList[ii] = SDGdataPtr->endVertex[i0];
-                        r++;
-                        ULONGINT_T t;
-                        for (t = i0+1; t < j; t++) {
-                            if (SDGdataPtr->endVertex[t] !=
-                                SDGdataPtr->endVertex[t-1])
-                            {
-                                GPtr->paralEdgeIndex[ii+r] = t;
-                                GPtr->outVertexList[ii+r] = SDGdataPtr->endVertex[t];
-                                r++;
-                            }
-                        }
-
-                    }
-                }
-                i0 = j;
-                break;
-            }
-        } /* for j */
-
-        if (i == GPtr->numVertices-1) {
-            ULONGINT_T r = 0;
-            if (numEdgesPlaced - i0 >= 0) {
-                long ii = GPtr->outVertexIndex[i];
-                GPtr->paralEdgeIndex[ii+r] = i0;
-                GPtr->outVertexList[ii+r] = SDGdataPtr->endVertex[i0];
-                r++;
-                ULONGINT_T t;
-                for (t = i0 + 1; t < numEdgesPlaced; t++) {
-                    if (SDGdataPtr->endVertex[t] != SDGdataPtr->endVertex[t-1]) {
-                        GPtr->paralEdgeIndex[ii+r] = t;
-                        GPtr->outVertexList[ii+r] = SDGdataPtr->endVertex[t];
-                        r++;
-                    }
-                }
-            }
-        }
-
-    } /* for i */
+    }
 
     thread_barrier_wait();
 
     if (myId == 0) {
-        free(SDGdataPtr->startVertex);
-        free(SDGdataPtr->endVertex);
+        if (SDGdataPtr->mapPtr == NULL) {
+            free(SDGdataPtr->startVertex);
+            free(SDGdataPtr->endVertex);
+        }
         GPtr->inDegree =
             (LONGINT_T*)malloc(GPtr->numVertices * sizeof(LONGINT_T));
         assert(GPtr->inDegree);
@@ -413,119 +294,92 @@ computeGraph (void* argPtr)
         GPtr->inVertexIndex[i] = 0;
     }
 
-    /* A temp. array to store the inplied edges */
-    ULONGINT_T* impliedEdgeList;
-    if (myId == 0) {
-        impliedEdgeList = (ULONGINT_T*)malloc(GPtr->numVertices
-                                                * MAX_CLUSTER_SIZE
-                                                * sizeof(ULONGINT_T));
-        global_impliedEdgeList = impliedEdgeList;
-    }
-
     thread_barrier_wait();
 
-    impliedEdgeList = global_impliedEdgeList;
-
-    createPartition(0,
-                    (GPtr->numVertices * MAX_CLUSTER_SIZE),
-                    myId,
-                    numThread,
-                    &i_start,
-                    &i_stop);
-
-    for (i = i_start; i < i_stop; i++) {
-        impliedEdgeList[i] = 0;
-    }
-
     /*
-     * An auxiliary array to store implied edges, in case we overshoot
-     * MAX_CLUSTER_SIZE
+     * Build the inVertex list in CSR form: count the implied edges per
+     * vertex, prefix-sum the counts, then scatter. An edge i->v is implied
+     * for v when v has no edge back to i. Each thread counts the edges of
+     * its own source vertices into a private row of per-vertex counts and
+     * remembers each edge's slot within that row; summing the rows per
+     * vertex then gives inDegree and every thread's base offset, so none
+     * of the passes needs transactions. Each list stays sorted by source.
      */
 
-    ULONGINT_T** auxArr;
+    ULONGINT_T numVertices = GPtr->numVertices;
+    LONGINT_T* inSlot;
+    LONGINT_T* inCount;
     if (myId == 0) {
-        auxArr = (ULONGINT_T**)malloc(GPtr->numVertices * sizeof(ULONGINT_T*));
-        assert(auxArr);
-        global_auxArr = auxArr;
+        inSlot = (LONGINT_T*)malloc(GPtr->numDirectedEdges * sizeof(LONGINT_T));
+        assert(inSlot);
+        global_inSlot = inSlot;
+        inCount = (LONGINT_T*)malloc(numThread * numVertices * sizeof(LONGINT_T));
+        assert(inCount);
+        global_inCount = inCount;
     }
 
     thread_barrier_wait();
 
-    auxArr = global_auxArr;
+    inSlot = global_inSlot;
+    inCount = global_inCount;
+    LONGINT_T* myCount = &inCount[myId * numVertices];
 
-    createPartition(0, GPtr->numVertices, myId, numThread, &i_start, &i_stop);
+    for (j = 0; j < numVertices; j++) {
+        myCount[j] = 0;
+    }
 
     for (i = i_start; i < i_stop; i++) {
-        /* Inspect adjacency list of vertex i */
         for (j = GPtr->outVertexIndex[i];
              j < (GPtr->outVertexIndex[i] + GPtr->outDegree[i]);
              j++)
         {
             ULONGINT_T v = GPtr->outVertexList[j];
-            ULONGINT_T k;
-            for (k = GPtr->outVertexIndex[v];
-                 k < (GPtr->outVertexIndex[v] + GPtr->outDegree[v]);
-                 k++)
-            {
-                if (GPtr->outVertexList[k] == i) {
-                    break;
-                }
-            }
-            if (k == GPtr->outVertexIndex[v]+GPtr->outDegree[v]) {
-              __transaction_atomic {
-                /* Add i to the impliedEdgeList of v */
-
-                long inDegree = GPtr->inDegree[v];
-                GPtr->inDegree[v] = (inDegree + 1);
-
-                if (inDegree < MAX_CLUSTER_SIZE) {
-                    impliedEdgeList[v*MAX_CLUSTER_SIZE+inDegree] = (unsigned long)i;
-                } else {
-                  /* Use auxiliary array to store the implied edge */
-                  /* Create an array if it's not present already */
-                  ULONGINT_T* a = NULL;
-                  if ((inDegree % MAX_CLUSTER_SIZE) == 0) {
-                    a = (ULONGINT_T*)malloc(MAX_CLUSTER_SIZE * sizeof(ULONGINT_T));
-                    assert(a);
-                    auxArr[v] = a;
-                  } else {
-                    a = auxArr[v];
-                  }
-                  a[inDegree % MAX_CLUSTER_SIZE] = (unsigned long)i;
-                }
-              } // TM_END
+            LONGINT_T slot = -1;
+            if (!hasOutEdge(GPtr, v, i)) {
+                slot = myCount[v]++;
             }
+            inSlot[j] = slot;
         }
-    } /* for i */
+    }
 
     thread_barrier_wait();
 
-    prefix_sums(GPtr->inVertexIndex, GPtr->inDegree, GPtr->numVertices);
+    for (i = i_start; i < i_stop; i++) {
+        LONGINT_T sum = 0;
+        long t;
+        for (t = 0; t < numThread; t++) {
+            LONGINT_T count = inCount[t * numVertices + i];
+            inCount[t * numVertices + i] = sum;
+            sum += count;
+        }
+        GPtr->inDegree[i] = sum;
+    }
+
+    thread_barrier_wait();
+
+    ULONGINT_T numUndirectedEdges =
+        parallel_exclusiveScan((long*)GPtr->inVertexIndex,
+                               GPtr->inDegree,
+                               GPtr->numVertices);
 
     if (myId == 0) {
-        GPtr->numUndirectedEdges = GPtr->inVertexIndex[GPtr->numVertices-1]
-                                   + GPtr->inDegree[GPtr->numVertices-1];
+        GPtr->numUndirectedEdges = numUndirectedEdges;
         GPtr->inVertexList =
             (ULONGINT_T *)malloc(GPtr->numUndirectedEdges * sizeof(ULONGINT_T));
+        assert(GPtr->inVertexList);
     }
 
     thread_barrier_wait();
 
-    /*
-     * Create the inVertex List
-     */
-
     for (i = i_start; i < i_stop; i++) {
-        for (j = GPtr->inVertexIndex[i];
-             j < (GPtr->inVertexIndex[i] + GPtr->inDegree[i]);
+        for (j = GPtr->outVertexIndex[i];
+             j < (GPtr->outVertexIndex[i] + GPtr->outDegree[i]);
              j++)
         {
-            if ((j - GPtr->inVertexIndex[i]) < MAX_CLUSTER_SIZE) {
-                GPtr->inVertexList[j] =
-                    impliedEdgeList[i*MAX_CLUSTER_SIZE+j-GPtr->inVertexIndex[i]];
-            } else {
-                GPtr->inVertexList[j] =
-                    auxArr[i][(j-GPtr->inVertexIndex[i]) % MAX_CLUSTER_SIZE];
+            if (inSlot[j] >= 0) {
+                ULONGINT_T v = GPtr->outVertexList[j];
+                GPtr->inVertexList[GPtr->inVertexIndex[v] + myCount[v] +
+                                   inSlot[j]] = (ULONGINT_T)i;
             }
         }
     }
@@ -533,19 +387,8 @@ computeGraph (void* argPtr)
     thread_barrier_wait();
 
     if (myId == 0) {
-        free(impliedEdgeList);
-    }
-
-    for (i = i_start; i < i_stop; i++) {
-        if (GPtr->inDegree[i] > MAX_CLUSTER_SIZE) {
-            free(auxArr[i]);
-        }
-    }
-
-    thread_barrier_wait();
-
-    if (myId == 0) {
-        free(auxArr);
+        free(inSlot);
+        free(inCount);
     }
 
 }
@@ -85,6 +85,15 @@ void
 computeGraph (void* argPtr);
 
 
+/* =============================================================================
+ * hasOutEdge
+ * -- Returns true if the graph has the directed edge u->v
+ * =============================================================================
+ */
+bool
+hasOutEdge (graph* GPtr, ULONGINT_T u, ULONGINT_T v);
+
+
 #endif /* COMPUTEGRAPH_H */
 
 
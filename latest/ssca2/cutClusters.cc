@@ -72,23 +72,271 @@
 #include "cutClusters.h"
 #include "defs.h"
 #include "globals.h"
+#include "parallel.h"
 #include "thread.h"
 
-static ULONGINT_T* global_Index                = NULL;
-static ULONGINT_T* global_neighbourArray       = NULL;
-static ULONGINT_T* global_IndexSorted          = NULL;
-static ULONGINT_T* global_neighbourArraySorted = NULL;
-static long*       global_vStatus              = NULL;
-static edge*       global_pCutSet              = NULL;
-static ULONGINT_T* global_startV               = NULL;
-static ULONGINT_T* global_clusterSize          = NULL;
-static ULONGINT_T* global_edgeStartCounter     = NULL;
-static ULONGINT_T* global_edgeEndCounter       = NULL;
-static edge*       global_cutSet               = NULL;
+/*
+ * Greedy clustering in four barrier-separated phases:
+ *
+ *   1. Rank vertices by undirected degree (radix sort).
+ *   2. Each thread walks its own stride of the ranking, highest degree first,
+ *      and grows a cluster around every start vertex it can claim: it claims
+ *      the unassigned neighbours, then releases those with more edges leaving
+ *      the cluster than inside it. The first walk only commits clusters that
+ *      got most of the start's neighbourhood; the second commits any.
+ *   3. Vertices still unassigned become singleton clusters.
+ *   4. Each thread collects the cut edges of its vertex partition into a
+ *      growable buffer; the buffers are concatenated at offsets from
+ *      parallel_scanThread.
+ *
+ * vStatus[v] is -1 or the start vertex of v's cluster. Claims and releases
+ * are transactions that re-check the slot before changing it. The other
+ * reads in phase 2 (the unassigned test before growing from s, membership
+ * tests and counts) go without one, as they only steer the heuristic: a
+ * stale value at worst skips a start that phase 3 then covers, or costs a
+ * claim or release whose transaction finds the slot changed and does
+ * nothing.
+ */
+
+#define CLUSTER_START_FRACTION   0.6 /* of the start's neighbours, first walk */
+#define CLUSTER_MEMBER_FRACTION  0.5 /* of the cluster, for each member */
+
+typedef struct cut_buffer {
+    edge* list;
+    long  size;
+    long  capacity;
+} cut_buffer_t;
+
+static ULONGINT_T*   global_Index                = NULL;
+static ULONGINT_T*   global_neighbourArray       = NULL;
+static ULONGINT_T*   global_IndexSorted          = NULL;
+static ULONGINT_T*   global_neighbourArraySorted = NULL;
+static long*         global_vStatus              = NULL;
+static edge*         global_cutSet               = NULL;
+
 
-static long       global_iter;
-static ULONGINT_T global_cliqueSize = 0;
-static ULONGINT_T global_cutSetIndex = 0;
+/* =============================================================================
+ * claimVertex
+ * =============================================================================
+ */
+static bool
+claimVertex (long* vStatus, ULONGINT_T v, long label)
+{
+    bool isClaimed = false;
+
+    __transaction_atomic {
+        if (vStatus[v] == -1) {
+            vStatus[v] = label;
+            isClaimed = true;
+        }
+    }
+
+    return isClaimed;
+}
+
+
+/* =============================================================================
+ * releaseVertex
+ * -- Unassigns v if it still belongs to cluster label
+ * =============================================================================
+ */
+static void
+releaseVertex (long* vStatus, ULONGINT_T v, long label)
+{
+    __transaction_atomic {
+        if (vStatus[v] == label) {
+            vStatus[v] = -1;
+        }
+    }
+}
+
+
+/* =============================================================================
+ * claimNeighbours
+ * -- Returns the number of neighbours of s newly labelled s
+ * =============================================================================
+ */
+static ULONGINT_T
+claimNeighbours (graph* GPtr, long* vStatus, ULONGINT_T s)
+{
+    ULONGINT_T numClaimed = 0;
+    ULONGINT_T j;
+
+    for (j = 0; j < (ULONGINT_T)GPtr->outDegree[s]; j++) {
+        if (claimVertex(vStatus, GPtr->outVertexList[GPtr->outVertexIndex[s]+j], s)) {
+            numClaimed++;
+        }
+    }
+    for (j = 0; j < (ULONGINT_T)GPtr->inDegree[s]; j++) {
+        if (claimVertex(vStatus, GPtr->inVertexList[GPtr->inVertexIndex[s]+j], s)) {
+            numClaimed++;
+        }
+    }
+
+    return numClaimed;
+}
+
+
+/* =============================================================================
+ * releaseNeighbours
+ * -- Undoes claimNeighbours and the claim of s itself
+ * =============================================================================
+ */
+static void
+releaseNeighbours (graph* GPtr, long* vStatus, ULONGINT_T s)
+{
+    ULONGINT_T j;
+
+    for (j = 0; j < (ULONGINT_T)GPtr->outDegree[s]; j++) {
+        releaseVertex(vStatus, GPtr->outVertexList[GPtr->outVertexIndex[s]+j], s);
+    }
+    for (j = 0; j < (ULONGINT_T)GPtr->inDegree[s]; j++) {
+        releaseVertex(vStatus, GPtr->inVertexList[GPtr->inVertexIndex[s]+j], s);
+    }
+    releaseVertex(vStatus, s, s);
+}
+
+
+/* =============================================================================
+ * isLooseMember
+ * -- True if v has at least as many neighbours outside cluster s as inside,
+ *    or reaches too little of it
+ * =============================================================================
+ */
+static bool
+isLooseMember (graph* GPtr, long* vStatus, ULONGINT_T v, long s, ULONGINT_T clusterSize)
+{
+    ULONGINT_T numIn = 0;
+    ULONGINT_T numOut = 0;
+    ULONGINT_T k;
+
+    for (k = 0; k < (ULONGINT_T)GPtr->outDegree[v]; k++) {
+        if (vStatus[GPtr->outVertexList[GPtr->outVertexIndex[v]+k]] == s) {
+            numIn++;
+        } else {
+            numOut++;
+        }
+    }
+    for (k = 0; k < (ULONGINT_T)GPtr->inDegree[v]; k++) {
+        if (vStatus[GPtr->inVertexList[GPtr->inVertexIndex[v]+k]] == s) {
+            numIn++;
+        } else {
+            numOut++;
+        }
+    }
+
+    return ((numOut >= numIn) ||
+            (numIn < CLUSTER_MEMBER_FRACTION * clusterSize));
+}
+
+
+/* =============================================================================
+ * growCluster
+ * -- Returns true if a cluster rooted at s was committed
+ * =============================================================================
+ */
+static bool
+growCluster (graph* GPtr, long* vStatus, ULONGINT_T s, bool isStrict)
+{
+    if (!claimVertex(vStatus, s, s)) {
+        return false;
+    }
+
+    ULONGINT_T degree = GPtr->outDegree[s] + GPtr->inDegree[s];
+    ULONGINT_T clusterSize = claimNeighbours(GPtr, vStatus, s);
+
+    if (isStrict && (clusterSize < CLUSTER_START_FRACTION * degree)) {
+        releaseNeighbours(GPtr, vStatus, s);
+        return false;
+    }
+
+    /*
+     * Drop weakly attached members; s itself always stays. The membership
+     * test is a plain read, re-checked by releaseVertex
+     */
+    ULONGINT_T j;
+    for (j = 0; j < (ULONGINT_T)GPtr->outDegree[s]; j++) {
+        ULONGINT_T v = GPtr->outVertexList[GPtr->outVertexIndex[s]+j];
+        if (vStatus[v] == (long)s && isLooseMember(GPtr, vStatus, v, s, clusterSize)) {
+            releaseVertex(vStatus, v, s);
+        }
+    }
+    for (j = 0; j < (ULONGINT_T)GPtr->inDegree[s]; j++) {
+        ULONGINT_T v = GPtr->inVertexList[GPtr->inVertexIndex[s]+j];
+        if (vStatus[v] == (long)s && isLooseMember(GPtr, vStatus, v, s, clusterSize)) {
+            releaseVertex(vStatus, v, s);
+        }
+    }
+
+    return true;
+}
+
+
+/* =============================================================================
+ * appendCutEdge
+ * =============================================================================
+ */
+static void
+appendCutEdge (cut_buffer_t* bufferPtr, ULONGINT_T u, ULONGINT_T v, ULONGINT_T edgeNum)
+{
+    if (bufferPtr->size == bufferPtr->capacity) {
+        bufferPtr->capacity *= 2;
+        bufferPtr->list =
+            (edge*)realloc(bufferPtr->list, bufferPtr->capacity * sizeof(edge));
+        assert(bufferPtr->list);
+    }
+    edge* edgePtr = &bufferPtr->list[bufferPtr->size++];
+    edgePtr->startVertex = u;
+    edgePtr->endVertex = v;
+    edgePtr->edgeNum = edgeNum;
+}
+
+
+#ifdef WRITE_RESULT_FILES
+/* =============================================================================
+ * writeResults
+ * =============================================================================
+ */
+static void
+writeResults (graph* GPtr, long* vStatus, edge* cutSet, long cutSetSize)
+{
+    FILE* outfp1 = fopen("clusters.txt", "w");
+    assert(outfp1);
+    fprintf(outfp1, "\nKernel 4 - Extracted Clusters\n");
+
+    ULONGINT_T s;
+    for (s = 0; s < GPtr->numVertices; s++) {
+        if (vStatus[s] != (long)s) {
+            continue;
+        }
+        fprintf(outfp1, "%lu ", s);
+        ULONGINT_T j;
+        for (j = 0; j < (ULONGINT_T)GPtr->outDegree[s]; j++) {
+            ULONGINT_T v = GPtr->outVertexList[GPtr->outVertexIndex[s]+j];
+            if (v != s && vStatus[v] == (long)s) {
+                fprintf(outfp1, "%lu ", v);
+            }
+        }
+        for (j = 0; j < (ULONGINT_T)GPtr->inDegree[s]; j++) {
+            ULONGINT_T v = GPtr->inVertexList[GPtr->inVertexIndex[s]+j];
+            if (v != s && vStatus[v] == (long)s) {
+                fprintf(outfp1, "%lu ", v);
+            }
+        }
+        fprintf(outfp1, "\n");
+    }
+    fclose(outfp1);
+
+    FILE* outfp2 = fopen("edgeCut.txt", "w");
+    assert(outfp2);
+    fprintf(outfp2, "\nEdges in Cut Set - \n");
+    long i;
+    for (i = 0; i < cutSetSize; i++) {
+        fprintf(outfp2, "[%lu %lu] ", cutSet[i].startVertex, cutSet[i].endVertex);
+    }
+    fclose(outfp2);
+}
+#endif /* WRITE_RESULT_FILES */
 
 
 /* =============================================================================
@@ -111,6 +359,7 @@ cutClusters (void* argPtr)
     ULONGINT_T* neighbourArray;
     ULONGINT_T* IndexSorted;
     ULONGINT_T* neighbourArraySorted;
+    long* vStatus;
 
     if (myId == 0) {
         long numByte = GPtr->numVertices * sizeof(ULONGINT_T);
@@ -126,6 +375,9 @@ cutClusters (void* argPtr)
         neighbourArraySorted = (ULONGINT_T*)malloc(numByte);
         assert(neighbourArraySorted);
         global_neighbourArraySorted = neighbourArraySorted;
+        vStatus = (long*)malloc(GPtr->numVertices * sizeof(long));
+        assert(vStatus);
+        global_vStatus = vStatus;
     }
 
     thread_barrier_wait();
@@ -134,6 +386,7 @@ cutClusters (void* argPtr)
     neighbourArray = global_neighbourArray;
     IndexSorted = global_IndexSorted;
     neighbourArraySorted = global_neighbourArraySorted;
+    vStatus = global_vStatus;
 
     long i;
     long i_start;
@@ -143,518 +396,111 @@ cutClusters (void* argPtr)
     for (i = i_start; i < i_stop; i++) {
         neighbourArray[i] = GPtr->inDegree[i] + GPtr->outDegree[i];
         Index[i] = i;
+        vStatus[i] = -1;
     }
 
     thread_barrier_wait();
 
-
-    all_radixsort_node_aux_s3(GPtr->numVertices,
-                              neighbourArray,
-                              neighbourArraySorted,
-                              Index,
-                              IndexSorted);
-
-    thread_barrier_wait();
+    /* in + out degree is below 2 * numVertices <= 2^(SCALE+1) */
+    all_radixsort_node_aux(GPtr->numVertices,
+                           neighbourArray,
+                           neighbourArraySorted,
+                           Index,
+                           IndexSorted,
+                           (SCALE + 1));
 
     /*
-     * Global array to keep track of vertex status:
-     * -1 if a vertex hasn't been assigned to a cluster yet
-     * t if it belongs to a cluster; t = iteration*numThread + myId
+     * Grow clusters; thread t starts from ranks t, t + numThread, ...
+     * counted from the highest degree
      */
-    long* vStatus;
 
-    edge* pCutSet;
-    ULONGINT_T* startV;
-    ULONGINT_T* clusterSize;
-
-    if (myId == 0) {
-
-        free(Index);
-        free(neighbourArray);
-
-        vStatus = (long*)malloc(GPtr->numVertices * sizeof(long));
-        assert(vStatus);
-        global_vStatus = vStatus;
-
-        /*
-         * Allocate mem. for the cut set list
-         * Maintain local arrays initially and merge them in the end
-         */
-
-        if (SCALE < 12) {
-            pCutSet =(edge*)malloc((1*(GPtr->numDirectedEdges)/numThread)
-                                     * sizeof(edge));
-        } else {
-            pCutSet = (edge*)malloc((0.2*(GPtr->numDirectedEdges)/numThread)
-                                      * sizeof(edge));
+    long numVertex = GPtr->numVertices;
+    long pass;
+    for (pass = 0; pass < 2; pass++) {
+        bool isStrict = (pass == 0);
+        long r;
+        for (r = myId; r < numVertex; r += numThread) {
+            ULONGINT_T s = IndexSorted[numVertex - r - 1];
+            /* Plain read: growCluster re-checks it when claiming s */
+            if (vStatus[s] == -1) {
+                growCluster(GPtr, vStatus, s, isStrict);
+            }
         }
-        assert(pCutSet);
-        global_pCutSet = pCutSet;
-
-        /*
-         * Vertex to start from, on each thread
-         */
-        startV = (ULONGINT_T*)malloc(numThread * sizeof(ULONGINT_T));
-        assert(startV);
-        global_startV = startV;
-        clusterSize = (ULONGINT_T*)malloc(numThread * sizeof(ULONGINT_T));
-        assert(clusterSize);
-        global_clusterSize = clusterSize;
     }
 
     thread_barrier_wait();
 
-    vStatus     = global_vStatus;
-    pCutSet     = global_pCutSet;
-    startV      = global_startV;
-    clusterSize = global_clusterSize;
+    /*
+     * Whatever the walks left behind is a cluster of its own
+     */
 
     for (i = i_start; i < i_stop; i++) {
-        vStatus[i] = -1;
-    }
-
-    thread_barrier_wait();
-
-    ULONGINT_T verticesVisited = 0;
-
-#ifdef WRITE_RESULT_FILES
-    FILE* outfp1 = NULL;
-    if (myId == 0) {
-        outfp1 = fopen("clusters.txt", "w");
-        fprintf(outfp1, "\nKernel 4 - Extracted Clusters\n");
-    }
-#endif
-
-    long iter = 0;
-    ULONGINT_T currIndex = 0;
-    ULONGINT_T cutSetIndex = 0;
-
-    while (verticesVisited < GPtr->numVertices) {
-
-        /* Clear start vertex array */
-        startV[myId] = -1;
-        clusterSize[myId] = 0;
-
-        if (currIndex == GPtr->numVertices) {
-            currIndex = 0;
-        }
-
-        thread_barrier_wait();
-
-        /*
-         * Choose vertices to start from
-         * Done sequentially right now, can be parallelized
-         */
-        if (myId == 0) {
-            long t;
-            for (t = 0; t < numThread; t++) {
-                long r;
-                for (r = currIndex; r < GPtr->numVertices; r++) {
-                    if (vStatus[IndexSorted[GPtr->numVertices - r - 1]] == -1) {
-                        startV[t] = IndexSorted[GPtr->numVertices - r - 1];
-                        vStatus[startV[t]] = iter * numThread + t;
-                        long j;
-                        for (j = 0; j < GPtr->outDegree[startV[t]]; j++) {
-                            long outVertexListIndex =
-                                j+GPtr->outVertexIndex[startV[t]];
-                            long vStatusIndex =
-                                GPtr->outVertexList[outVertexListIndex];
-                            if (vStatus[vStatusIndex] == -1) {
-                                vStatus[vStatusIndex] = iter * numThread + t;
-                                clusterSize[t]++;
-                            }
-                        }
-                        for (j = 0; j < GPtr->inDegree[startV[t]]; j++) {
-                            long inVertexIndex = j+GPtr->inVertexIndex[startV[t]];
-                            long vStatusIndex = GPtr->inVertexList[inVertexIndex];
-                            if (vStatus[vStatusIndex] == -1) {
-                                vStatus[vStatusIndex] = iter * numThread + t;
-                                clusterSize[t]++;
-                            }
-                        }
-                        currIndex = r+1;
-                        break;
-                    }
-                }
-            }
-        }
-
-        thread_barrier_wait();
-
-        /*
-         * Determine clusters and cut sets in parallel
-         */
-
-        i = startV[myId];
-
-        ULONGINT_T cliqueSize = 0;
-
-        /* If the thread has some vertex to start from */
-        if (i != -1)  {
-
-            cliqueSize = 1;
-
-            /* clusterSize[myId] gives the no. of 'unassigned' vertices adjacent to the current vertex */
-            if ((clusterSize[myId] >= 0.6*(GPtr->inDegree[i]+GPtr->outDegree[i])) ||
-                ((iter > (GPtr->numVertices)/(numThread*MAX_CLUSTER_SIZE)) &&
-                 (clusterSize[myId] > 0)))
-            {
-
-                /*
-                 * Most of the adjacent vertices are unassigned,
-                 * should be able to extract a cluster easily
-                 */
-
-                /* Inspect adjacency list */
-                long j;
-                for (j = 0; j < GPtr->outDegree[i]; j++) {
-
-                    ULONGINT_T clusterCounter = 0;
-                    ULONGINT_T cutSetIndexPrev = cutSetIndex;
-                    ULONGINT_T cutSetCounter = 0;
-
-                    if (vStatus[GPtr->outVertexList[j+GPtr->outVertexIndex[i]]] ==
-                        iter * numThread + myId)
-                    {
-
-                        long v = GPtr->outVertexList[j+GPtr->outVertexIndex[i]];
-
-                        /*
-                         * Inspect vertices adjacent to v and determine if it belongs
-                         * to a cluster or not
-                         */
-                        long k;
-                        for (k = 0; k < GPtr->outDegree[v]; k++) {
-                            long outVertexListIndex = k+GPtr->outVertexIndex[v];
-                            long vStatusIndex = GPtr->outVertexList[outVertexListIndex];
-                            if (vStatus[vStatusIndex] == (iter * numThread + myId)) {
-                                clusterCounter++;
-                            } else {
-                                cutSetCounter++;
-                                if (vStatus[vStatusIndex] == -1) {
-                                    /* Ensure that an edge is not added twice to the list */
-                                    pCutSet[cutSetIndex].startVertex = v;
-                                    pCutSet[cutSetIndex].endVertex = vStatusIndex;
-                                    cutSetIndex++;
-                                }
-                            }
-                        }
-
-                        if ((cutSetCounter >= clusterCounter) ||
-                            ((SCALE < 9) &&
-                             (clusterCounter <= 2) &&
-                             (GPtr->inDegree[v]+GPtr->outDegree[v] >
-                              clusterCounter + cutSetCounter) &&
-                             (clusterSize[myId] > clusterCounter + 2)) ||
-                            ((SCALE > 9) &&
-                             (clusterCounter < 0.5*clusterSize[myId])))
-                        {
-
-                            /* v doesn't belong to this clique, free it */
-                            vStatus[v] = -1;
-
-                            /* Also add this edge to cutset list, removing previously added edges */
-                            cutSetIndex = cutSetIndexPrev;
-                            pCutSet[cutSetIndex].startVertex = i;
-                            pCutSet[cutSetIndex].endVertex = v;
-                            cutSetIndex++;
-
-                        } else {
-
-                            cliqueSize++;
-                             /* Add edges in inVertexList also to cut Set */
-                            for (k = 0; k < GPtr->inDegree[v]; k++) {
-                                long inVertexListIndex = k+GPtr->inVertexIndex[v];
-                                long vStatusIndex = GPtr->inVertexList[inVertexListIndex];
-                                if (vStatus[vStatusIndex] == -1) {
-                                    pCutSet[cutSetIndex].startVertex = v;
-                                    pCutSet[cutSetIndex].endVertex = vStatusIndex;
-                                    cutSetIndex++;
-                                }
-                            }
-
-                        }
-
-                    }
-
-                }
-
-                /* Do the same for the implied edges too */
-                for (j = 0; j < GPtr->inDegree[i]; j++) {
-
-                    ULONGINT_T clusterCounter = 0;
-                    ULONGINT_T cutSetIndexPrev = cutSetIndex;
-                    ULONGINT_T cutSetCounter = 0;
-
-                    if (vStatus[GPtr->inVertexList[j+GPtr->inVertexIndex[i]]] ==
-                        iter*numThread+myId)
-                    {
-                        long v = GPtr->inVertexList[j+GPtr->inVertexIndex[i]];
-
-                        /* Inspect vertices adjacent to v and determine if it belongs to a cluster or not */
-                        long k;
-                        for (k = 0; k < GPtr->outDegree[v]; k++) {
-                            long outVertexListIndex = k+GPtr->outVertexIndex[v];
-                            long vStatusIndex = GPtr->outVertexList[outVertexListIndex];
-                            if (vStatus[vStatusIndex] == iter*numThread+myId) {
-                                clusterCounter++;
-                            } else {
-                                cutSetCounter++;
-                                if (vStatus[vStatusIndex] == -1) {
-                                    /* To ensure that an edge is not added twice to the list */
-                                    pCutSet[cutSetIndex].startVertex = v;
-                                    pCutSet[cutSetIndex].endVertex = vStatusIndex;
-                                    cutSetIndex++;
-                                }
-                            }
-                        }
-
-                        if ((cutSetCounter >= clusterCounter) ||
-                            ((SCALE < 9) &&
-                             (clusterCounter <= 2) &&
-                             (GPtr->inDegree[v]+GPtr->outDegree[v] >
-                              clusterCounter + cutSetCounter)  &&
-                             (clusterSize[myId] > clusterCounter + 2)) ||
-                            ((SCALE > 9) &&
-                             (clusterCounter < 0.5*clusterSize[myId])))
-                        {
-                            /* v doesn't belong to this clique, free it */
-                            vStatus[v] = -1;
-                            cutSetIndex = cutSetIndexPrev;
-                            pCutSet[cutSetIndex].startVertex = i;
-                            pCutSet[cutSetIndex].endVertex = v;
-                            cutSetIndex++;
-
-                        } else {
-
-                            cliqueSize++;
-                            /* Add edges in inVertexList also to cut Set */
-                            for (k = 0; k < GPtr->inDegree[v]; k++) {
-                                long inVertexListIndex = k+GPtr->inVertexIndex[v];
-                                long vStatusIndex = GPtr->inVertexList[inVertexListIndex];
-                                if (vStatus[vStatusIndex] == -1) {
-                                    pCutSet[cutSetIndex].startVertex = v;
-                                    pCutSet[cutSetIndex].endVertex = vStatusIndex;
-                                    cutSetIndex++;
-                                }
-                            }
-
-                        }
-
-                    }
-
-                }
-
-            } /* i != -1 */
-
-            if (clusterSize[myId] == 0)  {
-
-              /* Only one vertex in cluster */
-              cliqueSize = 1;
-
-            } else {
-
-                if ((clusterSize[myId] < 0.6*(GPtr->inDegree[i]+GPtr->outDegree[i])) &&
-                    (iter <= GPtr->numVertices/(numThread*MAX_CLUSTER_SIZE)))
-                {
-                    /* High perc. of intra-clique edges, do not commit clique */
-                    cliqueSize = 0;
-                    vStatus[i] = -1;
-
-                    long j;
-                    for (j=0; j<GPtr->outDegree[i]; j++) {
-                        long outVertexListIndex = j+GPtr->outVertexIndex[i];
-                        long vStatusIndex = GPtr->outVertexList[outVertexListIndex];
-                        if (vStatus[vStatusIndex] == iter*numThread+myId) {
-                            vStatus[vStatusIndex] = -1;
-                        }
-                    }
-
-                    for (j=0; j<GPtr->inDegree[i]; j++) {
-                        long inVertexListIndex = j+GPtr->inVertexIndex[i];
-                        long vStatusIndex = GPtr->inVertexList[inVertexListIndex];
-                        if (vStatus[vStatusIndex] == iter*numThread+myId) {
-                            vStatus[vStatusIndex] = -1;
-                        }
-                    }
-                }
-
-            }
-        } /* if i != -1 */
-
-        if (myId == 0) {
-            global_cliqueSize = 0;
-        }
-
-        thread_barrier_wait();
-
-#ifdef WRITE_RESULT_FILES
-        /* Print to results.clq file */
-
-        if (myId == 0) {
-            long t;
-            for (t = 0; t < numThread; t++) {
-                if (startV[t] != -1) {
-                    if (vStatus[startV[t]] == iter*numThread+t) {
-                        fprintf(outfp1, "%lu ", startV[t]);
-                        long j;
-                        for (j = 0; j < GPtr->outDegree[startV[t]]; j++) {
-                            long outVertexListIndex = j+GPtr->outVertexIndex[startV[t]];
-                            long vStatusIndex = GPtr->outVertexList[outVertexListIndex];
-                            if (vStatus[vStatusIndex] == iter*numThread+t) {
-                                fprintf(outfp1, "%lu ", vStatusIndex);
-                            }
-                        }
-                        for (j = 0; j < GPtr->inDegree[startV[t]]; j++) {
-                            long inVertexListIndex = j+GPtr->inVertexIndex[startV[t]];
-                            long vStatusIndex = GPtr->inVertexList[inVertexListIndex];
-                            if (vStatus[vStatusIndex] == iter*numThread+t) {
-                                fprintf(outfp1, "%lu ", vStatusIndex);
-                            }
-                        }
-                        fprintf(outfp1, "\n");
-                    }
-                }
-            }
-        }
-
-        thread_barrier_wait();
-#endif /* WRITE_RESULTS_FILE */
-
-        if (myId == 0) {
-            iter++;
-            global_iter = iter;
-        }
-
-        __transaction_atomic {
-          global_cliqueSize += cliqueSize;
-        }
-
-        thread_barrier_wait();
-
-        iter = global_iter;
-        verticesVisited += global_cliqueSize;
-
-        if ((verticesVisited >= 0.95*GPtr->numVertices) ||
-            (iter > GPtr->numVertices/2))
-        {
-            break;
-        }
-
-    } /* while (verticesVisited < GPtr->numVertices) */
-
-    thread_barrier_wait();
-
-#ifdef WRITE_RESULT_FILES
-    /* Take care of unmarked vertices */
-    if (myId == 0) {
-        if (verticesVisited < GPtr->numVertices) {
-            for(i = 0; i < GPtr->numVertices; i++) {
-                if (vStatus[i] == -1) {
-                    vStatus[i] = iter*numThread+myId;
-                    fprintf(outfp1, "%lu\n", i);
-                    iter++;
-                }
-            }
+        if (vStatus[i] == -1) {
+            vStatus[i] = i;
         }
     }
 
+    cut_buffer_t buffer;
+    buffer.size = 0;
+    buffer.capacity = 64;
+    buffer.list = (edge*)malloc(buffer.capacity * sizeof(edge));
+    assert(buffer.list);
+
     thread_barrier_wait();
-#endif
 
     /*
-     * Merge partial Cutset Lists
+     * Cut set: directed edges whose endpoints lie in different clusters
      */
 
-    /* Temp vars for merging edge lists */
-    ULONGINT_T* edgeStartCounter;
-    ULONGINT_T* edgeEndCounter;
-
-    if (myId == 0) {
-        edgeStartCounter = (ULONGINT_T*)malloc(numThread * sizeof(ULONGINT_T));
-        assert(edgeStartCounter);
-        global_edgeStartCounter = edgeStartCounter;
-        edgeEndCounter = (ULONGINT_T*)malloc(numThread * sizeof(ULONGINT_T));
-        assert(edgeEndCounter);
-        global_edgeEndCounter = edgeEndCounter;
-    }
-
-    thread_barrier_wait();
-
-    edgeStartCounter = global_edgeStartCounter;
-    edgeEndCounter   = global_edgeEndCounter;
-
-    edgeEndCounter[myId] = cutSetIndex;
-    edgeStartCounter[myId] = 0;
-
-    thread_barrier_wait();
-
-    if (myId == 0) {
-        long t;
-        for (t = 1; t < numThread; t++) {
-            edgeEndCounter[t] = edgeEndCounter[t-1] + edgeEndCounter[t];
-            edgeStartCounter[t] = edgeEndCounter[t-1];
+    for (i = i_start; i < i_stop; i++) {
+        long label = vStatus[i];
+        ULONGINT_T j;
+        for (j = GPtr->outVertexIndex[i];
+             j < (GPtr->outVertexIndex[i] + GPtr->outDegree[i]);
+             j++)
+        {
+            ULONGINT_T v = GPtr->outVertexList[j];
+            if (vStatus[v] != label) {
+                appendCutEdge(&buffer, i, v, j);
+            }
         }
     }
 
-    __transaction_atomic {
-      //long tmp_cutSetIndex = (long)TM_SHARED_READ(global_cutSetIndex);
-      //TM_SHARED_WRITE(global_cutSetIndex, (tmp_cutSetIndex + cutSetIndex));
-      global_cutSetIndex += cutSetIndex;
-    }
-
-    thread_barrier_wait();
-
-    cutSetIndex = global_cutSetIndex;
-    ULONGINT_T cutSetCounter = cutSetIndex;
-
-    /* Data struct. for storing edgeCut */
-    edge* cutSet;
+    long cutSetSize;
+    long cutSetStart = parallel_scanThread(buffer.size, &cutSetSize);
 
     if (myId == 0) {
-        cutSet = (edge*)malloc(cutSetCounter * sizeof(edge));
-        assert(cutSet);
-        global_cutSet = cutSet;
+        global_cutSet = (edge*)malloc((cutSetSize + 1) * sizeof(edge));
+        assert(global_cutSet);
     }
 
     thread_barrier_wait();
 
-    cutSet = global_cutSet;
-
-    long j;
-    for (j = edgeStartCounter[myId]; j < edgeEndCounter[myId]; j++) {
-        cutSet[j].startVertex = pCutSet[j-edgeStartCounter[myId]].startVertex;
-        cutSet[j].endVertex = pCutSet[j-edgeStartCounter[myId]].endVertex;
+    edge* cutSet = global_cutSet;
+    long k;
+    for (k = 0; k < buffer.size; k++) {
+        cutSet[cutSetStart + k] = buffer.list[k];
     }
+    free(buffer.list);
 
     thread_barrier_wait();
 
 #ifdef WRITE_RESULT_FILES
-    FILE* outfp2 = NULL;
     if (myId == 0) {
-        outfp2 = fopen("edgeCut.txt", "w");
-        fprintf(outfp2, "\nEdges in Cut Set - \n");
-        for (i = 0; i < cutSetCounter; i++) {
-            fprintf(outfp2, "[%lu %lu] ",
-                    cutSet[i].startVertex, cutSet[i].endVertex);
-        }
-        fclose(outfp2);
-        fclose(outfp1);
+        writeResults(GPtr, vStatus, cutSet, cutSetSize);
     }
+
+    thread_barrier_wait();
 #endif
 
     if (myId == 0) {
-        free(edgeStartCounter);
-        free(edgeEndCounter);
-        free(pCutSet);
+        free(Index);
+        free(neighbourArray);
         free(IndexSorted);
         free(neighbourArraySorted);
-        free(startV);
-        free(clusterSize);
-        free(cutSet);
         free(vStatus);
+        free(cutSet);
     }
-
 }
 
 
@@ -90,6 +90,9 @@ typedef struct
     char* strWeight;
     ULONGINT_T numEdgesPlaced;
 
+    void* mapPtr; /* non-NULL when the arrays live in a graphFile mapping */
+    ULONGINT_T mapSize;
+
 } graphSDG;
 
 typedef struct /*the graph data structure*/
@@ -115,6 +118,9 @@ typedef struct /*the graph data structure*/
     LONGINT_T* intWeight;
     char* strWeight;
 
+    void* mapPtr; /* non-NULL when the arrays live in a graphFile mapping */
+    ULONGINT_T mapSize;
+
 } graph;
 
 typedef struct /* edge structure for Kernel 2 */
@@ -144,6 +150,13 @@ typedef struct /* A dynamic array for Kernel 3 */
     V** vList;
 } Vd;
 
+typedef struct /* A compact vertex list for Kernel 3 */
+{
+    ULONGINT_T numVertices;
+    ULONGINT_T capacity;
+    V* vList; /* levels are stored contiguously, in BFS order */
+} Vc;
+
 
 #endif /* DEFS_H */
 
@@ -68,11 +68,13 @@
 #include <sys/types.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include "computeGraph.h"
 #include "createPartition.h"
 #include "defs.h"
 #include "findSubGraphs.h"
 #include "globals.h"
 #include "thread.h"
+#include "utility.h"
 
 /* =============================================================================
  * findSubGraphs0
@@ -280,7 +282,7 @@ findSubGraphs1 (void* argPtr)
             visited[(intWtVLList[i])->num] = 'v';
 
             (intWtVLList[i])->next = (Vl*)malloc(sizeof(Vl));
-            free((intWtVLList[i])->next);
+            assert((intWtVLList[i])->next);
             ((intWtVLList[i])->next)->num = maxIntWtList[i].endVertex;
             ((intWtVLList[i])->next)->depth = 1;
             visited[((intWtVLList[i])->next)->num] = 'v';
@@ -611,6 +613,224 @@ findSubGraphs2 (void* argPtr)
 }
 
 
+/* =============================================================================
+ * Kernel 3 BFS engine
+ *
+ * -- One search per start edge, as in the variants above, but the visited
+ *    set is a per-thread array of generation stamps that is allocated once:
+ *    a vertex is visited by the current search iff its stamp equals the
+ *    search's generation, so nothing is cleared between searches.
+ * -- The result list doubles as the BFS queue; each level is a contiguous
+ *    slice of it.
+ * -- When the frontier's out-edges exceed 1/K3_ALPHA of the edges not yet
+ *    examined, a level is expanded bottom-up (every unvisited vertex looks
+ *    for a parent in the frontier); it switches back once the frontier is
+ *    below 1/K3_BETA of the vertices.
+ * =============================================================================
+ */
+
+#define K3_ALPHA 14
+#define K3_BETA  24
+
+typedef struct k3_mark {
+    ULONGINT_T generation;
+    long depth;
+} k3_mark_t;
+
+
+/* =============================================================================
+ * appendVertex
+ * =============================================================================
+ */
+static void
+appendVertex (Vc* listPtr, ULONGINT_T num, long depth)
+{
+    if (listPtr->numVertices == listPtr->capacity) {
+        listPtr->capacity *= 2;
+        listPtr->vList =
+            (V*)realloc(listPtr->vList, listPtr->capacity * sizeof(V));
+        assert(listPtr->vList);
+    }
+    V* vPtr = &listPtr->vList[listPtr->numVertices++];
+    vPtr->num = num;
+    vPtr->depth = depth;
+}
+
+
+/* =============================================================================
+ * hasParentInFrontier
+ * -- Predecessors of v are its implied in-edges plus the out-neighbours that
+ *    have an edge back to v
+ * =============================================================================
+ */
+static bool
+hasParentInFrontier (graph* GPtr,
+                     k3_mark_t* mark,
+                     ULONGINT_T generation,
+                     long depth,
+                     ULONGINT_T v)
+{
+    ULONGINT_T j;
+    ULONGINT_T j_stop;
+
+    j_stop = GPtr->inVertexIndex[v] + GPtr->inDegree[v];
+    for (j = GPtr->inVertexIndex[v]; j < j_stop; j++) {
+        k3_mark_t* markPtr = &mark[GPtr->inVertexList[j]];
+        if (markPtr->generation == generation && markPtr->depth == depth) {
+            return true;
+        }
+    }
+
+    j_stop = GPtr->outVertexIndex[v] + GPtr->outDegree[v];
+    for (j = GPtr->outVertexIndex[v]; j < j_stop; j++) {
+        ULONGINT_T u = GPtr->outVertexList[j];
+        if (mark[u].generation == generation &&
+            mark[u].depth == depth &&
+            hasOutEdge(GPtr, u, v))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/* =============================================================================
+ * searchSubGraph
+ * -- Same depth convention as findSubGraphs0: start vertex at -1 (never
+ *    expanded), end vertex at 1, expansion stops at SUBGR_EDGE_LENGTH
+ * =============================================================================
+ */
+static void
+searchSubGraph (graph* GPtr,
+                k3_mark_t* mark,
+                ULONGINT_T generation,
+                edge* edgePtr,
+                Vc* listPtr)
+{
+    listPtr->numVertices = 0;
+    listPtr->capacity = 5 * MAX_CLUSTER_SIZE;
+    listPtr->vList = (V*)malloc(listPtr->capacity * sizeof(V));
+    assert(listPtr->vList);
+
+    appendVertex(listPtr, edgePtr->startVertex, -1);
+    mark[edgePtr->startVertex].generation = generation;
+    mark[edgePtr->startVertex].depth = -1;
+
+    appendVertex(listPtr, edgePtr->endVertex, 1);
+    mark[edgePtr->endVertex].generation = generation;
+    mark[edgePtr->endVertex].depth = 1;
+
+    ULONGINT_T numVertices = GPtr->numVertices;
+    ULONGINT_T edgesUnexplored = GPtr->numDirectedEdges;
+    bool isBottomUp = false;
+    ULONGINT_T levelStart = 1;
+    ULONGINT_T levelStop = 2;
+    long depth = 1;
+
+    while ((depth < SUBGR_EDGE_LENGTH) && (levelStart < levelStop)) {
+
+        ULONGINT_T frontierEdges = 0;
+        ULONGINT_T k;
+        for (k = levelStart; k < levelStop; k++) {
+            frontierEdges += GPtr->outDegree[listPtr->vList[k].num];
+        }
+
+        if (!isBottomUp) {
+            isBottomUp = (frontierEdges * K3_ALPHA > edgesUnexplored);
+        } else {
+            isBottomUp = ((levelStop - levelStart) * K3_BETA >= numVertices);
+        }
+        edgesUnexplored -= MIN(frontierEdges, edgesUnexplored);
+
+        if (isBottomUp) {
+            ULONGINT_T v;
+            for (v = 0; v < numVertices; v++) {
+                if (mark[v].generation != generation &&
+                    hasParentInFrontier(GPtr, mark, generation, depth, v))
+                {
+                    appendVertex(listPtr, v, (depth + 1));
+                    mark[v].generation = generation;
+                    mark[v].depth = depth + 1;
+                }
+            }
+        } else {
+            for (k = levelStart; k < levelStop; k++) {
+                ULONGINT_T u = listPtr->vList[k].num;
+                ULONGINT_T j;
+                ULONGINT_T j_stop = GPtr->outVertexIndex[u] + GPtr->outDegree[u];
+                for (j = GPtr->outVertexIndex[u]; j < j_stop; j++) {
+                    ULONGINT_T v = GPtr->outVertexList[j];
+                    if (mark[v].generation != generation) {
+                        appendVertex(listPtr, v, (depth + 1));
+                        mark[v].generation = generation;
+                        mark[v].depth = depth + 1;
+                    }
+                }
+            }
+        }
+
+        levelStart = levelStop;
+        levelStop = listPtr->numVertices;
+        depth++;
+    }
+}
+
+
+/* =============================================================================
+ * findSubGraphs3
+ * =============================================================================
+ */
+void
+findSubGraphs3 (void* argPtr)
+{
+    graph* GPtr                = ((findSubGraphs3_arg_t*)argPtr)->GPtr;
+    Vc*    intWtVCList         = ((findSubGraphs3_arg_t*)argPtr)->intWtVCList;
+    Vc*    strWtVCList         = ((findSubGraphs3_arg_t*)argPtr)->strWtVCList;
+    edge*  maxIntWtList        = ((findSubGraphs3_arg_t*)argPtr)->maxIntWtList;
+    long   maxIntWtListSize    = ((findSubGraphs3_arg_t*)argPtr)->maxIntWtListSize;
+    edge*  soughtStrWtList     = ((findSubGraphs3_arg_t*)argPtr)->soughtStrWtList;
+    long   soughtStrWtListSize = ((findSubGraphs3_arg_t*)argPtr)->soughtStrWtListSize;
+
+    long myId = thread_getId();
+    long numThread = thread_getNumThread();
+
+    long i;
+    long i_start;
+    long i_stop;
+    createPartition(0,
+                    (maxIntWtListSize + soughtStrWtListSize),
+                    myId,
+                    numThread,
+                    &i_start,
+                    &i_stop);
+
+    if (i_start == i_stop) {
+        return;
+    }
+
+    k3_mark_t* mark = (k3_mark_t*)calloc(GPtr->numVertices, sizeof(k3_mark_t));
+    assert(mark);
+
+    ULONGINT_T generation = 0;
+
+    for (i = i_start; i < i_stop; i++) {
+        generation++;
+        if (i < maxIntWtListSize) {
+            searchSubGraph(GPtr, mark, generation,
+                           &maxIntWtList[i], &intWtVCList[i]);
+        } else {
+            long t = i - maxIntWtListSize;
+            searchSubGraph(GPtr, mark, generation,
+                           &soughtStrWtList[t], &strWtVCList[t]);
+        }
+    }
+
+    free(mark);
+}
+
+
 /* =============================================================================
  *
  * End of findSubGraphs.c
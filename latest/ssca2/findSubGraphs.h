@@ -100,6 +100,16 @@ typedef struct findSubGraphs2_arg {
     long soughtStrWtListSize;
 } findSubGraphs2_arg_t;
 
+typedef struct findSubGraphs3_arg {
+    graph* GPtr;
+    Vc* intWtVCList;
+    Vc* strWtVCList;
+    edge* maxIntWtList;
+    long maxIntWtListSize;
+    edge* soughtStrWtList;
+    long soughtStrWtListSize;
+} findSubGraphs3_arg_t;
+
 
 /* =============================================================================
  * findSubGraphs0
@@ -125,6 +135,15 @@ void
 findSubGraphs2 (void* argPtr);
 
 
+/* =============================================================================
+ * findSubGraphs3
+ * -- Direction-optimizing BFS with a generation-stamped visited set
+ * =============================================================================
+ */
+void
+findSubGraphs3 (void* argPtr);
+
+
 #endif /* FINDSUBGRAPHS_H */
 
 
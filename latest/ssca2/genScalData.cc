@@ -75,6 +75,7 @@
 #include "defs.h"
 #include "genScalData.h"
 #include "globals.h"
+#include "parallel.h"
 #include "thread.h"
 
 static ULONGINT_T* global_permV              = NULL;
@@ -82,13 +83,13 @@ static long*       global_cliqueSizes        = NULL;
 static long        global_totCliques         = 0;
 static ULONGINT_T* global_firstVsInCliques   = NULL;
 static ULONGINT_T* global_lastVsInCliques    = NULL;
-static ULONGINT_T* global_i_edgeStartCounter = NULL;
-static ULONGINT_T* global_i_edgeEndCounter   = NULL;
-static long        global_edgeNum            = 0;
-static ULONGINT_T  global_numStrWtEdges      = 0;
+static ULONGINT_T* global_permKey            = NULL;
+static ULONGINT_T* global_permKeySorted      = NULL;
+static ULONGINT_T* global_permId             = NULL;
 static ULONGINT_T* global_startVertex        = NULL;
 static ULONGINT_T* global_endVertex          = NULL;
-static ULONGINT_T* global_tempIndex          = NULL;
+static ULONGINT_T* global_tmpStartVertex     = NULL;
+static ULONGINT_T* global_tmpEndVertex       = NULL;
 
 
 /* =============================================================================
@@ -626,137 +627,253 @@ genScalData_seq (graphSDG* SDGdataPtr)
      */
 
     /*
-     * Radix sort with StartVertex as primary key
+     * Radix sort with endVertex as secondary and startVertex as primary key:
+     * two stable sorts leave the tuples in (startVertex, endVertex) order
      */
 
     numByte = numEdgesPlaced * sizeof(ULONGINT_T);
-    SDGdataPtr->startVertex = (ULONGINT_T*)malloc(numByte);
-    assert(SDGdataPtr->startVertex);
-    SDGdataPtr->endVertex = (ULONGINT_T*)malloc(numByte);
-    assert(SDGdataPtr->endVertex);
+    ULONGINT_T* tmpStartVertex = (ULONGINT_T*)malloc(numByte);
+    assert(tmpStartVertex);
+    ULONGINT_T* tmpEndVertex = (ULONGINT_T*)malloc(numByte);
+    assert(tmpEndVertex);
+
+    all_radixsort_node_aux_seq(numEdgesPlaced,
+                               endVertex,
+                               tmpEndVertex,
+                               startVertex,
+                               tmpStartVertex,
+                               SCALE);
+    all_radixsort_node_aux_seq(numEdgesPlaced,
+                               tmpStartVertex,
+                               startVertex,
+                               tmpEndVertex,
+                               endVertex,
+                               SCALE);
+
+    SDGdataPtr->startVertex = startVertex;
+    SDGdataPtr->endVertex = endVertex;
+
+    free(tmpStartVertex);
+    free(tmpEndVertex);
 
-    all_radixsort_node_aux_s3_seq(numEdgesPlaced,
-                                  startVertex,
-                                  SDGdataPtr->startVertex,
-                                  endVertex,
-                                  SDGdataPtr->endVertex);
+    free(permV);
+}
 
-    free(startVertex);
-    free(endVertex);
 
-    if (SCALE < 12) {
+/* =============================================================================
+ * Counter-based random streams for genScalData
+ *
+ * -- Every vertex, clique and edge draws from its own splitmix64 stream
+ *    keyed by (step, index), so the generated graph does not depend on how
+ *    the work is split among threads
+ * =============================================================================
+ */
 
-        /*
-         * Sort with endVertex as secondary key
-         */
+enum genStep {
+    GEN_STEP_PERMUTE     = 1,
+    GEN_STEP_CLIQUE_SIZE = 2,
+    GEN_STEP_CLIQUE_EDGE = 3,
+    GEN_STEP_INTER_EDGE  = 4,
+    GEN_STEP_WEIGHT      = 5,
+    GEN_STEP_STRING      = 6,
+    GEN_STEP_SOUGHT      = 7
+};
 
-        long i0 = 0;
-        long i1 = 0;
-        i = 0;
 
-        while (i < numEdgesPlaced) {
+/* =============================================================================
+ * nextRandom
+ * =============================================================================
+ */
+static inline unsigned long
+nextRandom (unsigned long* statePtr)
+{
+    unsigned long z = (*statePtr += 0x9E3779B97F4A7C15UL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9UL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBUL;
+    return z ^ (z >> 31);
+}
 
-            for (i = i0; i < numEdgesPlaced; i++) {
-                if (SDGdataPtr->startVertex[i] !=
-                    SDGdataPtr->startVertex[i1])
-                {
-                    i1 = i;
-                    break;
-                }
-            }
 
-            long j;
-            for (j = i0; j < i1; j++) {
-                long k;
-                for (k = j+1; k < i1; k++) {
-                    if (SDGdataPtr->endVertex[k] <
-                        SDGdataPtr->endVertex[j])
-                    {
-                        long t = SDGdataPtr->endVertex[j];
-                        SDGdataPtr->endVertex[j] = SDGdataPtr->endVertex[k];
-                        SDGdataPtr->endVertex[k] = t;
-                    }
-                }
-            }
+/* =============================================================================
+ * seedRandom
+ * =============================================================================
+ */
+static inline unsigned long
+seedRandom (long step, unsigned long index)
+{
+    unsigned long state = ((unsigned long)step << 56) ^ index;
+    return nextRandom(&state);
+}
+
+
+/* =============================================================================
+ * putEdge
+ * -- Only counts when startV is NULL
+ * =============================================================================
+ */
+static inline void
+putEdge (ULONGINT_T* startV,
+         ULONGINT_T* endV,
+         long* i_edgePtr,
+         ULONGINT_T start,
+         ULONGINT_T end)
+{
+    if (startV) {
+        startV[*i_edgePtr] = start;
+        endV[*i_edgePtr] = end;
+    }
+    (*i_edgePtr)++;
+}
+
+
+/* =============================================================================
+ * genCliqueEdges
+ * -- Returns the number of edges within clique i_clique
+ * =============================================================================
+ */
+static long
+genCliqueEdges (long i_clique,
+                long i_cliqueSize,
+                ULONGINT_T i_firstVsInClique,
+                ULONGINT_T** tmpEdgeCounter,
+                ULONGINT_T* startV,
+                ULONGINT_T* endV)
+{
+    unsigned long stream = seedRandom(GEN_STEP_CLIQUE_EDGE, i_clique);
+    float p = PROB_UNIDIRECTIONAL;
+    long i_edgePtr = 0;
+
+    /*
+     * First create at least one edge between two vetices in a clique
+     */
 
-            if (SDGdataPtr->startVertex[i0] != TOT_VERTICES-1) {
-                i0 = i1;
+    long i;
+    for (i = 0; i < i_cliqueSize; i++) {
+        long j;
+        for (j = 0; j < i; j++) {
+            float r = (float)(nextRandom(&stream) % 1000) / (float)1000;
+            if (r >= p) {
+                putEdge(startV, endV, &i_edgePtr,
+                        (i + i_firstVsInClique), (j + i_firstVsInClique));
+                tmpEdgeCounter[i][j] = 1;
+                putEdge(startV, endV, &i_edgePtr,
+                        (j + i_firstVsInClique), (i + i_firstVsInClique));
+                tmpEdgeCounter[j][i] = 1;
+            } else if (r >= 0.5) {
+                putEdge(startV, endV, &i_edgePtr,
+                        (i + i_firstVsInClique), (j + i_firstVsInClique));
+                tmpEdgeCounter[i][j] = 1;
+                tmpEdgeCounter[j][i] = 0;
             } else {
-                long j;
-                for (j=i0; j<numEdgesPlaced; j++) {
-                    long k;
-                    for (k=j+1; k<numEdgesPlaced; k++) {
-                        if (SDGdataPtr->endVertex[k] <
-                            SDGdataPtr->endVertex[j])
-                        {
-                            long t = SDGdataPtr->endVertex[j];
-                            SDGdataPtr->endVertex[j] = SDGdataPtr->endVertex[k];
-                            SDGdataPtr->endVertex[k] = t;
-                        }
-                    }
+                putEdge(startV, endV, &i_edgePtr,
+                        (j + i_firstVsInClique), (i + i_firstVsInClique));
+                tmpEdgeCounter[j][i] = 1;
+                tmpEdgeCounter[i][j] = 0;
+            }
+        }
+    }
+
+    if (i_cliqueSize != 1) {
+        long randNumEdges = (long)(nextRandom(&stream)
+                                   % (2*i_cliqueSize*MAX_PARAL_EDGES));
+        long i_paralEdge;
+        for (i_paralEdge = 0; i_paralEdge < randNumEdges; i_paralEdge++) {
+            i = (nextRandom(&stream) % i_cliqueSize);
+            long j = (nextRandom(&stream) % i_cliqueSize);
+            if ((i != j) && (tmpEdgeCounter[i][j] < MAX_PARAL_EDGES)) {
+                float r = (float)(nextRandom(&stream) % 1000) / (float)1000;
+                if (r >= p) {
+                    putEdge(startV, endV, &i_edgePtr,
+                            (i + i_firstVsInClique), (j + i_firstVsInClique));
+                    tmpEdgeCounter[i][j]++;
                 }
             }
+        }
+    }
 
-        } /* while i < numEdgesPlaced */
+    return i_edgePtr;
+}
 
-    } else {
 
-        ULONGINT_T* tempIndex =
-            (ULONGINT_T*)malloc((TOT_VERTICES + 1) * sizeof(ULONGINT_T));
+/* =============================================================================
+ * findClique
+ * -- Returns the clique containing vertex v
+ * =============================================================================
+ */
+static long
+findClique (ULONGINT_T* firstVsInCliques, long totCliques, ULONGINT_T v)
+{
+    long low = 0;
+    long high = totCliques;
 
-        /*
-         * Update degree of each vertex
-         */
+    while (high - low > 1) {
+        long mid = (low + high) / 2;
+        if (v >= firstVsInCliques[mid]) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
 
-        tempIndex[0] = 0;
-        tempIndex[TOT_VERTICES] = numEdgesPlaced;
-        long i0 = 0;
 
-        for (i=0; i < TOT_VERTICES; i++) {
-            tempIndex[i+1] = tempIndex[i];
-            long j;
-            for (j = i0; j < numEdgesPlaced; j++) {
-                if (SDGdataPtr->startVertex[j] !=
-                    SDGdataPtr->startVertex[i0])
-                {
-                    if (SDGdataPtr->startVertex[i0] == i) {
-                        tempIndex[i+1] = j;
-                        i0 = j;
-                        break;
-                    }
+/* =============================================================================
+ * genInterEdges
+ * -- Returns the number of inter-clique edges starting at vertex i
+ * =============================================================================
+ */
+static long
+genInterEdges (ULONGINT_T i,
+               ULONGINT_T* firstVsInCliques,
+               long totCliques,
+               ULONGINT_T* startV,
+               ULONGINT_T* endV)
+{
+    unsigned long stream = seedRandom(GEN_STEP_INTER_EDGE, i);
+    long i_edgePtr = 0;
+    long t1 = findClique(firstVsInCliques, totCliques, i);
+
+    ULONGINT_T d;
+    float p;
+    for (d = 1, p = PROB_INTERCL_EDGES; d < TOT_VERTICES; d *= 2, p /= 2) {
+
+        float r = (float)(nextRandom(&stream) % 1000) / (float)1000;
+
+        if (r <= p) {
+            ULONGINT_T tempVertex2 = (i + d) % TOT_VERTICES;
+            if (findClique(firstVsInCliques, totCliques, tempVertex2) != t1) {
+                long randNumEdges = nextRandom(&stream) % MAX_PARAL_EDGES + 1;
+                long j;
+                for (j = 0; j < randNumEdges; j++) {
+                    putEdge(startV, endV, &i_edgePtr, i, tempVertex2);
                 }
             }
         }
 
-        /*
-         * Insertion sort for now, replace with something better later on
-         */
-        for (i = 0; i < TOT_VERTICES; i++) {
-            long j;
-            for (j = tempIndex[i]; j < tempIndex[i+1]; j++) {
-                long k;
-                for (k = (j + 1); k < tempIndex[i+1]; k++) {
-                    if (SDGdataPtr->endVertex[k] <
-                        SDGdataPtr->endVertex[j])
-                    {
-                        long t = SDGdataPtr->endVertex[j];
-                        SDGdataPtr->endVertex[j] = SDGdataPtr->endVertex[k];
-                        SDGdataPtr->endVertex[k] = t;
-                    }
+        float r0 = (float)(nextRandom(&stream) % 1000) / (float)1000;
+
+        if (r0 <= p) {
+            ULONGINT_T tempVertex2 = (i + TOT_VERTICES - d) % TOT_VERTICES;
+            if (findClique(firstVsInCliques, totCliques, tempVertex2) != t1) {
+                long randNumEdges = nextRandom(&stream) % MAX_PARAL_EDGES + 1;
+                long j;
+                for (j = 0; j < randNumEdges; j++) {
+                    putEdge(startV, endV, &i_edgePtr, i, tempVertex2);
                 }
             }
         }
 
-       free(tempIndex);
-
-    } /* SCALE >= 12 */
+    }
 
-    free(permV);
+    return i_edgePtr;
 }
 
 
 /* =============================================================================
  * genScalData
+ * -- Output is identical for any number of threads
  * =============================================================================
  */
 void
@@ -767,50 +884,67 @@ genScalData (void* argPtr)
     long myId = thread_getId();
     long numThread = thread_getNumThread();
 
+    long i;
+    long i_start;
+    long i_stop;
+
     /*
      * STEP 0: Create the permutations required to randomize the vertices
+     *
+     * Vertex ids are sorted by a random key (stable, so ties keep id order)
      */
 
-    std::mt19937 stream;
-    stream.seed(myId);
-
-    ULONGINT_T* permV; /* the vars associated with the graph tuple */
+    ULONGINT_T* permV;
+    ULONGINT_T* permKey;
+    ULONGINT_T* permKeySorted;
+    ULONGINT_T* permId;
 
     if (myId == 0) {
-        permV = (ULONGINT_T*)malloc(TOT_VERTICES * sizeof(ULONGINT_T));
+        long numByte = TOT_VERTICES * sizeof(ULONGINT_T);
+        permV = (ULONGINT_T*)malloc(numByte);
         assert(permV);
         global_permV = permV;
+        permKey = (ULONGINT_T*)malloc(numByte);
+        assert(permKey);
+        global_permKey = permKey;
+        permKeySorted = (ULONGINT_T*)malloc(numByte);
+        assert(permKeySorted);
+        global_permKeySorted = permKeySorted;
+        permId = (ULONGINT_T*)malloc(numByte);
+        assert(permId);
+        global_permId = permId;
     }
 
     thread_barrier_wait();
 
-    permV = global_permV;
+    permV         = global_permV;
+    permKey       = global_permKey;
+    permKeySorted = global_permKeySorted;
+    permId        = global_permId;
+
+    long keyBit = ((2 * SCALE < 64) ? (2 * SCALE) : 64);
+    ULONGINT_T keyMask = ((keyBit < 64) ? ((1UL << keyBit) - 1) : ~0UL);
 
-    long i;
-    long i_start;
-    long i_stop;
     createPartition(0, TOT_VERTICES, myId, numThread, &i_start, &i_stop);
 
-    /* Initialize the array */
     for (i = i_start; i < i_stop; i++) {
-        permV[i] = i;
+        permKey[i] = seedRandom(GEN_STEP_PERMUTE, i) & keyMask;
+        permId[i] = i;
     }
 
     thread_barrier_wait();
 
-    for (i = i_start; i < i_stop; i++) {
-        long t1 = stream();
-        long t = i + t1 % (TOT_VERTICES - i);
-        if (t != i) {
-          __transaction_atomic {
-            //unsigned long t2 = (unsigned long)TM_SHARED_READ(permV[t]);
-            //TM_SHARED_WRITE(permV[t], TM_SHARED_READ(permV[i]));
-            //TM_SHARED_WRITE(permV[i], t2);
-            unsigned long temp = (unsigned long)permV[t];
-            permV[t] = permV[i];
-            permV[i] = temp;
-          }
-        }
+    all_radixsort_node_aux(TOT_VERTICES,
+                           permKey,
+                           permKeySorted,
+                           permId,
+                           permV,
+                           keyBit);
+
+    if (myId == 0) {
+        free(permKey);
+        free(permKeySorted);
+        free(permId);
     }
 
     /*
@@ -839,7 +973,8 @@ genScalData (void* argPtr)
 
     /* Generate random clique sizes. */
     for (i = i_start; i < i_stop; i++) {
-        cliqueSizes[i] = 1 + (stream() % MAX_CLIQUE_SIZE);
+        cliqueSizes[i] =
+            1 + (seedRandom(GEN_STEP_CLIQUE_SIZE, i) % MAX_CLIQUE_SIZE);
     }
 
     thread_barrier_wait();
@@ -900,9 +1035,9 @@ genScalData (void* argPtr)
         firstVsInCliques[i] = lastVsInCliques[i-1] + 1;
     }
 
-#ifdef WRITE_RESULT_FILES
     thread_barrier_wait();
 
+#ifdef WRITE_RESULT_FILES
     /* Write the generated cliques to file for comparison with Kernel 4 */
     if (myId == 0) {
         FILE* outfp = fopen("cliques.txt", "w");
@@ -922,45 +1057,14 @@ genScalData (void* argPtr)
 #endif
 
     /*
-     * STEP 2: Create the edges within the cliques
-     */
-
-    /*
-     * Estimate number of edges - using an empirical measure
-     */
-    long estTotEdges;
-    if (SCALE >= 12) {
-        estTotEdges = ceil((double)((MAX_CLIQUE_SIZE-1) * TOT_VERTICES));
-    } else {
-        estTotEdges = ceil(1.2 * (((MAX_CLIQUE_SIZE-1)*TOT_VERTICES)
-                                  * ((1 + MAX_PARAL_EDGES)/2) + TOT_VERTICES*2));
-    }
-
-    /*
-     * Initialize edge counter
-     */
-    long i_edgePtr = 0;
-    float p = PROB_UNIDIRECTIONAL;
-
-    /*
-     * Partial edgeLists
+     * STEP 2 and 3: Create the edges within the cliques, then connect the
+     * cliques as given in the specs
+     *
+     * Each thread counts the edges of its cliques and vertices first, so
+     * the output arrays are sized exactly and every thread writes its own
+     * slice in clique/vertex order
      */
 
-    ULONGINT_T* startV;
-    ULONGINT_T* endV;
-
-    if (numThread > 3) {
-        long numByte = 1.5 * (estTotEdges/numThread) * sizeof(ULONGINT_T);
-        startV = (ULONGINT_T*)malloc(numByte);
-        endV = (ULONGINT_T*)malloc(numByte);
-    } else  {
-        long numByte = (estTotEdges/numThread) * sizeof(ULONGINT_T);
-        startV = (ULONGINT_T*)malloc(numByte);
-        endV = (ULONGINT_T*)malloc(numByte);
-    }
-    assert(startV);
-    assert(endV);
-
     /*
      * Tmp array to keep track of the no. of parallel edges in each direction
      */
@@ -973,432 +1077,117 @@ genScalData (void* argPtr)
         assert(tmpEdgeCounter[i]);
     }
 
-    /*
-     * Create edges in parallel
-     */
-     long i_clique;
-     createPartition(0, totCliques, myId, numThread, &i_start, &i_stop);
-
-     for (i_clique = i_start; i_clique < i_stop; i_clique++) {
-
-        /*
-         * Get current clique parameters
-         */
-
-        long i_cliqueSize = cliqueSizes[i_clique];
-        long i_firstVsInClique = firstVsInCliques[i_clique];
-
-        /*
-         * First create at least one edge between two vetices in a clique
-         */
-
-        for (i = 0; i < i_cliqueSize; i++) {
+    long c_start;
+    long c_stop;
+    createPartition(0, totCliques, myId, numThread, &c_start, &c_stop);
+    long v_start;
+    long v_stop;
+    createPartition(0, TOT_VERTICES, myId, numThread, &v_start, &v_stop);
+
+    ULONGINT_T numEdge = 0;
+    for (i = c_start; i < c_stop; i++) {
+        numEdge += genCliqueEdges(i, cliqueSizes[i], firstVsInCliques[i],
+                                  tmpEdgeCounter, NULL, NULL);
+    }
 
-            long j;
-            for (j = 0; j < i; j++) {
+    long numEdgesPlacedInCliques;
+    ULONGINT_T cliqueEdgeStart =
+        parallel_scanThread(numEdge, &numEdgesPlacedInCliques);
 
-                float r = (float)(stream() % 1000) / (float)1000;
-                if (r >= p) {
+    numEdge = 0;
+    for (i = v_start; i < v_stop; i++) {
+        numEdge += genInterEdges(i, firstVsInCliques, totCliques, NULL, NULL);
+    }
 
-                    startV[i_edgePtr] = i + i_firstVsInClique;
-                    endV[i_edgePtr] = j + i_firstVsInClique;
-                    i_edgePtr++;
-                    tmpEdgeCounter[i][j] = 1;
+    long numEdgesPlacedOutside;
+    ULONGINT_T interEdgeStart =
+        parallel_scanThread(numEdge, &numEdgesPlacedOutside);
 
-                    startV[i_edgePtr] = j + i_firstVsInClique;
-                    endV[i_edgePtr] = i + i_firstVsInClique;
-                    i_edgePtr++;
-                    tmpEdgeCounter[j][i] = 1;
+    ULONGINT_T numEdgesPlaced = numEdgesPlacedInCliques + numEdgesPlacedOutside;
 
-                } else  if (r >= 0.5) {
+    ULONGINT_T* startVertex;
+    ULONGINT_T* endVertex;
 
-                    startV[i_edgePtr] = i + i_firstVsInClique;
-                    endV[i_edgePtr] = j + i_firstVsInClique;
-                    i_edgePtr++;
-                    tmpEdgeCounter[i][j] = 1;
-                    tmpEdgeCounter[j][i] = 0;
+    if (myId == 0) {
+        SDGdataPtr->numEdgesPlaced = numEdgesPlaced;
 
-                } else {
+        long numByte = numEdgesPlaced * sizeof(ULONGINT_T);
+        startVertex = (ULONGINT_T*)malloc(numByte);
+        assert(startVertex);
+        endVertex = (ULONGINT_T*)malloc(numByte);
+        assert(endVertex);
+        global_startVertex = startVertex;
+        global_endVertex = endVertex;
 
-                    startV[i_edgePtr] = j + i_firstVsInClique;
-                    endV[i_edgePtr] = i + i_firstVsInClique;
-                    i_edgePtr++;
-                    tmpEdgeCounter[j][i] = 1;
-                    tmpEdgeCounter[i][j] = 0;
+        printf("Finished generating edges\n");
+        printf("No. of intra-clique edges - %lu\n", numEdgesPlacedInCliques);
+        printf("No. of inter-clique edges - %lu\n", numEdgesPlacedOutside);
+        printf("Total no. of edges        - %lu\n", numEdgesPlaced);
+    }
 
-                }
+    thread_barrier_wait();
 
-            } /* for j */
-        } /* for i */
+    startVertex = global_startVertex;
+    endVertex = global_endVertex;
 
-        if (i_cliqueSize != 1) {
-            long randNumEdges = (long)(stream()
-                                       % (2*i_cliqueSize*MAX_PARAL_EDGES));
-            long i_paralEdge;
-            for (i_paralEdge = 0; i_paralEdge < randNumEdges; i_paralEdge++) {
-                i = (stream() % i_cliqueSize);
-                long j = (stream() % i_cliqueSize);
-                if ((i != j) && (tmpEdgeCounter[i][j] < MAX_PARAL_EDGES)) {
-                    float r = (float)(stream() % 1000) / (float)1000;
-                    if (r >= p) {
-                        /* Copy to edge structure. */
-                        startV[i_edgePtr] = i + i_firstVsInClique;
-                        endV[i_edgePtr] = j + i_firstVsInClique;
-                        i_edgePtr++;
-                        tmpEdgeCounter[i][j]++;
-                    }
-                }
-            }
-        }
+    numEdge = cliqueEdgeStart;
+    for (i = c_start; i < c_stop; i++) {
+        numEdge += genCliqueEdges(i, cliqueSizes[i], firstVsInCliques[i],
+                                  tmpEdgeCounter,
+                                  &startVertex[numEdge], &endVertex[numEdge]);
+    }
 
-    } /* for i_clique */
+    numEdge = numEdgesPlacedInCliques + interEdgeStart;
+    for (i = v_start; i < v_stop; i++) {
+        numEdge += genInterEdges(i, firstVsInCliques, totCliques,
+                                 &startVertex[numEdge], &endVertex[numEdge]);
+    }
 
     for (i = 0; i < MAX_CLIQUE_SIZE; i++) {
         free(tmpEdgeCounter[i]);
     }
     free(tmpEdgeCounter);
 
+    thread_barrier_wait();
+
+    if (myId == 0) {
+        free(cliqueSizes);
+        free(firstVsInCliques);
+        free(lastVsInCliques);
+    }
+
     /*
-     * Merge partial edge lists
+     * STEP 4: Generate edge weights
      */
 
-    ULONGINT_T* i_edgeStartCounter;
-    ULONGINT_T* i_edgeEndCounter;
-
     if (myId == 0) {
-        i_edgeStartCounter = (ULONGINT_T*)malloc(numThread * sizeof(ULONGINT_T));
-        assert(i_edgeStartCounter);
-        global_i_edgeStartCounter = i_edgeStartCounter;
-        i_edgeEndCounter = (ULONGINT_T*)malloc(numThread * sizeof(ULONGINT_T));
-        assert(i_edgeEndCounter);
-        global_i_edgeEndCounter = i_edgeEndCounter;
+        SDGdataPtr->intWeight =
+            (LONGINT_T*)malloc(numEdgesPlaced * sizeof(LONGINT_T));
+        assert(SDGdataPtr->intWeight);
     }
 
     thread_barrier_wait();
 
-    i_edgeStartCounter = global_i_edgeStartCounter;
-    i_edgeEndCounter   = global_i_edgeEndCounter;
-
-    i_edgeEndCounter[myId] = i_edgePtr;
-    i_edgeStartCounter[myId] = 0;
+    float p = PERC_INT_WEIGHTS;
+    ULONGINT_T numStrWtEdges  = 0;
 
-    thread_barrier_wait();
+    createPartition(0, numEdgesPlaced, myId, numThread, &i_start, &i_stop);
 
-    if (myId == 0) {
-        for (i = 1; i < numThread; i++) {
-            i_edgeEndCounter[i] = i_edgeEndCounter[i-1] + i_edgeEndCounter[i];
-            i_edgeStartCounter[i] = i_edgeEndCounter[i-1];
+    for (i = i_start; i < i_stop; i++) {
+        unsigned long stream = seedRandom(GEN_STEP_WEIGHT, i);
+        float r = (float)(nextRandom(&stream) % 1000) / (float)1000;
+        if (r <= p) {
+            SDGdataPtr->intWeight[i] =
+                1 + (nextRandom(&stream) % (MAX_INT_WEIGHT-1));
+        } else {
+            SDGdataPtr->intWeight[i] = -1;
+            numStrWtEdges++;
         }
     }
 
-    __transaction_atomic {
-      //TM_SHARED_WRITE(global_edgeNum,
-      //                ((long)TM_SHARED_READ(global_edgeNum) + i_edgePtr));
-      global_edgeNum += i_edgePtr;
-    }
-
-    thread_barrier_wait();
-
-    long edgeNum = global_edgeNum;
-
-    /*
-     * Initialize edge list arrays
-     */
-
-    ULONGINT_T* startVertex;
-    ULONGINT_T* endVertex;
-
-    if (myId == 0) {
-        if (SCALE < 10) {
-            long numByte = 2 * edgeNum * sizeof(ULONGINT_T);
-            startVertex = (ULONGINT_T*)malloc(numByte);
-            endVertex = (ULONGINT_T*)malloc(numByte);
-        } else {
-            long numByte = (edgeNum + MAX_PARAL_EDGES * TOT_VERTICES)
-                           * sizeof(ULONGINT_T);
-            startVertex = (ULONGINT_T*)malloc(numByte);
-            endVertex = (ULONGINT_T*)malloc(numByte);
-        }
-        assert(startVertex);
-        assert(endVertex);
-        global_startVertex = startVertex;
-        global_endVertex = endVertex;
-    }
-
-    thread_barrier_wait();
-
-    startVertex = global_startVertex;
-    endVertex = global_endVertex;
-
-    for (i = i_edgeStartCounter[myId]; i < i_edgeEndCounter[myId]; i++) {
-        startVertex[i] = startV[i-i_edgeStartCounter[myId]];
-        endVertex[i] = endV[i-i_edgeStartCounter[myId]];
-    }
-
-    ULONGINT_T numEdgesPlacedInCliques = edgeNum;
-
-    thread_barrier_wait();
-
-    /*
-     * STEP 3: Connect the cliques
-     */
-
-    i_edgePtr = 0;
-    p = PROB_INTERCL_EDGES;
-
-    /*
-     * Generating inter-clique edges as given in the specs
-     */
-
-    createPartition(0, TOT_VERTICES, myId, numThread, &i_start, &i_stop);
-
-    for (i = i_start; i < i_stop; i++) {
-
-        ULONGINT_T tempVertex1 = i;
-        long h = totCliques;
-        long l = 0;
-        long t = -1;
-        while (h - l > 1) {
-            long m = (h + l) / 2;
-            if (tempVertex1 >= firstVsInCliques[m]) {
-                l = m;
-            } else {
-                if ((tempVertex1 < firstVsInCliques[m]) && (m > 0)) {
-                    if (tempVertex1 >= firstVsInCliques[m-1]) {
-                        t = m - 1;
-                        break;
-                    } else {
-                        h = m;
-                    }
-                }
-            }
-        }
-
-        if (t == -1) {
-            long m;
-            for (m = (l + 1); m < h; m++) {
-                if (tempVertex1<firstVsInCliques[m]) {
-                    break;
-                }
-            }
-            t = m-1;
-        }
-
-        long t1 = firstVsInCliques[t];
-
-        ULONGINT_T d;
-        for (d = 1, p = PROB_INTERCL_EDGES; d < TOT_VERTICES; d *= 2, p /= 2) {
-
-            float r = (float)(stream() % 1000) / (float)1000;
-
-            if (r <= p) {
-
-                ULONGINT_T tempVertex2 = (i+d) % TOT_VERTICES;
-
-                h = totCliques;
-                l = 0;
-                t = -1;
-                while (h - l > 1) {
-                    long m = (h + l) / 2;
-                    if (tempVertex2 >= firstVsInCliques[m]) {
-                        l = m;
-                    } else {
-                        if ((tempVertex2 < firstVsInCliques[m]) && (m > 0)) {
-                            if (firstVsInCliques[m-1] <= tempVertex2) {
-                                t = m - 1;
-                                break;
-                            } else {
-                                h = m;
-                            }
-                        }
-                    }
-                }
-
-                if (t == -1) {
-                    long m;
-                    for (m = (l + 1); m < h; m++) {
-                        if (tempVertex2 < firstVsInCliques[m]) {
-                            break;
-                        }
-                    }
-                    t = m - 1;
-                }
-
-                long t2 = firstVsInCliques[t];
-
-                if (t1 != t2) {
-                    long randNumEdges =
-                        stream() % MAX_PARAL_EDGES + 1;
-                    long j;
-                    for (j = 0; j < randNumEdges; j++) {
-                        startV[i_edgePtr] = tempVertex1;
-                        endV[i_edgePtr] = tempVertex2;
-                        i_edgePtr++;
-                    }
-                }
-
-            } /* r <= p */
-
-            float r0 = (float)(stream() % 1000) / (float)1000;
-
-            if ((r0 <= p) && (i-d>=0)) {
-
-                ULONGINT_T tempVertex2 = (i-d) % TOT_VERTICES;
-
-                h = totCliques;
-                l = 0;
-                t = -1;
-                while (h - l > 1) {
-                    long m = (h + l) / 2;
-                    if (tempVertex2 >= firstVsInCliques[m]) {
-                        l = m;
-                    } else {
-                        if ((tempVertex2 < firstVsInCliques[m]) && (m > 0)) {
-                            if (firstVsInCliques[m-1] <= tempVertex2) {
-                                t = m - 1;
-                                break;
-                            } else {
-                                h = m;
-                            }
-                        }
-                    }
-                }
-
-                if (t == -1) {
-                    long m;
-                    for (m = (l + 1); m < h; m++) {
-                        if (tempVertex2 < firstVsInCliques[m]) {
-                            break;
-                        }
-                    }
-                    t = m - 1;
-                }
-
-                long t2 = firstVsInCliques[t];
-
-                if (t1 != t2) {
-                    long randNumEdges =
-                        stream() % MAX_PARAL_EDGES + 1;
-                    long j;
-                    for (j = 0; j < randNumEdges; j++) {
-                        startV[i_edgePtr] = tempVertex1;
-                        endV[i_edgePtr] = tempVertex2;
-                        i_edgePtr++;
-                    }
-                }
-
-            } /* r0 <= p && (i-d) > 0 */
-
-        } /* for d, p */
-
-    } /* for i */
-
-
-    i_edgeEndCounter[myId] = i_edgePtr;
-    i_edgeStartCounter[myId] = 0;
-
-    if (myId == 0) {
-        global_edgeNum = 0;
-    }
-
-    thread_barrier_wait();
-
-    if (myId == 0) {
-        for (i = 1; i < numThread; i++) {
-            i_edgeEndCounter[i] = i_edgeEndCounter[i-1] + i_edgeEndCounter[i];
-            i_edgeStartCounter[i] = i_edgeEndCounter[i-1];
-        }
-    }
-    __transaction_atomic {
-      //TM_SHARED_WRITE(global_edgeNum,
-      //                ((long)TM_SHARED_READ(global_edgeNum) + i_edgePtr));
-      global_edgeNum += i_edgePtr;
-    }
-
-    thread_barrier_wait();
-
-    edgeNum = global_edgeNum;
-    ULONGINT_T numEdgesPlacedOutside = global_edgeNum;
-
-    for (i = i_edgeStartCounter[myId]; i < i_edgeEndCounter[myId]; i++) {
-        startVertex[i+numEdgesPlacedInCliques] = startV[i-i_edgeStartCounter[myId]];
-        endVertex[i+numEdgesPlacedInCliques] = endV[i-i_edgeStartCounter[myId]];
-    }
-
-    thread_barrier_wait();
-
-    ULONGINT_T  numEdgesPlaced = numEdgesPlacedInCliques + numEdgesPlacedOutside;
-
-    if (myId == 0) {
-
-        SDGdataPtr->numEdgesPlaced = numEdgesPlaced;
-
-        printf("Finished generating edges\n");
-        printf("No. of intra-clique edges - %lu\n", numEdgesPlacedInCliques);
-        printf("No. of inter-clique edges - %lu\n", numEdgesPlacedOutside);
-        printf("Total no. of edges        - %lu\n", numEdgesPlaced);
-
-        free(i_edgeStartCounter);
-        free(i_edgeEndCounter);
-
-        free(cliqueSizes);
-        free(firstVsInCliques);
-        free(lastVsInCliques);
-    }
-
-    thread_barrier_wait();
-
-    free(startV);
-    free(endV);
-
-    /*
-     * STEP 4: Generate edge weights
-     */
-
-    if (myId == 0) {
-        SDGdataPtr->intWeight =
-            (LONGINT_T*)malloc(numEdgesPlaced * sizeof(LONGINT_T));
-        assert(SDGdataPtr->intWeight);
-    }
-
-    thread_barrier_wait();
-
-    p = PERC_INT_WEIGHTS;
-    ULONGINT_T numStrWtEdges  = 0;
-
-    createPartition(0, numEdgesPlaced, myId, numThread, &i_start, &i_stop);
-
-    for (i = i_start; i < i_stop; i++) {
-        float r = (float)(stream() % 1000) / (float)1000;
-        if (r <= p) {
-            SDGdataPtr->intWeight[i] =
-                1 + (stream() % (MAX_INT_WEIGHT-1));
-        } else {
-            SDGdataPtr->intWeight[i] = -1;
-            numStrWtEdges++;
-        }
-    }
-
-    thread_barrier_wait();
-
-    if (myId == 0) {
-        long t = 0;
-        for (i = 0; i < numEdgesPlaced; i++) {
-            if (SDGdataPtr->intWeight[i] < 0) {
-                SDGdataPtr->intWeight[i] = -t;
-                t++;
-            }
-        }
-    }
-    __transaction_atomic {
-      //TM_SHARED_WRITE(global_numStrWtEdges,
-      //                ((long)TM_SHARED_READ(global_numStrWtEdges) + numStrWtEdges));
-      global_numStrWtEdges += numStrWtEdges;
-    }
-
-    thread_barrier_wait();
-
-    numStrWtEdges = global_numStrWtEdges;
+    long totStrWtEdges;
+    ULONGINT_T strWtStart = parallel_scanThread(numStrWtEdges, &totStrWtEdges);
+    numStrWtEdges = totStrWtEdges;
 
     if (myId == 0) {
         SDGdataPtr->strWeight =
@@ -1408,18 +1197,27 @@ genScalData (void* argPtr)
 
     thread_barrier_wait();
 
-    createPartition(0, numEdgesPlaced, myId, numThread, &i_start, &i_stop);
+    /*
+     * String-weighted edges are numbered in edge order; the weight holds
+     * -(string index)
+     */
 
+    ULONGINT_T t = strWtStart;
     for (i = i_start; i < i_stop; i++) {
-        if (SDGdataPtr->intWeight[i] <= 0) {
+        if (SDGdataPtr->intWeight[i] < 0) {
+            SDGdataPtr->intWeight[i] = -t;
+            unsigned long stream = seedRandom(GEN_STEP_STRING, t);
             long j;
             for (j = 0; j < MAX_STRLEN; j++) {
-                SDGdataPtr->strWeight[(-SDGdataPtr->intWeight[i])*MAX_STRLEN+j] =
-                    (char) (1 + stream() % 127);
+                SDGdataPtr->strWeight[t*MAX_STRLEN+j] =
+                    (char) (1 + nextRandom(&stream) % 127);
             }
+            t++;
         }
     }
 
+    thread_barrier_wait();
+
     /*
      * Choose SOUGHT STRING randomly if not assigned
      */
@@ -1431,17 +1229,14 @@ genScalData (void* argPtr)
             assert(SOUGHT_STRING);
         }
 
-        long t = stream() % numStrWtEdges;
+        long t = seedRandom(GEN_STEP_SOUGHT, 0) % numStrWtEdges;
         long j;
         for (j = 0; j < MAX_STRLEN; j++) {
             SOUGHT_STRING[j] =
                 (char) ((long) SDGdataPtr->strWeight[t*MAX_STRLEN+j]);
         }
-
     }
 
-    thread_barrier_wait();
-
     /*
      * STEP 5: Permute Vertices
      */
@@ -1458,178 +1253,48 @@ genScalData (void* argPtr)
      */
 
     /*
-     * Radix sort with StartVertex as primary key
+     * Radix sort with endVertex as secondary and startVertex as primary key:
+     * two stable sorts leave the tuples in (startVertex, endVertex) order
      */
 
+    ULONGINT_T* tmpStartVertex;
+    ULONGINT_T* tmpEndVertex;
+
     if (myId == 0) {
         long numByte = numEdgesPlaced * sizeof(ULONGINT_T);
-        SDGdataPtr->startVertex = (ULONGINT_T*)malloc(numByte);
-        assert(SDGdataPtr->startVertex);
-        SDGdataPtr->endVertex = (ULONGINT_T*)malloc(numByte);
-        assert(SDGdataPtr->endVertex);
+        tmpStartVertex = (ULONGINT_T*)malloc(numByte);
+        assert(tmpStartVertex);
+        tmpEndVertex = (ULONGINT_T*)malloc(numByte);
+        assert(tmpEndVertex);
+        global_tmpStartVertex = tmpStartVertex;
+        global_tmpEndVertex = tmpEndVertex;
     }
 
     thread_barrier_wait();
 
-    all_radixsort_node_aux_s3(numEdgesPlaced,
-                              startVertex,
-                              SDGdataPtr->startVertex,
-                              endVertex,
-                              SDGdataPtr->endVertex);
-
-    thread_barrier_wait();
+    tmpStartVertex = global_tmpStartVertex;
+    tmpEndVertex = global_tmpEndVertex;
+
+    all_radixsort_node_aux(numEdgesPlaced,
+                           endVertex,
+                           tmpEndVertex,
+                           startVertex,
+                           tmpStartVertex,
+                           SCALE);
+    all_radixsort_node_aux(numEdgesPlaced,
+                           tmpStartVertex,
+                           startVertex,
+                           tmpEndVertex,
+                           endVertex,
+                           SCALE);
 
     if (myId == 0) {
-        free(startVertex);
-        free(endVertex);
+        SDGdataPtr->startVertex = startVertex;
+        SDGdataPtr->endVertex = endVertex;
+        free(tmpStartVertex);
+        free(tmpEndVertex);
     }
 
-    thread_barrier_wait();
-
-    if (SCALE < 12) {
-
-        /*
-         * Sort with endVertex as secondary key
-         */
-
-        if (myId == 0) {
-
-            long i0 = 0;
-            long i1 = 0;
-            i = 0;
-
-            while (i < numEdgesPlaced) {
-
-                for (i = i0; i < numEdgesPlaced; i++) {
-                    if (SDGdataPtr->startVertex[i] !=
-                        SDGdataPtr->startVertex[i1])
-                    {
-                        i1 = i;
-                        break;
-                    }
-                }
-
-                long j;
-                for (j = i0; j < i1; j++) {
-                    long k;
-                    for (k = j+1; k < i1; k++) {
-                        if (SDGdataPtr->endVertex[k] <
-                            SDGdataPtr->endVertex[j])
-                        {
-                            long t = SDGdataPtr->endVertex[j];
-                            SDGdataPtr->endVertex[j] = SDGdataPtr->endVertex[k];
-                            SDGdataPtr->endVertex[k] = t;
-                        }
-                    }
-                }
-
-                if (SDGdataPtr->startVertex[i0] != TOT_VERTICES-1) {
-                    i0 = i1;
-                } else {
-                    long j;
-                    for (j=i0; j<numEdgesPlaced; j++) {
-                        long k;
-                        for (k=j+1; k<numEdgesPlaced; k++) {
-                            if (SDGdataPtr->endVertex[k] <
-                                SDGdataPtr->endVertex[j])
-                            {
-                                long t = SDGdataPtr->endVertex[j];
-                                SDGdataPtr->endVertex[j] = SDGdataPtr->endVertex[k];
-                                SDGdataPtr->endVertex[k] = t;
-                            }
-                        }
-                    }
-                }
-
-            } /* while i < numEdgesPlaced */
-
-        }
-
-    } else {
-
-        ULONGINT_T* tempIndex;
-
-        if (myId == 0) {
-
-            tempIndex =
-                (ULONGINT_T*)malloc((TOT_VERTICES + 1) * sizeof(ULONGINT_T));
-            assert(tempIndex);
-            global_tempIndex = tempIndex;
-
-            /*
-             * Update degree of each vertex
-             */
-            tempIndex[0] = 0;
-            tempIndex[TOT_VERTICES] = numEdgesPlaced;
-            long i0 = 0;
-
-            for (i=0; i < TOT_VERTICES; i++) {
-                tempIndex[i+1] = tempIndex[i];
-                long j;
-                for (j = i0; j < numEdgesPlaced; j++) {
-                    if (SDGdataPtr->startVertex[j] !=
-                        SDGdataPtr->startVertex[i0]) {
-                        if (SDGdataPtr->startVertex[i0] == i) {
-                            tempIndex[i+1] = j;
-                            i0 = j;
-                            break;
-                        }
-                    }
-                }
-            }
-        }
-
-        thread_barrier_wait();
-
-        tempIndex = global_tempIndex;
-
-        /*
-         * Insertion sort for now, replace with something better later on
-         */
-#if 0
-        createPartition(0, TOT_VERTICES, myId, numThread, &i_start, &i_stop);
-
-        for (i = i_start; i < i_stop; i++) {
-            long j;
-            for (j = tempIndex[i]; j < tempIndex[i+1]; j++) {
-                long k;
-                for (k = (j + 1); k < tempIndex[i+1]; k++) {
-                    if (SDGdataPtr->endVertex[k] <
-                        SDGdataPtr->endVertex[j])
-                    {
-                        long t = SDGdataPtr->endVertex[j];
-                        SDGdataPtr->endVertex[j] = SDGdataPtr->endVertex[k];
-                        SDGdataPtr->endVertex[k] = t;
-                    }
-                }
-            }
-        }
-#else
-        if (myId == 0) {
-            for (i = 0; i < TOT_VERTICES; i++) {
-                long j;
-                for (j = tempIndex[i]; j < tempIndex[i+1]; j++) {
-                    long k;
-                    for (k = (j + 1); k < tempIndex[i+1]; k++) {
-                        if (SDGdataPtr->endVertex[k] <
-                            SDGdataPtr->endVertex[j])
-                        {
-                            long t = SDGdataPtr->endVertex[j];
-                            SDGdataPtr->endVertex[j] = SDGdataPtr->endVertex[k];
-                            SDGdataPtr->endVertex[k] = t;
-                        }
-                    }
-                }
-            }
-        }
-#endif
-
-        if (myId == 0) {
-            free(tempIndex);
-        }
-
-    } /* SCALE >= 12 */
-
     if (myId == 0) {
         free(permV);
     }
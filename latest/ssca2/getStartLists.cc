@@ -65,7 +65,6 @@
 
 
 #include <assert.h>
-#include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -73,14 +72,56 @@
 #include "defs.h"
 #include "getStartLists.h"
 #include "globals.h"
+#include "parallel.h"
 #include "thread.h"
 #include "utility.h"
 
-static LONGINT_T global_maxWeight          = 0;
-static long*     global_i_edgeStartCounter = NULL;
-static long*     global_i_edgeEndCounter   = NULL;
 static edge*     global_maxIntWtList       = NULL;
 static edge*     global_soughtStrWtList    = NULL;
+static long*     global_strEdgeIndex       = NULL;
+
+
+/* =============================================================================
+ * findUpper
+ * -- Returns index of first element > key (or num); array must be sorted
+ * =============================================================================
+ */
+static long
+findUpper (ULONGINT_T* array, long num, ULONGINT_T key)
+{
+    long low = 0;
+    long high = num;
+
+    while (low < high) {
+        long mid = low + (high - low) / 2;
+        if (array[mid] <= key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+
+/* =============================================================================
+ * fillEdge
+ * -- Recovers the directed edge containing SDG tuple i from the prefix arrays
+ * =============================================================================
+ */
+static void
+fillEdge (edge* edgePtr, graph* GPtr, long i)
+{
+    /* Last directed edge whose first parallel tuple is <= i */
+    long j = findUpper(GPtr->paralEdgeIndex, GPtr->numDirectedEdges, i);
+    edgePtr->endVertex = GPtr->outVertexList[j-1];
+    edgePtr->edgeNum = j-1;
+
+    /* Last vertex whose adjacency list starts at or before that edge */
+    long t = findUpper(GPtr->outVertexIndex, GPtr->numVertices, (j-1));
+    edgePtr->startVertex = t-1;
+}
 
 
 /* =============================================================================
@@ -116,214 +157,108 @@ getStartLists (void* argPtr)
         }
     }
 
-    __transaction_atomic {
-      //long tmp_maxWeight = (long)TM_SHARED_READ(global_maxWeight);
-      //if (maxWeight > tmp_maxWeight)
-      // TM_SHARED_WRITE(global_maxWeight, maxWeight);
-
-      if (maxWeight > global_maxWeight)
-        global_maxWeight = maxWeight;
-    }
-
-    thread_barrier_wait();
-
-    maxWeight = global_maxWeight;
+    maxWeight = parallel_reduceMaxLong(maxWeight);
 
     /*
-     * Create partial lists
+     * Count the matches per thread, then write them at this thread's offset
      */
 
-    /*
-     * Allocate mem. for temp edge list for each thread
-     */
-    long numTmpEdge = (5+ceil(1.5*(GPtr->numIntEdges)/MAX_INT_WEIGHT));
-    edge* tmpEdgeList = (edge*)malloc(numTmpEdge * sizeof(edge));
-
     long i_edgeCounter = 0;
 
     for (i = i_start; i < i_stop; i++) {
-
         if (GPtr->intWeight[i] == maxWeight) {
-
-            /* Find the corresponding endVertex */
-            long j;
-            for (j = 0; j < GPtr->numDirectedEdges; j++) {
-                if (GPtr->paralEdgeIndex[j] > i) {
-                    break;
-                }
-            }
-            tmpEdgeList[i_edgeCounter].endVertex = GPtr->outVertexList[j-1];
-            tmpEdgeList[i_edgeCounter].edgeNum = j-1;
-
-            long t;
-            for (t = 0; t < GPtr->numVertices; t++) {
-                if (GPtr->outVertexIndex[t] > j-1) {
-                    break;
-                }
-            }
-            tmpEdgeList[i_edgeCounter].startVertex = t-1;
-
             i_edgeCounter++;
-
         }
     }
 
-    /*
-     * Merge partial edge lists
-     */
-
-    long* i_edgeStartCounter;
-    long* i_edgeEndCounter;
-
-    if (myId == 0) {
-        i_edgeStartCounter = (long*)malloc(numThread * sizeof(long));
-        assert(i_edgeStartCounter);
-        global_i_edgeStartCounter = i_edgeStartCounter;
-        i_edgeEndCounter = (long*)malloc(numThread * sizeof(long));
-        assert(i_edgeEndCounter);
-        global_i_edgeEndCounter = i_edgeEndCounter;
-
-        *maxIntWtListSize = 0;
-    }
-
-    thread_barrier_wait();
-
-    i_edgeStartCounter = global_i_edgeStartCounter;
-    i_edgeEndCounter = global_i_edgeEndCounter;
-
-    i_edgeEndCounter[myId] = i_edgeCounter;
-    i_edgeStartCounter[myId] = 0;
-
-    thread_barrier_wait();
-
-    if (myId == 0) {
-        for (i = 1; i < numThread; i++) {
-            i_edgeEndCounter[i] = i_edgeEndCounter[i-1] + i_edgeEndCounter[i];
-            i_edgeStartCounter[i] = i_edgeEndCounter[i-1];
-        }
-    }
-
-    *maxIntWtListSize += i_edgeCounter;
-
-    thread_barrier_wait();
+    long numEdge;
+    long i_edgeStart = parallel_scanThread(i_edgeCounter, &numEdge);
 
     edge* maxIntWtList;
 
     if (myId == 0) {
         free(*maxIntWtListPtr);
-        maxIntWtList = (edge*)malloc((*maxIntWtListSize) * sizeof(edge));
+        maxIntWtList = (edge*)malloc(numEdge * sizeof(edge));
         assert(maxIntWtList);
         global_maxIntWtList = maxIntWtList;
+        *maxIntWtListPtr = maxIntWtList;
+        *maxIntWtListSize = numEdge;
+        global_strEdgeIndex = (long*)malloc(GPtr->numStrEdges * sizeof(long));
+        assert(global_strEdgeIndex);
     }
 
     thread_barrier_wait();
 
     maxIntWtList = global_maxIntWtList;
 
-    for (i = i_edgeStartCounter[myId]; i<i_edgeEndCounter[myId]; i++) {
-      (maxIntWtList[i]).startVertex = tmpEdgeList[i-i_edgeStartCounter[myId]].startVertex;
-      (maxIntWtList[i]).endVertex = tmpEdgeList[i-i_edgeStartCounter[myId]].endVertex;
-      (maxIntWtList[i]).edgeNum = tmpEdgeList[i-i_edgeStartCounter[myId]].edgeNum;
+    for (i = i_start; i < i_stop; i++) {
+        if (GPtr->intWeight[i] == maxWeight) {
+            fillEdge(&maxIntWtList[i_edgeStart], GPtr, i);
+            i_edgeStart++;
+        }
     }
 
-    if (myId == 0) {
-        *maxIntWtListPtr = maxIntWtList;
+    /*
+     * String weights are stored as -(string index) in tuple order, so invert
+     * that mapping once instead of scanning all tuples per match
+     */
+
+    long* strEdgeIndex = global_strEdgeIndex;
+
+    for (i = i_start; i < i_stop; i++) {
+        if (GPtr->intWeight[i] <= 0) {
+            strEdgeIndex[-(GPtr->intWeight[i])] = i;
+        }
     }
 
-    i_edgeCounter = 0;
+    thread_barrier_wait();
 
     createPartition(0, GPtr->numStrEdges, myId, numThread, &i_start, &i_stop);
 
-    for (i = i_start; i < i_stop; i++) {
+    i_edgeCounter = 0;
 
+    for (i = i_start; i < i_stop; i++) {
         if (strncmp(GPtr->strWeight+i*MAX_STRLEN,
                     SOUGHT_STRING,
                     MAX_STRLEN) == 0)
         {
-            /*
-             * Find the corresponding endVertex
-             */
-
-            long t;
-            for (t = 0; t < GPtr->numEdges; t++) {
-                if (GPtr->intWeight[t] == -i) {
-                    break;
-                }
-            }
-
-            long j;
-            for (j = 0; j < GPtr->numDirectedEdges; j++) {
-            if (GPtr->paralEdgeIndex[j] > t) {
-                    break;
-                }
-            }
-            tmpEdgeList[i_edgeCounter].endVertex = GPtr->outVertexList[j-1];
-            tmpEdgeList[i_edgeCounter].edgeNum = j-1;
-
-            for (t = 0; t < GPtr->numVertices; t++) {
-                if (GPtr->outVertexIndex[t] > j-1) {
-                    break;
-                }
-            }
-            tmpEdgeList[i_edgeCounter].startVertex = t-1;
             i_edgeCounter++;
         }
-
-    }
-
-    thread_barrier_wait();
-
-    i_edgeEndCounter[myId] = i_edgeCounter;
-    i_edgeStartCounter[myId] = 0;
-
-    if (myId == 0) {
-        *soughtStrWtListSize = 0;
-    }
-
-    thread_barrier_wait();
-
-    if (myId == 0) {
-        for (i = 1; i < numThread; i++) {
-            i_edgeEndCounter[i] = i_edgeEndCounter[i-1] + i_edgeEndCounter[i];
-            i_edgeStartCounter[i] = i_edgeEndCounter[i-1];
-        }
     }
 
-    *soughtStrWtListSize += i_edgeCounter;
-
-    thread_barrier_wait();
+    i_edgeStart = parallel_scanThread(i_edgeCounter, &numEdge);
 
     edge* soughtStrWtList;
 
     if (myId == 0) {
         free(*soughtStrWtListPtr);
-        soughtStrWtList = (edge*)malloc((*soughtStrWtListSize) * sizeof(edge));
+        soughtStrWtList = (edge*)malloc(numEdge * sizeof(edge));
         assert(soughtStrWtList);
         global_soughtStrWtList = soughtStrWtList;
+        *soughtStrWtListPtr = soughtStrWtList;
+        *soughtStrWtListSize = numEdge;
     }
 
     thread_barrier_wait();
 
     soughtStrWtList = global_soughtStrWtList;
 
-    for (i = i_edgeStartCounter[myId]; i < i_edgeEndCounter[myId]; i++) {
-        (soughtStrWtList[i]).startVertex =
-            tmpEdgeList[i-i_edgeStartCounter[myId]].startVertex;
-        (soughtStrWtList[i]).endVertex =
-            tmpEdgeList[i-i_edgeStartCounter[myId]].endVertex;
-        (soughtStrWtList[i]).edgeNum =
-            tmpEdgeList[i-i_edgeStartCounter[myId]].edgeNum;
+    for (i = i_start; i < i_stop; i++) {
+        if (strncmp(GPtr->strWeight+i*MAX_STRLEN,
+                    SOUGHT_STRING,
+                    MAX_STRLEN) == 0)
+        {
+            fillEdge(&soughtStrWtList[i_edgeStart], GPtr, strEdgeIndex[i]);
+            i_edgeStart++;
+        }
     }
 
     thread_barrier_wait();
 
     if (myId == 0) {
-        *soughtStrWtListPtr = soughtStrWtList;
-        free(i_edgeStartCounter);
-        free(i_edgeEndCounter);
+        free(global_strEdgeIndex);
+        global_strEdgeIndex = NULL;
     }
-
-    free(tmpEdgeList);
 }
 
 
@@ -81,8 +81,10 @@ displayUsage (const char* appName)
 {
     printf("Usage: %s [options]\n", appName);
     puts("\nOptions:                                       (defaults)\n");
+    printf("    c <STR>    Kernel 1 graph [c]ache          (%s)\n", (GRAPH_FILE ? GRAPH_FILE : "none"));
+    printf("    g <STR>    [g]enerated data cache          (%s)\n", (SDG_FILE ? SDG_FILE : "none"));
     printf("    i <FLT>    Probability [i]nter-clique      (%f)\n",  PROB_INTERCL_EDGES);
-    printf("    k <UINT>   [k]ind: 0=array 1=list 2=vector (%li)\n", K3_DS);
+    printf("    k <UINT>   [k]ind: 0=arr 1=lst 2=vec 3=bfs (%li)\n", K3_DS);
     printf("    l <UINT>   Max path [l]ength               (%li)\n", SUBGR_EDGE_LENGTH);
     printf("    p <UINT>   Max [p]arallel edges            (%li)\n", MAX_PARAL_EDGES);
     printf("    s <UINT>   Problem [s]cale                 (%li)\n", SCALE);
@@ -105,14 +107,20 @@ parseArgs (long argc, char* const argv[])
 
     opterr = 0;
 
-    while ((opt = getopt(argc, argv, "i:k:l:p:s:t:u:w:")) != -1) {
+    while ((opt = getopt(argc, argv, "c:g:i:k:l:p:s:t:u:w:")) != -1) {
         switch (opt) {
+            case 'c':
+                GRAPH_FILE = optarg;
+                break;
+            case 'g':
+                SDG_FILE = optarg;
+                break;
             case 'i':
                 PROB_INTERCL_EDGES = atof(optarg);
                 break;
             case 'k':
                 K3_DS = atol(optarg);
-                assert(K3_DS >= 0 && K3_DS <= 2);
+                assert(K3_DS >= 0 && K3_DS <= 3);
                 break;
             case 'l':
                 SUBGR_EDGE_LENGTH = atol(optarg);
@@ -177,9 +185,14 @@ getUserParameters (long argc, char* const argv[])
      * Some implementation-specific vars, nothing to do with the specs
      */
 
-    K3_DS               = 2;               /* 0 - Array         */
+    K3_DS               = 3;               /* 0 - Array         */
                                            /* 1 - Linked List   */
                                            /* 2 - Dynamic Array */
+                                           /* 3 - BFS engine    */
+
+    SDG_FILE            = NULL;            /* Snapshot caches: loaded when    */
+    GRAPH_FILE          = NULL;            /* present and generated with the  */
+                                           /* same parameters, else written   */
 
     parseArgs(argc, argv); /* overrides default values set above */
 
@@ -81,6 +81,8 @@ long       SUBGR_EDGE_LENGTH;
 long       MAX_CLUSTER_SIZE;
 long       K3_DS;
 long       THREADS;
+char*      SDG_FILE;
+char*      GRAPH_FILE;
 
 
 /* =============================================================================
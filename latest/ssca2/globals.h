@@ -92,6 +92,9 @@ extern long       K3_DS;
 
 extern long       THREADS;
 
+extern char*      SDG_FILE;
+extern char*      GRAPH_FILE;
+
 
 #endif /* GLOBALS_H */
 
@@ -0,0 +1,580 @@
+/* =============================================================================
+ *
+ * graphFile.c
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * Unless otherwise noted, the following license applies to STAMP files:
+ * 
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ * 
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ * 
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "globals.h"
+#include "graphFile.h"
+
+/*
+ * Layout: one graphFile_header_t, then each section padded to
+ * GRAPHFILE_ALIGN. Files are written to "<name>.tmp" and renamed, so an
+ * interrupted save never leaves a snapshot that passes validation.
+ */
+
+#define GRAPHFILE_MAGIC       "SSCA2GF"
+#define GRAPHFILE_VERSION     1
+#define GRAPHFILE_BYTE_ORDER  0x0102030405060708UL
+#define GRAPHFILE_ALIGN       64
+#define GRAPHFILE_MAX_SECTION 16
+
+enum graphFile_kind {
+    GRAPHFILE_KIND_SDG   = 1,
+    GRAPHFILE_KIND_GRAPH = 2
+};
+
+enum graphFile_sdgSection {
+    SDG_START_VERTEX = 0,
+    SDG_END_VERTEX,
+    SDG_INT_WEIGHT,
+    SDG_STR_WEIGHT,
+    SDG_SOUGHT_STRING,
+    SDG_NUM_SECTION
+};
+
+enum graphFile_graphSection {
+    GRAPH_OUT_DEGREE = 0,
+    GRAPH_OUT_VERTEX_INDEX,
+    GRAPH_OUT_VERTEX_LIST,
+    GRAPH_PARAL_EDGE_INDEX,
+    GRAPH_IN_DEGREE,
+    GRAPH_IN_VERTEX_INDEX,
+    GRAPH_IN_VERTEX_LIST,
+    GRAPH_INT_WEIGHT,
+    GRAPH_STR_WEIGHT,
+    GRAPH_SOUGHT_STRING,
+    GRAPH_NUM_SECTION
+};
+
+typedef struct graphFile_header {
+    char       magic[8];
+    ULONGINT_T version;
+    ULONGINT_T kind;
+    ULONGINT_T byteOrder;
+    /* Generation parameters */
+    LONGINT_T  scale;
+    LONGINT_T  maxParalEdges;
+    double     percIntWeights;
+    double     probUnidirectional;
+    double     probInterclEdges;
+    /* Counts; an SDG leaves the vertex and directed edge counts at zero */
+    ULONGINT_T numVertices;
+    ULONGINT_T numEdges;
+    ULONGINT_T numDirectedEdges;
+    ULONGINT_T numUndirectedEdges;
+    ULONGINT_T numIntEdges;
+    ULONGINT_T numStrEdges;
+    ULONGINT_T numSection;
+    ULONGINT_T sectionOffset[GRAPHFILE_MAX_SECTION];
+    ULONGINT_T sectionSize[GRAPHFILE_MAX_SECTION];
+} graphFile_header_t;
+
+
+/* =============================================================================
+ * countStrEdges
+ * -- String-weighted edges carry their strWeight index as a non-positive value
+ * =============================================================================
+ */
+static ULONGINT_T
+countStrEdges (LONGINT_T* intWeight, ULONGINT_T numEdge)
+{
+    ULONGINT_T numStr = 0;
+    ULONGINT_T i;
+
+    for (i = 0; i < numEdge; i++) {
+        if (intWeight[i] <= 0) {
+            numStr++;
+        }
+    }
+
+    return numStr;
+}
+
+
+/* =============================================================================
+ * initHeader
+ * =============================================================================
+ */
+static void
+initHeader (graphFile_header_t* headerPtr, ULONGINT_T kind, ULONGINT_T numSection)
+{
+    assert(numSection <= GRAPHFILE_MAX_SECTION);
+
+    memset(headerPtr, 0, sizeof(graphFile_header_t));
+    memcpy(headerPtr->magic, GRAPHFILE_MAGIC, sizeof(headerPtr->magic));
+    headerPtr->version            = GRAPHFILE_VERSION;
+    headerPtr->kind               = kind;
+    headerPtr->byteOrder          = GRAPHFILE_BYTE_ORDER;
+    headerPtr->scale              = SCALE;
+    headerPtr->maxParalEdges      = MAX_PARAL_EDGES;
+    headerPtr->percIntWeights     = PERC_INT_WEIGHTS;
+    headerPtr->probUnidirectional = PROB_UNIDIRECTIONAL;
+    headerPtr->probInterclEdges   = PROB_INTERCL_EDGES;
+    headerPtr->numSection         = numSection;
+}
+
+
+/* =============================================================================
+ * writePad
+ * =============================================================================
+ */
+static bool
+writePad (FILE* file, ULONGINT_T* offsetPtr)
+{
+    static const char zero[GRAPHFILE_ALIGN] = {0};
+    ULONGINT_T pad = (GRAPHFILE_ALIGN - (*offsetPtr % GRAPHFILE_ALIGN)) % GRAPHFILE_ALIGN;
+
+    if (pad && fwrite(zero, 1, pad, file) != pad) {
+        return false;
+    }
+    *offsetPtr += pad;
+
+    return true;
+}
+
+
+/* =============================================================================
+ * writeFile
+ * -- headerPtr->sectionSize[] must be filled in; the offsets are assigned here
+ * =============================================================================
+ */
+static bool
+writeFile (const char* fileName, graphFile_header_t* headerPtr, void** data)
+{
+    long nameLength = strlen(fileName) + sizeof(".tmp");
+    char* tmpName = (char*)malloc(nameLength);
+    assert(tmpName);
+    snprintf(tmpName, nameLength, "%s.tmp", fileName);
+
+    bool status = false;
+    FILE* file = fopen(tmpName, "wb");
+
+    if (file) {
+        ULONGINT_T offset = sizeof(graphFile_header_t);
+        ULONGINT_T s;
+        status = (fwrite(headerPtr, sizeof(graphFile_header_t), 1, file) == 1);
+        for (s = 0; status && s < headerPtr->numSection; s++) {
+            ULONGINT_T size = headerPtr->sectionSize[s];
+            status = writePad(file, &offset);
+            headerPtr->sectionOffset[s] = offset;
+            if (status && size) {
+                status = (fwrite(data[s], 1, size, file) == size);
+            }
+            offset += size;
+        }
+        if (status) {
+            status = (fseek(file, 0, SEEK_SET) == 0 &&
+                      fwrite(headerPtr, sizeof(graphFile_header_t), 1, file) == 1);
+        }
+        status = (fclose(file) == 0) && status;
+        if (status) {
+            status = (rename(tmpName, fileName) == 0);
+        }
+        if (!status) {
+            remove(tmpName);
+        }
+    }
+
+    if (!status) {
+        fprintf(stderr, "graphFile: cannot write %s\n", fileName);
+    }
+
+    free(tmpName);
+
+    return status;
+}
+
+
+/* =============================================================================
+ * mapFile
+ * -- Returns the validated header at the start of a private mapping, or NULL
+ * =============================================================================
+ */
+static graphFile_header_t*
+mapFile (const char* fileName,
+         ULONGINT_T kind,
+         ULONGINT_T numSection,
+         ULONGINT_T* mapSizePtr)
+{
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 ||
+        (ULONGINT_T)fileStat.st_size < sizeof(graphFile_header_t))
+    {
+        fprintf(stderr, "graphFile: %s is not a snapshot\n", fileName);
+        close(fd);
+        return NULL;
+    }
+
+    ULONGINT_T mapSize = fileStat.st_size;
+
+    /*
+     * Private and writable: kernels see ordinary memory and any store is
+     * copy-on-write, never reaching the file.
+     */
+    void* mapPtr = mmap(NULL, mapSize, (PROT_READ | PROT_WRITE), MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapPtr == MAP_FAILED) {
+        fprintf(stderr, "graphFile: cannot map %s\n", fileName);
+        return NULL;
+    }
+
+    graphFile_header_t* headerPtr = (graphFile_header_t*)mapPtr;
+    const char* reason = NULL;
+
+    if (memcmp(headerPtr->magic, GRAPHFILE_MAGIC, sizeof(headerPtr->magic)) != 0 ||
+        headerPtr->byteOrder != GRAPHFILE_BYTE_ORDER)
+    {
+        reason = "not a snapshot";
+    } else if (headerPtr->version != GRAPHFILE_VERSION) {
+        reason = "unsupported version";
+    } else if (headerPtr->kind != kind || headerPtr->numSection != numSection) {
+        reason = "wrong snapshot kind";
+    } else if (headerPtr->scale != SCALE ||
+               headerPtr->maxParalEdges != MAX_PARAL_EDGES ||
+               (float)headerPtr->percIntWeights != PERC_INT_WEIGHTS ||
+               (float)headerPtr->probUnidirectional != PROB_UNIDIRECTIONAL ||
+               (float)headerPtr->probInterclEdges != PROB_INTERCL_EDGES)
+    {
+        reason = "generated with other parameters";
+    } else {
+        ULONGINT_T s;
+        for (s = 0; s < numSection; s++) {
+            ULONGINT_T offset = headerPtr->sectionOffset[s];
+            if ((offset % GRAPHFILE_ALIGN) != 0 ||
+                offset > mapSize ||
+                headerPtr->sectionSize[s] > (mapSize - offset))
+            {
+                reason = "truncated";
+                break;
+            }
+        }
+    }
+
+    if (reason) {
+        fprintf(stderr, "graphFile: %s: %s\n", fileName, reason);
+        munmap(mapPtr, mapSize);
+        return NULL;
+    }
+
+    *mapSizePtr = mapSize;
+
+    return headerPtr;
+}
+
+
+/* =============================================================================
+ * checkSections
+ * =============================================================================
+ */
+static bool
+checkSections (const char* fileName,
+               graphFile_header_t* headerPtr,
+               ULONGINT_T* expectSize)
+{
+    ULONGINT_T s;
+
+    for (s = 0; s < headerPtr->numSection; s++) {
+        if (headerPtr->sectionSize[s] != expectSize[s]) {
+            fprintf(stderr, "graphFile: %s: section %lu has the wrong size\n",
+                    fileName, s);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/* =============================================================================
+ * getSection
+ * =============================================================================
+ */
+static void*
+getSection (graphFile_header_t* headerPtr, ULONGINT_T s)
+{
+    return (void*)((char*)headerPtr + headerPtr->sectionOffset[s]);
+}
+
+
+/* =============================================================================
+ * setSoughtString
+ * -- Copied so that main can free SOUGHT_STRING as it does after generation
+ * =============================================================================
+ */
+static void
+setSoughtString (const char* str)
+{
+    SOUGHT_STRING = (char*)malloc(MAX_STRLEN * sizeof(char));
+    assert(SOUGHT_STRING);
+    memcpy(SOUGHT_STRING, str, MAX_STRLEN * sizeof(char));
+}
+
+
+/* =============================================================================
+ * graphFile_saveSDG
+ * =============================================================================
+ */
+bool
+graphFile_saveSDG (const char* fileName, graphSDG* SDGdataPtr)
+{
+    ULONGINT_T numEdge = SDGdataPtr->numEdgesPlaced;
+    ULONGINT_T numStr = countStrEdges(SDGdataPtr->intWeight, numEdge);
+
+    graphFile_header_t header;
+    initHeader(&header, GRAPHFILE_KIND_SDG, SDG_NUM_SECTION);
+    header.numEdges    = numEdge;
+    header.numStrEdges = numStr;
+    header.numIntEdges = numEdge - numStr;
+
+    void* data[SDG_NUM_SECTION];
+    data[SDG_START_VERTEX]  = SDGdataPtr->startVertex;
+    data[SDG_END_VERTEX]    = SDGdataPtr->endVertex;
+    data[SDG_INT_WEIGHT]    = SDGdataPtr->intWeight;
+    data[SDG_STR_WEIGHT]    = SDGdataPtr->strWeight;
+    data[SDG_SOUGHT_STRING] = SOUGHT_STRING;
+
+    header.sectionSize[SDG_START_VERTEX]  = numEdge * sizeof(ULONGINT_T);
+    header.sectionSize[SDG_END_VERTEX]    = numEdge * sizeof(ULONGINT_T);
+    header.sectionSize[SDG_INT_WEIGHT]    = numEdge * sizeof(LONGINT_T);
+    header.sectionSize[SDG_STR_WEIGHT]    = numStr * MAX_STRLEN * sizeof(char);
+    header.sectionSize[SDG_SOUGHT_STRING] = MAX_STRLEN * sizeof(char);
+
+    return writeFile(fileName, &header, data);
+}
+
+
+/* =============================================================================
+ * graphFile_loadSDG
+ * =============================================================================
+ */
+bool
+graphFile_loadSDG (const char* fileName, graphSDG* SDGdataPtr)
+{
+    ULONGINT_T mapSize;
+    graphFile_header_t* headerPtr =
+        mapFile(fileName, GRAPHFILE_KIND_SDG, SDG_NUM_SECTION, &mapSize);
+    if (headerPtr == NULL) {
+        return false;
+    }
+
+    ULONGINT_T numEdge = headerPtr->numEdges;
+    ULONGINT_T expectSize[SDG_NUM_SECTION];
+    expectSize[SDG_START_VERTEX]  = numEdge * sizeof(ULONGINT_T);
+    expectSize[SDG_END_VERTEX]    = numEdge * sizeof(ULONGINT_T);
+    expectSize[SDG_INT_WEIGHT]    = numEdge * sizeof(LONGINT_T);
+    expectSize[SDG_STR_WEIGHT]    = headerPtr->numStrEdges * MAX_STRLEN * sizeof(char);
+    expectSize[SDG_SOUGHT_STRING] = MAX_STRLEN * sizeof(char);
+
+    if (!checkSections(fileName, headerPtr, expectSize)) {
+        munmap(headerPtr, mapSize);
+        return false;
+    }
+
+    SDGdataPtr->startVertex    = (ULONGINT_T*)getSection(headerPtr, SDG_START_VERTEX);
+    SDGdataPtr->endVertex      = (ULONGINT_T*)getSection(headerPtr, SDG_END_VERTEX);
+    SDGdataPtr->intWeight      = (LONGINT_T*)getSection(headerPtr, SDG_INT_WEIGHT);
+    SDGdataPtr->strWeight      = (char*)getSection(headerPtr, SDG_STR_WEIGHT);
+    SDGdataPtr->numEdgesPlaced = numEdge;
+    SDGdataPtr->mapPtr         = headerPtr;
+    SDGdataPtr->mapSize        = mapSize;
+
+    setSoughtString((char*)getSection(headerPtr, SDG_SOUGHT_STRING));
+
+    return true;
+}
+
+
+/* =============================================================================
+ * graphFile_saveGraph
+ * =============================================================================
+ */
+bool
+graphFile_saveGraph (const char* fileName, graph* GPtr)
+{
+    ULONGINT_T numVertex = GPtr->numVertices;
+    ULONGINT_T numStr = countStrEdges(GPtr->intWeight, GPtr->numEdges);
+
+    graphFile_header_t header;
+    initHeader(&header, GRAPHFILE_KIND_GRAPH, GRAPH_NUM_SECTION);
+    header.numVertices        = numVertex;
+    header.numEdges           = GPtr->numEdges;
+    header.numDirectedEdges   = GPtr->numDirectedEdges;
+    header.numUndirectedEdges = GPtr->numUndirectedEdges;
+    header.numIntEdges        = GPtr->numIntEdges;
+    header.numStrEdges        = GPtr->numStrEdges;
+
+    void* data[GRAPH_NUM_SECTION];
+    data[GRAPH_OUT_DEGREE]       = GPtr->outDegree;
+    data[GRAPH_OUT_VERTEX_INDEX] = GPtr->outVertexIndex;
+    data[GRAPH_OUT_VERTEX_LIST]  = GPtr->outVertexList;
+    data[GRAPH_PARAL_EDGE_INDEX] = GPtr->paralEdgeIndex;
+    data[GRAPH_IN_DEGREE]        = GPtr->inDegree;
+    data[GRAPH_IN_VERTEX_INDEX]  = GPtr->inVertexIndex;
+    data[GRAPH_IN_VERTEX_LIST]   = GPtr->inVertexList;
+    data[GRAPH_INT_WEIGHT]       = GPtr->intWeight;
+    data[GRAPH_STR_WEIGHT]       = GPtr->strWeight;
+    data[GRAPH_SOUGHT_STRING]    = SOUGHT_STRING;
+
+    header.sectionSize[GRAPH_OUT_DEGREE]       = numVertex * sizeof(LONGINT_T);
+    header.sectionSize[GRAPH_OUT_VERTEX_INDEX] = numVertex * sizeof(ULONGINT_T);
+    header.sectionSize[GRAPH_OUT_VERTEX_LIST]  = GPtr->numDirectedEdges * sizeof(ULONGINT_T);
+    header.sectionSize[GRAPH_PARAL_EDGE_INDEX] = GPtr->numDirectedEdges * sizeof(ULONGINT_T);
+    header.sectionSize[GRAPH_IN_DEGREE]        = numVertex * sizeof(LONGINT_T);
+    header.sectionSize[GRAPH_IN_VERTEX_INDEX]  = numVertex * sizeof(ULONGINT_T);
+    header.sectionSize[GRAPH_IN_VERTEX_LIST]   = GPtr->numUndirectedEdges * sizeof(ULONGINT_T);
+    header.sectionSize[GRAPH_INT_WEIGHT]       = GPtr->numEdges * sizeof(LONGINT_T);
+    header.sectionSize[GRAPH_STR_WEIGHT]       = numStr * MAX_STRLEN * sizeof(char);
+    header.sectionSize[GRAPH_SOUGHT_STRING]    = MAX_STRLEN * sizeof(char);
+
+    return writeFile(fileName, &header, data);
+}
+
+
+/* =============================================================================
+ * graphFile_loadGraph
+ * =============================================================================
+ */
+bool
+graphFile_loadGraph (const char* fileName, graph* GPtr)
+{
+    ULONGINT_T mapSize;
+    graphFile_header_t* headerPtr =
+        mapFile(fileName, GRAPHFILE_KIND_GRAPH, GRAPH_NUM_SECTION, &mapSize);
+    if (headerPtr == NULL) {
+        return false;
+    }
+
+    ULONGINT_T numVertex = headerPtr->numVertices;
+    ULONGINT_T numStr = (headerPtr->sectionSize[GRAPH_STR_WEIGHT] / MAX_STRLEN);
+    ULONGINT_T expectSize[GRAPH_NUM_SECTION];
+    expectSize[GRAPH_OUT_DEGREE]       = numVertex * sizeof(LONGINT_T);
+    expectSize[GRAPH_OUT_VERTEX_INDEX] = numVertex * sizeof(ULONGINT_T);
+    expectSize[GRAPH_OUT_VERTEX_LIST]  = headerPtr->numDirectedEdges * sizeof(ULONGINT_T);
+    expectSize[GRAPH_PARAL_EDGE_INDEX] = headerPtr->numDirectedEdges * sizeof(ULONGINT_T);
+    expectSize[GRAPH_IN_DEGREE]        = numVertex * sizeof(LONGINT_T);
+    expectSize[GRAPH_IN_VERTEX_INDEX]  = numVertex * sizeof(ULONGINT_T);
+    expectSize[GRAPH_IN_VERTEX_LIST]   = headerPtr->numUndirectedEdges * sizeof(ULONGINT_T);
+    expectSize[GRAPH_INT_WEIGHT]       = headerPtr->numEdges * sizeof(LONGINT_T);
+    expectSize[GRAPH_STR_WEIGHT]       = numStr * MAX_STRLEN * sizeof(char);
+    expectSize[GRAPH_SOUGHT_STRING]    = MAX_STRLEN * sizeof(char);
+
+    if (!checkSections(fileName, headerPtr, expectSize)) {
+        munmap(headerPtr, mapSize);
+        return false;
+    }
+
+    GPtr->numVertices        = numVertex;
+    GPtr->numEdges           = headerPtr->numEdges;
+    GPtr->numDirectedEdges   = headerPtr->numDirectedEdges;
+    GPtr->numUndirectedEdges = headerPtr->numUndirectedEdges;
+    GPtr->numIntEdges        = headerPtr->numIntEdges;
+    GPtr->numStrEdges        = headerPtr->numStrEdges;
+    GPtr->outDegree          = (LONGINT_T*)getSection(headerPtr, GRAPH_OUT_DEGREE);
+    GPtr->outVertexIndex     = (ULONGINT_T*)getSection(headerPtr, GRAPH_OUT_VERTEX_INDEX);
+    GPtr->outVertexList      = (ULONGINT_T*)getSection(headerPtr, GRAPH_OUT_VERTEX_LIST);
+    GPtr->paralEdgeIndex     = (ULONGINT_T*)getSection(headerPtr, GRAPH_PARAL_EDGE_INDEX);
+    GPtr->inDegree           = (LONGINT_T*)getSection(headerPtr, GRAPH_IN_DEGREE);
+    GPtr->inVertexIndex      = (ULONGINT_T*)getSection(headerPtr, GRAPH_IN_VERTEX_INDEX);
+    GPtr->inVertexList       = (ULONGINT_T*)getSection(headerPtr, GRAPH_IN_VERTEX_LIST);
+    GPtr->intWeight          = (LONGINT_T*)getSection(headerPtr, GRAPH_INT_WEIGHT);
+    GPtr->strWeight          = (char*)getSection(headerPtr, GRAPH_STR_WEIGHT);
+    GPtr->mapPtr             = headerPtr;
+    GPtr->mapSize            = mapSize;
+
+    setSoughtString((char*)getSection(headerPtr, GRAPH_SOUGHT_STRING));
+
+    return true;
+}
+
+
+/* =============================================================================
+ * graphFile_unmap
+ * =============================================================================
+ */
+void
+graphFile_unmap (void* mapPtr, ULONGINT_T mapSize)
+{
+    munmap(mapPtr, mapSize);
+}
+
+
+/* =============================================================================
+ *
+ * End of graphFile.c
+ *
+ * =============================================================================
+ */
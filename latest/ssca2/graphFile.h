@@ -0,0 +1,134 @@
+/* =============================================================================
+ *
+ * graphFile.h
+ *
+ * =============================================================================
+ *
+ * For the license of bayes/sort.h and bayes/sort.c, please see the header
+ * of the files.
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of kmeans, please see kmeans/LICENSE.kmeans
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of ssca2, please see ssca2/COPYRIGHT
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of lib/mt19937ar.c and lib/mt19937ar.h, please see the
+ * header of the files.
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * For the license of lib/rbtree.h and lib/rbtree.c, please see
+ * lib/LEGALNOTICE.rbtree and lib/LICENSE.rbtree
+ * 
+ * ------------------------------------------------------------------------
+ * 
+ * Unless otherwise noted, the following license applies to STAMP files:
+ * 
+ * Copyright (c) 2007, Stanford University
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ * 
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ * 
+ *     * Neither the name of Stanford University nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY STANFORD UNIVERSITY ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL STANFORD UNIVERSITY BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * =============================================================================
+ */
+
+
+#ifndef GRAPHFILE_H
+#define GRAPHFILE_H 1
+
+
+#include "defs.h"
+
+
+/*
+ * Binary snapshots of the generated data (graphSDG) and of the kernel 1
+ * graph. Arrays are stored cache-line aligned in the native layout, so a
+ * loaded snapshot is used in place from a private mapping; the struct's
+ * mapPtr/mapSize then own the storage instead of the individual arrays.
+ * A snapshot only loads if it was written with the same generation
+ * parameters (scale, parallel edges, probabilities, int weight fraction).
+ */
+
+
+/* =============================================================================
+ * graphFile_saveSDG
+ * -- Returns false on I/O failure; SOUGHT_STRING must already be set
+ * =============================================================================
+ */
+bool
+graphFile_saveSDG (const char* fileName, graphSDG* SDGdataPtr);
+
+
+/* =============================================================================
+ * graphFile_loadSDG
+ * -- Returns false if the file is missing, malformed or from other parameters
+ * =============================================================================
+ */
+bool
+graphFile_loadSDG (const char* fileName, graphSDG* SDGdataPtr);
+
+
+/* =============================================================================
+ * graphFile_saveGraph
+ * =============================================================================
+ */
+bool
+graphFile_saveGraph (const char* fileName, graph* GPtr);
+
+
+/* =============================================================================
+ * graphFile_loadGraph
+ * =============================================================================
+ */
+bool
+graphFile_loadGraph (const char* fileName, graph* GPtr);
+
+
+/* =============================================================================
+ * graphFile_unmap
+ * =============================================================================
+ */
+void
+graphFile_unmap (void* mapPtr, ULONGINT_T mapSize);
+
+
+#endif /* GRAPHFILE_H */
+
+
+/* =============================================================================
+ *
+ * End of graphFile.h
+ *
+ * =============================================================================
+ */
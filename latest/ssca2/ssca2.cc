@@ -67,6 +67,7 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include "alg_radix_smp.h"
 #include "computeGraph.h"
 #include "cutClusters.h"
 #include "defs.h"
@@ -75,6 +76,7 @@
 #include "getStartLists.h"
 #include "getUserParameters.h"
 #include "globals.h"
+#include "graphFile.h"
 #include "timer.h"
 #include "thread.h"
 
@@ -118,6 +120,8 @@ int main (int argc, char** argv)
     Vl** strWtVLList = NULL;
     Vd*  intWtVDList = NULL;
     Vd*  strWtVDList = NULL;
+    Vc*  intWtVCList = NULL;
+    Vc*  strWtVCList = NULL;
 
 #endif /* ENABLE_KERNEL3 */
 
@@ -150,79 +154,127 @@ int main (int argc, char** argv)
     printf("Kernel 3 data structure:    %ld\n", K3_DS);
     puts("");
 
+    SDGdata = (graphSDG*)malloc(sizeof(graphSDG));
+    assert(SDGdata);
+    SDGdata->mapPtr = NULL;
+
+    G = (graph*)malloc(sizeof(graph));
+    assert(G);
+    G->mapPtr = NULL;
+
+    TIMER_T start;
+    TIMER_T stop;
+    double time;
+
+#ifdef ENABLE_KERNEL1
+
     /*
-     * Scalable Data Generator
+     * A kernel 1 snapshot replaces both data generation and kernel 1
      */
 
-    printf("\nScalable Data Generator - genScalData() beginning execution...\n");
+    if (GRAPH_FILE) {
+        TIMER_READ(start);
+        if (graphFile_loadGraph(GRAPH_FILE, G)) {
+            TIMER_READ(stop);
+            time = TIMER_DIFF_SECONDS(start, stop);
+            totalTime += time;
+            printf("\nLoaded graph from %s\n", GRAPH_FILE);
+            printf("\nTime taken for loading the graph is %9.6f sec.\n\n", time);
+        }
+    }
 
-    SDGdata = (graphSDG*)malloc(sizeof(graphSDG));
-    assert(SDGdata);
+#endif /* ENABLE_KERNEL1 */
 
-    TIMER_T start;
-    TIMER_READ(start);
+    if (G->mapPtr == NULL) {
+
+        /*
+         * Scalable Data Generator
+         */
+
+        if (SDG_FILE) {
+            TIMER_READ(start);
+            if (graphFile_loadSDG(SDG_FILE, SDGdata)) {
+                TIMER_READ(stop);
+                time = TIMER_DIFF_SECONDS(start, stop);
+                totalTime += time;
+                printf("\nLoaded generated data from %s\n", SDG_FILE);
+                printf("\nTime taken for loading the data is %9.6f sec.\n\n", time);
+            }
+        }
+
+        if (SDGdata->mapPtr == NULL) {
+
+            printf("\nScalable Data Generator - genScalData() beginning execution...\n");
+
+            TIMER_READ(start);
 
 #ifdef USE_PARALLEL_DATA_GENERATION
 #ifdef OTM
 #pragma omp parallel
-    {
-        genScalData((void*)SDGdata);
-    }
+            {
+                genScalData((void*)SDGdata);
+            }
 #else
-    thread_start(genScalData, (void*)SDGdata);
+            thread_start(genScalData, (void*)SDGdata);
 #endif
 #else /* !USE_PARALLEL_DATA_GENERATION */
-    genScalData_seq(SDGdata);
+            genScalData_seq(SDGdata);
 #endif /* !USE_PARALLEL_DATA_GENERATION */
 
-    TIMER_T stop;
-    TIMER_READ(stop);
+            TIMER_READ(stop);
 
-    double time = TIMER_DIFF_SECONDS(start, stop);
-    totalTime += time;
+            time = TIMER_DIFF_SECONDS(start, stop);
+            totalTime += time;
 
-    printf("\nTime taken for Scalable Data Generation is %9.6f sec.\n\n", time);
-    printf("\n\tgenScalData() completed execution.\n");
+            printf("\nTime taken for Scalable Data Generation is %9.6f sec.\n\n", time);
+            printf("\n\tgenScalData() completed execution.\n");
 
+            if (SDG_FILE && graphFile_saveSDG(SDG_FILE, SDGdata)) {
+                printf("\nSaved generated data to %s\n", SDG_FILE);
+            }
+        }
 
 #ifdef ENABLE_KERNEL1
 
-    /* -------------------------------------------------------------------------
-     * Kernel 1 - Graph Construction
-     *
-     * From the input edges, construct the graph 'G'
-     * -------------------------------------------------------------------------
-     */
-
-    printf("\nKernel 1 - computeGraph() beginning execution...\n");
+        /* ---------------------------------------------------------------------
+         * Kernel 1 - Graph Construction
+         *
+         * From the input edges, construct the graph 'G'
+         * ---------------------------------------------------------------------
+         */
 
-    G = (graph*)malloc(sizeof(graph));
-    assert(G);
+        printf("\nKernel 1 - computeGraph() beginning execution...\n");
 
-    computeGraph_arg_t computeGraphArgs;
-    computeGraphArgs.GPtr       = G;
-    computeGraphArgs.SDGdataPtr = SDGdata;
+        computeGraph_arg_t computeGraphArgs;
+        computeGraphArgs.GPtr       = G;
+        computeGraphArgs.SDGdataPtr = SDGdata;
 
-    TIMER_READ(start);
+        TIMER_READ(start);
 
 #ifdef OTM
 #pragma omp parallel
-    {
-        computeGraph((void*)&computeGraphArgs);
-    }
+        {
+            computeGraph((void*)&computeGraphArgs);
+        }
 #else
-    thread_start(computeGraph, (void*)&computeGraphArgs);
+        thread_start(computeGraph, (void*)&computeGraphArgs);
 #endif
-    TIMER_READ(stop);
+        TIMER_READ(stop);
 
-    time = TIMER_DIFF_SECONDS(start, stop);
-    totalTime += time;
+        time = TIMER_DIFF_SECONDS(start, stop);
+        totalTime += time;
 
-    printf("\n\tcomputeGraph() completed execution.\n");
-    printf("\nTime taken for kernel 1 is %9.6f sec.\n", time);
+        printf("\n\tcomputeGraph() completed execution.\n");
+        printf("\nTime taken for kernel 1 is %9.6f sec.\n", time);
+
+        if (GRAPH_FILE && graphFile_saveGraph(GRAPH_FILE, G)) {
+            printf("\nSaved graph to %s\n", GRAPH_FILE);
+        }
 
 #endif /* ENABLE_KERNEL1 */
 
+    }
+
 #ifdef ENABLE_KERNEL2
 
     /* -------------------------------------------------------------------------
@@ -419,6 +471,35 @@ int main (int argc, char** argv)
         }
        */
 
+    } else if (K3_DS == 3) {
+
+        intWtVCList = (Vc*)malloc(maxIntWtListSize * sizeof(Vc));
+        assert(intWtVCList);
+        strWtVCList = (Vc*)malloc(soughtStrWtListSize * sizeof(Vc));
+        assert(strWtVCList);
+
+        findSubGraphs3_arg_t findSubGraphs3Arg;
+        findSubGraphs3Arg.GPtr                = G;
+        findSubGraphs3Arg.intWtVCList         = intWtVCList;
+        findSubGraphs3Arg.strWtVCList         = strWtVCList;
+        findSubGraphs3Arg.maxIntWtList        = maxIntWtList;
+        findSubGraphs3Arg.maxIntWtListSize    = maxIntWtListSize;
+        findSubGraphs3Arg.soughtStrWtList     = soughtStrWtList;
+        findSubGraphs3Arg.soughtStrWtListSize = soughtStrWtListSize;
+
+        TIMER_READ(start);
+
+#ifdef OTM
+#pragma omp parallel
+        {
+            findSubGraphs3((void*)&findSubGraphs3Arg);
+        }
+#else
+        thread_start(findSubGraphs3, (void*)&findSubGraphs3Arg);
+#endif
+
+        TIMER_READ(stop);
+
     } else {
 
         assert(0);
@@ -470,15 +551,25 @@ int main (int argc, char** argv)
      * -------------------------------------------------------------------------
      */
 
-    free(G->outDegree);
-    free(G->outVertexIndex);
-    free(G->outVertexList);
-    free(G->paralEdgeIndex);
-    free(G->inDegree);
-    free(G->inVertexIndex);
-    free(G->inVertexList);
-    free(G->intWeight);
-    free(G->strWeight);
+    if (G->mapPtr) {
+        graphFile_unmap(G->mapPtr, G->mapSize);
+    } else {
+        free(G->outDegree);
+        free(G->outVertexIndex);
+        free(G->outVertexList);
+        free(G->paralEdgeIndex);
+        free(G->inDegree);
+        free(G->inVertexIndex);
+        free(G->inVertexList);
+        if (SDGdata->mapPtr == NULL) {
+            free(G->intWeight);
+            free(G->strWeight);
+        }
+    }
+
+    if (SDGdata->mapPtr) {
+        graphFile_unmap(SDGdata->mapPtr, SDGdata->mapSize);
+    }
 
 #ifdef ENABLE_KERNEL3
 
@@ -532,6 +623,17 @@ int main (int argc, char** argv)
         free(intWtVDList);
     }
 
+    if (K3_DS == 3) {
+        for (i = 0; i < maxIntWtListSize; i++) {
+            free(intWtVCList[i].vList);
+        }
+        for (i = 0; i < soughtStrWtListSize; i++) {
+            free(strWtVCList[i].vList);
+        }
+        free(strWtVCList);
+        free(intWtVCList);
+    }
+
     free(soughtStrWtList);
     free(maxIntWtList);
 
@@ -541,6 +643,8 @@ int main (int argc, char** argv)
     free(G);
     free(SDGdata);
 
+    all_radixsort_release();
+
     thread_shutdown();
 
     return 0;
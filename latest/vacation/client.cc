@@ -3,12 +3,29 @@
  */
 
 #include <assert.h>
+#include <math.h>
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
 #include "action.h"
+#include "alias.h"
 #include "client.h"
+#include "histogram.h"
 #include "manager.h"
 #include "reservation.h"
 #include "thread.h"
 #include "tm_transition.h"
+#include "tmretry.h"
+
+static tmretry_site_t global_reservationRetrySite =
+    TMRETRY_SITE_INIT("client:makeReservation");
+static tmretry_site_t global_deleteRetrySite =
+    TMRETRY_SITE_INIT("client:deleteCustomer");
+static tmretry_site_t global_updateRetrySite =
+    TMRETRY_SITE_INIT("client:updateTables");
+
+/* Closer than this to an arrival, yield instead of sleeping */
+#define CLIENT_SLEEP_SLACK_NS (100000L)
 
 /* =============================================================================
  * client_alloc
@@ -20,7 +37,11 @@ client_t::client_t(long _id,
                    long _numOperation,
                    long _numQueryPerTransaction,
                    long _queryRange,
-                   long _percentUser)
+                   long _percentUser,
+                   double _arrivalRate,
+                   bool _isFixedInterval,
+                   distribution_t _distribution,
+                   alias_t* _keyAliasPtr)
 {
     id = _id;
     managerPtr = _managerPtr;
@@ -29,6 +50,148 @@ client_t::client_t(long _id,
     numQueryPerTransaction = _numQueryPerTransaction;
     queryRange = _queryRange;
     percentUser = _percentUser;
+    arrivalRate = _arrivalRate;
+    isFixedInterval = _isFixedInterval;
+    distribution = _distribution;
+    keyAliasPtr = _keyAliasPtr;
+    assert((distribution == DISTRIBUTION_UNIFORM) || (keyAliasPtr != NULL));
+    for (long a = 0; a < NUM_ACTION; a++) {
+        latencies[a] = histogram_alloc();
+        assert(latencies[a] != NULL);
+    }
+}
+
+/* =============================================================================
+ * client_free
+ * =============================================================================
+ */
+client_t::~client_t()
+{
+    for (long a = 0; a < NUM_ACTION; a++) {
+        histogram_free(latencies[a]);
+    }
+}
+
+/* =============================================================================
+ * client_allocKeyAlias
+ * -- Returns NULL for DISTRIBUTION_UNIFORM, which needs no table
+ * =============================================================================
+ */
+alias_t*
+client_allocKeyAlias (distribution_t distribution,
+                      long queryRange,
+                      double theta,
+                      long percentHotTraffic,
+                      long percentHotKey)
+{
+    alias_t* aliasPtr;
+    double* weights;
+    long numHotKey;
+    long k;
+
+    if (distribution == DISTRIBUTION_UNIFORM) {
+        return NULL;
+    }
+
+    weights = (double*)malloc(queryRange * sizeof(double));
+    assert(weights != NULL);
+
+    switch (distribution) {
+        case DISTRIBUTION_ZIPF:
+            for (k = 0; k < queryRange; k++) {
+                weights[k] = pow((double)(k + 1), -theta);
+            }
+            break;
+        case DISTRIBUTION_HOTSPOT:
+        case DISTRIBUTION_MOVING_HOTSPOT:
+            numHotKey = (long)((double)percentHotKey / 100.0 *
+                               (double)queryRange + 0.5);
+            numHotKey = ((numHotKey < 1) ? 1 : numHotKey);
+            numHotKey = ((numHotKey > queryRange) ? queryRange : numHotKey);
+            for (k = 0; k < queryRange; k++) {
+                if (numHotKey == queryRange) {
+                    weights[k] = 1.0; /* every id is hot: uniform */
+                } else if (k < numHotKey) {
+                    weights[k] = (double)percentHotTraffic / (double)numHotKey;
+                } else {
+                    weights[k] = (double)(100 - percentHotTraffic) /
+                                 (double)(queryRange - numHotKey);
+                }
+            }
+            break;
+        default:
+            assert(0);
+    }
+
+    aliasPtr = alias_alloc(weights, queryRange);
+    assert(aliasPtr != NULL);
+    free(weights);
+
+    return aliasPtr;
+}
+
+/* =============================================================================
+ * selectId
+ * -- Returns an id in [1, queryRange] for the i-th operation
+ * =============================================================================
+ */
+static inline long
+selectId (client_t* clientPtr, long i)
+{
+    std::mt19937& randomPtr = clientPtr->randomPtr;
+    long queryRange = clientPtr->queryRange;
+
+    if (clientPtr->keyAliasPtr == NULL) {
+        return (randomPtr() % queryRange) + 1;
+    }
+
+    unsigned long r = randomPtr();
+    unsigned long coin = randomPtr();
+    long key = alias_sample(clientPtr->keyAliasPtr, r, coin);
+    if (clientPtr->distribution == DISTRIBUTION_MOVING_HOTSPOT) {
+        long shift = (long)((double)i * (double)queryRange /
+                            (double)clientPtr->numOperation);
+        key = (key + shift) % queryRange;
+    }
+
+    return key + 1;
+}
+
+/* =============================================================================
+ * getTime
+ * -- Monotonic, in ns
+ * =============================================================================
+ */
+static inline unsigned long
+getTime ()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((unsigned long)ts.tv_sec * 1000000000UL) + (unsigned long)ts.tv_nsec;
+}
+
+/* =============================================================================
+ * waitUntil
+ * =============================================================================
+ */
+static void
+waitUntil (unsigned long time)
+{
+    while (1) {
+        unsigned long now = getTime();
+        if (now >= time) {
+            return;
+        }
+        long remaining = (long)(time - now);
+        if (remaining > CLIENT_SLEEP_SLACK_NS) {
+            struct timespec ts;
+            ts.tv_sec = (remaining - CLIENT_SLEEP_SLACK_NS) / 1000000000L;
+            ts.tv_nsec = (remaining - CLIENT_SLEEP_SLACK_NS) % 1000000000L;
+            nanosleep(&ts, NULL);
+        } else {
+            sched_yield();
+        }
+    }
 }
 
 /* =============================================================================
@@ -53,182 +216,273 @@ selectAction (long r, long percentUser)
 
 
 /* =============================================================================
- * client_run
- * -- Execute list operations on the database
+ * runOperation
+ * -- Picks and runs the i-th operation of the client; returns its action
+ * -- Kept out of line so client_run's timing state is not live across the
+ *    transaction begin
  * =============================================================================
  */
-void
-client_run (void* argPtr)
+__attribute__((noinline))
+static action_t
+runOperation (client_t* clientPtr, long i,
+              long* types, long* ids, long* ops, long* prices)
 {
-    long myId = thread_getId();
-    client_t* clientPtr = ((client_t**)argPtr)[myId];
-
     manager_t* managerPtr = clientPtr->managerPtr;
     std::mt19937&  randomPtr  = clientPtr->randomPtr;
 
-    long numOperation           = clientPtr->numOperation;
     long numQueryPerTransaction = clientPtr->numQueryPerTransaction;
-    long queryRange             = clientPtr->queryRange;
     long percentUser            = clientPtr->percentUser;
 
-    long types[numQueryPerTransaction];
-    long ids[numQueryPerTransaction];
-    long ops[numQueryPerTransaction];
-    long prices[numQueryPerTransaction];
-
-    for (long i = 0; i < numOperation; i++) {
-        long r = randomPtr() % 100;
-        action_t action = selectAction(r, percentUser);
+    long r = randomPtr() % 100;
+    action_t action = selectAction(r, percentUser);
 
-        switch (action) {
-            case ACTION_MAKE_RESERVATION: {
+    switch (action) {
+        case ACTION_MAKE_RESERVATION: {
+            long n;
+            long numQuery = randomPtr() % numQueryPerTransaction + 1;
+            long customerId = selectId(clientPtr, i);
+            for (n = 0; n < numQuery; n++) {
+                types[n] = randomPtr() % NUM_RESERVATION_TYPE;
+                ids[n] = selectId(clientPtr, i);
+            }
+            tmretry_t retry;
+            tmretry_start(&retry, &global_reservationRetrySite);
+            while (1) {
+              __transaction_atomic {
+                tmretry_enter(&retry);
                 long maxPrices[NUM_RESERVATION_TYPE] = { -1, -1, -1 };
                 long maxIds[NUM_RESERVATION_TYPE] = { -1, -1, -1 };
-                long n;
-                long numQuery = randomPtr() % numQueryPerTransaction + 1;
-                long customerId = randomPtr() % queryRange + 1;
-                for (n = 0; n < numQuery; n++) {
-                    types[n] = randomPtr() % NUM_RESERVATION_TYPE;
-                    ids[n] = (randomPtr() % queryRange) + 1;
-                }
                 bool isFound = false;
                 bool done = true;
-                //[wer210] I modified here to remove _ITM_abortTransaction().
-                while (1) {
-                  __transaction_atomic {
-                    for (n = 0; n < numQuery; n++) {
-                      long t = types[n];
-                      long id = ids[n];
-                      long price = -1;
-                      switch (t) {
-                       case RESERVATION_CAR:
-                        if (manager_queryCar(managerPtr, id) >= 0) {
-                          price = manager_queryCarPrice(managerPtr, id);
-                        }
-                        break;
-                       case RESERVATION_FLIGHT:
-                        if (manager_queryFlight(managerPtr, id) >= 0) {
-                          price = manager_queryFlightPrice(managerPtr, id);
-                        }
-                        break;
-                       case RESERVATION_ROOM:
-                        if (manager_queryRoom(managerPtr, id) >= 0) {
-                          price = manager_queryRoomPrice(managerPtr, id);
-                        }
-                        break;
-                       default:
-                        assert(0);
-                      }
-                      //[wer210] read-only above
-                      if (price > maxPrices[t]) {
-                        maxPrices[t] = price;
-                        maxIds[t] = id;
-                        isFound = true;
-                      }
-                    } /* for n */
-
-                    if (isFound) {
-                      done = done && manager_addCustomer(managerPtr, customerId);
-                    }
-
-                    if (maxIds[RESERVATION_CAR] > 0) {
-                      done = done && manager_reserveCar(managerPtr,
-                                                  customerId, maxIds[RESERVATION_CAR]);
+                for (n = 0; n < numQuery; n++) {
+                  long t = types[n];
+                  long id = ids[n];
+                  long price = -1;
+                  switch (t) {
+                   case RESERVATION_CAR:
+                    if (manager_queryCar(managerPtr, id) >= 0) {
+                      price = manager_queryCarPrice(managerPtr, id);
                     }
-
-                    if (maxIds[RESERVATION_FLIGHT] > 0) {
-                      done = done && manager_reserveFlight(managerPtr,
-                                                     customerId, maxIds[RESERVATION_FLIGHT]);
+                    break;
+                   case RESERVATION_FLIGHT:
+                    if (manager_queryFlight(managerPtr, id) >= 0) {
+                      price = manager_queryFlightPrice(managerPtr, id);
                     }
-                    if (maxIds[RESERVATION_ROOM] > 0) {
-                      done = done && manager_reserveRoom(managerPtr,
-                                                   customerId, maxIds[RESERVATION_ROOM]);
+                    break;
+                   case RESERVATION_ROOM:
+                    if (manager_queryRoom(managerPtr, id) >= 0) {
+                      price = manager_queryRoomPrice(managerPtr, id);
                     }
-                    if (done) break;
-                    else __transaction_cancel;
-                  } // TM_END
-            }
-                break;
+                    break;
+                   default:
+                    assert(0);
+                  }
+                  //[wer210] read-only above
+                  if (price > maxPrices[t]) {
+                    maxPrices[t] = price;
+                    maxIds[t] = id;
+                    isFound = true;
+                  }
+                } /* for n */
+
+                if (isFound) {
+                  done = done && manager_addCustomer(managerPtr, customerId);
+                }
+
+                if (maxIds[RESERVATION_CAR] > 0) {
+                  done = done && manager_reserveCar(managerPtr,
+                                              customerId, maxIds[RESERVATION_CAR]);
+                }
 
+                if (maxIds[RESERVATION_FLIGHT] > 0) {
+                  done = done && manager_reserveFlight(managerPtr,
+                                                 customerId, maxIds[RESERVATION_FLIGHT]);
+                }
+                if (maxIds[RESERVATION_ROOM] > 0) {
+                  done = done && manager_reserveRoom(managerPtr,
+                                               customerId, maxIds[RESERVATION_ROOM]);
+                }
+                if (done) break;
+                else __transaction_cancel;
+              } // TM_END
+              tmretry_backoff(&retry);
             }
+            tmretry_finish(&retry);
+            break;
+        }
 
-            case ACTION_DELETE_CUSTOMER: {
-                long customerId = randomPtr() % queryRange + 1;
+        case ACTION_DELETE_CUSTOMER: {
+            long customerId = selectId(clientPtr, i);
+            tmretry_t retry;
+            tmretry_start(&retry, &global_deleteRetrySite);
+            while (1) {
+              __transaction_atomic {
+                tmretry_enter(&retry);
                 bool done = true;
-                while (1) {
-                  __transaction_atomic {
-                    long bill = manager_queryCustomerBill(managerPtr, customerId);
-                    if (bill >= 0) {
-                      done = done && manager_deleteCustomer(managerPtr, customerId);
-                    }
-                    if(done) break;
-                    else __transaction_cancel;
-                  }
+                long bill = manager_queryCustomerBill(managerPtr, customerId);
+                if (bill >= 0) {
+                  done = done && manager_deleteCustomer(managerPtr, customerId);
                 }
-                break;
+                if(done) break;
+                else __transaction_cancel;
+              }
+              tmretry_backoff(&retry);
             }
+            tmretry_finish(&retry);
+            break;
+        }
 
-            case ACTION_UPDATE_TABLES: {
-                long numUpdate = randomPtr() % numQueryPerTransaction + 1;
-                long n;
-                for (n = 0; n < numUpdate; n++) {
-                    types[n] = randomPtr() % NUM_RESERVATION_TYPE;
-                    ids[n] = (randomPtr() % queryRange) + 1;
-                    ops[n] = randomPtr() % 2;
-                    if (ops[n]) {
-                        prices[n] = ((randomPtr() % 5) * 10) + 50;
-                    }
+        case ACTION_UPDATE_TABLES: {
+            long numUpdate = randomPtr() % numQueryPerTransaction + 1;
+            long n;
+            for (n = 0; n < numUpdate; n++) {
+                types[n] = randomPtr() % NUM_RESERVATION_TYPE;
+                ids[n] = selectId(clientPtr, i);
+                ops[n] = randomPtr() % 2;
+                if (ops[n]) {
+                    prices[n] = ((randomPtr() % 5) * 10) + 50;
                 }
+            }
+            tmretry_t retry;
+            tmretry_start(&retry, &global_updateRetrySite);
+            while (1) {
+              __transaction_atomic {
+                tmretry_enter(&retry);
                 bool done = true;
-                while (1) {
-                  __transaction_atomic {
-                    for (n = 0; n < numUpdate; n++) {
-                      long t = types[n];
-                      long id = ids[n];
-                      long doAdd = ops[n];
-                      if (doAdd) {
-                        long newPrice = prices[n];
-                        switch (t) {
-                         case RESERVATION_CAR:
-                          done = done && manager_addCar(managerPtr, id, 100, newPrice);
-                          break;
-                         case RESERVATION_FLIGHT:
-                          done = done && manager_addFlight(managerPtr, id, 100, newPrice);
-                          break;
-                         case RESERVATION_ROOM:
-                          done = done && manager_addRoom(managerPtr, id, 100, newPrice);
-                          break;
-                         default:
-                          assert(0);
-                        }
-                      } else { /* do delete */
-                        switch (t) {
-                         case RESERVATION_CAR:
-                          done = done && manager_deleteCar(managerPtr, id, 100);
-                          break;
-                         case RESERVATION_FLIGHT:
-                          done = done && manager_deleteFlight(managerPtr, id);
-                          break;
-                         case RESERVATION_ROOM:
-                          done = done && manager_deleteRoom(managerPtr, id, 100);
-                          break;
-                         default:
-                          assert(0);
-                        }
-                      }
+                for (n = 0; n < numUpdate; n++) {
+                  long t = types[n];
+                  long id = ids[n];
+                  long doAdd = ops[n];
+                  if (doAdd) {
+                    long newPrice = prices[n];
+                    switch (t) {
+                     case RESERVATION_CAR:
+                      done = done && manager_addCar(managerPtr, id, 100, newPrice);
+                      break;
+                     case RESERVATION_FLIGHT:
+                      done = done && manager_addFlight(managerPtr, id, 100, newPrice);
+                      break;
+                     case RESERVATION_ROOM:
+                      done = done && manager_addRoom(managerPtr, id, 100, newPrice);
+                      break;
+                     default:
+                      assert(0);
+                    }
+                  } else { /* do delete */
+                    switch (t) {
+                     case RESERVATION_CAR:
+                      done = done && manager_deleteCar(managerPtr, id, 100);
+                      break;
+                     case RESERVATION_FLIGHT:
+                      done = done && manager_deleteFlight(managerPtr, id);
+                      break;
+                     case RESERVATION_ROOM:
+                      done = done && manager_deleteRoom(managerPtr, id, 100);
+                      break;
+                     default:
+                      assert(0);
                     }
-                  if (done) break;
-                  else __transaction_cancel;
-                  } // TM_END
+                  }
                 }
-                break;
+              if (done) break;
+              else __transaction_cancel;
+              } // TM_END
+              tmretry_backoff(&retry);
             }
+            tmretry_finish(&retry);
+            break;
+        }
+
+        default:
+            assert(0);
+
+    } /* switch (action) */
+
+    return action;
+}
+
+
+/* =============================================================================
+ * client_run
+ * -- Execute list operations on the database
+ * =============================================================================
+ */
+void
+client_run (void* argPtr)
+{
+    long myId = thread_getId();
+    client_t* clientPtr = ((client_t**)argPtr)[myId];
+
+    long numOperation           = clientPtr->numOperation;
+    long numQueryPerTransaction = clientPtr->numQueryPerTransaction;
+
+    long types[numQueryPerTransaction];
+    long ids[numQueryPerTransaction];
+    long ops[numQueryPerTransaction];
+    long prices[numQueryPerTransaction];
+
+    /* Arrivals draw from their own stream so the operations do not change */
+    bool isOpenLoop = (clientPtr->arrivalRate > 0.0);
+    double meanInterval = (isOpenLoop ? (1e9 / clientPtr->arrivalRate) : 0.0);
+    std::mt19937 arrivalRandom(clientPtr->id + 0x9E3779B9UL);
+    std::exponential_distribution<double> exponential(1.0);
+    unsigned long stopTime = getTime();
+    double arrivalTime = (double)stopTime;
+
+    for (long i = 0; i < numOperation; i++) {
+        unsigned long startTime;
+        if (isOpenLoop) {
+            arrivalTime += (clientPtr->isFixedInterval ?
+                            meanInterval :
+                            (meanInterval * exponential(arrivalRandom)));
+            startTime = (unsigned long)arrivalTime;
+            waitUntil(startTime);
+        } else {
+            /* Back to back: one clock read per operation is enough */
+            startTime = stopTime;
+        }
 
-            default:
-                assert(0);
+        action_t action = runOperation(clientPtr, i, types, ids, ops, prices);
 
-        } /* switch (action) */
+        stopTime = getTime();
+        histogram_record(clientPtr->latencies[action], (stopTime - startTime));
 
     } /* for i */
 
 }
+
+
+/* =============================================================================
+ * client_printLatencies
+ * -- Merges the per-client histograms and prints percentiles per action
+ * =============================================================================
+ */
+void
+client_printLatencies (client_t** clients, long numClient)
+{
+    const char* names[NUM_ACTION] = {
+        "makeReservation",
+        "deleteCustomer",
+        "updateTables"
+    };
+    histogram_t* totalPtr = histogram_alloc();
+    assert(totalPtr != NULL);
+
+    printf("Latency (us)       %10s %10s %10s %10s %10s %10s\n",
+           "count", "mean", "p50", "p99", "p99.9", "max");
+    for (long a = 0; a < NUM_ACTION; a++) {
+        histogram_clear(totalPtr);
+        for (long c = 0; c < numClient; c++) {
+            histogram_add(totalPtr, clients[c]->latencies[a]);
+        }
+        printf("    %-15s %10li %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+               names[a], totalPtr->numValue,
+               (histogram_getMean(totalPtr) / 1e3),
+               (histogram_getPercentile(totalPtr, 50.0) / 1e3),
+               (histogram_getPercentile(totalPtr, 99.0) / 1e3),
+               (histogram_getPercentile(totalPtr, 99.9) / 1e3),
+               (histogram_getPercentile(totalPtr, 100.0) / 1e3));
+    }
+
+    histogram_free(totalPtr);
+}
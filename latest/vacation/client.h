@@ -5,8 +5,33 @@
 #pragma once
 
 #include <random>
+#include "action.h"
+#include "alias.h"
+#include "histogram.h"
 #include "manager.h"
 
+/*
+ * How clients pick customer and item ids in [1, queryRange]. Apart from
+ * uniform, ids are drawn from an alias table built once by
+ * client_allocKeyAlias() and shared read-only by all clients, so sampling
+ * costs the same whatever the skew. Zipfian and hotspot favour the lowest
+ * ids; the moving hotspot shifts the hot window by queryRange/numOperation
+ * ids per operation, so it sweeps the whole range once per run.
+ */
+enum distribution_t {
+    DISTRIBUTION_UNIFORM        = 'u',
+    DISTRIBUTION_ZIPF           = 'z', /* p(rank k) ~ 1/k^theta */
+    DISTRIBUTION_HOTSPOT        = 'h', /* x% of draws hit y% of ids */
+    DISTRIBUTION_MOVING_HOTSPOT = 'm'
+};
+
+/*
+ * With arrivalRate == 0 a client runs its operations back to back (closed
+ * loop). Otherwise operation i is due at the i-th arrival of a Poisson
+ * process (or of a fixed-interval schedule) of that rate, and its latency
+ * is measured from when it was due, not from when the client got to it,
+ * so time spent queued behind slow transactions is counted.
+ */
 struct client_t {
     long id;
     manager_t* managerPtr;
@@ -15,16 +40,25 @@ struct client_t {
     long numQueryPerTransaction;
     long queryRange;
     long percentUser;
+    double arrivalRate;                 /* operations/s; 0 is closed loop */
+    bool isFixedInterval;               /* else Poisson arrivals */
+    histogram_t* latencies[NUM_ACTION]; /* ns, indexed by action_t */
+    distribution_t distribution;
+    alias_t* keyAliasPtr;               /* shared; NULL if uniform */
 
     client_t(long id,
              manager_t* managerPtr,
              long numOperation,
              long numQueryPerTransaction,
              long queryRange,
-             long percentUser);
+             long percentUser,
+             double arrivalRate,
+             bool isFixedInterval,
+             distribution_t distribution,
+             alias_t* keyAliasPtr);
 
-    // NB: no need for explicit destructor, since the managerPtr is shared
-    // among clients
+    // NB: the managerPtr is shared among clients, so it is not freed here
+    ~client_t();
 };
 
 
@@ -34,3 +68,23 @@ struct client_t {
  */
 void
 client_run (void* argPtr);
+
+
+/*
+ * client_printLatencies
+ * -- Merges the per-client histograms and prints percentiles per action
+ */
+void
+client_printLatencies (client_t** clients, long numClient);
+
+
+/*
+ * client_allocKeyAlias
+ * -- Returns NULL for DISTRIBUTION_UNIFORM, which needs no table
+ */
+alias_t*
+client_allocKeyAlias (distribution_t distribution,
+                      long queryRange,
+                      double theta,
+                      long percentHotTraffic,
+                      long percentHotKey);
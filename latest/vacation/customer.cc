@@ -9,21 +9,31 @@
 #include <assert.h>
 #include <stdlib.h>
 #include "customer.h"
-#include "list.h"
 #include "memory.h"
 #include "reservation.h"
+#include "svector.h"
 #include "tm_transition.h"
 
 /* =============================================================================
- * compareReservationInfo
+ * findReservationInfo
+ * -- Returns index in reservationInfos, or -1 if absent
  * =============================================================================
  */
-//static
-__attribute__((transaction_safe)) long
-compareReservationInfo (const void* aPtr, const void* bPtr)
+__attribute__((transaction_safe))
+static long
+findReservationInfo (customer_t* customerPtr, reservation_type_t type, long id)
 {
-    return reservation_info_compare((reservation_info_t*)aPtr,
-                                    (reservation_info_t*)bPtr);
+    reservation_info_t* infos = svector_getElements(&customerPtr->reservationInfos);
+    long numInfo = svector_getSize(&customerPtr->reservationInfos);
+    long i;
+
+    for (i = 0; i < numInfo; i++) {
+        if (infos[i].id == id && infos[i].type == type) {
+            return i;
+        }
+    }
+
+    return -1;
 }
 
 
@@ -35,10 +45,8 @@ __attribute__((transaction_safe))
 customer_t::customer_t(long _id)
 {
     id = _id;
-
-    // NB: must initialize with TM_SAFE compare function
-    reservationInfoListPtr = TMLIST_ALLOC(&compareReservationInfo);
-    assert(reservationInfoListPtr != NULL);
+    bill = 0;
+    svector_init(&reservationInfos);
 }
 
 
@@ -49,27 +57,31 @@ customer_t::customer_t(long _id)
 __attribute__((transaction_safe))
 customer_t::~customer_t()
 {
-    // [mfs] Is this sufficient?  Does it free the whole list?
-    TMLIST_FREE(reservationInfoListPtr);
+    svector_free(&reservationInfos);
 }
 
 
 /* =============================================================================
  * customer_addReservationInfo
  * -- Returns TRUE if success, else FALSE
+ * -- Fails if the customer already holds this (type, id)
  * =============================================================================
  */
 __attribute__((transaction_safe)) bool
 customer_addReservationInfo (customer_t* customerPtr,
                              reservation_type_t type, long id, long price)
 {
-    reservation_info_t* reservationInfoPtr =
-        new reservation_info_t(type, id, price);
+    if (findReservationInfo(customerPtr, type, id) >= 0) {
+        return false;
+    }
 
-    list_t* reservationInfoListPtr =
-        customerPtr->reservationInfoListPtr;
+    reservation_info_t reservationInfo(type, id, price);
+    if (!svector_pushBack(&customerPtr->reservationInfos, reservationInfo)) {
+        return false;
+    }
+    customerPtr->bill += price;
 
-    return TMLIST_INSERT(reservationInfoListPtr, (void*)reservationInfoPtr);
+    return true;
 }
 
 
@@ -84,28 +96,15 @@ __attribute__((transaction_safe)) bool
 customer_removeReservationInfo (customer_t* customerPtr,
                                 reservation_type_t type, long id)
 {
-    // NB: price not used to compare reservation infos
-    reservation_info_t findReservationInfo(type, id, 0);
-
-    list_t* reservationInfoListPtr = customerPtr->reservationInfoListPtr;
-
-    reservation_info_t* reservationInfoPtr =
-        (reservation_info_t*)TMLIST_FIND(reservationInfoListPtr,
-                                         &findReservationInfo);
-
-    if (reservationInfoPtr == NULL) {
+    long i = findReservationInfo(customerPtr, type, id);
+    if (i < 0) {
         return false;
     }
-    bool status = TMLIST_REMOVE(reservationInfoListPtr,
-                                  (void*)&findReservationInfo);
 
-    //[wer210] get rid of restart()
-    if (status == false) {
-      //_ITM_abortTransaction(2);
-      return false;
-    }
-
-    delete reservationInfoPtr;
+    /* Order does not matter: fill the hole with the last element */
+    reservation_info_t* infos = svector_getElements(&customerPtr->reservationInfos);
+    customerPtr->bill -= infos[i].price;
+    infos[i] = svector_popBack(&customerPtr->reservationInfos);
 
     return true;
 }
@@ -119,18 +118,7 @@ customer_removeReservationInfo (customer_t* customerPtr,
 __attribute__((transaction_safe)) long
 customer_getBill (  customer_t* customerPtr)
 {
-    long bill = 0;
-    list_iter_t it;
-    list_t* reservationInfoListPtr = customerPtr->reservationInfoListPtr;
-
-    TMLIST_ITER_RESET(&it, reservationInfoListPtr);
-    while (TMLIST_ITER_HASNEXT(&it)) {
-        reservation_info_t* reservationInfoPtr =
-            (reservation_info_t*)TMLIST_ITER_NEXT(&it);
-        bill += reservationInfoPtr->price;
-    }
-
-    return bill;
+    return customerPtr->bill;
 }
 
 
@@ -8,12 +8,16 @@
 
 #pragma once
 
-#include "list.h"
 #include "reservation.h"
+#include "svector.h"
+
+/* Most customers hold one reservation of each type */
+#define CUSTOMER_NUM_INLINE_RESERVATION (4)
 
 struct customer_t {
     long id;
-    list_t* reservationInfoListPtr;
+    long bill; /* sum of price over reservationInfos */
+    svector_t<reservation_info_t, CUSTOMER_NUM_INLINE_RESERVATION> reservationInfos;
 
     __attribute__((transaction_safe))
     customer_t(long id);
@@ -29,30 +29,79 @@ queryPrice (  MAP_T* tablePtr, long id);
 
 __attribute__((transaction_safe))
 bool
-reserve ( MAP_T* tablePtr, MAP_T* customerTablePtr, long customerId, long id, reservation_type_t type);
+reserve (manager_t* managerPtr, long customerId, long id, reservation_type_t type);
 
 __attribute__((transaction_safe))
 bool
-cancel ( MAP_T* tablePtr, MAP_T* customerTablePtr, long customerId, long id, reservation_type_t type);
+cancel (manager_t* managerPtr, long customerId, long id, reservation_type_t type);
 
 __attribute__((transaction_safe))
 bool
 addReservation (  MAP_T* tablePtr, long id, long num, long price);
 
+/* =============================================================================
+ * getTable
+ * -- Returns the shard of the car/room/flight table that holds 'id'
+ * =============================================================================
+ */
+__attribute__((transaction_safe))
+static inline MAP_T*
+getTable (manager_t* managerPtr, reservation_type_t type, long id)
+{
+    long shard = manager_getShard(managerPtr, id);
+
+    switch (type) {
+        case RESERVATION_CAR:
+            return managerPtr->carTables[shard];
+        case RESERVATION_ROOM:
+            return managerPtr->roomTables[shard];
+        case RESERVATION_FLIGHT:
+        default:
+            return managerPtr->flightTables[shard];
+    }
+}
+
+
+/* =============================================================================
+ * getCustomerTable
+ * =============================================================================
+ */
+__attribute__((transaction_safe))
+static inline MAP_T*
+getCustomerTable (manager_t* managerPtr, long customerId)
+{
+    return managerPtr->customerTables[manager_getShard(managerPtr, customerId)];
+}
+
 /**
  * Constructor for manager objects
  */
-manager_t::manager_t()
+manager_t::manager_t(long _numShard)
 {
-    carTablePtr = MAP_ALLOC(NULL, NULL);
-    roomTablePtr = MAP_ALLOC(NULL, NULL);
-    flightTablePtr = MAP_ALLOC(NULL, NULL);
-    customerTablePtr = MAP_ALLOC(NULL, NULL);
-    // [mfs] Once map is a c++ object, these asserts are unnecessary
-    assert(carTablePtr != NULL);
-    assert(roomTablePtr != NULL);
-    assert(flightTablePtr != NULL);
-    assert(customerTablePtr != NULL);
+    long s;
+
+    assert(_numShard > 0);
+    numShard = _numShard;
+    carTables = (MAP_T**)malloc(numShard * sizeof(MAP_T*));
+    roomTables = (MAP_T**)malloc(numShard * sizeof(MAP_T*));
+    flightTables = (MAP_T**)malloc(numShard * sizeof(MAP_T*));
+    customerTables = (MAP_T**)malloc(numShard * sizeof(MAP_T*));
+    assert(carTables != NULL);
+    assert(roomTables != NULL);
+    assert(flightTables != NULL);
+    assert(customerTables != NULL);
+
+    for (s = 0; s < numShard; s++) {
+        carTables[s] = MAP_ALLOC(NULL, NULL);
+        roomTables[s] = MAP_ALLOC(NULL, NULL);
+        flightTables[s] = MAP_ALLOC(NULL, NULL);
+        customerTables[s] = MAP_ALLOC(NULL, NULL);
+        // [mfs] Once map is a c++ object, these asserts are unnecessary
+        assert(carTables[s] != NULL);
+        assert(roomTables[s] != NULL);
+        assert(flightTables[s] != NULL);
+        assert(customerTables[s] != NULL);
+    }
 }
 
 /**
@@ -63,10 +112,18 @@ manager_t::manager_t()
  */
 manager_t::~manager_t()
 {
-    MAP_FREE(carTablePtr);
-    MAP_FREE(roomTablePtr);
-    MAP_FREE(flightTablePtr);
-    MAP_FREE(customerTablePtr);
+    long s;
+
+    for (s = 0; s < numShard; s++) {
+        MAP_FREE(carTables[s]);
+        MAP_FREE(roomTables[s]);
+        MAP_FREE(flightTables[s]);
+        MAP_FREE(customerTables[s]);
+    }
+    free(carTables);
+    free(roomTables);
+    free(flightTables);
+    free(customerTables);
 }
 
 
@@ -146,7 +203,8 @@ addReservation (MAP_T* tablePtr, long id, long num, long price)
 __attribute__((transaction_safe)) bool
 manager_addCar (manager_t* managerPtr, long carId, long numCars, long price)
 {
-    return addReservation(  managerPtr->carTablePtr, carId, numCars, price);
+    return addReservation(getTable(managerPtr, RESERVATION_CAR, carId),
+                          carId, numCars, price);
 }
 
 
@@ -163,7 +221,8 @@ __attribute__((transaction_safe)) bool
 manager_deleteCar (  manager_t* managerPtr, long carId, long numCar)
 {
     /* -1 keeps old price */
-    return addReservation(  managerPtr->carTablePtr, carId, -numCar, -1);
+    return addReservation(getTable(managerPtr, RESERVATION_CAR, carId),
+                          carId, -numCar, -1);
 }
 
 
@@ -177,7 +236,8 @@ manager_deleteCar (  manager_t* managerPtr, long carId, long numCar)
 __attribute__((transaction_safe)) bool
 manager_addRoom (manager_t* managerPtr, long roomId, long numRoom, long price)
 {
-    return addReservation(  managerPtr->roomTablePtr, roomId, numRoom, price);
+    return addReservation(getTable(managerPtr, RESERVATION_ROOM, roomId),
+                          roomId, numRoom, price);
 }
 
 
@@ -195,7 +255,8 @@ __attribute__((transaction_safe)) bool
 manager_deleteRoom (manager_t* managerPtr, long roomId, long numRoom)
 {
     /* -1 keeps old price */
-    return addReservation(  managerPtr->roomTablePtr, roomId, -numRoom, -1);
+    return addReservation(getTable(managerPtr, RESERVATION_ROOM, roomId),
+                          roomId, -numRoom, -1);
 }
 
 
@@ -209,7 +270,8 @@ manager_deleteRoom (manager_t* managerPtr, long roomId, long numRoom)
 __attribute__((transaction_safe)) bool
 manager_addFlight (manager_t* managerPtr, long flightId, long numSeat, long price)
 {
-    return addReservation(managerPtr->flightTablePtr, flightId, numSeat, price);
+    return addReservation(getTable(managerPtr, RESERVATION_FLIGHT, flightId),
+                          flightId, numSeat, price);
 }
 
 
@@ -227,7 +289,10 @@ manager_deleteFlight (  manager_t* managerPtr, long flightId)
 {
     reservation_t* reservationPtr;
 
-    reservationPtr = (reservation_t*)TMMAP_FIND(managerPtr->flightTablePtr, flightId);
+    reservationPtr =
+        (reservation_t*)TMMAP_FIND(getTable(managerPtr, RESERVATION_FLIGHT,
+                                            flightId),
+                                   flightId);
     if (reservationPtr == NULL) {
       //return FALSE;
       return true;
@@ -238,7 +303,7 @@ manager_deleteFlight (  manager_t* managerPtr, long flightId)
       return true;
     }
 
-    return addReservation(managerPtr->flightTablePtr,
+    return addReservation(getTable(managerPtr, RESERVATION_FLIGHT, flightId),
                           flightId,
                           -1*reservationPtr->numTotal,
                           -1 /* -1 keeps old price */);
@@ -260,7 +325,7 @@ manager_addCustomer (  manager_t* managerPtr, long customerId)
     customer_t* customerPtr;
     bool status;
 
-    if (TMMAP_CONTAINS(managerPtr->customerTablePtr, customerId)) {
+    if (TMMAP_CONTAINS(getCustomerTable(managerPtr, customerId), customerId)) {
       //return FALSE;
       return true;
     }
@@ -268,7 +333,8 @@ manager_addCustomer (  manager_t* managerPtr, long customerId)
     customerPtr = new customer_t(customerId);
     assert(customerPtr != NULL);
 
-    status = TMMAP_INSERT(managerPtr->customerTablePtr, customerId, customerPtr);
+    status = TMMAP_INSERT(getCustomerTable(managerPtr, customerId),
+                          customerId, customerPtr);
     if (status == false) {
       //_ITM_abortTransaction(2);
       return false;
@@ -292,29 +358,28 @@ __attribute__((transaction_safe)) bool
 manager_deleteCustomer (  manager_t* managerPtr, long customerId)
 {
     customer_t* customerPtr;
-    MAP_T* reservationTables[NUM_RESERVATION_TYPE];
-    list_t* reservationInfoListPtr;
-    list_iter_t it;
+    reservation_info_t* reservationInfos;
+    long numReservationInfo;
+    long i;
     bool status;
 
-    customerPtr = (customer_t*)TMMAP_FIND(managerPtr->customerTablePtr, customerId);
+    customerPtr =
+        (customer_t*)TMMAP_FIND(getCustomerTable(managerPtr, customerId),
+                                customerId);
     if (customerPtr == NULL) {
       //return FALSE;
       return true;
     }
 
-    reservationTables[RESERVATION_CAR] = managerPtr->carTablePtr;
-    reservationTables[RESERVATION_ROOM] = managerPtr->roomTablePtr;
-    reservationTables[RESERVATION_FLIGHT] = managerPtr->flightTablePtr;
-
     /* Cancel this customer's reservations */
-    reservationInfoListPtr = customerPtr->reservationInfoListPtr;
-    TMLIST_ITER_RESET(&it, reservationInfoListPtr);
-    while (TMLIST_ITER_HASNEXT(&it)) {
-      reservation_info_t* reservationInfoPtr =
-        (reservation_info_t*)TMLIST_ITER_NEXT(&it);
+    reservationInfos = svector_getElements(&customerPtr->reservationInfos);
+    numReservationInfo = svector_getSize(&customerPtr->reservationInfos);
+    for (i = 0; i < numReservationInfo; i++) {
+      reservation_info_t* reservationInfoPtr = &reservationInfos[i];
       reservation_t* reservationPtr =
-        (reservation_t*)TMMAP_FIND(reservationTables[reservationInfoPtr->type],
+        (reservation_t*)TMMAP_FIND(getTable(managerPtr,
+                                            reservationInfoPtr->type,
+                                            reservationInfoPtr->id),
                                    reservationInfoPtr->id);
       if (reservationPtr == NULL) {
         //_ITM_abortTransaction(2);
@@ -326,10 +391,9 @@ manager_deleteCustomer (  manager_t* managerPtr, long customerId)
         //_ITM_abortTransaction(2);
         return false;
       }
-      delete reservationInfoPtr;
     }
 
-    status = TMMAP_REMOVE(managerPtr->customerTablePtr, customerId);
+    status = TMMAP_REMOVE(getCustomerTable(managerPtr, customerId), customerId);
     if (status == false) {
       //_ITM_abortTransaction(2);
       return false;
@@ -395,7 +459,8 @@ queryPrice (  MAP_T* tablePtr, long id)
 __attribute__((transaction_safe)) long
 manager_queryCar (manager_t* managerPtr, long carId)
 {
-    return queryNumFree(managerPtr->carTablePtr, carId);
+    return queryNumFree(getTable(managerPtr, RESERVATION_CAR, carId),
+                        carId);
 }
 
 
@@ -408,7 +473,8 @@ manager_queryCar (manager_t* managerPtr, long carId)
 __attribute__((transaction_safe)) long
 manager_queryCarPrice (manager_t* managerPtr, long carId)
 {
-    return queryPrice(managerPtr->carTablePtr, carId);
+    return queryPrice(getTable(managerPtr, RESERVATION_CAR, carId),
+                      carId);
 }
 
 
@@ -421,7 +487,8 @@ manager_queryCarPrice (manager_t* managerPtr, long carId)
 __attribute__((transaction_safe)) long
 manager_queryRoom (  manager_t* managerPtr, long roomId)
 {
-    return queryNumFree(  managerPtr->roomTablePtr, roomId);
+    return queryNumFree(getTable(managerPtr, RESERVATION_ROOM, roomId),
+                        roomId);
 }
 
 
@@ -434,7 +501,8 @@ manager_queryRoom (  manager_t* managerPtr, long roomId)
 __attribute__((transaction_safe)) long
 manager_queryRoomPrice (  manager_t* managerPtr, long roomId)
 {
-    return queryPrice(  managerPtr->roomTablePtr, roomId);
+    return queryPrice(getTable(managerPtr, RESERVATION_ROOM, roomId),
+                      roomId);
 }
 
 
@@ -447,7 +515,8 @@ manager_queryRoomPrice (  manager_t* managerPtr, long roomId)
 __attribute__((transaction_safe)) long
 manager_queryFlight (  manager_t* managerPtr, long flightId)
 {
-    return queryNumFree(  managerPtr->flightTablePtr, flightId);
+    return queryNumFree(getTable(managerPtr, RESERVATION_FLIGHT, flightId),
+                        flightId);
 }
 
 
@@ -460,7 +529,8 @@ manager_queryFlight (  manager_t* managerPtr, long flightId)
 __attribute__((transaction_safe)) long
 manager_queryFlightPrice (  manager_t* managerPtr, long flightId)
 {
-    return queryPrice(  managerPtr->flightTablePtr, flightId);
+    return queryPrice(getTable(managerPtr, RESERVATION_FLIGHT, flightId),
+                      flightId);
 }
 
 
@@ -476,7 +546,9 @@ manager_queryCustomerBill (  manager_t* managerPtr, long customerId)
     long bill = -1;
     customer_t* customerPtr;
 
-    customerPtr = (customer_t*)TMMAP_FIND(managerPtr->customerTablePtr, customerId);
+    customerPtr =
+        (customer_t*)TMMAP_FIND(getCustomerTable(managerPtr, customerId),
+                                customerId);
 
     if (customerPtr != NULL) {
         bill = customer_getBill(customerPtr);
@@ -502,19 +574,22 @@ manager_queryCustomerBill (  manager_t* managerPtr, long customerId)
 // to indicate if should restart a transaction.
 __attribute__((transaction_safe))
 bool
-reserve (MAP_T* tablePtr, MAP_T* customerTablePtr,
+reserve (manager_t* managerPtr,
          long customerId, long id, reservation_type_t type)
 {
     customer_t* customerPtr;
     reservation_t* reservationPtr;
 
-    customerPtr = (customer_t*)TMMAP_FIND(customerTablePtr, customerId);
+    customerPtr =
+        (customer_t*)TMMAP_FIND(getCustomerTable(managerPtr, customerId),
+                                customerId);
     if (customerPtr == NULL) {
       //return FALSE;
       return true;
     }
 
-    reservationPtr = (reservation_t*)TMMAP_FIND(tablePtr, id);
+    reservationPtr =
+        (reservation_t*)TMMAP_FIND(getTable(managerPtr, type, id), id);
     if (reservationPtr == NULL) {
       //return FALSE;
       return true;
@@ -549,8 +624,7 @@ reserve (MAP_T* tablePtr, MAP_T* customerTablePtr,
 __attribute__((transaction_safe)) bool
 manager_reserveCar (  manager_t* managerPtr, long customerId, long carId)
 {
-    return reserve(managerPtr->carTablePtr,
-                   managerPtr->customerTablePtr,
+    return reserve(managerPtr,
                    customerId,
                    carId,
                    RESERVATION_CAR);
@@ -566,8 +640,7 @@ manager_reserveCar (  manager_t* managerPtr, long customerId, long carId)
 __attribute__((transaction_safe)) bool
 manager_reserveRoom (  manager_t* managerPtr, long customerId, long roomId)
 {
-    return reserve(managerPtr->roomTablePtr,
-                   managerPtr->customerTablePtr,
+    return reserve(managerPtr,
                    customerId,
                    roomId,
                    RESERVATION_ROOM);
@@ -583,8 +656,7 @@ manager_reserveRoom (  manager_t* managerPtr, long customerId, long roomId)
 __attribute__((transaction_safe)) bool
 manager_reserveFlight (manager_t* managerPtr, long customerId, long flightId)
 {
-    return reserve(managerPtr->flightTablePtr,
-                   managerPtr->customerTablePtr,
+    return reserve(managerPtr,
                    customerId,
                    flightId,
                    RESERVATION_FLIGHT);
@@ -601,18 +673,21 @@ manager_reserveFlight (manager_t* managerPtr, long customerId, long flightId)
 //         however, never called.
 __attribute__((transaction_safe))
 bool
-cancel (MAP_T* tablePtr, MAP_T* customerTablePtr,
+cancel (manager_t* managerPtr,
         long customerId, long id, reservation_type_t type)
 {
     customer_t* customerPtr;
     reservation_t* reservationPtr;
 
-    customerPtr = (customer_t*)TMMAP_FIND(customerTablePtr, customerId);
+    customerPtr =
+        (customer_t*)TMMAP_FIND(getCustomerTable(managerPtr, customerId),
+                                customerId);
     if (customerPtr == NULL) {
         return false;
     }
 
-    reservationPtr = (reservation_t*)TMMAP_FIND(tablePtr, id);
+    reservationPtr =
+        (reservation_t*)TMMAP_FIND(getTable(managerPtr, type, id), id);
     if (reservationPtr == NULL) {
         return false;
     }
@@ -643,8 +718,7 @@ cancel (MAP_T* tablePtr, MAP_T* customerTablePtr,
 __attribute__((transaction_safe)) bool
 manager_cancelCar (  manager_t* managerPtr, long customerId, long carId)
 {
-    return cancel(managerPtr->carTablePtr,
-                  managerPtr->customerTablePtr,
+    return cancel(managerPtr,
                   customerId,
                   carId,
                   RESERVATION_CAR);
@@ -660,8 +734,7 @@ manager_cancelCar (  manager_t* managerPtr, long customerId, long carId)
 __attribute__((transaction_safe)) bool
 manager_cancelRoom (  manager_t* managerPtr, long customerId, long roomId)
 {
-    return cancel(managerPtr->roomTablePtr,
-                  managerPtr->customerTablePtr,
+    return cancel(managerPtr,
                   customerId,
                   roomId,
                   RESERVATION_ROOM);
@@ -678,8 +751,7 @@ manager_cancelRoom (  manager_t* managerPtr, long customerId, long roomId)
 __attribute__((transaction_safe)) bool
 manager_cancelFlight (manager_t* managerPtr, long customerId, long flightId)
 {
-    return cancel(managerPtr->flightTablePtr,
-                  managerPtr->customerTablePtr,
+    return cancel(managerPtr,
                   customerId,
                   flightId,
                   RESERVATION_FLIGHT);
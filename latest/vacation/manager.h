@@ -10,16 +10,38 @@
 
 #include "map.h"
 
+/*
+ * Each table is split into numShard independent maps and an id always lives
+ * in shard manager_getShard(id), so transactions on unrelated ids do not
+ * meet in (or rebalance) a shared tree. The transactional interface below is
+ * unchanged; numShard == 1 is the original single-map layout.
+ */
 struct manager_t {
-    MAP_T* carTablePtr;
-    MAP_T* roomTablePtr;
-    MAP_T* flightTablePtr;
-    MAP_T* customerTablePtr;
+    long numShard;
+    MAP_T** carTables;      /* [numShard] */
+    MAP_T** roomTables;     /* [numShard] */
+    MAP_T** flightTables;   /* [numShard] */
+    MAP_T** customerTables; /* [numShard] */
 
-    manager_t();
+    manager_t(long numShard = 1);
     ~manager_t();
 };
 
+
+/* =============================================================================
+ * manager_getShard
+ * -- Fibonacci hash, so consecutive ids spread over the shards
+ * =============================================================================
+ */
+__attribute__((transaction_safe))
+inline long
+manager_getShard (manager_t* managerPtr, long id)
+{
+    unsigned long hash = (unsigned long)id * 0x9E3779B97F4A7C15UL;
+    return (long)((hash >> 32) % (unsigned long)managerPtr->numShard);
+}
+
+
 /* =============================================================================
  * ADMINISTRATIVE INTERFACE
  * =============================================================================
@@ -20,6 +20,9 @@ struct reservation_info_t {
     long id;
     long price; /* holds price at time reservation was made */
 
+    // NB: trivial default constructor so infos can live in an svector_t
+    reservation_info_t() = default;
+
     __attribute__((transaction_safe))
     reservation_info_t(reservation_type_t type, long id, long price);
 
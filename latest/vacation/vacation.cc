@@ -7,36 +7,52 @@
 #include <stdio.h>
 #include <getopt.h>
 #include <random>
+#include "alias.h"
 #include "client.h"
 #include "customer.h"
-#include "list.h"
 #include "manager.h"
 #include "map.h"
 #include "memory.h"
 #include "operation.h"
 #include "reservation.h"
 #include "timer.h"
+#include "tmretry.h"
 #include "utility.h"
 #include "thread.h"
 
 enum param_types {
+    PARAM_ARRIVAL      = (unsigned char)'a',
+    PARAM_FIXED        = (unsigned char)'f',
     PARAM_CLIENTS      = (unsigned char)'t',
+    PARAM_DISTRIBUTION = (unsigned char)'d',
     PARAM_NUMBER       = (unsigned char)'n',
     PARAM_QUERIES      = (unsigned char)'q',
     PARAM_RELATIONS    = (unsigned char)'r',
+    PARAM_SHARDS       = (unsigned char)'s',
     PARAM_TRANSACTIONS = (unsigned char)'T',
-    PARAM_USER         = (unsigned char)'u'
+    PARAM_USER         = (unsigned char)'u',
+    PARAM_HOT_TRAFFIC  = (unsigned char)'x',
+    PARAM_HOT_KEYS     = (unsigned char)'y',
+    PARAM_THETA        = (unsigned char)'Z'
 };
 
+#define PARAM_DEFAULT_ARRIVAL      (0)
 #define PARAM_DEFAULT_CLIENTS      (1)
+#define PARAM_DEFAULT_DISTRIBUTION ('u')
+#define PARAM_DEFAULT_HOT_TRAFFIC  (80)
+#define PARAM_DEFAULT_HOT_KEYS     (20)
+#define PARAM_DEFAULT_THETA        (0.99)
 #define PARAM_DEFAULT_NUMBER       (4)
 #define PARAM_DEFAULT_QUERIES      (60)
 #define PARAM_DEFAULT_RELATIONS    (1 << 20)
+#define PARAM_DEFAULT_SHARDS       (1)
 #define PARAM_DEFAULT_TRANSACTIONS (1 << 22)
 #define PARAM_DEFAULT_USER         (90)
 
 double global_params[256]; /* 256 = ascii limit */
 
+alias_t* global_keyAliasPtr = NULL;
+
 pthread_barrier_t* global_barrierPtr;
 
 /* =============================================================================
@@ -48,6 +64,12 @@ displayUsage (const char* appName)
 {
     printf("Usage: %s [options]\n", appName);
     puts("\nOptions:                                             (defaults)\n");
+    printf("    a <UINT>   [a]rrivals/s per client, 0 = closed   (%i)\n",
+           PARAM_DEFAULT_ARRIVAL);
+    printf("    f          [f]ixed arrival interval, not Poisson\n");
+    printf("    d <CHAR>   Id [d]istribution: u, z, h, m         (%c)\n",
+           PARAM_DEFAULT_DISTRIBUTION);
+    printf("               ([u]niform, [z]ipfian, [h]otspot, [m]oving hotspot)\n");
     printf("    t <UINT>   Number of clien[t]s ([t]hreads)       (%i)\n",
            PARAM_DEFAULT_CLIENTS);
     printf("    n <UINT>   [n]umber of user queries/transaction  (%i)\n",
@@ -56,10 +78,18 @@ displayUsage (const char* appName)
            PARAM_DEFAULT_QUERIES);
     printf("    r <UINT>   Number of possible [r]elations        (%i)\n",
            PARAM_DEFAULT_RELATIONS);
+    printf("    s <UINT>   Number of [s]hards per table          (%i)\n",
+           PARAM_DEFAULT_SHARDS);
     printf("    T <UINT>   Number of [T]ransactions              (%i)\n",
            PARAM_DEFAULT_TRANSACTIONS);
     printf("    u <UINT>   Percentage of [u]ser transactions     (%i)\n",
            PARAM_DEFAULT_USER);
+    printf("    x <UINT>   Hotspot: percentage of draws (-d h/m) (%i)\n",
+           PARAM_DEFAULT_HOT_TRAFFIC);
+    printf("    y <UINT>   Hotspot: percentage of ids (-d h/m)   (%i)\n",
+           PARAM_DEFAULT_HOT_KEYS);
+    printf("    Z <FLT>    [Z]ipfian theta (-d z)                (%g)\n",
+           PARAM_DEFAULT_THETA);
     exit(1);
 }
 
@@ -71,10 +101,17 @@ displayUsage (const char* appName)
 static void
 setDefaultParams ()
 {
+    global_params[PARAM_ARRIVAL]      = PARAM_DEFAULT_ARRIVAL;
+    global_params[PARAM_FIXED]        = 0;
     global_params[PARAM_CLIENTS]      = PARAM_DEFAULT_CLIENTS;
+    global_params[PARAM_DISTRIBUTION] = PARAM_DEFAULT_DISTRIBUTION;
+    global_params[PARAM_HOT_TRAFFIC]  = PARAM_DEFAULT_HOT_TRAFFIC;
+    global_params[PARAM_HOT_KEYS]     = PARAM_DEFAULT_HOT_KEYS;
+    global_params[PARAM_THETA]        = PARAM_DEFAULT_THETA;
     global_params[PARAM_NUMBER]       = PARAM_DEFAULT_NUMBER;
     global_params[PARAM_QUERIES]      = PARAM_DEFAULT_QUERIES;
     global_params[PARAM_RELATIONS]    = PARAM_DEFAULT_RELATIONS;
+    global_params[PARAM_SHARDS]       = PARAM_DEFAULT_SHARDS;
     global_params[PARAM_TRANSACTIONS] = PARAM_DEFAULT_TRANSACTIONS;
     global_params[PARAM_USER]         = PARAM_DEFAULT_USER;
 }
@@ -94,16 +131,39 @@ parseArgs (long argc, char* const argv[])
 
     setDefaultParams();
 
-    while ((opt = getopt(argc, argv, "t:n:q:r:T:u:L")) != -1) {
+    while ((opt = getopt(argc, argv, "a:d:ft:n:q:r:s:T:u:x:y:Z:L")) != -1) {
         switch (opt) {
+            case 'a':
             case 'T':
             case 'n':
             case 'q':
             case 'r':
+            case 's':
             case 't':
             case 'u':
+            case 'x':
+            case 'y':
                 global_params[(unsigned char)opt] = atol(optarg);
                 break;
+            case 'Z':
+                global_params[(unsigned char)opt] = atof(optarg);
+                break;
+            case 'd':
+                switch (optarg[0]) {
+                    case DISTRIBUTION_UNIFORM:
+                    case DISTRIBUTION_ZIPF:
+                    case DISTRIBUTION_HOTSPOT:
+                    case DISTRIBUTION_MOVING_HOTSPOT:
+                        global_params[PARAM_DISTRIBUTION] = optarg[0];
+                        break;
+                    default:
+                        opterr++;
+                        break;
+                }
+                break;
+            case 'f':
+                global_params[PARAM_FIXED] = 1;
+                break;
             case 'L':
                 global_params[PARAM_NUMBER] = 2;
                 global_params[PARAM_QUERIES] = 90;
@@ -116,6 +176,25 @@ parseArgs (long argc, char* const argv[])
         }
     }
 
+    if (global_params[PARAM_SHARDS] < 1) {
+        opterr++;
+    }
+
+    if ((global_params[PARAM_HOT_TRAFFIC] < 0) ||
+        (global_params[PARAM_HOT_TRAFFIC] > 100) ||
+        (global_params[PARAM_HOT_KEYS] < 0) ||
+        (global_params[PARAM_HOT_KEYS] > 100))
+    {
+        opterr++;
+    }
+
+    /* No draws to the hotspot and no ids outside it */
+    if ((global_params[PARAM_HOT_TRAFFIC] == 0) &&
+        (global_params[PARAM_HOT_KEYS] == 100))
+    {
+        opterr++;
+    }
+
     for (i = optind; i < argc; i++) {
         fprintf(stderr, "Non-option argument: %s\n", argv[i]);
         opterr++;
@@ -140,13 +219,19 @@ addCustomer (manager_t* managerPtr, long id, long, long)
 
 
 /* =============================================================================
- * initializeManager
+ * populateManager
+ * -- Every thread replays the same random sequence but only inserts the ids
+ *    whose shard it owns, so each shard's nodes are first touched by (and
+ *    allocated from the arena of) one thread; with one thread this is the
+ *    original serial fill
  * =============================================================================
  */
-static manager_t*
-initializeManager ()
+static void
+populateManager (void* argPtr)
 {
-    manager_t* managerPtr;
+    manager_t* managerPtr = (manager_t*)argPtr;
+    long myId = thread_getId();
+    long numThread = thread_getNumThread();
     long i;
     long numRelation;
     std::mt19937 randomPtr;
@@ -160,14 +245,9 @@ initializeManager ()
     long t;
     long numTable = sizeof(manager_add) / sizeof(manager_add[0]);
 
-    printf("Initializing manager... ");
-    fflush(stdout);
-
-    managerPtr = new manager_t();
-    assert(managerPtr != NULL);
-
     numRelation = (long)global_params[PARAM_RELATIONS];
     ids = (long*)malloc(numRelation * sizeof(long));
+    assert(ids != NULL);
     for (i = 0; i < numRelation; i++) {
         ids[i] = i + 1;
     }
@@ -189,16 +269,39 @@ initializeManager ()
             long id = ids[i];
             long num = ((randomPtr() % 5) + 1) * 100;
             long price = ((randomPtr() % 5) * 10) + 50;
+            if ((manager_getShard(managerPtr, id) % numThread) != myId) {
+                continue;
+            }
             status = manager_add[t](managerPtr, id, num, price);
             assert(status);
         }
 
     } /* for t */
 
-    puts("done.");
+    free(ids);
+}
+
+
+/* =============================================================================
+ * initializeManager
+ * =============================================================================
+ */
+static manager_t*
+initializeManager ()
+{
+    manager_t* managerPtr;
+    long numShard = (long)global_params[PARAM_SHARDS];
+
+    printf("Initializing manager... ");
     fflush(stdout);
 
-    free(ids);
+    managerPtr = new manager_t(numShard);
+    assert(managerPtr != NULL);
+
+    thread_start(populateManager, (void*)managerPtr);
+
+    puts("done.");
+    fflush(stdout);
 
     return managerPtr;
 }
@@ -221,6 +324,13 @@ initializeClients (manager_t* managerPtr)
     long percentQuery = (long)global_params[PARAM_QUERIES];
     long queryRange;
     long percentUser = (long)global_params[PARAM_USER];
+    double arrivalRate = global_params[PARAM_ARRIVAL];
+    bool isFixedInterval = (global_params[PARAM_FIXED] != 0);
+    distribution_t distribution =
+        (distribution_t)(long)global_params[PARAM_DISTRIBUTION];
+    long percentHotTraffic = (long)global_params[PARAM_HOT_TRAFFIC];
+    long percentHotKey = (long)global_params[PARAM_HOT_KEYS];
+    double theta = global_params[PARAM_THETA];
 
     printf("Initializing clients... ");
     fflush(stdout);
@@ -229,6 +339,11 @@ initializeClients (manager_t* managerPtr)
     assert(clients != NULL);
     numTransactionPerClient = (long)((double)numTransaction / (double)numClient + 0.5);
     queryRange = (long)((double)percentQuery / 100.0 * (double)numRelation + 0.5);
+    global_keyAliasPtr = client_allocKeyAlias(distribution,
+                                              queryRange,
+                                              theta,
+                                              percentHotTraffic,
+                                              percentHotKey);
 
     for (i = 0; i < numClient; i++) {
         clients[i] = new client_t(i,
@@ -236,7 +351,11 @@ initializeClients (manager_t* managerPtr)
                                   numTransactionPerClient,
                                   numQueryPerTransaction,
                                   queryRange,
-                                  percentUser);
+                                  percentUser,
+                                  arrivalRate,
+                                  isFixedInterval,
+                                  distribution,
+                                  global_keyAliasPtr);
         assert(clients[i]  != NULL);
     }
 
@@ -246,9 +365,21 @@ initializeClients (manager_t* managerPtr)
     printf("    Transactions/client = %li\n", numTransactionPerClient);
     printf("    Queries/transaction = %li\n", numQueryPerTransaction);
     printf("    Relations           = %li\n", numRelation);
+    printf("    Shards              = %li\n", managerPtr->numShard);
     printf("    Query percent       = %li\n", percentQuery);
     printf("    Query range         = %li\n", queryRange);
     printf("    Percent user        = %li\n", percentUser);
+    if (distribution == DISTRIBUTION_ZIPF) {
+        printf("    Id distribution     = zipfian (theta = %g)\n", theta);
+    } else if (distribution != DISTRIBUTION_UNIFORM) {
+        printf("    Id distribution     = %shotspot (%li%% of draws, %li%% of ids)\n",
+               ((distribution == DISTRIBUTION_MOVING_HOTSPOT) ? "moving " : ""),
+               percentHotTraffic, percentHotKey);
+    }
+    if (arrivalRate > 0) {
+        printf("    Arrivals/s/client   = %g (%s)\n",
+               arrivalRate, (isFixedInterval ? "fixed interval" : "Poisson"));
+    }
     fflush(stdout);
 
     return clients;
@@ -265,11 +396,11 @@ checkTables (manager_t* managerPtr)
 {
     long i;
     long numRelation = (long)global_params[PARAM_RELATIONS];
-    MAP_T* customerTablePtr = managerPtr->customerTablePtr;
-    MAP_T* tables[] = {
-        managerPtr->carTablePtr,
-        managerPtr->flightTablePtr,
-        managerPtr->roomTablePtr,
+    MAP_T** customerTables = managerPtr->customerTables;
+    MAP_T** tables[] = {
+        managerPtr->carTables,
+        managerPtr->flightTables,
+        managerPtr->roomTables,
     };
     long numTable = sizeof(tables) / sizeof(tables[0]);
     bool (*manager_add[])(manager_t*, long, long, long) = {
@@ -287,6 +418,7 @@ checkTables (manager_t* managerPtr)
     long queryRange = (long)((double)percentQuery / 100.0 * (double)numRelation + 0.5);
     long maxCustomerId = queryRange + 1;
     for (i = 1; i <= maxCustomerId; i++) {
+        MAP_T* customerTablePtr = customerTables[manager_getShard(managerPtr, i)];
         if (MAP_FIND(customerTablePtr, i)) {
             if (MAP_REMOVE(customerTablePtr, i)) {
                 assert(!MAP_FIND(customerTablePtr, i));
@@ -296,8 +428,8 @@ checkTables (manager_t* managerPtr)
 
     /* Check reservation tables for consistency and unique ids */
     for (t = 0; t < numTable; t++) {
-        MAP_T* tablePtr = tables[t];
         for (i = 1; i <= numRelation; i++) {
+            MAP_T* tablePtr = tables[t][manager_getShard(managerPtr, i)];
             if (MAP_FIND(tablePtr, i)) {
                 assert(manager_add[t](managerPtr, i, 0, 0)); /* validate entry */
                 if (MAP_REMOVE(tablePtr, i)) {
@@ -324,6 +456,9 @@ freeClients (client_t** clients)
         client_t* clientPtr = clients[i];
         delete clientPtr;
     }
+    if (global_keyAliasPtr != NULL) {
+        alias_free(global_keyAliasPtr);
+    }
 }
 
 
@@ -340,12 +475,12 @@ int main (int argc, char** argv)
 
     /* Initialization */
     parseArgs(argc, (char** const)argv);
+    long numThread = global_params[PARAM_CLIENTS];
+    thread_startup(numThread);
     managerPtr = initializeManager();
     assert(managerPtr != NULL);
     clients = initializeClients(managerPtr);
     assert(clients != NULL);
-    long numThread = global_params[PARAM_CLIENTS];
-    thread_startup(numThread);
 
     /* Run transactions */
     printf("Running clients... ");
@@ -356,6 +491,8 @@ int main (int argc, char** argv)
     puts("done.");
     printf("Time = %0.6lf\n",
            TIMER_DIFF_SECONDS(start, stop));
+    client_printLatencies(clients, numThread);
+    tmretry_printStats();
     fflush(stdout);
     checkTables(managerPtr);
 
@@ -74,27 +74,6 @@
 #include "coordinate.h"
 
 
-/* =============================================================================
- * coordinate_compare
- * =============================================================================
- */
-__attribute__ ((transaction_safe))
-long
-coordinate_compare (coordinate_t* aPtr, coordinate_t* bPtr)
-{
-    if (aPtr->x < bPtr->x) {
-        return -1;
-    } else if (aPtr->x > bPtr->x) {
-        return 1;
-    } else if (aPtr->y < bPtr->y) {
-        return -1;
-    } else if (aPtr->y > bPtr->y) {
-        return 1;
-    }
-
-    return 0;
-}
-
 #define ABS(a) (((a) > 0) ? (a) : -(a))
 /*
  * a transaction_safe version of sqrt, Newton's method
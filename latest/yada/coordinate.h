@@ -81,11 +81,25 @@ typedef struct coordinate {
 
 /* =============================================================================
  * coordinate_compare
+ * -- Inline so typed edge/element comparators reduce to plain compares
  * =============================================================================
  */
 __attribute__ ((transaction_safe))
-long
-coordinate_compare (coordinate_t* aPtr, coordinate_t* bPtr);
+inline long
+coordinate_compare (coordinate_t* aPtr, coordinate_t* bPtr)
+{
+    if (aPtr->x < bPtr->x) {
+        return -1;
+    } else if (aPtr->x > bPtr->x) {
+        return 1;
+    } else if (aPtr->y < bPtr->y) {
+        return -1;
+    } else if (aPtr->y > bPtr->y) {
+        return 1;
+    }
+
+    return 0;
+}
 
 
 /* =============================================================================
@@ -445,13 +445,7 @@ element_getEdge (element_t* elementPtr, long i)
 long
 compareEdge (edge_t* aEdgePtr, edge_t* bEdgePtr)
 {
-    long diffFirst = coordinate_compare((coordinate_t*)aEdgePtr->firstPtr,
-                                        (coordinate_t*)bEdgePtr->firstPtr);
-
-    return ((diffFirst != 0) ?
-            (diffFirst) :
-            (coordinate_compare((coordinate_t*)aEdgePtr->secondPtr,
-                                (coordinate_t*)bEdgePtr->secondPtr)));
+    return element_edgeCompare::compare(aEdgePtr, bEdgePtr);
 }
 
 
@@ -472,23 +466,6 @@ element_listCompareEdge (const void* aPtr, const void* bPtr)
 }
 
 
-/* =============================================================================
- * element_mapCompareEdge
- *
-  * For use in MAP_T
- * =============================================================================
- */
-__attribute__((transaction_safe))
-long
-element_mapCompareEdge (const pair_t* aPtr, const pair_t* bPtr)
-{
-    edge_t* aEdgePtr = (edge_t*)(aPtr->firstPtr);
-    edge_t* bEdgePtr = (edge_t*)(bPtr->firstPtr);
-
-    return compareEdge(aEdgePtr, bEdgePtr);
-}
-
-
 /* =============================================================================
  * element_heapCompare
  *
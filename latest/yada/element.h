@@ -73,6 +73,7 @@
 #include "coordinate.h"
 #include "list.h"
 #include "pair.h"
+#include "trbtree.h"
 
 typedef pair_t         edge_t;
 struct element_t {
@@ -178,14 +179,28 @@ element_listCompareEdge (const void* aPtr, const void* bPtr);
 
 
 /* =============================================================================
- * element_mapCompareEdge
+ * element_edgeCompare
  *
- * For use in MAP_T
+ * Compile-time comparator for edge_map_t
  * =============================================================================
  */
-__attribute__((transaction_safe))
-long
-element_mapCompareEdge (const pair_t* aPtr, const pair_t* bPtr);
+struct element_edgeCompare {
+    __attribute__((transaction_safe))
+    static long
+    compare (edge_t* aEdgePtr, edge_t* bEdgePtr)
+    {
+        long diffFirst = coordinate_compare((coordinate_t*)aEdgePtr->firstPtr,
+                                            (coordinate_t*)bEdgePtr->firstPtr);
+
+        return ((diffFirst != 0) ?
+                (diffFirst) :
+                (coordinate_compare((coordinate_t*)aEdgePtr->secondPtr,
+                                    (coordinate_t*)bEdgePtr->secondPtr)));
+    }
+};
+
+/* Maps each mesh edge to the element that shares it */
+typedef trbtree_t<edge_t*, element_t*, element_edgeCompare> edge_map_t;
 
 
 /* =============================================================================
@@ -233,6 +248,7 @@ element_getEncroachedPtr (element_t* elementPtr);
  * element_isSkinny
  * =============================================================================
  */
+__attribute__((transaction_safe))
 bool
 element_isSkinny (element_t* elementPtr);
 
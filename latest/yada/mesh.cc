@@ -132,7 +132,7 @@ mesh_free (mesh_t* meshPtr)
  */
 __attribute__((transaction_safe))
 void
-TMmesh_insert (mesh_t* meshPtr, element_t* elementPtr, MAP_T* edgeMapPtr)
+TMmesh_insert (mesh_t* meshPtr, element_t* elementPtr, edge_map_t* edgeMapPtr)
 {
     /*
      * Assuming fully connected graph, we just need to record one element.
@@ -150,26 +150,22 @@ TMmesh_insert (mesh_t* meshPtr, element_t* elementPtr, MAP_T* edgeMapPtr)
     long numEdge = element_getNumEdge(elementPtr);
     for (i = 0; i < numEdge; i++) {
         edge_t* edgePtr = element_getEdge(elementPtr, i);
-        if (!MAP_CONTAINS(edgeMapPtr, (void*)edgePtr)) {
+        if (!trbtree_contains(edgeMapPtr, edgePtr)) {
             /* Record existance of this edge */
             bool isSuccess;
-            isSuccess =
-                MAP_INSERT(edgeMapPtr, (void*)edgePtr, (void*)elementPtr);
+            isSuccess = trbtree_insert(edgeMapPtr, edgePtr, elementPtr);
             assert(isSuccess);
         } else {
             /*
              * Shared edge; update each element's neighborList
              */
             bool isSuccess;
-            element_t* sharerPtr = (element_t*)MAP_FIND(edgeMapPtr, edgePtr);
+            element_t* sharerPtr = trbtree_get(edgeMapPtr, edgePtr);
             assert(sharerPtr); /* cannot be shared by >2 elements */
             TMELEMENT_ADDNEIGHBOR(elementPtr, sharerPtr);
             TMELEMENT_ADDNEIGHBOR(sharerPtr, elementPtr);
-            isSuccess = MAP_REMOVE(edgeMapPtr, edgePtr);
-            assert(isSuccess);
-            isSuccess = MAP_INSERT(edgeMapPtr,
-                                    edgePtr,
-                                    NULL); /* marker to check >2 sharers */
+            /* NULL is the marker to check >2 sharers */
+            isSuccess = trbtree_update(edgeMapPtr, edgePtr, (element_t*)NULL);
             assert(isSuccess);
         }
     }
@@ -269,7 +265,7 @@ static void
 createElement (mesh_t* meshPtr,
                coordinate_t* coordinates,
                long numCoordinate,
-               MAP_T* edgeMapPtr)
+               edge_map_t* edgeMapPtr)
 {
     element_t* elementPtr = TMelement_alloc(coordinates, numCoordinate);
     assert(elementPtr);
@@ -312,7 +308,8 @@ mesh_read (mesh_t* meshPtr, const char* fileNamePrefix)
     long i;
     long numElement = 0;
 
-    MAP_T* edgeMapPtr = MAP_ALLOC(NULL, &element_mapCompareEdge);
+    edge_map_t* edgeMapPtr =
+        trbtree_alloc<edge_t*, element_t*, element_edgeCompare>();
     assert(edgeMapPtr);
 
     /*
@@ -413,7 +410,7 @@ mesh_read (mesh_t* meshPtr, const char* fileNamePrefix)
     fclose(inputFile);
 
     free(coordinates);
-    MAP_FREE(edgeMapPtr);
+    trbtree_free(edgeMapPtr);
 
     return numElement;
 }
@@ -74,7 +74,6 @@
 
 #include <random>
 #include "element.h"
-#include "map.h"
 #include "vector.h"
 
 
@@ -104,7 +103,7 @@ mesh_free (mesh_t* meshPtr);
  */
 __attribute__((transaction_safe))
 void
-TMmesh_insert (mesh_t* meshPtr, element_t* elementPtr, MAP_T* edgeMapPtr);
+TMmesh_insert (mesh_t* meshPtr, element_t* elementPtr, edge_map_t* edgeMapPtr);
 
 
 /* =============================================================================
@@ -75,17 +75,25 @@
 #include "coordinate.h"
 #include "element.h"
 #include "list.h"
-#include "map.h"
 #include "queue.h"
 #include "mesh.h"
+#include "svector.h"
 #include "tm_transition.h"
 
+/*
+ * A retriangulation creates only as many elements as the region has border
+ * edges, so the bad list almost always fits inline.
+ */
+#define REGION_BAD_INLINE (16)
+
+typedef svector_t<element_t*, REGION_BAD_INLINE> bad_vector_t;
+
 struct region_t {
     coordinate_t centerCoordinate;
     queue_t*     expandQueuePtr;
     list_t*   beforeListPtr; /* before retriangulation; list to avoid duplicates */
     list_t* borderListPtr; /* edges adjacent to region; list to avoid duplicates */
-    vector_t*    badVectorPtr;
+    bad_vector_t badVector;
 };
 
 /* =============================================================================
@@ -95,20 +103,20 @@ struct region_t {
 
 __attribute__((transaction_safe))
 void
-TMaddToBadVector (  vector_t* badVectorPtr, element_t* badElementPtr);
+TMaddToBadVector (  bad_vector_t* badVectorPtr, element_t* badElementPtr);
 
 __attribute__((transaction_safe))
 long
 TMretriangulate (element_t* elementPtr,
                  region_t* regionPtr,
                  mesh_t* meshPtr,
-                 MAP_T* edgeMapPtr);
+                 edge_map_t* edgeMapPtr);
 
 __attribute__((transaction_safe))
 element_t*
 TMgrowRegion (element_t* centerElementPtr,
               region_t* regionPtr,
-              MAP_T* edgeMapPtr,
+              edge_map_t* edgeMapPtr,
               bool* success);
 
 /* =============================================================================
@@ -132,8 +140,7 @@ Pregion_alloc ()
         regionPtr->borderListPtr = TMLIST_ALLOC(&element_listCompareEdge);
         assert(regionPtr->borderListPtr);
 
-        regionPtr->badVectorPtr = PVECTOR_ALLOC(1);
-        assert(regionPtr->badVectorPtr);
+        svector_init(&regionPtr->badVector);
     }
 
     return regionPtr;
@@ -147,7 +154,7 @@ Pregion_alloc ()
 void
 Pregion_free (region_t* regionPtr)
 {
-    PVECTOR_FREE(regionPtr->badVectorPtr);
+    svector_free(&regionPtr->badVector);
     list_free(regionPtr->borderListPtr);
     list_free(regionPtr->beforeListPtr);
     TMQUEUE_FREE(regionPtr->expandQueuePtr);
@@ -161,9 +168,9 @@ Pregion_free (region_t* regionPtr)
  */
 __attribute__((transaction_safe))
 void
-TMaddToBadVector (  vector_t* badVectorPtr, element_t* badElementPtr)
+TMaddToBadVector (  bad_vector_t* badVectorPtr, element_t* badElementPtr)
 {
-    bool status = PVECTOR_PUSHBACK(badVectorPtr, (void*)badElementPtr);
+    bool status = svector_pushBack(badVectorPtr, badElementPtr);
     assert(status);
     TMELEMENT_SETISREFERENCED(badElementPtr, true);
 }
@@ -180,9 +187,9 @@ long
 TMretriangulate (element_t* elementPtr,
                  region_t* regionPtr,
                  mesh_t* meshPtr,
-                 MAP_T* edgeMapPtr)
+                 edge_map_t* edgeMapPtr)
 {
-    vector_t* badVectorPtr = regionPtr->badVectorPtr; /* private */
+    bad_vector_t* badVectorPtr = &regionPtr->badVector; /* private */
     list_t* beforeListPtr = regionPtr->beforeListPtr; /* private */
     list_t* borderListPtr = regionPtr->borderListPtr; /* private */
     list_iter_t it;
@@ -285,7 +292,7 @@ __attribute__((transaction_safe))
 element_t*
 TMgrowRegion (element_t* centerElementPtr,
               region_t* regionPtr,
-              MAP_T* edgeMapPtr,
+              edge_map_t* edgeMapPtr,
               bool* success)
 {
   *success = true;
@@ -352,8 +359,8 @@ TMgrowRegion (element_t* centerElementPtr,
                       return NULL;
                     }
                     TMLIST_INSERT(borderListPtr,(void*)borderEdgePtr); /* no duplicates */
-                    if (!MAP_CONTAINS(edgeMapPtr, borderEdgePtr)) {
-                        MAP_INSERT(edgeMapPtr, borderEdgePtr, neighborElementPtr);
+                    if (!trbtree_contains(edgeMapPtr, borderEdgePtr)) {
+                        trbtree_insert(edgeMapPtr, borderEdgePtr, neighborElementPtr);
                     }
                 }
             } /* not visited before */
@@ -377,15 +384,14 @@ TMregion_refine (region_t* regionPtr, element_t* elementPtr, mesh_t* meshPtr, bo
 {
 
     long numDelta = 0L;
-    MAP_T* edgeMapPtr = NULL;
+    edge_map_t* edgeMapPtr = NULL;
     element_t* encroachElementPtr = NULL;
 
     if (TMELEMENT_ISGARBAGE(elementPtr))
       return numDelta; /* so we can detect conflicts */
 
     while (1) {
-      //[wer] MAP_ALLOC = jsw_avlnew(cmp), where cmp should be SAFE
-        edgeMapPtr = MAP_ALLOC(NULL, &element_mapCompareEdge);
+        edgeMapPtr = trbtree_alloc<edge_t*, element_t*, element_edgeCompare>();
         assert(edgeMapPtr);
         //[wer210] added one more parameter "success" to indicate successfulness
         encroachElementPtr = TMgrowRegion(elementPtr,
@@ -405,7 +411,7 @@ TMregion_refine (region_t* regionPtr, element_t* elementPtr, mesh_t* meshPtr, bo
         } else {
             break;
         }
-        MAP_FREE(edgeMapPtr); // jsw_avldelete(edgeMapPtr)
+        trbtree_free(edgeMapPtr);
     }
 
     /*
@@ -419,7 +425,7 @@ TMregion_refine (region_t* regionPtr, element_t* elementPtr, mesh_t* meshPtr, bo
                                     edgeMapPtr);
     }
 
-    MAP_FREE(edgeMapPtr); /* no need to free elements */
+    trbtree_free(edgeMapPtr); /* no need to free elements */
 
     return numDelta;
 }
@@ -434,7 +440,7 @@ __attribute__((transaction_safe))
 void
 Pregion_clearBad (region_t* regionPtr)
 {
-    PVECTOR_CLEAR(regionPtr->badVectorPtr);
+    svector_clear(&regionPtr->badVector);
 }
 
 
@@ -446,12 +452,12 @@ __attribute__((transaction_safe))
 void
 TMregion_transferBad (region_t* regionPtr, heap_t* workHeapPtr)
 {
-    vector_t* badVectorPtr = regionPtr->badVectorPtr;
-    long numBad = PVECTOR_GETSIZE(badVectorPtr);
+    bad_vector_t* badVectorPtr = &regionPtr->badVector;
+    long numBad = svector_getSize(badVectorPtr);
     long i;
 
     for (i = 0; i < numBad; i++) {
-        element_t* badElementPtr = (element_t*)vector_at(badVectorPtr, i);
+        element_t* badElementPtr = svector_at(badVectorPtr, i);
         if (TMELEMENT_ISGARBAGE(badElementPtr)) {
             TMELEMENT_FREE(badElementPtr);
         } else {
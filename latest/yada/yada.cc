@@ -79,6 +79,7 @@
 #include "heap.h"
 #include "thread.h"
 #include "timer.h"
+#include "tmretry.h"
 
 #define PARAM_DEFAULT_INPUTPREFIX ("inputs/ttimeu1000000.2")
 #define PARAM_DEFAULT_NUMTHREAD   (1L)
@@ -93,6 +94,9 @@ heap_t*  global_workHeapPtr;
 long     global_totalNumAdded = 0;
 long     global_numProcess    = 0;
 
+static tmretry_site_t global_refineRetrySite =
+    TMRETRY_SITE_INIT("yada:refine");
+
 
 /* =============================================================================
  * displayUsage
@@ -221,9 +225,12 @@ process (void*)
 
         long numAdded;
         //[wer210] changed the control flow to get rid of self-abort
-        bool success = true;
+        tmretry_t retry;
+        tmretry_start(&retry, &global_refineRetrySite);
         while (1) {
           __transaction_atomic {
+            tmretry_enter(&retry);
+            bool success = true;
             // TM_SAFE: PVECTOR_CLEAR (regionPtr->badVectorPtr);
             PREGION_CLEARBAD(regionPtr);
             //[wer210] problematic function!
@@ -231,7 +238,9 @@ process (void*)
             if (success) break;
             else __transaction_cancel;
           }
+          tmretry_backoff(&retry);
         }
+        tmretry_finish(&retry);
 
         __transaction_atomic {
           TMELEMENT_SETISREFERENCED(elementPtr, false);
@@ -320,6 +329,7 @@ int main (int argc, char** argv)
     long finalNumElement = initNumElement + global_totalNumAdded;
     printf("Final mesh size                 = %li\n", finalNumElement);
     printf("Number of elements processed    = %li\n", global_numProcess);
+    tmretry_printStats();
     fflush(stdout);
 
 #if 0